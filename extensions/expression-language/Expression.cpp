@@ -29,6 +29,10 @@
 #include <utils/OsUtils.h>
 #include <expression/Expression.h>
 #include <regex>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 #ifndef DISABLE_CURL
 #include <curl/curl.h>
 #endif
@@ -734,16 +738,77 @@ Value expr_replace(const std::vector<Value> &args) {
   return Value(result);
 }
 
-Value expr_replaceFirst(const std::vector<Value> &args) {
+/**
+ * Bounded cache of compiled regular expressions, evicting the least recently used one. Used for the
+ * patterns that are only known when the expression is evaluated.
+ */
+class RegexCache {
+ public:
+  explicit RegexCache(size_t capacity)
+      : capacity_(capacity) {
+  }
+
+  std::shared_ptr<const std::regex> get(const std::string &pattern) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto entry = index_.find(pattern);
+      if (entry != index_.end()) {
+        entries_.splice(entries_.begin(), entries_, entry->second);
+        return entry->second->second;
+      }
+    }
+    // compile without holding the lock, the constructor throws on invalid patterns
+    auto regex = std::make_shared<const std::regex>(pattern);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.find(pattern) == index_.end()) {
+      entries_.emplace_front(pattern, regex);
+      index_[pattern] = entries_.begin();
+      if (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+    }
+    return regex;
+  }
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  // most recently used first
+  std::list<std::pair<std::string, std::shared_ptr<const std::regex>>> entries_;
+  std::unordered_map<std::string, std::list<std::pair<std::string, std::shared_ptr<const std::regex>>>::iterator> index_;
+};
+
+std::shared_ptr<const std::regex> get_cached_regex(const std::string &pattern) {
+  static RegexCache cache(EXPRESSION_LANGUAGE_REGEX_CACHE_SIZE);
+  return cache.get(pattern);
+}
+
+/**
+ * Compiles the pattern of a function if it is a literal, so that it is compiled only once instead
+ * of at every evaluation.
+ * @return the compiled pattern or nullptr if it has to be compiled when the expression is evaluated
+ */
+std::shared_ptr<const std::regex> precompile_regex(const Expression &pattern) {
+  if (pattern.is_dynamic()) {
+    return nullptr;
+  }
+  try {
+    return std::make_shared<const std::regex>(pattern({}).asString());
+  } catch (const std::regex_error&) {
+    // report invalid patterns on evaluation, as if they were dynamic
+    return nullptr;
+  }
+}
+
+Value expr_replaceFirst(const std::vector<Value> &args, const std::regex &find) {
   std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
   const std::string &replace = args[2].asString();
   return Value(std::regex_replace(result, find, replace, std::regex_constants::format_first_only));
 }
 
-Value expr_replaceAll(const std::vector<Value> &args) {
+Value expr_replaceAll(const std::vector<Value> &args, const std::regex &find) {
   std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
   const std::string &replace = args[2].asString();
   return Value(std::regex_replace(result, find, replace));
 }
@@ -757,22 +822,20 @@ Value expr_replaceNull(const std::vector<Value> &args) {
 }
 
 Value expr_replaceEmpty(const std::vector<Value> &args) {
+  static const std::regex find("^[ \n\r\t]*$");
   std::string result = args[0].asString();
-  const std::regex find("^[ \n\r\t]*$");
   const std::string &replace = args[1].asString();
   return Value(std::regex_replace(result, find, replace));
 }
 
-Value expr_matches(const std::vector<Value> &args) {
+Value expr_matches(const std::vector<Value> &args, const std::regex &expr) {
   const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
 
   return Value(std::regex_match(subject.begin(), subject.end(), expr));
 }
 
-Value expr_find(const std::vector<Value> &args) {
+Value expr_find(const std::vector<Value> &args, const std::regex &expr) {
   const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
 
   return Value(std::regex_search(subject.begin(), subject.end(), expr));
 }
@@ -889,6 +952,87 @@ Value expr_random(const std::vector<Value> &args) {
   return Value(distribution(generator));
 }
 
+/**
+ * Whether the result of the function only depends on its arguments, so that calls with constant
+ * arguments can be evaluated once, at compile time.
+ */
+bool is_deterministic(const std::string &function_name) {
+  static const std::set<std::string> non_deterministic = { "hostname", "ip", "UUID", "random", "now", "resolve_user_id" };
+  return non_deterministic.find(function_name) == non_deterministic.end();
+}
+
+bool is_constant(const std::vector<Expression> &args) {
+  return std::none_of(args.begin(), args.end(), [](const Expression &arg) {
+    return arg.is_dynamic() || arg.is_multi();
+  });
+}
+
+std::vector<Value> evaluate_constant(const std::vector<Expression> &args) {
+  std::vector<Value> evaluated_args;
+  evaluated_args.reserve(args.size());
+  for (const auto &arg : args) {
+    evaluated_args.emplace_back(arg(Parameters()));
+  }
+  return evaluated_args;
+}
+
+bool is_integer_literal(const std::string &str, std::size_t pos = 0) {
+  if (pos < str.length() && str[pos] == '-') {
+    pos++;
+  }
+  return pos < str.length() && std::all_of(str.begin() + pos, str.end(), [](char c) {return c >= '0' && c <= '9';});
+}
+
+/**
+ * Parses the constant arguments of arithmetic and comparison functions up front, so that they are
+ * not converted from strings on each evaluation. Only literals that convert to the same integer and
+ * decimal value either way are parsed, anything else is left to the function.
+ */
+std::vector<Expression> with_numeric_literals(const std::vector<Expression> &args) {
+  std::vector<Expression> typed_args;
+  typed_args.reserve(args.size());
+  for (const auto &arg : args) {
+    const Value value = arg.is_dynamic() || arg.is_multi() ? Value() : arg(Parameters());
+    const std::string str = value.isString() ? value.asString() : "";
+    const auto point = str.find('.');
+    try {
+      if (is_integer_literal(str)) {
+        typed_args.emplace_back(Value(static_cast<int64_t>(std::stol(str))));
+        continue;
+      } else if (point != std::string::npos && point > 0 && is_integer_literal(str.substr(0, point)) && is_integer_literal(str, point + 1) && str[point + 1] != '-') {
+        typed_args.emplace_back(Value(std::stold(str)));
+        continue;
+      }
+    } catch (const std::exception &) {
+      // out of range, keeps failing at evaluation time
+    }
+    typed_args.push_back(arg);
+  }
+  return typed_args;
+}
+
+/**
+ * Like with_numeric_literals, for the first count arguments of logical functions.
+ */
+std::vector<Expression> with_boolean_literals(const std::vector<Expression> &args, std::size_t count) {
+  std::vector<Expression> typed_args(args);
+  for (std::size_t i = 0; i < count && i < typed_args.size(); i++) {
+    if (typed_args[i].is_dynamic() || typed_args[i].is_multi()) {
+      continue;
+    }
+    const Value value = typed_args[i](Parameters());
+    if (!value.isString()) {
+      continue;
+    }
+    std::string str = value.asString();
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    if (str == "true" || str == "false") {
+      typed_args[i] = Expression(Value(str == "true"));
+    }
+  }
+  return typed_args;
+}
+
 template<Value T(const std::vector<Value> &)>
 Expression make_dynamic_function_incomplete(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
 
@@ -909,19 +1053,80 @@ Expression make_dynamic_function_incomplete(const std::string &function_name, co
       return T(args);
     },
                                  multi_args);
-  } else {
-    return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
-      std::vector<Value> evaluated_args;
+  }
 
-      for (const auto &arg : args) {
-        evaluated_args.emplace_back(arg(params));
-      }
+  if (is_deterministic(function_name) && is_constant(args)) {
+    try {
+      return Expression(T(evaluate_constant(args)));
+    } catch (const std::exception &) {
+      // not folded, so that the error is reported when the expression is evaluated, as before
+    }
+  }
 
-      return T(evaluated_args);
-    });
+  return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
+    std::vector<Value> evaluated_args;
+    evaluated_args.reserve(args.size());
+
+    for (const auto &arg : args) {
+      evaluated_args.emplace_back(arg(params));
+    }
+
+    return T(evaluated_args);
+  });
+}
+
+#ifdef EXPRESSION_LANGUAGE_USE_REGEX
+
+/**
+ * Like make_dynamic_function_incomplete, for functions whose second argument is a regular
+ * expression. Literal patterns are compiled here, others are looked up in the regex cache.
+ */
+template<Value T(const std::vector<Value> &, const std::regex &)>
+Expression make_regex_function(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
+  // num_args counts the subject and the pattern, which are always required
+  if (args.size() < num_args) {
+    std::stringstream message_ss;
+    message_ss << "Expression language function " << function_name << " called with " << args.size() << " argument(s), but " << num_args << " are required";
+    throw std::runtime_error(message_ss.str());
   }
+
+  const auto compiled = precompile_regex(args[1]);
+  auto eval = [compiled](const std::vector<Value> &args) -> Value {
+    return T(args, compiled ? *compiled : *get_cached_regex(args[1].asString()));
+  };
+
+  if (args[0].is_multi()) {
+    std::vector<Expression> multi_args;
+
+    for (auto it = std::next(args.begin()); it != args.end(); ++it) {
+      multi_args.emplace_back(*it);
+    }
+
+    return args[0].compose_multi(eval, multi_args);
+  }
+
+  if (is_constant(args)) {
+    try {
+      return Expression(eval(evaluate_constant(args)));
+    } catch (const std::exception &) {
+      // invalid patterns are reported when the expression is evaluated
+    }
+  }
+
+  return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
+    std::vector<Value> evaluated_args;
+    evaluated_args.reserve(args.size());
+
+    for (const auto &arg : args) {
+      evaluated_args.emplace_back(arg(params));
+    }
+
+    return eval(evaluated_args);
+  });
 }
 
+#endif  // EXPRESSION_LANGUAGE_USE_REGEX
+
 Value expr_literal(const std::vector<Value> &args) {
   return args[0];
 }
@@ -1127,11 +1332,16 @@ Expression make_allMatchingAttributes(const std::string &function_name, const st
     return Value(all_true);
   });
 
+  std::vector<std::shared_ptr<const std::regex>> compiled;
+  for (const auto &arg : args) {
+    compiled.push_back(precompile_regex(arg));
+  }
+
   result.make_multi([=](const Parameters &params) -> std::vector<Expression> {
     std::vector<Expression> out_exprs;
 
-    for (const auto &arg : args) {
-      const std::regex attr_regex = std::regex(arg(params).asString());
+    for (std::size_t i = 0; i < args.size(); i++) {
+      const auto attr_regex = compiled[i] ? compiled[i] : get_cached_regex(args[i](params).asString());
       const auto cur_flow_file = params.flow_file.lock();
       std::map<std::string, std::string> attrs;
 
@@ -1140,7 +1350,7 @@ Expression make_allMatchingAttributes(const std::string &function_name, const st
       }
 
       for (const auto &attr : attrs) {
-        if (std::regex_match(attr.first.begin(), attr.first.end(), attr_regex)) {
+        if (std::regex_match(attr.first.begin(), attr.first.end(), *attr_regex)) {
           out_exprs.emplace_back(make_dynamic([=](const Parameters &params,
                       const std::vector<Expression> &sub_exprs) -> Value {
                     std::string attr_val;
@@ -1180,11 +1390,16 @@ Expression make_anyMatchingAttribute(const std::string &function_name, const std
     return Value(any_true);
   });
 
+  std::vector<std::shared_ptr<const std::regex>> compiled;
+  for (const auto &arg : args) {
+    compiled.push_back(precompile_regex(arg));
+  }
+
   result.make_multi([=](const Parameters &params) -> std::vector<Expression> {
     std::vector<Expression> out_exprs;
 
-    for (const auto &arg : args) {
-      const std::regex attr_regex = std::regex(arg(params).asString());
+    for (std::size_t i = 0; i < args.size(); i++) {
+      const auto attr_regex = compiled[i] ? compiled[i] : get_cached_regex(args[i](params).asString());
       const auto cur_flow_file = params.flow_file.lock();
       std::map<std::string, std::string> attrs;
 
@@ -1193,7 +1408,7 @@ Expression make_anyMatchingAttribute(const std::string &function_name, const std
       }
 
       for (const auto &attr : attrs) {
-        if (std::regex_match(attr.first.begin(), attr.first.end(), attr_regex)) {
+        if (std::regex_match(attr.first.begin(), attr.first.end(), *attr_regex)) {
           out_exprs.emplace_back(make_dynamic([=](const Parameters &params,
                       const std::vector<Expression> &sub_exprs) -> Value {
                     std::string attr_val;
@@ -1407,17 +1622,17 @@ Expression make_dynamic_function(const std::string &function_name, const std::ve
   } else if (function_name == "replace") {
     return make_dynamic_function_incomplete<expr_replace>(function_name, args, 2);
   } else if (function_name == "replaceFirst") {
-    return make_dynamic_function_incomplete<expr_replaceFirst>(function_name, args, 2);
+    return make_regex_function<expr_replaceFirst>(function_name, args, 3);
   } else if (function_name == "replaceAll") {
-    return make_dynamic_function_incomplete<expr_replaceAll>(function_name, args, 2);
+    return make_regex_function<expr_replaceAll>(function_name, args, 3);
   } else if (function_name == "replaceNull") {
     return make_dynamic_function_incomplete<expr_replaceNull>(function_name, args, 1);
   } else if (function_name == "replaceEmpty") {
     return make_dynamic_function_incomplete<expr_replaceEmpty>(function_name, args, 1);
   } else if (function_name == "matches") {
-    return make_dynamic_function_incomplete<expr_matches>(function_name, args, 1);
+    return make_regex_function<expr_matches>(function_name, args, 2);
   } else if (function_name == "find") {
-    return make_dynamic_function_incomplete<expr_find>(function_name, args, 1);
+    return make_regex_function<expr_find>(function_name, args, 2);
   } else if (function_name == "allMatchingAttributes") {
     return make_allMatchingAttributes(function_name, args);
   } else if (function_name == "anyMatchingAttribute") {
@@ -1432,15 +1647,15 @@ Expression make_dynamic_function(const std::string &function_name, const std::ve
   } else if (function_name == "length") {
     return make_dynamic_function_incomplete<expr_length>(function_name, args, 0);
   } else if (function_name == "plus") {
-    return make_dynamic_function_incomplete<expr_plus>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_plus>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "minus") {
-    return make_dynamic_function_incomplete<expr_minus>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_minus>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "multiply") {
-    return make_dynamic_function_incomplete<expr_multiply>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_multiply>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "divide") {
-    return make_dynamic_function_incomplete<expr_divide>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_divide>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "mod") {
-    return make_dynamic_function_incomplete<expr_mod>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_mod>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "fromRadix") {
     return make_dynamic_function_incomplete<expr_fromRadix>(function_name, args, 2);
   } else if (function_name == "toRadix") {
@@ -1460,21 +1675,21 @@ Expression make_dynamic_function(const std::string &function_name, const std::ve
   } else if (function_name == "equalsIgnoreCase") {
     return make_dynamic_function_incomplete<expr_equalsIgnoreCase>(function_name, args, 1);
   } else if (function_name == "gt") {
-    return make_dynamic_function_incomplete<expr_gt>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_gt>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "ge") {
-    return make_dynamic_function_incomplete<expr_ge>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_ge>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "lt") {
-    return make_dynamic_function_incomplete<expr_lt>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_lt>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "le") {
-    return make_dynamic_function_incomplete<expr_le>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_le>(function_name, with_numeric_literals(args), 1);
   } else if (function_name == "and") {
-    return make_dynamic_function_incomplete<expr_and>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_and>(function_name, with_boolean_literals(args, 2), 1);
   } else if (function_name == "or") {
-    return make_dynamic_function_incomplete<expr_or>(function_name, args, 1);
+    return make_dynamic_function_incomplete<expr_or>(function_name, with_boolean_literals(args, 2), 1);
   } else if (function_name == "not") {
-    return make_dynamic_function_incomplete<expr_not>(function_name, args, 0);
+    return make_dynamic_function_incomplete<expr_not>(function_name, with_boolean_literals(args, 1), 0);
   } else if (function_name == "ifElse") {
-    return make_dynamic_function_incomplete<expr_ifElse>(function_name, args, 2);
+    return make_dynamic_function_incomplete<expr_ifElse>(function_name, with_boolean_literals(args, 1), 2);
   } else if (function_name == "allAttributes") {
     return make_allAttributes(function_name, args);
   } else if (function_name == "anyAttribute") {
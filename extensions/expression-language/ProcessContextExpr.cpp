@@ -28,15 +28,16 @@ bool ProcessContextExpr::getProperty(const Property &property, std::string &valu
     return ProcessContext::getProperty(property.getName(), value);
   }
   auto name = property.getName();
-  if (expressions_.find(name) == expressions_.end()) {
+  auto compiled = expressions_.find(name);
+  if (compiled == expressions_.end()) {
     std::string expression_str;
     ProcessContext::getProperty(name, expression_str);
     logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    expressions_.emplace(name, expression::compile(expression_str));
+    compiled = expressions_.emplace(name, expression::compile(expression_str)).first;
   }
 
   minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = expressions_[name](p).asString();
+  value = compiled->second(p).asString();
   return true;
 }
 
@@ -46,14 +47,15 @@ bool ProcessContextExpr::getDynamicProperty(const Property &property, std::strin
     return ProcessContext::getDynamicProperty(property.getName(), value);
   }
   auto name = property.getName();
-  if (dynamic_property_expressions_.find(name) == dynamic_property_expressions_.end()) {
+  auto compiled = dynamic_property_expressions_.find(name);
+  if (compiled == dynamic_property_expressions_.end()) {
     std::string expression_str;
     ProcessContext::getDynamicProperty(name, expression_str);
     logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    dynamic_property_expressions_.emplace(name, expression::compile(expression_str));
+    compiled = dynamic_property_expressions_.emplace(name, expression::compile(expression_str)).first;
   }
   minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = dynamic_property_expressions_[name](p).asString();
+  value = compiled->second(p).asString();
   return true;
 }
 
@@ -17,6 +17,8 @@
 
 #include <ProcessContext.h>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <impl/expression/Expression.h>
 
 namespace org {
@@ -64,8 +66,9 @@ class ProcessContextExpr : public core::ProcessContext {
   virtual bool getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
  protected:
 
-  std::map<std::string, org::apache::nifi::minifi::expression::Expression> expressions_;
-  std::map<std::string, org::apache::nifi::minifi::expression::Expression> dynamic_property_expressions_;
+  // compiled on first use, looked up with a single hash lookup per evaluation
+  std::unordered_map<std::string, org::apache::nifi::minifi::expression::Expression> expressions_;
+  std::unordered_map<std::string, org::apache::nifi::minifi::expression::Expression> dynamic_property_expressions_;
 
  private:
   std::shared_ptr<logging::Logger> logger_;
@@ -20,6 +20,7 @@
 #include <iomanip>
 #include <limits>
 #include <algorithm>
+#include <cctype>
 
 #ifndef NIFI_MINIFI_CPP_VALUE_H
 #define NIFI_MINIFI_CPP_VALUE_H
@@ -89,9 +90,7 @@ class Value {
   bool isDecimal() const {
     if (is_long_double_) {
       return true;
-    } else if (is_string_ && (string_val_.find('.') != string_val_.npos ||
-        string_val_.find('e') != string_val_.npos ||
-        string_val_.find('E') != string_val_.npos)) {
+    } else if (is_string_ && string_val_.find_first_of(".eE") != string_val_.npos) {
       return true;
     } else {
       return false;
@@ -231,6 +230,12 @@ class Value {
     } else if (is_long_double_) {
       return long_double_val_ != 0.0;
     } else if (is_string_) {
+      // the common spellings are recognized without a stream
+      if (equalsIgnoreCase(string_val_, "true")) {
+        return true;
+      } else if (equalsIgnoreCase(string_val_, "false")) {
+        return false;
+      }
       std::string bool_str = string_val_;
       std::transform(bool_str.begin(), bool_str.end(), bool_str.begin(), ::tolower);
       std:: istringstream bools(bool_str);
@@ -243,6 +248,16 @@ class Value {
   }
 
  private:
+  static bool equalsIgnoreCase(const std::string &str, const char *lower) {
+    std::size_t i = 0;
+    for (; i < str.length() && lower[i] != '\0'; i++) {
+      if (std::tolower(static_cast<unsigned char>(str[i])) != lower[i]) {
+        return false;
+      }
+    }
+    return i == str.length() && lower[i] == '\0';
+  }
+
   bool is_null_ = true;
   bool is_string_ = false;
   bool is_bool_ = false;
@@ -25,6 +25,9 @@
 #undef EXPRESSION_LANGUAGE_USE_REGEX
 #endif
 
+// Number of compiled regular expressions cached for patterns that are not literals
+#define EXPRESSION_LANGUAGE_REGEX_CACHE_SIZE (256)
+
 #define EXPRESSION_LANGUAGE_USE_DATE
 
 // Disable date in EL for incompatible compilers
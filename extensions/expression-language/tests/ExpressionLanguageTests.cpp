@@ -18,7 +18,12 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
 #include <memory>
+#include <regex>
 #include <string>
 #ifndef DISABLE_CURL
 #pragma comment(lib, "libcurl.lib")
@@ -540,6 +545,42 @@ TEST_CASE("Find 3", "[expressionLanguageFind3]") {  // NOLINT
   REQUIRE("true" == expr( { flow_file_a }).asString());
 }
 
+TEST_CASE("Matches with a dynamic pattern", "[expressionLanguageMatchesDynamic]") {  // NOLINT
+  auto expr = expression::compile("${attr:matches(${pattern})}");
+
+  for (int i = 0; i < 2 * EXPRESSION_LANGUAGE_REGEX_CACHE_SIZE; i++) {
+    auto flow_file_a = std::make_shared<MockFlowFile>();
+    flow_file_a->addAttribute("attr", "At:" + std::to_string(i));
+    flow_file_a->addAttribute("pattern", "At:" + std::to_string(i % (EXPRESSION_LANGUAGE_REGEX_CACHE_SIZE + 1)));
+    REQUIRE((i <= EXPRESSION_LANGUAGE_REGEX_CACHE_SIZE) == expr( { flow_file_a }).asBoolean());
+  }
+}
+
+TEST_CASE("Replace All with a dynamic pattern", "[expressionLanguageReplaceAllDynamic]") {  // NOLINT
+  auto expr = expression::compile("${attr:replaceAll(${pattern}, 'x')}");
+
+  auto flow_file_a = std::make_shared<MockFlowFile>();
+  flow_file_a->addAttribute("attr", "a brand new filename.txt");
+  flow_file_a->addAttribute("pattern", "[aeiou]");
+  REQUIRE("x brxnd nxw fxlxnxmx.txt" == expr( { flow_file_a }).asString());
+  flow_file_a->setAttribute("pattern", "\\.txt$");
+  REQUIRE("a brand new filenamex" == expr( { flow_file_a }).asString());
+}
+
+TEST_CASE("Replace functions require a replacement", "[expressionLanguageReplaceMissingArgument]") {  // NOLINT
+  REQUIRE_THROWS_WITH(expression::compile("${attr:replaceFirst('x')}"), "Expression language function replaceFirst called with 2 argument(s), but 3 are required");
+  REQUIRE_THROWS_WITH(expression::compile("${attr:replaceAll('x')}"), "Expression language function replaceAll called with 2 argument(s), but 3 are required");
+  REQUIRE_THROWS_WITH(expression::compile("${attr:matches()}"), "Expression language function matches called with 1 argument(s), but 2 are required");
+}
+
+TEST_CASE("Matches with an invalid pattern", "[expressionLanguageMatchesInvalid]") {  // NOLINT
+  auto expr = expression::compile("${attr:matches('(At')}");
+
+  auto flow_file_a = std::make_shared<MockFlowFile>();
+  flow_file_a->addAttribute("attr", "At");
+  REQUIRE_THROWS(expr( { flow_file_a }));
+}
+
 TEST_CASE("IndexOf", "[expressionLanguageIndexOf]") {  // NOLINT
   auto expr = expression::compile("${attr:indexOf('a.*txt')}");
 
@@ -1460,6 +1501,52 @@ TEST_CASE("Any Matching Contains 4", "[expressionAnyMatchingContains4]") {  // N
   REQUIRE(!expr( { flow_file_a }).asBoolean());
 }
 
+TEST_CASE("Any Matching Contains with a dynamic pattern", "[expressionAnyMatchingContainsDynamic]") {  // NOLINT
+  auto expr = expression::compile("${anyMatchingAttribute(${prefix:append('_.*')}):contains('hello')}");
+
+  auto flow_file_a = std::make_shared<MockFlowFile>();
+  flow_file_a->addAttribute("prefix", "abc");
+  flow_file_a->addAttribute("abc_1", "hello 1");
+  flow_file_a->addAttribute("xyz_2", "mello 2");
+  REQUIRE(expr( { flow_file_a }).asBoolean());
+  flow_file_a->setAttribute("prefix", "xyz");
+  REQUIRE(!expr( { flow_file_a }).asBoolean());
+}
+
+TEST_CASE("Regular expression evaluation benchmark", "[.][benchmark]") {  // NOLINT
+  const int evaluations = 100000;
+  auto flow_file_a = std::make_shared<MockFlowFile>();
+  flow_file_a->addAttribute("attr", "sensor-42.temperature.celsius");
+  flow_file_a->addAttribute("pattern", "^sensor-[0-9]+[.](temperature|humidity)[.].*$");
+  std::string pattern;
+  flow_file_a->getAttribute("pattern", pattern);
+
+  auto run = [&](const std::string &name, const std::function<bool()> &evaluate) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < evaluations; i++) {
+      REQUIRE(evaluate());
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << (evaluations * 1000LL / (std::max)(elapsed, static_cast<decltype(elapsed)>(1))) << " evaluations/s" << std::endl;
+  };
+
+  // what every evaluation used to do
+  run("compiling the pattern on each evaluation", [&]() {
+    std::string subject;
+    flow_file_a->getAttribute("attr", subject);
+    const std::regex expr(pattern);
+    return std::regex_match(subject.begin(), subject.end(), expr);
+  });
+  auto literal = expression::compile("${attr:matches('" + pattern + "')}");
+  run("literal pattern", [&]() {
+    return literal( { flow_file_a }).asBoolean();
+  });
+  auto dynamic = expression::compile("${attr:matches(${pattern})}");
+  run("dynamic pattern", [&]() {
+    return dynamic( { flow_file_a }).asBoolean();
+  });
+}
+
 #endif  // EXPRESSION_LANGUAGE_USE_REGEX
 
 TEST_CASE("All Delineated Contains", "[expressionAllDelineatedContains]") {  // NOLINT
@@ -1570,3 +1657,72 @@ TEST_CASE("resolve_user_id_test", "[resolve_user_id tests]") {  // NOLINT
 }
 }
 
+
+TEST_CASE("Constant subexpressions are folded", "[expressionConstantFolding]") {  // NOLINT
+  auto expr = expression::compile("${literal(2):plus(3):multiply(4)}");
+  REQUIRE(!expr.is_dynamic());
+  REQUIRE("20" == expr( { }).asString());
+
+  auto concatenated = expression::compile("a${literal('b'):toUpper()}c");
+  REQUIRE(!concatenated.is_dynamic());
+  REQUIRE("aBc" == concatenated( { }).asString());
+
+  auto mixed = expression::compile("${attr:plus(${literal(2):multiply(3)})}");
+  REQUIRE(mixed.is_dynamic());
+  auto flow_file_a = std::make_shared<MockFlowFile>();
+  flow_file_a->addAttribute("attr", "4");
+  REQUIRE("10" == mixed( { flow_file_a }).asString());
+}
+
+TEST_CASE("Non-deterministic functions are not folded", "[expressionConstantFoldingNonDeterministic]") {  // NOLINT
+  auto random = expression::compile("${random()}");
+  REQUIRE(random.is_dynamic());
+  auto uuid = expression::compile("${UUID():toUpper()}");
+  REQUIRE(uuid.is_dynamic());
+  REQUIRE(uuid( { }).asString() != uuid( { }).asString());
+}
+
+TEST_CASE("Errors of constant subexpressions are reported at evaluation", "[expressionConstantFoldingError]") {  // NOLINT
+  auto expr = expression::compile("${literal(10):toRadix(1)}");
+  REQUIRE_THROWS(expr( { }));
+}
+
+TEST_CASE("Literal arguments of arithmetic and logical functions", "[expressionTypedLiterals]") {  // NOLINT
+  auto flow_file_a = std::make_shared<MockFlowFile>();
+  flow_file_a->addAttribute("attr", "11");
+  flow_file_a->addAttribute("decimal", "2.5");
+  REQUIRE(expression::compile("${attr:gt('5')}")( { flow_file_a }).asBoolean());
+  REQUIRE(!expression::compile("${attr:lt(-5)}")( { flow_file_a }).asBoolean());
+  REQUIRE("13.5" == expression::compile("${attr:plus('2.5')}")( { flow_file_a }).asString());
+  REQUIRE("5" == expression::compile("${decimal:multiply(2.0)}")( { flow_file_a }).asString());
+  REQUIRE("21" == expression::compile("${attr:plus('1e1')}")( { flow_file_a }).asString());
+  REQUIRE(expression::compile("${attr:equals('11'):and('TRUE')}")( { flow_file_a }).asBoolean());
+  REQUIRE(!expression::compile("${attr:equals('11'):and('False')}")( { flow_file_a }).asBoolean());
+  REQUIRE("yes" == expression::compile("${literal('true'):ifElse('yes', 'no')}")( { flow_file_a }).asString());
+}
+
+TEST_CASE("Expression evaluation benchmark", "[.][benchmark]") {  // NOLINT
+  const int evaluations = 100000;
+  auto flow_file_a = std::make_shared<MockFlowFile>();
+  flow_file_a->addAttribute("filename", "sensor-42.json");
+  flow_file_a->addAttribute("size", "2048");
+  flow_file_a->addAttribute("retries", "2");
+
+  // rules typical for UpdateAttribute and RouteOnAttribute
+  const std::vector<std::string> rules = {
+    "${filename:substringBefore('.'):append('-'):append(${literal(1024):multiply(4)})}",
+    "${size:gt(1024):and(${retries:lt(3)})}",
+    "${retries:plus(1):mod(5)}",
+    "${literal('prefix'):toUpper()}/${filename}",
+    "${size:divide(1024):ge('1.5'):ifElse('large', 'small')}"
+  };
+  for (const auto &rule : rules) {
+    auto expr = expression::compile(rule);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < evaluations; i++) {
+      REQUIRE(!expr( { flow_file_a }).asString().empty());
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << rule << ": " << (evaluations * 1000LL / (std::max)(elapsed, static_cast<decltype(elapsed)>(1))) << " evaluations/s" << std::endl;
+  }
+}
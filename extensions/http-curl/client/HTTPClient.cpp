@@ -32,7 +32,8 @@ namespace nifi {
 namespace minifi {
 namespace utils {
 
-HTTPClient::HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service)
+HTTPClient::HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service,
+                       const std::shared_ptr<HTTPConnectionPool> &connection_pool)
     : core::Connectable("HTTPClient"),
       ssl_context_service_(ssl_context_service),
       url_(url),
@@ -46,10 +47,15 @@ HTTPClient::HTTPClient(const std::string &url, const std::shared_ptr<minifi::con
       read_callback_(INT_MAX),
       header_response_(-1),
       res(CURLE_OK),
+      connection_pool_(connection_pool),
       keep_alive_probe_(-1),
       keep_alive_idle_(-1),
       logger_(logging::LoggerFactory<HTTPClient>::getLogger()) {
-  http_session_ = curl_easy_init();
+  if (nullptr != connection_pool_) {
+    http_session_ = connection_pool_->acquire();
+  } else {
+    http_session_ = curl_easy_init();
+  }
 }
 
 HTTPClient::HTTPClient(std::string name, utils::Identifier uuid)
@@ -98,7 +104,11 @@ HTTPClient::~HTTPClient() {
     headers_ = nullptr;
   }
   if (http_session_ != nullptr) {
-    curl_easy_cleanup(http_session_);
+    if (nullptr != connection_pool_) {
+      connection_pool_->release(http_session_);
+    } else {
+      curl_easy_cleanup(http_session_);
+    }
     http_session_ = nullptr;
   }
   // forceClose ended up not being the issue in MINIFICPP-667, but leaving here
@@ -202,6 +212,14 @@ bool HTTPClient::setMinimumSSLVersion(SSLVersion minimum_version) {
   return ret == CURLE_OK;
 }
 
+bool HTTPClient::setUseHTTP2() {
+#if CURL_AT_LEAST_VERSION(7, 47, 0)
+  return curl_easy_setopt(http_session_, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS) == CURLE_OK;
+#else
+  return false;
+#endif
+}
+
 void HTTPClient::setConnectionTimeout(int64_t timeout) {
   connect_timeout_ = timeout;
   curl_easy_setopt(http_session_, CURLOPT_NOSIGNAL, 1);
@@ -276,7 +294,13 @@ void HTTPClient::setUseChunkedEncoding() {
 }
 
 bool HTTPClient::submit() {
-  if (IsNullOrEmpty(url_))
+  if (!prepare())
+    return false;
+  return finish(curl_easy_perform(http_session_));
+}
+
+bool HTTPClient::prepare() {
+  if (IsNullOrEmpty(url_) || http_session_ == nullptr)
     return false;
   if (connect_timeout_ > 0) {
     curl_easy_setopt(http_session_, CURLOPT_CONNECTTIMEOUT, connect_timeout_);
@@ -307,7 +331,11 @@ bool HTTPClient::submit() {
     logger_->log_debug("Not using keep alive");
     curl_easy_setopt(http_session_, CURLOPT_TCP_KEEPALIVE, 0L);
   }
-  res = curl_easy_perform(http_session_);
+  return true;
+}
+
+bool HTTPClient::finish(CURLcode result) {
+  res = result;
   if (callback == nullptr) {
     read_callback_.close();
   }
@@ -42,6 +42,7 @@
 
 #include "utils/ByteArrayCallback.h"
 #include "controllers/SSLContextService.h"
+#include "HTTPConnectionPool.h"
 #include "core/logging/Logger.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "properties/Configure.h"
@@ -68,7 +69,12 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   HTTPClient(std::string name, utils::Identifier uuid);
 
-  HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service = nullptr);
+  /**
+   * @param connection_pool if set, the curl handle is taken from the pool and returned to it once the client is destroyed,
+   * so that its connections are reused by the following clients.
+   */
+  HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service = nullptr,
+             const std::shared_ptr<HTTPConnectionPool> &connection_pool = nullptr);
 
   ~HTTPClient();
 
@@ -104,6 +110,21 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   bool submit() override;
 
+  /**
+   * Sets the options of the request, without performing it. submit() is prepare(), a blocking transfer, then finish().
+   * Callers driving the transfer themselves, such as HTTPMultiClient, call them around it.
+   */
+  bool prepare();
+
+  /**
+   * Collects the response once the transfer of the handle completed with the given result.
+   */
+  bool finish(CURLcode result);
+
+  CURL *getHandle() const {
+    return http_session_;
+  }
+
   CURLcode getResponseResult();
 
   int64_t &getResponseCode() override;
@@ -124,6 +145,13 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   bool setMinimumSSLVersion(SSLVersion minimum_version) override;
 
+  /**
+   * Negotiates HTTP/2 with https servers, which lets the requests to the same host share a connection. Plain http
+   * requests keep using HTTP/1.1.
+   * @return false if curl was built without HTTP/2 support
+   */
+  bool setUseHTTP2();
+
   void setKeepAliveProbe(long probe){
     keep_alive_probe_ = probe;
   }
@@ -245,6 +273,8 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   CURL *http_session_;
 
+  std::shared_ptr<HTTPConnectionPool> connection_pool_;
+
   std::string method_;
 
   long keep_alive_probe_;
@@ -0,0 +1,109 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HTTPConnectionPool.h"
+
+#include <memory>
+#include <vector>
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+HTTPConnectionPool::HTTPConnectionPool(size_t max_idle)
+    : share_(curl_share_init()),
+      max_idle_(max_idle),
+      logger_(logging::LoggerFactory<HTTPConnectionPool>::getLogger()) {
+  if (nullptr == share_) {
+    logger_->log_warn("Could not create a curl share, the pooled handles will not share their caches");
+    return;
+  }
+  curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HTTPConnectionPool::lock);
+  curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HTTPConnectionPool::unlock);
+  curl_share_setopt(share_, CURLSHOPT_USERDATA, static_cast<void*>(this));
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  // a shared connection cache is not safe to use from several threads, so connections stay with their handles
+}
+
+HTTPConnectionPool::~HTTPConnectionPool() {
+  // the share cannot be released while handles use it
+  for (CURL *handle : idle_) {
+    curl_easy_cleanup(handle);
+  }
+  idle_.clear();
+  if (nullptr != share_) {
+    curl_share_cleanup(share_);
+  }
+}
+
+CURL *HTTPConnectionPool::acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+      CURL *handle = idle_.back();
+      idle_.pop_back();
+      return handle;
+    }
+  }
+  CURL *handle = curl_easy_init();
+  if (nullptr != handle && nullptr != share_) {
+    curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+  }
+  return handle;
+}
+
+void HTTPConnectionPool::release(CURL *handle) {
+  if (nullptr == handle) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < max_idle_) {
+      // clears the options pointing into the released client, but keeps the connections and caches
+      curl_easy_reset(handle);
+      if (nullptr != share_) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+      }
+      idle_.push_back(handle);
+      return;
+    }
+  }
+  curl_easy_cleanup(handle);
+}
+
+size_t HTTPConnectionPool::getIdleCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idle_.size();
+}
+
+void HTTPConnectionPool::lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr) {
+  static_cast<HTTPConnectionPool*>(userptr)->share_mutexes_[data].lock();
+}
+
+void HTTPConnectionPool::unlock(CURL *handle, curl_lock_data data, void *userptr) {
+  static_cast<HTTPConnectionPool*>(userptr)->share_mutexes_[data].unlock();
+}
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
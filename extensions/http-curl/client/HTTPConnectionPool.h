@@ -0,0 +1,91 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_HTTP_CURL_CLIENT_HTTPCONNECTIONPOOL_H_
+#define EXTENSIONS_HTTP_CURL_CLIENT_HTTPCONNECTIONPOOL_H_
+
+#ifdef WIN32
+#define CURL_STATICLIB
+#endif
+#include <curl/curl.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+// idle handles kept by a pool
+#define HTTP_CONNECTION_POOL_DEFAULT_SIZE 8
+
+/**
+ * Purpose and Justification: Creating a curl handle for every request throws away its connections, so every
+ * request pays for a TCP connection and a TLS handshake. The pool keeps the handles of finished requests, along
+ * with their open connections, for the next requests.
+ *
+ * The handles of a pool also share their DNS cache and TLS sessions, so a handle opening a new connection can resume
+ * the session of another one. Connections are not shared, as curl does not support sharing them across threads.
+ */
+class HTTPConnectionPool {
+ public:
+  explicit HTTPConnectionPool(size_t max_idle = HTTP_CONNECTION_POOL_DEFAULT_SIZE);
+
+  HTTPConnectionPool(const HTTPConnectionPool &other) = delete;
+  HTTPConnectionPool &operator=(const HTTPConnectionPool &other) = delete;
+
+  ~HTTPConnectionPool();
+
+  /**
+   * Returns an idle handle, or a new one if there is none. Idle handles have their options reset.
+   */
+  CURL *acquire();
+
+  /**
+   * Returns a handle to the pool, which closes it if it already holds as many idle handles as it may.
+   */
+  void release(CURL *handle);
+
+  size_t getIdleCount();
+
+ private:
+  static void lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+
+  static void unlock(CURL *handle, curl_lock_data data, void *userptr);
+
+  // guard the data shared by the handles
+  std::mutex share_mutexes_[CURL_LOCK_DATA_LAST];
+  CURLSH *share_;
+
+  std::mutex mutex_;
+  std::vector<CURL*> idle_;
+  size_t max_idle_;
+
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_HTTP_CURL_CLIENT_HTTPCONNECTIONPOOL_H_ */
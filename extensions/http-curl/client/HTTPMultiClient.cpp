@@ -0,0 +1,123 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HTTPMultiClient.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+HTTPMultiClient::HTTPMultiClient(bool multiplex)
+    : multi_(curl_multi_init()),
+      logger_(logging::LoggerFactory<HTTPMultiClient>::getLogger()) {
+  if (nullptr == multi_) {
+    logger_->log_error("Could not create a curl multi handle");
+    return;
+  }
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+  curl_multi_setopt(multi_, CURLMOPT_PIPELINING, multiplex ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+#endif
+}
+
+HTTPMultiClient::~HTTPMultiClient() {
+  if (nullptr == multi_) {
+    return;
+  }
+  for (const auto &client : clients_) {
+    curl_multi_remove_handle(multi_, client.first);
+  }
+  clients_.clear();
+  curl_multi_cleanup(multi_);
+}
+
+bool HTTPMultiClient::add(HTTPClient *client) {
+  if (nullptr == multi_ || !client->prepare()) {
+    return false;
+  }
+  CURL *handle = client->getHandle();
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+  // waits for a connection that can be multiplexed rather than opening another one
+  curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+#endif
+  CURLMcode result = curl_multi_add_handle(multi_, handle);
+  if (result != CURLM_OK) {
+    logger_->log_error("Could not start the request to %s: %s", client->getURL(), curl_multi_strerror(result));
+    return false;
+  }
+  clients_[handle] = client;
+  return true;
+}
+
+void HTTPMultiClient::remove(HTTPClient *client) {
+  auto found = clients_.find(client->getHandle());
+  if (found == clients_.end()) {
+    return;
+  }
+  curl_multi_remove_handle(multi_, found->first);
+  clients_.erase(found);
+}
+
+std::vector<std::pair<HTTPClient*, bool>> HTTPMultiClient::perform(int timeout_ms) {
+  std::vector<std::pair<HTTPClient*, bool>> completed;
+  if (nullptr == multi_ || clients_.empty()) {
+    return completed;
+  }
+  int running = 0;
+  curl_multi_perform(multi_, &running);
+  completed = collect();
+  if (completed.empty() && running > 0) {
+    int ready = 0;
+    curl_multi_wait(multi_, nullptr, 0, timeout_ms, &ready);
+    curl_multi_perform(multi_, &running);
+    completed = collect();
+  }
+  return completed;
+}
+
+std::vector<std::pair<HTTPClient*, bool>> HTTPMultiClient::collect() {
+  std::vector<std::pair<HTTPClient*, bool>> completed;
+  int pending = 0;
+  while (CURLMsg *message = curl_multi_info_read(multi_, &pending)) {
+    if (message->msg != CURLMSG_DONE) {
+      continue;
+    }
+    CURL *handle = message->easy_handle;
+    CURLcode result = message->data.result;
+    auto found = clients_.find(handle);
+    curl_multi_remove_handle(multi_, handle);
+    if (found == clients_.end()) {
+      continue;
+    }
+    HTTPClient *client = found->second;
+    clients_.erase(found);
+    completed.push_back(std::make_pair(client, client->finish(result)));
+  }
+  return completed;
+}
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
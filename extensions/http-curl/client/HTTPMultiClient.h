@@ -0,0 +1,93 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_HTTP_CURL_CLIENT_HTTPMULTICLIENT_H_
+#define EXTENSIONS_HTTP_CURL_CLIENT_HTTPMULTICLIENT_H_
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "HTTPClient.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Purpose and Justification: HTTPClient::submit() blocks until the response arrives, so a thread sends a single
+ * request at a time. The multi client keeps any number of requests in flight from the calling thread through a
+ * curl multi handle, and hands back the clients of the completed ones.
+ *
+ * With multiplexing enabled, requests made over HTTP/2 (see HTTPClient::setUseHTTP2) to the same host share a
+ * single connection instead of opening one each.
+ *
+ * Not thread safe: a multi client is used by one thread at a time.
+ */
+class HTTPMultiClient {
+ public:
+  explicit HTTPMultiClient(bool multiplex = false);
+
+  HTTPMultiClient(const HTTPMultiClient &other) = delete;
+  HTTPMultiClient &operator=(const HTTPMultiClient &other) = delete;
+
+  /**
+   * Abandons the requests still in flight.
+   */
+  ~HTTPMultiClient();
+
+  /**
+   * Starts the request of a client, which has to outlive the request. The client is not to be used until it is
+   * returned by perform().
+   */
+  bool add(HTTPClient *client);
+
+  /**
+   * Transfers the data of the requests in flight, waiting at most timeout_ms for any of them to make progress.
+   * @return the clients whose requests completed, with the result of HTTPClient::finish() for each
+   */
+  std::vector<std::pair<HTTPClient*, bool>> perform(int timeout_ms);
+
+  /**
+   * Abandons the request of a client before it completed.
+   */
+  void remove(HTTPClient *client);
+
+  size_t getInFlightCount() const {
+    return clients_.size();
+  }
+
+ private:
+  std::vector<std::pair<HTTPClient*, bool>> collect();
+
+  CURLM *multi_;
+  std::map<CURL*, HTTPClient*> clients_;
+
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_HTTP_CURL_CLIENT_HTTPMULTICLIENT_H_ */
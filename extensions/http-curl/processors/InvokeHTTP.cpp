@@ -45,6 +45,7 @@
 #include "io/StreamFactory.h"
 #include "ResourceClaim.h"
 #include "utils/StringUtils.h"
+#include "../client/HTTPMultiClient.h"
 
 namespace org {
 namespace apache {
@@ -103,6 +104,25 @@ core::Property InvokeHTTP::AlwaysOutputResponse("Always Output Response", "Will
 core::Property InvokeHTTP::PenalizeOnNoRetry("Penalize on \"No Retry\"", "Enabling this property will penalize FlowFiles that are routed to the \"No Retry\" relationship.", "false");
 
 core::Property InvokeHTTP::DisablePeerVerification("Disable Peer Verification", "Disables peer verification for the SSL session", "false");
+
+core::Property InvokeHTTP::ConnectionPoolSize(
+    core::PropertyBuilder::createProperty("Connection Pool Size")->withDescription("The number of idle connections kept open for the following requests, "
+                                                                                   "which saves them from connecting and negotiating TLS again. If set to 0, every request opens "
+                                                                                   "a new connection.")->isRequired(false)->withDefaultValue<uint64_t>(HTTP_CONNECTION_POOL_DEFAULT_SIZE)->build());
+
+core::Property InvokeHTTP::MaxInFlight(
+    core::PropertyBuilder::createProperty("Max Requests In Flight")->withDescription("The maximum number of requests sent at the same time by a single thread. If greater than 1, "
+                                                                                     "the processor takes several FlowFiles at once and routes each of them as soon as its response "
+                                                                                     "arrives. Connection failures are then routed to failure instead of rolling back the session.")
+        ->isRequired(false)->withDefaultValue<uint64_t>(1)->build());
+
+core::Property InvokeHTTP::BatchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription("The maximum number of FlowFiles sent by a single run of the processor, when more than one request "
+                                                                         "is kept in flight.")->isRequired(false)->withDefaultValue<uint64_t>(100)->build());
+
+core::Property InvokeHTTP::UseHTTP2(
+    core::PropertyBuilder::createProperty("Use HTTP/2")->withDescription("Negotiates HTTP/2 with https servers, falling back to HTTP/1.1 if they do not support it. "
+                                                                         "Requests to http URLs always use HTTP/1.1.")->isRequired(false)->withDefaultValue<bool>(false)->build());
 const char* InvokeHTTP::STATUS_CODE = "invokehttp.status.code";
 const char* InvokeHTTP::STATUS_MESSAGE = "invokehttp.status.message";
 const char* InvokeHTTP::RESPONSE_BODY = "invokehttp.response.body";
@@ -146,6 +166,10 @@ void InvokeHTTP::initialize() {
   properties.insert(SendBody);
   properties.insert(DisablePeerVerification);
   properties.insert(AlwaysOutputResponse);
+  properties.insert(ConnectionPoolSize);
+  properties.insert(UseHTTP2);
+  properties.insert(MaxInFlight);
+  properties.insert(BatchSize);
 
   setSupportedProperties(properties);
   // Set the supported relationships
@@ -237,6 +261,30 @@ void InvokeHTTP::onSchedule(const std::shared_ptr<core::ProcessContext> &context
   if (context->getProperty(DisablePeerVerification.getName(), disablePeerVerification)) {
     utils::StringUtils::StringToBool(disablePeerVerification, disable_peer_verification_);
   }
+
+  if (!context->getProperty(ConnectionPoolSize.getName(), connection_pool_size_)) {
+    logger_->log_debug("%s attribute is missing, so default value of %s will be used", ConnectionPoolSize.getName(), ConnectionPoolSize.getValue());
+  }
+
+  if (!context->getProperty(MaxInFlight.getName(), max_in_flight_)) {
+    logger_->log_debug("%s attribute is missing, so default value of %s will be used", MaxInFlight.getName(), MaxInFlight.getValue());
+  }
+
+  if (!context->getProperty(BatchSize.getName(), batch_size_)) {
+    logger_->log_debug("%s attribute is missing, so default value of %s will be used", BatchSize.getName(), BatchSize.getValue());
+  }
+
+  // the handles of the previous schedule are released along with the pool
+  connection_pool_ = nullptr;
+  if (connection_pool_size_ > 0) {
+    // keeps the connections of all the requests in flight
+    connection_pool_ = std::make_shared<utils::HTTPConnectionPool>((std::max)(connection_pool_size_, max_in_flight_));
+  }
+
+  std::string useHTTP2 = "false";
+  if (context->getProperty(UseHTTP2.getName(), useHTTP2)) {
+    utils::StringUtils::StringToBool(useHTTP2, use_http2_);
+  }
 }
 
 InvokeHTTP::~InvokeHTTP() {
@@ -252,30 +300,15 @@ bool InvokeHTTP::emitFlowFile(const std::string &method) {
   return ("POST" == method || "PUT" == method || "PATCH" == method);
 }
 
-void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
-  std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->get());
-
-  std::string url = url_;
-
-  if (flowFile == nullptr) {
-    if (!emitFlowFile(method_)) {
-      logger_->log_debug("InvokeHTTP -- create flow file with  %s", method_);
-      flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-    } else {
-      logger_->log_debug("exiting because method is %s", method_);
-      return;
-    }
-  } else {
-    context->getProperty(URL, url, flowFile);
-    logger_->log_debug("InvokeHTTP -- Received flowfile");
-  }
-
-  logger_->log_debug("onTrigger InvokeHTTP with %s to %s", method_, url);
-
+std::unique_ptr<InvokeHTTP::Request> InvokeHTTP::prepareRequest(const std::shared_ptr<core::ProcessSession> &session, const std::shared_ptr<FlowFileRecord> &flowFile,
+                                                                const std::string &url) {
+  std::unique_ptr<Request> request(new Request());
+  request->flow_file = flowFile;
+  request->url = url;
   // create a transaction id
-  std::string tx_id = generateId();
-
-  utils::HTTPClient client(url, ssl_context_service_);
+  request->tx_id = generateId();
+  request->client = std::unique_ptr<utils::HTTPClient>(new utils::HTTPClient(url, ssl_context_service_, connection_pool_));
+  utils::HTTPClient &client = *request->client;
 
   client.initialize(method_);
   client.setConnectionTimeout(connect_timeout_);
@@ -294,22 +327,24 @@ void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context,
     client.setDisablePeerVerification();
   }
 
-  std::unique_ptr<utils::ByteInputCallBack> callback = nullptr;
-  std::unique_ptr<utils::HTTPUploadCallback> callbackObj = nullptr;
+  if (use_http2_ && !client.setUseHTTP2()) {
+    logger_->log_warn("HTTP/2 is not supported by curl, using HTTP/1.1");
+  }
+
   if (emitFlowFile(method_)) {
     logger_->log_trace("InvokeHTTP -- reading flowfile");
     std::shared_ptr<ResourceClaim> claim = flowFile->getResourceClaim();
     if (claim) {
-      callback = std::unique_ptr<utils::ByteInputCallBack>(new utils::ByteInputCallBack());
-      session->read(flowFile, callback.get());
-      callbackObj = std::unique_ptr<utils::HTTPUploadCallback>(new utils::HTTPUploadCallback);
-      callbackObj->ptr = callback.get();
-      callbackObj->pos = 0;
-      logger_->log_trace("InvokeHTTP -- Setting callback, size is %d", callback->getBufferSize());
+      request->callback = std::unique_ptr<utils::ByteInputCallBack>(new utils::ByteInputCallBack());
+      session->read(flowFile, request->callback.get());
+      request->callback_obj = std::unique_ptr<utils::HTTPUploadCallback>(new utils::HTTPUploadCallback);
+      request->callback_obj->ptr = request->callback.get();
+      request->callback_obj->pos = 0;
+      logger_->log_trace("InvokeHTTP -- Setting callback, size is %d", request->callback->getBufferSize());
       if (!use_chunked_encoding_) {
         client.appendHeader("Content-Length", std::to_string(flowFile->getSize()));
       }
-      client.setUploadCallback(callbackObj.get());
+      client.setUploadCallback(request->callback_obj.get());
     } else {
       logger_->log_error("InvokeHTTP -- no resource claim");
     }
@@ -320,54 +355,141 @@ void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context,
 
   // append all headers
   client.build_header_list(attribute_to_send_regex_, flowFile->getAttributes());
+  return request;
+}
 
-  logger_->log_trace("InvokeHTTP -- curl performed");
-  if (client.submit()) {
-    logger_->log_trace("InvokeHTTP -- curl successful");
+void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
+  std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->get());
+
+  if (flowFile != nullptr && max_in_flight_ > 1) {
+    onTriggerAsync(context, session, flowFile);
+    return;
+  }
 
-    bool putToAttribute = !IsNullOrEmpty(put_attribute_name_);
+  std::string url = url_;
 
-    const std::vector<char> &response_body = client.getResponseBody();
-    const std::vector<std::string> &response_headers = client.getHeaders();
+  if (flowFile == nullptr) {
+    if (!emitFlowFile(method_)) {
+      logger_->log_debug("InvokeHTTP -- create flow file with  %s", method_);
+      flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
+    } else {
+      logger_->log_debug("exiting because method is %s", method_);
+      return;
+    }
+  } else {
+    context->getProperty(URL, url, flowFile);
+    logger_->log_debug("InvokeHTTP -- Received flowfile");
+  }
 
-    int64_t http_code = client.getResponseCode();
-    const char *content_type = client.getContentType();
-    flowFile->addAttribute(STATUS_CODE, std::to_string(http_code));
-    if (response_headers.size() > 0)
-      flowFile->addAttribute(STATUS_MESSAGE, response_headers.at(0));
-    flowFile->addAttribute(REQUEST_URL, url);
-    flowFile->addAttribute(TRANSACTION_ID, tx_id);
+  logger_->log_debug("onTrigger InvokeHTTP with %s to %s", method_, url);
 
-    bool isSuccess = ((int32_t) (http_code / 100)) == 2;
-    bool output_body_to_content = isSuccess && !putToAttribute;
+  std::unique_ptr<Request> request = prepareRequest(session, flowFile, url);
 
-    logger_->log_debug("isSuccess: %d, response code %d", isSuccess, http_code);
-    std::shared_ptr<FlowFileRecord> response_flow = nullptr;
+  logger_->log_trace("InvokeHTTP -- curl performed");
+  if (request->client->submit()) {
+    processResponse(*request, context, session);
+  }
+}
 
-    if (output_body_to_content) {
-      if (flowFile != nullptr) {
-        response_flow = std::static_pointer_cast<FlowFileRecord>(session->create(flowFile));
+void InvokeHTTP::onTriggerAsync(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session,
+                                std::shared_ptr<FlowFileRecord> flowFile) {
+  std::map<utils::HTTPClient*, std::unique_ptr<Request>> requests;
+  // declared last, so that its handles are removed before the requests are destroyed
+  utils::HTTPMultiClient multi(use_http2_);
+  uint64_t taken = 0;
+  while (flowFile != nullptr || !requests.empty()) {
+    // fill the window with the queued flow files
+    while (flowFile != nullptr) {
+      taken++;
+      std::string url = url_;
+      context->getProperty(URL, url, flowFile);
+      logger_->log_debug("onTrigger InvokeHTTP with %s to %s, %d requests in flight", method_, url, requests.size());
+      std::unique_ptr<Request> request = prepareRequest(session, flowFile, url);
+      utils::HTTPClient *client = request->client.get();
+      if (multi.add(client)) {
+        requests[client] = std::move(request);
       } else {
-        response_flow = std::static_pointer_cast<FlowFileRecord>(session->create());
+        routeFailure(request->flow_file, session);
       }
+      flowFile = nullptr;
+      if (requests.size() < max_in_flight_ && taken < batch_size_) {
+        flowFile = std::static_pointer_cast<FlowFileRecord>(session->get());
+      }
+    }
+    // route the responses as they arrive
+    for (const auto &completed : multi.perform(INVOKE_HTTP_WAIT_PERIOD)) {
+      auto request = requests.find(completed.first);
+      if (request == requests.end()) {
+        continue;
+      }
+      if (completed.second) {
+        processResponse(*request->second, context, session);
+      } else {
+        routeFailure(request->second->flow_file, session);
+      }
+      requests.erase(request);
+    }
+    if (requests.size() < max_in_flight_ && taken < batch_size_) {
+      flowFile = std::static_pointer_cast<FlowFileRecord>(session->get());
+    }
+  }
+}
+
+void InvokeHTTP::routeFailure(const std::shared_ptr<FlowFileRecord> &flowFile, const std::shared_ptr<core::ProcessSession> &session) {
+  // left untransferred, the flow file would roll back the whole batch, including the requests already made
+  session->penalize(flowFile);
+  session->transfer(flowFile, RelFailure);
+}
 
-      // if content type isn't returned we should return application/octet-stream
-      // as per RFC 2046 -- 4.5.1
-      response_flow->addKeyedAttribute(MIME_TYPE, content_type ? std::string(content_type) : DefaultContentType);
-      response_flow->addAttribute(STATUS_CODE, std::to_string(http_code));
-      if (response_headers.size() > 0)
-        flowFile->addAttribute(STATUS_MESSAGE, response_headers.at(0));
-      response_flow->addAttribute(REQUEST_URL, url);
-      response_flow->addAttribute(TRANSACTION_ID, tx_id);
-      io::DataStream stream((const uint8_t*) response_body.data(), response_body.size());
-      // need an import from the data stream.
-      session->importFrom(stream, response_flow);
+void InvokeHTTP::processResponse(Request &request, const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
+  logger_->log_trace("InvokeHTTP -- curl successful");
+  utils::HTTPClient &client = *request.client;
+  std::shared_ptr<FlowFileRecord> &flowFile = request.flow_file;
+  const std::string &url = request.url;
+  const std::string &tx_id = request.tx_id;
+
+  bool putToAttribute = !IsNullOrEmpty(put_attribute_name_);
+
+  const std::vector<char> &response_body = client.getResponseBody();
+  const std::vector<std::string> &response_headers = client.getHeaders();
+
+  int64_t http_code = client.getResponseCode();
+  const char *content_type = client.getContentType();
+  flowFile->addAttribute(STATUS_CODE, std::to_string(http_code));
+  if (response_headers.size() > 0)
+    flowFile->addAttribute(STATUS_MESSAGE, response_headers.at(0));
+  flowFile->addAttribute(REQUEST_URL, url);
+  flowFile->addAttribute(TRANSACTION_ID, tx_id);
+
+  bool isSuccess = ((int32_t) (http_code / 100)) == 2;
+  bool output_body_to_content = isSuccess && !putToAttribute;
+
+  logger_->log_debug("isSuccess: %d, response code %d", isSuccess, http_code);
+  std::shared_ptr<FlowFileRecord> response_flow = nullptr;
+
+  if (output_body_to_content) {
+    if (flowFile != nullptr) {
+      response_flow = std::static_pointer_cast<FlowFileRecord>(session->create(flowFile));
     } else {
-      logger_->log_warn("Cannot output body to content");
       response_flow = std::static_pointer_cast<FlowFileRecord>(session->create());
     }
-    route(flowFile, response_flow, session, context, isSuccess, http_code);
+
+    // if content type isn't returned we should return application/octet-stream
+    // as per RFC 2046 -- 4.5.1
+    response_flow->addKeyedAttribute(MIME_TYPE, content_type ? std::string(content_type) : DefaultContentType);
+    response_flow->addAttribute(STATUS_CODE, std::to_string(http_code));
+    if (response_headers.size() > 0)
+      flowFile->addAttribute(STATUS_MESSAGE, response_headers.at(0));
+    response_flow->addAttribute(REQUEST_URL, url);
+    response_flow->addAttribute(TRANSACTION_ID, tx_id);
+    io::DataStream stream((const uint8_t*) response_body.data(), response_body.size());
+    // need an import from the data stream.
+    session->importFrom(stream, response_flow);
+  } else {
+    logger_->log_warn("Cannot output body to content");
+    response_flow = std::static_pointer_cast<FlowFileRecord>(session->create());
   }
+  route(flowFile, response_flow, session, context, isSuccess, http_code);
 }
 
 void InvokeHTTP::route(std::shared_ptr<FlowFileRecord> &request, std::shared_ptr<FlowFileRecord> &response, const std::shared_ptr<core::ProcessSession> &session,
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <curl/curl.h>
 #include "utils/ByteArrayCallback.h"
@@ -41,6 +42,9 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
+// milliseconds waited at once for the responses of the requests in flight
+#define INVOKE_HTTP_WAIT_PERIOD 100
+
 // InvokeHTTP Class
 class InvokeHTTP : public core::Processor {
  public:
@@ -59,6 +63,10 @@ class InvokeHTTP : public core::Processor {
         use_chunked_encoding_(false),
         penalize_no_retry_(false),
         disable_peer_verification_(false),
+        connection_pool_size_(HTTP_CONNECTION_POOL_DEFAULT_SIZE),
+        use_http2_(false),
+        max_in_flight_(1),
+        batch_size_(100),
         logger_(logging::LoggerFactory<InvokeHTTP>::getLogger()) {
   }
   // Destructor
@@ -83,6 +91,10 @@ class InvokeHTTP : public core::Processor {
   static core::Property SendBody;
   static core::Property UseChunkedEncoding;
   static core::Property DisablePeerVerification;
+  static core::Property ConnectionPoolSize;
+  static core::Property UseHTTP2;
+  static core::Property MaxInFlight;
+  static core::Property BatchSize;
   static core::Property PropPutOutputAttributes;
 
   static core::Property AlwaysOutputResponse;
@@ -116,6 +128,37 @@ class InvokeHTTP : public core::Processor {
 
  protected:
 
+  // a request, with what it needs until its response arrives
+  struct Request {
+    std::shared_ptr<FlowFileRecord> flow_file;
+    std::string url;
+    std::string tx_id;
+    std::unique_ptr<utils::ByteInputCallBack> callback;
+    std::unique_ptr<utils::HTTPUploadCallback> callback_obj;
+    std::unique_ptr<utils::HTTPClient> client;
+  };
+
+  /**
+   * Sets up the request of a flow file, without sending it.
+   */
+  std::unique_ptr<Request> prepareRequest(const std::shared_ptr<core::ProcessSession> &session, const std::shared_ptr<FlowFileRecord> &flowFile, const std::string &url);
+
+  /**
+   * Sends the requests of up to batch_size_ flow files, keeping up to max_in_flight_ of them in flight, and routes
+   * the flow files as their responses arrive.
+   */
+  void onTriggerAsync(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session, std::shared_ptr<FlowFileRecord> flowFile);
+
+  /**
+   * Sets the response attributes, creates the response flow file and routes both.
+   */
+  void processResponse(Request &request, const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session);
+
+  /**
+   * Routes a flow file whose request could not be made to failure.
+   */
+  void routeFailure(const std::shared_ptr<FlowFileRecord> &flowFile, const std::shared_ptr<core::ProcessSession> &session);
+
   /**
    * Generate a transaction ID
    * @return transaction ID string.
@@ -166,6 +209,16 @@ class InvokeHTTP : public core::Processor {
   bool penalize_no_retry_;
   // disable peer verification ( makes susceptible for MITM attacks )
   bool disable_peer_verification_;
+  // idle curl handles kept between requests, 0 disables the pool.
+  uint64_t connection_pool_size_;
+  // negotiate HTTP/2 with https servers.
+  bool use_http2_;
+  // requests sent at the same time, 1 sends them one by one.
+  uint64_t max_in_flight_;
+  // flow files sent by a trigger when several requests are in flight.
+  uint64_t batch_size_;
+  // curl handles, along with their connections, reused by the requests.
+  std::shared_ptr<utils::HTTPConnectionPool> connection_pool_;
  private:
   std::shared_ptr<logging::Logger> logger_;
   static std::shared_ptr<utils::IdGenerator> id_generator_;
@@ -55,6 +55,7 @@ std::shared_ptr<Transaction> HttpSiteToSiteClient::createTransaction(std::string
   uri << getBaseURI() << "data-transfer/" << dir_str << "/" << getPortId() << "/transactions";
   auto client = create_http_client(uri.str(), "POST");
   client->appendHeader(PROTOCOL_VERSION_HEADER, "1");
+  client->appendHeader(USE_COMPRESSION_HEADER, use_compression_ ? "true" : "false");
   client->setConnectionTimeout(5);
   client->setContentType("application/json");
   client->appendHeader("Accept: application/json");
@@ -73,7 +74,7 @@ std::shared_ptr<Transaction> HttpSiteToSiteClient::createTransaction(std::string
         logger_->log_debug("Location is empty");
       } else {
         org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> crcstream(peer_.get());
-        auto transaction = std::make_shared<HttpTransaction>(direction, crcstream);
+        auto transaction = std::make_shared<HttpTransaction>(direction, crcstream, use_compression_);
         transaction->initialize(this, url);
         auto transactionId = parseTransactionId(url);
         if (IsNullOrEmpty(transactionId))
@@ -206,6 +207,7 @@ std::shared_ptr<minifi::utils::HTTPClient> HttpSiteToSiteClient::openConnectionF
   std::shared_ptr<minifi::utils::HTTPClient> client = create_http_client(uri.str(), "POST");
   client->setContentType("application/octet-stream");
   client->appendHeader("Accept", "text/plain");
+  client->appendHeader(USE_COMPRESSION_HEADER, transaction->useCompression() ? "true" : "false");
   client->setUseChunkedEncoding();
   return client;
 }
@@ -214,6 +216,7 @@ std::shared_ptr<minifi::utils::HTTPClient> HttpSiteToSiteClient::openConnectionF
   std::stringstream uri;
   uri << transaction->getTransactionUrl() << "/flow-files";
   std::shared_ptr<minifi::utils::HTTPClient> client = create_http_client(uri.str(), "GET");
+  client->appendHeader(USE_COMPRESSION_HEADER, transaction->useCompression() ? "true" : "false");
   return client;
 }
 
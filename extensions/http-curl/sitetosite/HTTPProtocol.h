@@ -59,6 +59,7 @@ typedef struct Site2SitePeerStatus {
 class HttpSiteToSiteClient : public sitetosite::SiteToSiteClient {
 
   static constexpr char const* PROTOCOL_VERSION_HEADER = "x-nifi-site-to-site-protocol-version";
+  static constexpr char const* USE_COMPRESSION_HEADER = "x-nifi-site-to-site-use-compression";
  public:
 
   /*!
@@ -36,13 +36,13 @@ namespace sitetosite {
  */
 class HttpTransaction : public sitetosite::Transaction {
  public:
-  explicit HttpTransaction(sitetosite::TransferDirection direction, org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> &stream)
-      : Transaction(direction, stream),
+  explicit HttpTransaction(sitetosite::TransferDirection direction, org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> &stream, bool use_compression = false)
+      : Transaction(direction, stream, use_compression),
         client_ref_(nullptr) {
   }
 
   ~HttpTransaction(){
-    auto stream = dynamic_cast< org::apache::nifi::minifi::io::HttpStream*>(  dynamic_cast<SiteToSitePeer*>(crcStream.getstream())->getStream() );
+    auto stream = dynamic_cast< org::apache::nifi::minifi::io::HttpStream*>(  dynamic_cast<SiteToSitePeer*>(compressionStream.getstream())->getStream() );
 	if (stream)
 		stream->forceClose();
   }
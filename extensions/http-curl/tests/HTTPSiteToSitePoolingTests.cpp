@@ -0,0 +1,231 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define CURLOPT_SSL_VERIFYPEER_DISABLE 1
+#undef NDEBUG
+#include <cassert>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "HTTPClient.h"
+#include "CivetServer.h"
+#include "sitetosite/HTTPProtocol.h"
+#include "sitetosite/PeerSelector.h"
+#include "TestBase.h"
+#include "core/logging/Logger.h"
+#include "FlowController.h"
+#include "properties/Configure.h"
+#include "RemoteProcessorGroupPort.h"
+#include "TestServer.h"
+#include "HTTPIntegrationBase.h"
+#include "HTTPHandlers.h"
+
+// flow file counts the peers report, which PeerSelector weights the peers by
+#define FIRST_PEER_FLOW_FILES 30
+#define SECOND_PEER_FLOW_FILES 10
+
+/**
+ * Lists two peers, which are both served by the test server, and drops the second one from every other list
+ * so that its clients are checked out before and after it is added again.
+ */
+class AlternatingPeerResponder : public CivetHandler {
+ public:
+  explicit AlternatingPeerResponder(const std::string &port)
+      : port_(port),
+        requests_(0),
+        both_listed_(false) {
+  }
+
+  bool handleGet(CivetServer *server, struct mg_connection *conn) {
+    std::string site2site_rest_resp = "{\"peers\" : [{ \"hostname\": \"localhost\", \"port\": " + port_ + ",  \"secure\": false, \"flowFileCount\" : "
+        + std::to_string(FIRST_PEER_FLOW_FILES) + " }";
+    const bool both_listed = requests_++ % 2 == 0;
+    if (both_listed) {
+      site2site_rest_resp += ", { \"hostname\": \"127.0.0.1\", \"port\": " + port_ + ",  \"secure\": false, \"flowFileCount\" : "
+          + std::to_string(SECOND_PEER_FLOW_FILES) + " }";
+    }
+    site2site_rest_resp += "] }";
+    both_listed_ = both_listed;
+    std::stringstream headers;
+    headers << "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " << site2site_rest_resp.length() << "\r\nConnection: close\r\n\r\n";
+    mg_printf(conn, "%s", headers.str().c_str());
+    mg_printf(conn, "%s", site2site_rest_resp.c_str());
+    return true;
+  }
+
+  /**
+   * Whether the last list had both peers.
+   */
+  bool bothListed() const {
+    return both_listed_;
+  }
+
+ protected:
+  std::string port_;
+  std::atomic<int> requests_;
+  std::atomic<bool> both_listed_;
+};
+
+/**
+ * Counts the transactions each peer finishes while both peers are listed. The client finishes a transaction
+ * against the peer it was started with, so the Host header tells the peers apart.
+ */
+class PeerCountingDeleteResponder : public DeleteTransactionResponder {
+ public:
+  PeerCountingDeleteResponder(const std::string &base_url, const AlternatingPeerResponder &peers)
+      : DeleteTransactionResponder(base_url, "201 OK", 12),
+        peers_(peers) {
+  }
+
+  bool handleDelete(CivetServer *server, struct mg_connection *conn) {
+    const char *host = mg_get_header(conn, "Host");
+    if (host != nullptr && peers_.bothListed()) {
+      std::string hostname(host);
+      std::lock_guard<std::mutex> lock(mutex_);
+      transactions_[hostname.substr(0, hostname.find(':'))]++;
+    }
+    return DeleteTransactionResponder::handleDelete(server, conn);
+  }
+
+  int getTransactions(const std::string &hostname) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return transactions_[hostname];
+  }
+
+ private:
+  const AlternatingPeerResponder &peers_;
+  std::mutex mutex_;
+  std::map<std::string, int> transactions_;
+};
+
+/**
+ * Accepts the flow files of a transaction, however many it sends, and confirms them with the CRC of the whole body.
+ */
+class BatchFlowFileResponder : public CivetHandler {
+ public:
+  bool handlePost(CivetServer *server, struct mg_connection *conn) {
+    std::vector<uint8_t> body;
+    uint8_t chunk[4096];
+    int read;
+    while ((read = mg_read(conn, chunk, sizeof(chunk))) > 0) {
+      body.insert(body.end(), chunk, chunk + read);
+    }
+    minifi::io::BaseStream sink;
+    minifi::io::CRCStream<minifi::io::BaseStream> stream(&sink);
+    stream.writeData(body.data(), body.size());
+    std::string site2site_rest_resp = std::to_string(stream.getCRC());
+    std::stringstream headers;
+    headers << "HTTP/1.1 202 OK\r\nContent-Type: application/json\r\nContent-Length: " << site2site_rest_resp.length() << "\r\nConnection: close\r\n\r\n";
+    mg_printf(conn, "%s", headers.str().c_str());
+    mg_printf(conn, "%s", site2site_rest_resp.c_str());
+    return true;
+  }
+};
+
+class SiteToSitePoolingHarness : public CoapIntegrationBase {
+ public:
+  SiteToSitePoolingHarness()
+      : CoapIntegrationBase(6000),
+        finished_transactions_(nullptr) {
+  }
+
+  void setFinishedTransactions(PeerCountingDeleteResponder *finished_transactions) {
+    finished_transactions_ = finished_transactions;
+  }
+
+  void testSetup() override {
+    LogTestController::getInstance().setDebug<minifi::RemoteProcessorGroupPort>();
+    LogTestController::getInstance().setInfo<minifi::sitetosite::SiteToSiteClient>();
+    LogTestController::getInstance().setInfo<minifi::FlowController>();
+
+    configuration->set("nifi.c2.enable", "false");
+    configuration->set("nifi.remote.input.http.enabled", "true");
+    configuration->set("nifi.remote.input.socket.port", "8098");
+  }
+
+  void cleanup() override {
+    LogTestController::getInstance().reset();
+  }
+
+  void runAssertions() override {
+    const std::string logs = LogTestController::getInstance().log_output.str();
+    const int transactions = countPatInStr(logs, " peer finished transaction").second;
+    assert(transactions >= 10);
+
+    // the second peer takes transactions again after it is dropped and added back
+    assert(countPatInStr(logs, "Creating client for peer 127.0.0.1:8098").second >= 2);
+    // finished transactions return their clients for the next ones
+    assert(countPatInStr(logs, "enqueueing protocol").second >= 1);
+    assert(countPatInStr(logs, "Creating client for peer").second < transactions);
+
+    // while both peers are listed, the transactions are split by the weights of their flow file counts
+    const int first_peer = finished_transactions_->getTransactions("localhost");
+    const int second_peer = finished_transactions_->getTransactions("127.0.0.1");
+    assert(first_peer + second_peer >= 10);
+    const uint64_t total_flow_files = FIRST_PEER_FLOW_FILES + SECOND_PEER_FLOW_FILES;
+    const double first_weight = minifi::sitetosite::PeerSelector::calculateWeight(FIRST_PEER_FLOW_FILES, total_flow_files, 2, minifi::sitetosite::SEND);
+    const double second_weight = minifi::sitetosite::PeerSelector::calculateWeight(SECOND_PEER_FLOW_FILES, total_flow_files, 2, minifi::sitetosite::SEND);
+    const double expected_share = second_weight / (first_weight + second_weight);
+    const double share = static_cast<double>(second_peer) / (first_peer + second_peer);
+    // transactions that straddle a refresh are counted against the list they finish under
+    assert(std::fabs(share - expected_share) <= 0.15);
+  }
+
+ protected:
+  PeerCountingDeleteResponder *finished_transactions_;
+};
+
+int main(int argc, char **argv) {
+  transaction_id = 0;
+  transaction_id_output = 0;
+  std::string key_dir, test_file_location, url;
+  if (argc > 1) {
+    test_file_location = argv[1];
+    key_dir = argv[2];
+    url = argv[3];
+  }
+
+  SiteToSitePoolingHarness harness;
+  harness.setKeyDir("");
+
+  harness.setUrl(url + "/site-to-site", new SiteToSiteBaseResponder(url + "/site-to-site"));
+  harness.setUrl(url + "/controller", new SiteToSiteLocationResponder(false));
+  AlternatingPeerResponder *peers = new AlternatingPeerResponder(harness.getWebPort());
+  harness.setUrl(url + "/site-to-site/peers", peers);
+
+  // concurrent transactions are all given the same transaction, which the responders serve statelessly
+  std::string transaction_url = url + "/data-transfer/input-ports/471deef6-2a6e-4a7d-912a-81cc17e3a204/transactions";
+  std::string action_url = url + "/site-to-site/input-ports/471deef6-2a6e-4a7d-912a-81cc17e3a204/transactions";
+  TransactionResponder *transaction_response = new TransactionResponder(url, "471deef6-2a6e-4a7d-912a-81cc17e3a204", true, false, false);
+  std::string transaction_id = transaction_response->getTransactionId();
+  harness.setUrl(transaction_url, transaction_response);
+
+  harness.setUrl(action_url + "/" + transaction_id + "/flow-files", new BatchFlowFileResponder());
+
+  std::string delete_url = transaction_url + "/" + transaction_id;
+  PeerCountingDeleteResponder *finished_transactions = new PeerCountingDeleteResponder(delete_url, *peers);
+  harness.setFinishedTransactions(finished_transactions);
+  harness.setUrl(delete_url, finished_transactions);
+
+  harness.run(test_file_location);
+  return 0;
+}
@@ -16,18 +16,23 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <fstream>
+#include <iostream>
 #include <map>
 #include <memory>
 #include <utility>
 #include <string>
 #include <set>
+#include <vector>
 #include "FlowController.h"
 #include "io/BaseStream.h"
 #include "TestBase.h"
 #include "processors/GetFile.h"
 #include "core/Core.h"
 #include "client/HTTPClient.h"
+#include "client/HTTPConnectionPool.h"
+#include "client/HTTPMultiClient.h"
 #include "CivetServer.h"
 
 TEST_CASE("HTTPClientTestChunkedResponse", "[basic]") {
@@ -93,3 +98,125 @@ TEST_CASE("HTTPClientTestChunkedResponse", "[basic]") {
 
   LogTestController::getInstance().reset();
 }
+
+namespace {
+
+class EchoPathResponder : public CivetHandler {
+ public:
+  bool handleGet(CivetServer *server, struct mg_connection *conn) {
+    const std::string path = mg_get_request_info(conn)->local_uri;
+    // a single write, so that keep-alive requests are not held up by delayed acknowledgements
+    mg_printf(conn, "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %lu\r\n\r\n%s", path.size(), path.c_str());
+    return true;
+  }
+};
+
+std::vector<std::string> keepAliveOptions(int threads) {
+  return { "enable_keep_alive", "yes", "keep_alive_timeout_ms", "15000", "num_threads", std::to_string(threads), "listening_ports", "0" };
+}
+
+}  // namespace
+
+TEST_CASE("HTTPClient reuses the connections of a pool", "[pool]") {
+  CivetServer server(keepAliveOptions(2));
+  EchoPathResponder responder;
+  server.addHandler("**", responder);
+  const std::string url = "http://localhost:" + std::to_string(server.getListeningPorts().at(0)) + "/pooled";
+
+  auto pool = std::make_shared<utils::HTTPConnectionPool>(2);
+  for (int i = 0; i < 5; i++) {
+    utils::HTTPClient client(url, nullptr, pool);
+    client.initialize("GET");
+    REQUIRE(client.submit());
+    REQUIRE(200 == client.getResponseCode());
+    const std::vector<char> &response = client.getResponseBody();
+    REQUIRE("/pooled" == std::string(response.begin(), response.end()));
+    long new_connections = -1;
+    curl_easy_getinfo(client.getHandle(), CURLINFO_NUM_CONNECTS, &new_connections);
+    // only the first request connects
+    REQUIRE((i == 0 ? 1 : 0) == new_connections);
+  }
+  REQUIRE(1 == pool->getIdleCount());
+
+  // clients used at the same time take distinct handles, the pool keeps at most two of them
+  {
+    utils::HTTPClient first(url, nullptr, pool);
+    utils::HTTPClient second(url, nullptr, pool);
+    utils::HTTPClient third(url, nullptr, pool);
+    REQUIRE(first.getHandle() != second.getHandle());
+    REQUIRE(second.getHandle() != third.getHandle());
+    REQUIRE(0 == pool->getIdleCount());
+  }
+  REQUIRE(2 == pool->getIdleCount());
+}
+
+TEST_CASE("HTTPMultiClient keeps several requests in flight", "[multi]") {
+  CivetServer server(keepAliveOptions(4));
+  EchoPathResponder responder;
+  server.addHandler("**", responder);
+  const std::string base_url = "http://localhost:" + std::to_string(server.getListeningPorts().at(0)) + "/request";
+
+  auto pool = std::make_shared<utils::HTTPConnectionPool>();
+  utils::HTTPMultiClient multi;
+  std::vector<std::unique_ptr<utils::HTTPClient>> clients;
+  for (int i = 0; i < 20; i++) {
+    clients.emplace_back(new utils::HTTPClient(base_url + std::to_string(i), nullptr, pool));
+    clients.back()->initialize("GET");
+    REQUIRE(multi.add(clients.back().get()));
+  }
+  REQUIRE(20 == multi.getInFlightCount());
+
+  std::set<std::string> responses;
+  for (int i = 0; i < 1000 && multi.getInFlightCount() > 0; i++) {
+    for (const auto &completed : multi.perform(100)) {
+      REQUIRE(completed.second);
+      REQUIRE(200 == completed.first->getResponseCode());
+      const std::vector<char> &response = completed.first->getResponseBody();
+      responses.insert(std::string(response.begin(), response.end()));
+    }
+  }
+  REQUIRE(20 == responses.size());
+  REQUIRE(1 == responses.count("/request0"));
+  REQUIRE(1 == responses.count("/request19"));
+}
+
+TEST_CASE("HTTPClient connection pool benchmark", "[.][benchmark]") {
+  const int requests = 2000;
+  CivetServer server(keepAliveOptions(4));
+  EchoPathResponder responder;
+  server.addHandler("**", responder);
+  const std::string url = "http://localhost:" + std::to_string(server.getListeningPorts().at(0)) + "/benchmark";
+
+  auto requestsPerSecond = [](std::chrono::steady_clock::duration elapsed) {
+    return requests * 1000 / (std::max)(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()), static_cast<int64_t>(1));
+  };
+  auto run = [&url](const std::shared_ptr<utils::HTTPConnectionPool> &pool) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < requests; i++) {
+      utils::HTTPClient client(url, nullptr, pool);
+      client.initialize("GET");
+      REQUIRE(client.submit());
+    }
+    return std::chrono::steady_clock::now() - start;
+  };
+  auto fresh = run(nullptr);
+  auto pooled = run(std::make_shared<utils::HTTPConnectionPool>());
+
+  // the same requests, all in flight at once
+  auto start = std::chrono::steady_clock::now();
+  auto pool = std::make_shared<utils::HTTPConnectionPool>(64);
+  utils::HTTPMultiClient multi;
+  std::vector<std::unique_ptr<utils::HTTPClient>> clients;
+  for (int i = 0; i < requests; i++) {
+    clients.emplace_back(new utils::HTTPClient(url, nullptr, pool));
+    clients.back()->initialize("GET");
+    REQUIRE(multi.add(clients.back().get()));
+  }
+  while (multi.getInFlightCount() > 0) {
+    multi.perform(100);
+  }
+  auto multiplexed = std::chrono::steady_clock::now() - start;
+
+  std::cout << requests << " requests: new handles " << requestsPerSecond(fresh) << " req/s, pooled " << requestsPerSecond(pooled) << " req/s, multi "
+            << requestsPerSecond(multiplexed) << " req/s" << std::endl;
+}
@@ -16,12 +16,16 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <map>
 #include <memory>
 #include <utility>
 #include <string>
 #include <set>
+#include <thread>
 #include "FlowController.h"
 #include "io/BaseStream.h"
 #include "TestBase.h"
@@ -39,6 +43,8 @@
 #include "processors/InvokeHTTP.h"
 #include "processors/ListenHTTP.h"
 #include "processors/LogAttribute.h"
+#include "processors/GenerateFlowFile.h"
+#include "CivetServer.h"
 
 TEST_CASE("HTTPTestsWithNoResourceClaimPOST", "[httptest1]") {
   TestController testController;
@@ -312,3 +318,63 @@ TEST_CASE("HTTPTestsPostNoResourceClaim", "[httptest1]") {
   REQUIRE(true == LogTestController::getInstance().contains("exiting because method is POST"));
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("InvokeHTTP keeps several requests in flight", "[httptest1]") {
+  // answers after a delay, tracking how many requests it is answering at once
+  class SlowResponder : public CivetHandler {
+   public:
+    SlowResponder()
+        : requests(0),
+          active(0),
+          peak(0) {
+    }
+    bool handlePost(CivetServer *server, struct mg_connection *conn) {
+      int now = ++active;
+      int seen = peak;
+      while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+      }
+      char buffer[1024];
+      while (mg_read(conn, buffer, sizeof(buffer)) > 0) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      requests++;
+      active--;
+      mg_printf(conn, "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 2\r\n\r\nok");
+      return true;
+    }
+    std::atomic<int> requests;
+    std::atomic<int> active;
+    std::atomic<int> peak;
+  };
+
+  TestController testController;
+  LogTestController::getInstance().setDebug<org::apache::nifi::minifi::processors::InvokeHTTP>();
+
+  std::vector<std::string> options = { "enable_keep_alive", "yes", "num_threads", "20", "listening_ports", "0" };
+  CivetServer server(options);
+  SlowResponder responder;
+  server.addHandler("**", responder);
+  const std::string url = "http://localhost:" + std::to_string(server.getListeningPorts().at(0)) + "/slow";
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> generate = plan->addProcessor("GenerateFlowFile", "generate");
+  std::shared_ptr<core::Processor> invokehttp = plan->addProcessor("InvokeHTTP", "invokehttp", core::Relationship("success", "description"), true);
+  REQUIRE(plan->setProperty(generate, org::apache::nifi::minifi::processors::GenerateFlowFile::BatchSize.getName(), "20"));
+  REQUIRE(plan->setProperty(generate, org::apache::nifi::minifi::processors::GenerateFlowFile::FileSize.getName(), "16"));
+  REQUIRE(plan->setProperty(invokehttp, org::apache::nifi::minifi::processors::InvokeHTTP::Method.getName(), "POST"));
+  REQUIRE(plan->setProperty(invokehttp, org::apache::nifi::minifi::processors::InvokeHTTP::URL.getName(), url));
+  REQUIRE(plan->setProperty(invokehttp, org::apache::nifi::minifi::processors::InvokeHTTP::MaxInFlight.getName(), "10"));
+
+  plan->runNextProcessor();
+  auto start = std::chrono::steady_clock::now();
+  plan->runNextProcessor();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+  // a single run sends them all, ten at a time, instead of taking 4 seconds one by one
+  REQUIRE(20 == responder.requests);
+  REQUIRE(responder.peak > 1);
+  REQUIRE(responder.peak <= 10);
+  REQUIRE(elapsed < 2000);
+  REQUIRE(LogTestController::getInstance().contains("isSuccess: 1, response code 200"));
+  LogTestController::getInstance().reset();
+}
@@ -78,41 +78,38 @@ public:
 
 public:
   // Nest Callback Class for read stream from flow for compress
-  class ReadCallbackCompress: public InputStreamCallback {
+  class ReadCallbackCompress: public InputBufferCallback {
   public:
     ReadCallbackCompress(std::shared_ptr<core::FlowFile> &flow, struct archive *arch, struct archive_entry *entry) :
-        flow_(flow), arch_(arch), entry_(entry), status_(0), logger_(logging::LoggerFactory<CompressContent>::getLogger()) {
+        flow_(flow), arch_(arch), entry_(entry), status_(0), header_written_(false), logger_(logging::LoggerFactory<CompressContent>::getLogger()) {
     }
     ~ReadCallbackCompress() {
     }
-    int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      uint8_t buffer[4096U];
+    int64_t process(const uint8_t *data, uint64_t size) {
       int64_t ret = 0;
       uint64_t read_size = 0;
 
-      ret = archive_write_header(arch_, entry_);
-      if (ret != ARCHIVE_OK) {
-        logger_->log_error("Compress Content archive error %s", archive_error_string(arch_));
-        status_ = -1;
-        return -1;
+      // the content arrives in one or more pieces, the entry header precedes the first
+      if (!header_written_) {
+        ret = archive_write_header(arch_, entry_);
+        if (ret != ARCHIVE_OK) {
+          logger_->log_error("Compress Content archive error %s", archive_error_string(arch_));
+          status_ = -1;
+          return -1;
+        }
+        header_written_ = true;
       }
-      while (read_size < flow_->getSize()) {
-        ret = stream->read(buffer, sizeof(buffer));
+      while (read_size < size) {
+        ret = archive_write_data(arch_, data + read_size, size - read_size);
         if (ret < 0) {
+          logger_->log_error("Compress Content archive error %s", archive_error_string(arch_));
           status_ = -1;
           return -1;
         }
-        if (ret > 0) {
-          ret = archive_write_data(arch_, buffer, ret);
-          if (ret < 0) {
-            logger_->log_error("Compress Content archive error %s", archive_error_string(arch_));
-            status_ = -1;
-            return -1;
-          }
-          read_size += ret;
-        } else {
+        if (ret == 0) {
           break;
         }
+        read_size += ret;
       }
       return read_size;
     }
@@ -120,6 +117,7 @@ public:
     struct archive *arch_;
     struct archive_entry *entry_;
     int status_;
+    bool header_written_;
     std::shared_ptr<logging::Logger> logger_;
   };
   // Nest Callback Class for read stream from flow for decompress
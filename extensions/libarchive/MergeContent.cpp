@@ -61,6 +61,7 @@ void MergeContent::initialize() {
   properties.insert(MaxEntries);
   properties.insert(MaxBinAge);
   properties.insert(MaxBinCount);
+  properties.insert(BatchSize);
   properties.insert(MergeStrategy);
   properties.insert(MergeFormat);
   properties.insert(CorrelationAttributeName);
@@ -273,8 +274,25 @@ bool MergeContent::processBin(core::ProcessContext *context, core::ProcessSessio
 std::shared_ptr<core::FlowFile> BinaryConcatenationMerge::merge(core::ProcessContext *context, core::ProcessSession *session,
         std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header, std::string &footer, std::string &demarcator) {
   std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast < FlowFileRecord > (session->create());
-  BinaryConcatenationMerge::WriteCallback callback(header, footer, demarcator, flows, session);
-  session->write(flowFile, &callback);
+  // the header, demarcator and footer are written once, followed by each other
+  const std::string delimiterContent = header + demarcator + footer;
+  if (!delimiterContent.empty()) {
+    BinaryConcatenationMerge::WriteCallback callback(delimiterContent);
+    session->write(flowFile, &callback);
+  }
+  std::shared_ptr<ResourceClaim> delimiters = flowFile->getResourceClaim();
+  std::vector<core::ContentRange> ranges;
+  ranges.push_back(core::ContentRange{delimiters, 0, header.size()});
+  bool isFirst = true;
+  for (const auto &flow : flows) {
+    if (!isFirst) {
+      ranges.push_back(core::ContentRange{delimiters, header.size(), demarcator.size()});
+    }
+    ranges.push_back(core::ContentRange{flow->getResourceClaim(), flow->getOffset(), flow->getSize()});
+    isFirst = false;
+  }
+  ranges.push_back(core::ContentRange{delimiters, header.size() + demarcator.size(), footer.size()});
+  session->concatenate(flowFile, ranges);
   session->putAttribute(flowFile, FlowAttributeKey(MIME_TYPE), this->getMergedContentType());
   std::string fileName;
   if (flows.size() == 1) {
@@ -57,7 +57,7 @@ public:
       std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header, std::string &footer, std::string &demarcator) = 0;
 };
 
-// BinaryConcatenationMerge Class
+// BinaryConcatenationMerge Class, the merged content refers to the content of the merged flows instead of copying it
 class BinaryConcatenationMerge : public MergeBin {
 public:
   static const char *mimeType;
@@ -66,71 +66,18 @@ public:
   }
   std::shared_ptr<core::FlowFile> merge(core::ProcessContext *context, core::ProcessSession *session,
           std::deque<std::shared_ptr<core::FlowFile>> &flows, std::string &header, std::string &footer, std::string &demarcator);
-  // Nest Callback Class for read stream
-  class ReadCallback : public InputStreamCallback {
-   public:
-    ReadCallback(uint64_t size, std::shared_ptr<io::BaseStream> stream)
-        : buffer_size_(size), stream_(stream) {
-    }
-    ~ReadCallback() {
-    }
-    int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      uint8_t buffer[4096U];
-      int64_t ret = 0;
-      uint64_t read_size = 0;
-      while (read_size < buffer_size_) {
-        int readRet = stream->read(buffer, sizeof(buffer));
-        if (readRet > 0) {
-          ret += stream_->write(buffer, readRet);
-          read_size += readRet;
-        } else {
-          break;
-        }
-      }
-      return ret;
-    }
-    uint64_t buffer_size_;
-    std::shared_ptr<io::BaseStream> stream_;
-  };
-  // Nest Callback Class for write stream
+  // Nest Callback Class for writing the header, demarcator and footer, which the merged content refers to
   class WriteCallback: public OutputStreamCallback {
   public:
-    WriteCallback(std::string &header, std::string &footer, std::string &demarcator, std::deque<std::shared_ptr<core::FlowFile>> &flows, core::ProcessSession *session) :
-      header_(header), footer_(footer), demarcator_(demarcator), flows_(flows), session_(session) {
+    explicit WriteCallback(const std::string &delimiters) :
+      delimiters_(delimiters) {
     }
-    std::string &header_;
-    std::string &footer_;
-    std::string &demarcator_;
-    std::deque<std::shared_ptr<core::FlowFile>> &flows_;
-    core::ProcessSession *session_;
+    const std::string &delimiters_;
     int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      int64_t ret = 0;
-      if (!header_.empty()) {
-        int64_t len = stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(header_.data())), header_.size());
-        if (len < 0)
-          return len;
-        ret += len;
+      if (delimiters_.empty()) {
+        return 0;
       }
-      bool isFirst = true;
-      for (auto flow : flows_) {
-        if (!isFirst && !demarcator_.empty()) {
-          int64_t len = stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(demarcator_.data())), demarcator_.size());
-          if (len < 0)
-            return len;
-          ret += len;
-        }
-        ReadCallback readCb(flow->getSize(), stream);
-        session_->read(flow, &readCb);
-        ret += flow->getSize();
-        isFirst = false;
-      }
-      if (!footer_.empty()) {
-        int64_t len = stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(footer_.data())), footer_.size());
-        if (len < 0)
-          return len;
-        ret += len;
-      }
-      return ret;
+      return stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(delimiters_.data())), delimiters_.size());
     }
   };
 };
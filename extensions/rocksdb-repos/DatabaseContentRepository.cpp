@@ -66,8 +66,7 @@ std::shared_ptr<io::BaseStream> DatabaseContentRepository::write(const std::shar
   // we can simply return a nullptr, which is also valid from the API when this stream is not valid.
   if (nullptr == claim || !is_valid_ || !db_)
     return nullptr;
-  // append is already supported in all modes
-  return std::make_shared<io::RocksDbStream>(claim->getContentFullPath(), db_, true);
+  return std::make_shared<io::RocksDbStream>(claim->getContentFullPath(), db_, true, append);
 }
 
 std::shared_ptr<io::BaseStream> DatabaseContentRepository::read(const std::shared_ptr<minifi::ResourceClaim> &claim) {
@@ -75,13 +74,22 @@ std::shared_ptr<io::BaseStream> DatabaseContentRepository::read(const std::share
   // we can simply return a nullptr, which is also valid from the API when this stream is not valid.
   if (nullptr == claim || !is_valid_ || !db_)
     return nullptr;
+  if (isComposite(claim))
+    return readComposite(claim);
   return std::make_shared<io::RocksDbStream>(claim->getContentFullPath(), db_, false);
 }
 
 bool DatabaseContentRepository::exists(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
+  if (isComposite(streamId)) {
+    return compositeExists(streamId);
+  }
   std::string value;
   rocksdb::Status status;
-  status = db_->Get(rocksdb::ReadOptions(), streamId->getContentFullPath(), &value);
+  status = db_->Get(rocksdb::ReadOptions(), io::RocksDbStream::getManifestKey(streamId->getContentFullPath()), &value);
+  if (!status.ok()) {
+    // content written by earlier versions
+    status = db_->Get(rocksdb::ReadOptions(), streamId->getContentFullPath(), &value);
+  }
   if (status.ok()) {
     logger_->log_debug("%s exists", streamId->getContentFullPath());
     return true;
@@ -94,8 +102,19 @@ bool DatabaseContentRepository::exists(const std::shared_ptr<minifi::ResourceCla
 bool DatabaseContentRepository::remove(const std::shared_ptr<minifi::ResourceClaim> &claim) {
   if (nullptr == claim || !is_valid_ || !db_)
     return false;
+  if (isComposite(claim))
+    return removeComposite(claim);
+  const std::string path = claim->getContentFullPath();
+  rocksdb::WriteBatch batch;
+  // the manifest and the chunks of every generation share the prefix, including chunks of writes that never completed
+  const std::string prefix = io::RocksDbStream::getManifestKey(path);
+  std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+  for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next()) {
+    batch.Delete(it->key());
+  }
+  batch.Delete(path);
   rocksdb::Status status;
-  status = db_->Delete(rocksdb::WriteOptions(), claim->getContentFullPath());
+  status = db_->Write(rocksdb::WriteOptions(), &batch);
   if (status.ok()) {
     logger_->log_debug("Deleted %s", claim->getContentFullPath());
     return true;
@@ -38,7 +38,6 @@ namespace core {
 namespace repository {
 
 void FlowFileRepository::flush() {
-  rocksdb::WriteBatch batch;
   rocksdb::ReadOptions options;
 
   std::vector<std::shared_ptr<FlowFileRecord>> purgeList;
@@ -57,6 +56,7 @@ void FlowFileRepository::flush() {
 
   auto multistatus = db_->MultiGet(options, keys, &values);
 
+  std::vector<rocksdb::Slice> deleted_keys;
   for(size_t i=0; i<keys.size() && i<values.size() && i<multistatus.size(); ++i) {
     if(!multistatus[i].ok()) {
       logger_->log_error("Failed to read key from rocksdb: %s! DB is most probably in an inconsistent state!", keys[i].data());
@@ -69,10 +69,19 @@ void FlowFileRepository::flush() {
       purgeList.push_back(eventRead);
     }
     logger_->log_debug("Issuing batch delete, including %s, Content path %s", eventRead->getUUIDStr(), eventRead->getContentFullPath());
-    batch.Delete(keys[i]);
+    deleted_keys.push_back(keys[i]);
   }
 
-  auto operation = [this, &batch]() { return db_->Write(rocksdb::WriteOptions(), &batch); };
+  GroupCommitWriter::Operation remove = [&deleted_keys](rocksdb::WriteBatch &batch) {
+    for (const auto &key : deleted_keys) {
+      auto status = batch.Delete(key);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return rocksdb::Status::OK();
+  };
+  auto operation = [this, &remove]() { return group_commit_->write(remove); };
 
   if (!ExecuteWithRetry(operation)) {
     for (const auto& key: keystrings) {
@@ -126,7 +135,6 @@ void FlowFileRepository::prune_stored_flowfiles() {
   utils::ScopeGuard db_guard([&stored_database_]() {
     delete stored_database_;
   });
-  bool corrupt_checkpoint = false;
   if (nullptr != checkpoint_) {
     rocksdb::Options options;
     options.create_if_missing = true;
@@ -142,33 +150,90 @@ void FlowFileRepository::prune_stored_flowfiles() {
     return;
   }
 
-  rocksdb::Iterator* it = stored_database_->NewIterator(rocksdb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    std::shared_ptr<FlowFileRecord> eventRead = std::make_shared<FlowFileRecord>(shared_from_this(), content_repo_);
+  recovering_ = true;
+  recovered_count_ = 0;
+  discarded_count_ = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto ranges = splitKeySpace(recovery_threads_);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < ranges.size(); i++) {
+    threads.emplace_back(&FlowFileRepository::recoverRange, this, stored_database_, ranges[i].first, ranges[i].second);
+  }
+  recoverRange(stored_database_, ranges[0].first, ranges[0].second);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  recovery_duration_millis_ = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  recovering_ = false;
+  logger_->log_info("Recovered %llu flow files, discarded %llu in %llu ms using %u threads", recovered_count_.load(), discarded_count_.load(), recovery_duration_millis_.load(), static_cast<unsigned>(ranges.size()));
+}
+
+std::vector<std::pair<std::string, std::string>> FlowFileRepository::splitKeySpace(unsigned count) {
+  // keys are UUIDs, whose first hex digit is evenly distributed
+  static const char digits[] = "0123456789abcdef";
+  const unsigned ranges = (std::max)(1u, (std::min)(count, 16u));
+  std::vector<std::pair<std::string, std::string>> split;
+  std::string first;
+  for (unsigned i = 1; i < ranges; i++) {
+    std::string next(1, digits[i * 16 / ranges]);
+    split.emplace_back(first, next);
+    first = next;
+  }
+  split.emplace_back(first, "");
+  return split;
+}
+
+void FlowFileRepository::recoverRange(rocksdb::DB *database, const std::string &first, const std::string &last) {
+  std::map<std::shared_ptr<core::Connectable>, std::vector<std::shared_ptr<core::FlowFile>>> batches;
+  auto putBatch = [](const std::shared_ptr<core::Connectable> &connectable, std::vector<std::shared_ptr<core::FlowFile>> &flows) {
+    std::static_pointer_cast<minifi::Connection>(connectable)->multiPut(flows);
+    flows.clear();
+  };
+
+  std::unique_ptr<rocksdb::Iterator> it(database->NewIterator(rocksdb::ReadOptions()));
+  for (first.empty() ? it->SeekToFirst() : it->Seek(first); it->Valid(); it->Next()) {
     std::string key = it->key().ToString();
+    if (!last.empty() && key >= last) {
+      break;
+    }
+    if (ContentPathDictionary::isDictionaryKey(key)) {
+      continue;
+    }
+    std::shared_ptr<FlowFileRecord> eventRead = std::make_shared<FlowFileRecord>(shared_from_this(), content_repo_);
     if (eventRead->DeSerialize(reinterpret_cast<const uint8_t *>(it->value().data()), it->value().size())) {
       logger_->log_debug("Found connection for %s, path %s ", eventRead->getConnectionUuid(), eventRead->getContentFullPath());
       auto search = connectionMap.find(eventRead->getConnectionUuid());
-      if (!corrupt_checkpoint && search != connectionMap.end()) {
+      if (search != connectionMap.end()) {
         // we find the connection for the persistent flowfile, create the flowfile and enqueue that
-        std::shared_ptr<core::FlowFile> flow_file_ref = std::static_pointer_cast<core::FlowFile>(eventRead);
         eventRead->setStoredToRepository(true);
-        search->second->put(eventRead);
-      } else {
-        logger_->log_warn("Could not find connection for %s, path %s ", eventRead->getConnectionUuid(), eventRead->getContentFullPath());
-        if (eventRead->getContentFullPath().length() > 0) {
-          if (nullptr != eventRead->getResourceClaim()) {
-            content_repo_->remove(eventRead->getResourceClaim());
-          }
+        // the restored Flow File owns its claim like any other, which keeps content shared with other Flow Files
+        // and the content that composite claims refer to
+        if (!eventRead->getContentFullPath().empty()) {
+          eventRead->getResourceClaim()->increaseFlowFileRecordOwnedCount();
+        }
+        auto &batch = batches[search->second];
+        batch.push_back(eventRead);
+        if (batch.size() >= FLOWFILE_REPOSITORY_RECOVERY_BATCH_SIZE) {
+          putBatch(search->second, batch);
+        }
+        recovered_count_++;
+        continue;
+      }
+      logger_->log_warn("Could not find connection for %s, path %s ", eventRead->getConnectionUuid(), eventRead->getContentFullPath());
+      if (eventRead->getContentFullPath().length() > 0) {
+        if (nullptr != eventRead->getResourceClaim()) {
+          content_repo_->remove(eventRead->getResourceClaim());
         }
-        keys_to_delete.enqueue(key);
       }
-    } else {
-      keys_to_delete.enqueue(key);
+    }
+    keys_to_delete.enqueue(key);
+    discarded_count_++;
+  }
+  for (auto &batch : batches) {
+    if (!batch.second.empty()) {
+      putBatch(batch.first, batch.second);
     }
   }
-
-  delete it;
 }
 
 bool FlowFileRepository::ExecuteWithRetry(std::function<rocksdb::Status()> operation) {
@@ -18,6 +18,11 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_FLOWFILEREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_CORE_REPOSITORY_FLOWFILEREPOSITORY_H_
 
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "utils/file/FileUtils.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
@@ -28,6 +33,7 @@
 #include "Connection.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "concurrentqueue.h"
+#include "GroupCommitWriter.h"
 
 namespace org {
 namespace apache {
@@ -47,6 +53,9 @@ namespace repository {
 #define MAX_FLOWFILE_REPOSITORY_ENTRY_LIFE_TIME (600000) // 10 minute
 #define FLOWFILE_REPOSITORY_PURGE_PERIOD (2000) // 2000 msec
 #define FLOWFILE_REPOSITORY_RETRY_INTERVAL_INCREMENTS (500)  // msec
+#define FLOWFILE_REPOSITORY_COMMIT_WINDOW (0)  // msec
+#define FLOWFILE_REPOSITORY_RECOVERY_BATCH_SIZE (1000)  // flow files put into a connection at once during recovery
+#define FLOWFILE_REPOSITORY_MAX_RECOVERY_THREADS (16)
 
 /**
  * Flow File repository
@@ -66,12 +75,14 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
         Repository(repo_name.length() > 0 ? repo_name : core::getClassName<FlowFileRepository>(), directory, maxPartitionMillis, maxPartitionBytes, purgePeriod),
         content_repo_(nullptr),
         checkpoint_(nullptr),
+        recovery_threads_((std::max)(1u, (std::min)(std::thread::hardware_concurrency(), static_cast<unsigned>(FLOWFILE_REPOSITORY_MAX_RECOVERY_THREADS)))),
         logger_(logging::LoggerFactory<FlowFileRepository>::getLogger()) {
     db_ = NULL;
   }
 
   // Destructor
   ~FlowFileRepository() {
+    group_commit_.reset();
     if (db_)
       delete db_;
   }
@@ -80,6 +91,10 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
     return false;
   }
 
+  virtual bool isPersistent() {
+    return true;
+  }
+
   virtual void flush();
 
   virtual void printStats();
@@ -102,6 +117,23 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
       }
     }
     logger_->log_debug("NiFi FlowFile Max Storage Time: [%d] ms", max_partition_millis_);
+    int64_t commit_window = FLOWFILE_REPOSITORY_COMMIT_WINDOW;
+    if (configure->get(Configure::nifi_flowfile_repository_commit_window, value)) {
+      TimeUnit unit;
+      if (!Property::StringToTime(value, commit_window, unit) || !Property::ConvertTimeUnitToMS(commit_window, unit, commit_window)) {
+        commit_window = FLOWFILE_REPOSITORY_COMMIT_WINDOW;
+      }
+    }
+    bool sync_writes = false;
+    if (configure->get(Configure::nifi_flowfile_repository_sync_writes, value)) {
+      utils::StringUtils::StringToBool(value, sync_writes);
+    }
+    logger_->log_debug("NiFi FlowFile Repository commit window: [%d] ms, sync writes: %s", commit_window, sync_writes ? "true" : "false");
+    int recovery_threads = 0;
+    if (configure->get(Configure::nifi_flowfile_repository_recovery_threads, value) && core::Property::StringToInt(value, recovery_threads) && recovery_threads > 0) {
+      recovery_threads_ = (std::min)(static_cast<unsigned>(recovery_threads), static_cast<unsigned>(FLOWFILE_REPOSITORY_MAX_RECOVERY_THREADS));
+    }
+    logger_->log_debug("NiFi FlowFile Repository recovery threads: %u", recovery_threads_);
     rocksdb::Options options;
     options.create_if_missing = true;
     options.use_direct_io_for_flush_and_compaction = true;
@@ -119,6 +151,7 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
     rocksdb::Status status = rocksdb::DB::Open(options, directory_, &db_);
     if (status.ok()) {
       logger_->log_debug("NiFi FlowFile Repository database open %s success", directory_);
+      group_commit_ = std::unique_ptr<GroupCommitWriter>(new GroupCommitWriter(db_, std::chrono::milliseconds(commit_window), sync_writes));
     } else {
       logger_->log_error("NiFi FlowFile Repository database open %s fail", directory_);
     }
@@ -130,21 +163,23 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
   virtual bool Put(std::string key, const uint8_t *buf, size_t bufLen) {
     // persistent to the DB
     rocksdb::Slice value((const char *) buf, bufLen);
-    auto operation = [this, &key, &value]() { return db_->Put(rocksdb::WriteOptions(), key, value); };
-    return ExecuteWithRetry(operation);
+    GroupCommitWriter::Operation put = [&key, &value](rocksdb::WriteBatch &batch) { return batch.Put(key, value); };
+    return ExecuteWithRetry([this, &put]() { return group_commit_->write(put); });
   }
 
   virtual bool MultiPut(const std::vector<std::pair<std::string, std::unique_ptr<minifi::io::DataStream>>>& data) {
-    rocksdb::WriteBatch batch;
-    for (const auto &item: data) {
-      rocksdb::Slice value((const char *) item.second->getBuffer(), item.second->getSize());
-      if (!batch.Put(item.first, value).ok()) {
-        logger_->log_error("Failed to add item to batch operation");
-        return false;
+    GroupCommitWriter::Operation put = [this, &data](rocksdb::WriteBatch &batch) {
+      for (const auto &item : data) {
+        rocksdb::Slice value((const char *) item.second->getBuffer(), item.second->getSize());
+        auto status = batch.Put(item.first, value);
+        if (!status.ok()) {
+          logger_->log_error("Failed to add item to batch operation");
+          return status;
+        }
       }
-    }
-    auto operation = [this, &batch]() { return db_->Write(rocksdb::WriteOptions(), &batch); };
-    return ExecuteWithRetry(operation);
+      return rocksdb::Status::OK();
+    };
+    return ExecuteWithRetry([this, &put]() { return group_commit_->write(put); });
   }
 
 
@@ -201,10 +236,25 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
    */
   void prune_stored_flowfiles();
 
+  /**
+   * Splits the key space into at most count ranges of flow file UUIDs, each given by its first key
+   * (inclusive) and the first key of the next range, empty strings meaning unbounded.
+   */
+  static std::vector<std::pair<std::string, std::string>> splitKeySpace(unsigned count);
+
+  /**
+   * Recovers the flow files stored in the given key range of database into their connections.
+   */
+  void recoverRange(rocksdb::DB *database, const std::string &first, const std::string &last);
+
   moodycamel::ConcurrentQueue<std::string> keys_to_delete;
   std::shared_ptr<core::ContentRepository> content_repo_;
   rocksdb::DB* db_;
+  // coalesces the writes of concurrent sessions
+  std::unique_ptr<GroupCommitWriter> group_commit_;
   std::unique_ptr<rocksdb::Checkpoint> checkpoint_;
+  // number of threads recovering flow files on startup
+  unsigned recovery_threads_;
   std::shared_ptr<logging::Logger> logger_;
 };
 
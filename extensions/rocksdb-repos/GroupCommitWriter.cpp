@@ -0,0 +1,99 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GroupCommitWriter.h"
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+GroupCommitWriter::GroupCommitWriter(rocksdb::DB *db, std::chrono::milliseconds commit_window, bool sync)
+    : db_(db),
+      commit_window_(commit_window),
+      leader_active_(false),
+      commit_count_(0),
+      group_count_(0) {
+  write_options_.sync = sync;
+}
+
+rocksdb::Status GroupCommitWriter::write(const Operation &operation) {
+  Writer self(operation);
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_.push_back(&self);
+  group_done_.wait(lock, [this, &self] { return self.done || !leader_active_; });
+  if (self.done) {
+    // written by the leader of its group
+    return self.status;
+  }
+
+  leader_active_ = true;
+  if (commit_window_.count() > 0) {
+    // let the others join, mutex_ is released while waiting
+    group_done_.wait_for(lock, commit_window_);
+  }
+  std::vector<Writer*> group;
+  group.swap(pending_);
+  lock.unlock();
+
+  writeGroup(group);
+
+  lock.lock();
+  for (auto writer : group) {
+    writer->done = true;
+  }
+  leader_active_ = false;
+  lock.unlock();
+  group_done_.notify_all();
+  return self.status;
+}
+
+void GroupCommitWriter::writeGroup(const std::vector<Writer*> &group) {
+  rocksdb::WriteBatch batch;
+  std::vector<Writer*> included;
+  included.reserve(group.size());
+  for (auto writer : group) {
+    batch.SetSavePoint();
+    writer->status = writer->operation(batch);
+    if (writer->status.ok()) {
+      included.push_back(writer);
+    } else {
+      batch.RollbackToSavePoint();
+    }
+  }
+  if (included.empty()) {
+    return;
+  }
+
+  rocksdb::Status status = db_->Write(write_options_, &batch);
+  for (auto writer : included) {
+    writer->status = status;
+  }
+  group_count_++;
+  commit_count_ += included.size();
+}
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
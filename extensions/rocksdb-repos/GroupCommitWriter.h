@@ -0,0 +1,109 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_ROCKSDB_REPOS_GROUPCOMMITWRITER_H_
+#define EXTENSIONS_ROCKSDB_REPOS_GROUPCOMMITWRITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/write_batch.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+/**
+ * Coalesces the writes of concurrent threads into a single RocksDB write.
+ *
+ * The first writer to arrive leads a group: it waits up to the commit window for other writers to
+ * join, then writes the operations of the whole group with one DB::Write, so the group costs a single
+ * WAL append (and a single sync when sync is enabled). Writers arriving while a group is written form
+ * the next group. Every writer returns only after the write of its own group finished, with the status
+ * of that write, so a successful return still means that its operations are in the WAL.
+ */
+class GroupCommitWriter {
+ public:
+  /**
+   * Adds the operations of a writer to the batch of its group. The batch is rolled back to its
+   * previous state if the operation fails.
+   */
+  using Operation = std::function<rocksdb::Status(rocksdb::WriteBatch&)>;
+
+  GroupCommitWriter(rocksdb::DB *db, std::chrono::milliseconds commit_window, bool sync);
+
+  GroupCommitWriter(const GroupCommitWriter &other) = delete;
+  GroupCommitWriter &operator=(const GroupCommitWriter &other) = delete;
+
+  /**
+   * Executes operation as part of the next group write, blocks until it is written.
+   */
+  rocksdb::Status write(const Operation &operation);
+
+  // number of writes committed
+  uint64_t getCommitCount() const {
+    return commit_count_;
+  }
+
+  // number of DB writes issued for them
+  uint64_t getGroupCount() const {
+    return group_count_;
+  }
+
+ private:
+  struct Writer {
+    explicit Writer(const Operation &operation)
+        : operation(operation),
+          done(false) {
+    }
+    const Operation &operation;
+    rocksdb::Status status;
+    bool done;
+  };
+
+  // writes the group, called by its leader without holding mutex_
+  void writeGroup(const std::vector<Writer*> &group);
+
+  rocksdb::DB *db_;
+  const std::chrono::milliseconds commit_window_;
+  rocksdb::WriteOptions write_options_;
+
+  std::mutex mutex_;
+  std::condition_variable group_done_;
+  std::vector<Writer*> pending_;
+  bool leader_active_;
+
+  std::atomic<uint64_t> commit_count_;
+  std::atomic<uint64_t> group_count_;
+};
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_ROCKSDB_REPOS_GROUPCOMMITWRITER_H_ */
@@ -17,6 +17,8 @@
  */
 
 #include "RocksDbStream.h"
+#include <algorithm>
+#include <cinttypes>
 #include <fstream>
 #include <utility>
 #include <vector>
@@ -30,22 +32,175 @@ namespace nifi {
 namespace minifi {
 namespace io {
 
-RocksDbStream::RocksDbStream(std::string path, rocksdb::DB *db, bool write_enable)
+RocksDbStream::RocksDbStream(std::string path, rocksdb::DB *db, bool write_enable, bool append)
     : BaseStream(),
       path_(std::move(path)),
       write_enable_(write_enable),
+      exists_(false),
+      offset_(0),
+      legacy_(false),
       db_(db),
+      size_(0),
+      chunk_size_(ROCKSDB_STREAM_CHUNK_SIZE),
+      generation_(0),
+      chunk_index_(-1),
+      previous_chunks_(0),
+      previous_generation_(0),
+      snapshot_(write_enable ? nullptr : db->GetSnapshot()),
+      closed_(false),
+      failed_(false),
       logger_(logging::LoggerFactory<RocksDbStream>::getLogger()) {
-  exists_ = db_->Get(rocksdb::ReadOptions(), path_, &value_).ok();
-  offset_ = 0;
-  size_ = value_.size();
+  std::string manifest;
+  if (db_->Get(getReadOptions(), getManifestKey(path_), &manifest).ok()) {
+    uint64_t size;
+    uint32_t chunk_size;
+    uint32_t generation;
+    if (decodeManifest(manifest, size, chunk_size, generation)) {
+      exists_ = true;
+      size_ = size;
+      chunk_size_ = chunk_size;
+      previous_generation_ = generation_ = generation;
+      previous_chunks_ = getChunkCount(size_, chunk_size_);
+    } else {
+      logger_->log_error("Invalid content manifest of %s", path_);
+    }
+  } else {
+    legacy_ = exists_ = db_->Get(getReadOptions(), path_, &value_).ok();
+    size_ = value_.size();
+  }
+  if (!write_enable_) {
+    return;
+  }
+  if (!append) {
+    size_ = 0;
+    chunk_size_ = ROCKSDB_STREAM_CHUNK_SIZE;
+    if (previous_chunks_ > 0) {
+      // the replaced chunks stay intact until the new manifest is written
+      generation_ = previous_generation_ + 1;
+    }
+  } else if (legacy_) {
+    // rewritten in chunks, the legacy value is deleted when the stream is closed
+    size_ = 0;
+    for (size_t offset = 0; offset < value_.size() && !failed_; offset += chunk_size_) {
+      chunk_.assign(value_, offset, chunk_size_);
+      size_ += chunk_.size();
+      chunk_index_ = static_cast<int64_t>(offset / chunk_size_);
+      if (chunk_.size() == chunk_size_) {
+        failed_ = !flushChunk();
+      }
+    }
+  } else if (size_ % chunk_size_ != 0) {
+    // the last chunk is rewritten with the appended content, which readers of the current size do not see.
+    // It may hold content of an append that was never committed, which is dropped
+    chunk_index_ = size_ / chunk_size_;
+    failed_ = !db_->Get(rocksdb::ReadOptions(), getChunkKey(path_, generation_, static_cast<uint32_t>(chunk_index_)), &chunk_).ok() || chunk_.size() < size_ % chunk_size_;
+    chunk_.resize(size_ % chunk_size_);
+  }
+  if (chunk_index_ < 0 || chunk_.size() == chunk_size_) {
+    chunk_index_ = getChunkCount(size_, chunk_size_);
+    chunk_.clear();
+  }
+  std::string().swap(value_);
+}
+
+rocksdb::ReadOptions RocksDbStream::getReadOptions() const {
+  rocksdb::ReadOptions options;
+  options.snapshot = snapshot_;
+  return options;
+}
+
+std::string RocksDbStream::encodeManifest(uint64_t size, uint32_t chunk_size, uint32_t generation) {
+  std::string manifest;
+  for (int i = 0; i < 8; i++) {
+    manifest.push_back(static_cast<char>(size >> (8 * i)));
+  }
+  for (int i = 0; i < 4; i++) {
+    manifest.push_back(static_cast<char>(chunk_size >> (8 * i)));
+  }
+  for (int i = 0; i < 4; i++) {
+    manifest.push_back(static_cast<char>(generation >> (8 * i)));
+  }
+  return manifest;
+}
+
+bool RocksDbStream::decodeManifest(const std::string &manifest, uint64_t &size, uint32_t &chunk_size, uint32_t &generation) {
+  if (manifest.size() != 16) {
+    return false;
+  }
+  const auto *data = reinterpret_cast<const uint8_t*>(manifest.data());
+  size = 0;
+  for (int i = 0; i < 8; i++) {
+    size |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  chunk_size = 0;
+  for (int i = 0; i < 4; i++) {
+    chunk_size |= static_cast<uint32_t>(data[8 + i]) << (8 * i);
+  }
+  generation = 0;
+  for (int i = 0; i < 4; i++) {
+    generation |= static_cast<uint32_t>(data[12 + i]) << (8 * i);
+  }
+  return chunk_size > 0;
 }
 
 void RocksDbStream::closeStream() {
+  if (!write_enable_ || closed_) {
+    return;
+  }
+  closed_ = true;
+  if (failed_) {
+    logger_->log_error("Content of %s could not be written", path_);
+    return;
+  }
+  if (!chunk_.empty()) {
+    batch_.Put(getChunkKey(path_, generation_, static_cast<uint32_t>(chunk_index_)), chunk_);
+    chunk_index_++;
+  }
+  // the chunks of a replaced generation are removed with the switch to the new manifest
+  const uint32_t chunks = generation_ == previous_generation_ ? getChunkCount(size_, chunk_size_) : 0;
+  for (uint32_t index = chunks; index < previous_chunks_; index++) {
+    batch_.Delete(getChunkKey(path_, previous_generation_, index));
+  }
+  if (legacy_) {
+    batch_.Delete(path_);
+  }
+  if (size_ > 0) {
+    batch_.Put(getManifestKey(path_), encodeManifest(size_, chunk_size_, generation_));
+  } else if (exists_) {
+    // empty content is not stored
+    batch_.Delete(getManifestKey(path_));
+  }
+  if (batch_.Count() == 0) {
+    return;
+  }
+  // syncing the log also persists the chunks written ahead without sync
+  rocksdb::WriteOptions opts;
+  opts.sync = true;
+  if (!db_->Write(opts, &batch_).ok()) {
+    logger_->log_error("Content of %s could not be written", path_);
+  }
+  batch_.Clear();
+  std::string().swap(chunk_);
 }
 
 void RocksDbStream::seek(uint64_t offset) {
-  // noop
+  // written content is only ever appended
+  if (!write_enable_) {
+    offset_ = (std::min)(offset, size_);
+  }
+}
+
+bool RocksDbStream::flushChunk() {
+  batch_.Put(getChunkKey(path_, generation_, static_cast<uint32_t>(chunk_index_)), chunk_);
+  chunk_index_++;
+  chunk_.clear();
+  if (batch_.GetDataSize() < ROCKSDB_STREAM_MAX_BATCH_SIZE) {
+    return true;
+  }
+  // none of the chunks is referenced by the current manifest, or only beyond the size it holds
+  const bool written = db_->Write(rocksdb::WriteOptions(), &batch_).ok();
+  batch_.Clear();
+  return written;
 }
 
 int RocksDbStream::writeData(std::vector<uint8_t> &buf, int buflen) {
@@ -62,21 +217,32 @@ int RocksDbStream::writeData(std::vector<uint8_t> &buf, int buflen) {
 // data stream overrides
 
 int RocksDbStream::writeData(uint8_t *value, int size) {
-  if (!IsNullOrEmpty(value) && write_enable_) {
-    rocksdb::Slice slice_value((const char *) value, size);
-    rocksdb::Status status;
-    size_ += size;
-    rocksdb::WriteOptions opts;
-    opts.sync = true;
-    db_->Merge(opts, path_, slice_value);
-    if (status.ok()) {
-      return 0;
-    } else {
-      return -1;
-    }
-  } else {
+  if (size < 0 || (IsNullOrEmpty(value) && size > 0)) {
     return -1;
   }
+  IoVec buffer{value, static_cast<uint64_t>(size)};
+  return static_cast<int>(writev(&buffer, 1));
+}
+
+int64_t RocksDbStream::writev(const IoVec *buffers, size_t count) {
+  if (!write_enable_ || closed_ || failed_) {
+    return -1;
+  }
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    for (uint64_t written = 0; written < buffers[i].length;) {
+      const uint64_t amount = (std::min)(buffers[i].length - written, static_cast<uint64_t>(chunk_size_ - chunk_.size()));
+      chunk_.append(reinterpret_cast<const char*>(buffers[i].data) + written, amount);
+      written += amount;
+      if (chunk_.size() == chunk_size_ && !flushChunk()) {
+        failed_ = true;
+        return -1;
+      }
+    }
+    total += buffers[i].length;
+  }
+  size_ += total;
+  return total;
 }
 
 template<typename T>
@@ -104,20 +270,50 @@ int RocksDbStream::readData(std::vector<uint8_t> &buf, int buflen) {
 }
 
 int RocksDbStream::readData(uint8_t *buf, int buflen) {
-  if (!IsNullOrEmpty(buf) && exists_) {
-    int amtToRead = buflen;
-    if (offset_ >= value_.size()) {
-      return 0;
+  if (IsNullOrEmpty(buf) || buflen < 0) {
+    return -1;
+  }
+  IoVec buffer{buf, static_cast<uint64_t>(buflen)};
+  return static_cast<int>(readv(&buffer, 1));
+}
+
+int64_t RocksDbStream::readv(const IoVec *buffers, size_t count) {
+  if (!exists_ || write_enable_) {
+    return -1;
+  }
+  int64_t total = 0;
+  for (size_t i = 0; i < count && offset_ < size_; i++) {
+    const uint64_t amtToRead = (std::min)(buffers[i].length, size_ - offset_);
+    if (legacy_) {
+      std::memcpy(buffers[i].data, value_.data() + offset_, amtToRead);
+      offset_ += amtToRead;
+      total += amtToRead;
+      continue;
     }
-    if (buflen > value_.size() - offset_) {
-      amtToRead = value_.size() - offset_;
+    uint64_t copied = 0;
+    while (copied < amtToRead) {
+      const int64_t index = static_cast<int64_t>(offset_ / chunk_size_);
+      if (index != chunk_index_) {
+        chunk_index_ = -1;
+        if (!db_->Get(getReadOptions(), getChunkKey(path_, generation_, static_cast<uint32_t>(index)), &chunk_).ok()) {
+          logger_->log_error("Chunk %" PRId64 " of %s is missing", index, path_);
+          return -1;
+        }
+        chunk_index_ = index;
+      }
+      const size_t chunk_offset = offset_ % chunk_size_;
+      if (chunk_offset >= chunk_.size()) {
+        logger_->log_error("Chunk %" PRId64 " of %s is truncated", index, path_);
+        return -1;
+      }
+      const uint64_t amount = (std::min)(amtToRead - copied, static_cast<uint64_t>(chunk_.size() - chunk_offset));
+      std::memcpy(buffers[i].data + copied, chunk_.data() + chunk_offset, amount);
+      copied += amount;
+      offset_ += amount;
     }
-    std::memcpy(buf, value_.data() + offset_, amtToRead);
-    offset_ += amtToRead;
-    return amtToRead;
-  } else {
-    return -1;
+    total += copied;
   }
+  return total;
 }
 
 } /* namespace io */
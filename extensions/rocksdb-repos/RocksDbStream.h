@@ -19,6 +19,7 @@
 #define LIBMINIFI_INCLUDE_IO_TLS_RocksDbStream_H_
 
 #include "rocksdb/db.h"
+#include "rocksdb/write_batch.h"
 #include <iostream>
 #include <cstdint>
 #include <string>
@@ -33,23 +34,68 @@ namespace nifi {
 namespace minifi {
 namespace io {
 
+// size of the chunks content is stored in
+#define ROCKSDB_STREAM_CHUNK_SIZE (64 * 1024)
+// written chunks are written ahead of the manifest once they exceed this size, to bound the memory of a stream
+#define ROCKSDB_STREAM_MAX_BATCH_SIZE (4 * 1024 * 1024)
+
 /**
  * Purpose: File Stream Base stream extension. This is intended to be a thread safe access to
  * read/write to the local file system.
  *
  * Design: Simply extends BaseStream and overrides readData/writeData to allow a sink to the
  * fstream object.
+ *
+ * Content is stored in chunks of ROCKSDB_STREAM_CHUNK_SIZE under getChunkKey, described by a manifest
+ * under getManifestKey holding the size of the content and the generation of its chunks, so that reads
+ * only fetch the chunks they need and seeking does not read anything. Written chunks are buffered and
+ * committed with the manifest in a single synced batch when the stream is closed; content is only visible
+ * once its manifest is written. Chunks written ahead of the manifest to bound the batch go to keys no
+ * manifest refers to yet: replacing content writes a new generation, and appending only adds chunks past
+ * the end or extends the last one, so readers of the current manifest never see them. Read streams read
+ * from a snapshot, so content replaced or removed while they are open stays consistent.
+ * Content written by earlier versions as a single value under the path is still read, and rewritten in
+ * chunks when it is appended to.
  */
 class RocksDbStream : public io::BaseStream {
  public:
   /**
    * File Stream constructor that accepts an fstream shared pointer.
    * It must already be initialized for read and write.
+   * @param append whether a write stream continues the existing content or replaces it
    */
-  explicit RocksDbStream(std::string path, rocksdb::DB *db, bool write_enable = false);
+  explicit RocksDbStream(std::string path, rocksdb::DB *db, bool write_enable = false, bool append = false);
+
+  static std::string getManifestKey(const std::string &path) {
+    // keys of the manifest and the chunks of a path are adjacent, and do not collide with the legacy key
+    return path + '\0';
+  }
+
+  static std::string getChunkKey(const std::string &path, uint32_t generation, uint32_t index) {
+    std::string key = getManifestKey(path);
+    // big endian, so that the chunks of a generation are adjacent and ordered
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      key.push_back(static_cast<char>(generation >> shift));
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      key.push_back(static_cast<char>(index >> shift));
+    }
+    return key;
+  }
+
+  static std::string encodeManifest(uint64_t size, uint32_t chunk_size, uint32_t generation);
+
+  static bool decodeManifest(const std::string &manifest, uint64_t &size, uint32_t &chunk_size, uint32_t &generation);
+
+  static uint32_t getChunkCount(uint64_t size, uint32_t chunk_size) {
+    return static_cast<uint32_t>((size + chunk_size - 1) / chunk_size);
+  }
 
   ~RocksDbStream() override {
     closeStream();
+    if (snapshot_ != nullptr) {
+      db_->ReleaseSnapshot(snapshot_);
+    }
   }
 
   void closeStream() override;
@@ -131,6 +177,10 @@ class RocksDbStream : public io::BaseStream {
    */
   int writeData(uint8_t *value, int size) override;
 
+  int64_t readv(const IoVec *buffers, size_t count) override;
+
+  int64_t writev(const IoVec *buffers, size_t count) override;
+
   /**
    * Returns the underlying buffer
    * @return vector's array
@@ -150,19 +200,53 @@ class RocksDbStream : public io::BaseStream {
   template<typename T>
   std::vector<uint8_t> readBuffer(const T&);
 
+  // reads from the snapshot of a read stream
+  rocksdb::ReadOptions getReadOptions() const;
+
+  // moves the full write buffer into the batch, writing the batch ahead if it is too large
+  bool flushChunk();
+
   std::string path_;
 
   bool write_enable_;
 
   bool exists_;
 
-  int64_t offset_;
+  uint64_t offset_;
+
+  // content stored as a single value by earlier versions
+  bool legacy_;
 
   std::string value_;
 
   rocksdb::DB *db_;
 
-  size_t size_;
+  uint64_t size_;
+
+  uint32_t chunk_size_;
+
+  // generation of the chunks read or written
+  uint32_t generation_;
+
+  // chunk being read, or the partial chunk being written
+  std::string chunk_;
+
+  // index of chunk_, -1 if none is loaded yet
+  int64_t chunk_index_;
+
+  // chunks of the content this stream replaces or appends to, and their generation
+  uint32_t previous_chunks_;
+
+  uint32_t previous_generation_;
+
+  // view of the database read streams read from
+  const rocksdb::Snapshot *snapshot_;
+
+  rocksdb::WriteBatch batch_;
+
+  bool closed_;
+
+  bool failed_;
 
  private:
 
@@ -61,7 +61,7 @@ std::string LuaBaseStream::read(size_t len) {
   return std::move(buffer);
 }
 
-size_t LuaBaseStream::write(std::string buf) {
+size_t LuaBaseStream::write(sol::string_view buf) {
   return static_cast<size_t>(stream_->writeData(reinterpret_cast<uint8_t *>(const_cast<char *>(buf.data())),
                                                 static_cast<int>(buf.length())));
 }
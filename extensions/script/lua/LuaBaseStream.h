@@ -39,11 +39,12 @@ class LuaBaseStream {
   std::string read(size_t len = 0);
 
   /**
-   * Write data (receives string, to follow Lua idioms)
+   * Write data (receives string, to follow Lua idioms). The string is written from
+   * the Lua state as it is, without being copied first.
    * @param buf
    * @return
    */
-  size_t write(std::string buf);
+  size_t write(sol::string_view buf);
 
  private:
   std::shared_ptr<io::BaseStream> stream_;
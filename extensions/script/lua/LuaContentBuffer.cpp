@@ -0,0 +1,115 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "LuaContentBuffer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace lua {
+
+namespace {
+
+// normalizes a Lua start index into a 1-based position, as string.sub does
+int64_t startPosition(int64_t index, int64_t size) {
+  if (index < 0) {
+    return std::max<int64_t>(size + index + 1, 1);
+  }
+  return index == 0 ? 1 : index;
+}
+
+}  // namespace
+
+LuaContentBuffer::LuaContentBuffer(const uint8_t *data, uint64_t size)
+    : data_(data),
+      size_(size),
+      valid_(true) {
+}
+
+size_t LuaContentBuffer::len() const {
+  checkValid();
+  return static_cast<size_t>(size_);
+}
+
+int LuaContentBuffer::byte(int64_t i) const {
+  checkValid();
+  auto offset = i < 0 ? static_cast<int64_t>(size_) + i : i - 1;
+  if (offset < 0 || static_cast<uint64_t>(offset) >= size_) {
+    throw std::out_of_range("Content buffer index out of range");
+  }
+  return data_[offset];
+}
+
+std::string LuaContentBuffer::sub(int64_t i, sol::optional<int64_t> j) const {
+  checkValid();
+  auto size = static_cast<int64_t>(size_);
+  auto first = startPosition(i, size);
+  auto last = j ? *j : -1;
+  if (last < 0) {
+    last += size + 1;
+  } else if (last > size) {
+    last = size;
+  }
+  if (first > last) {
+    return std::string();
+  }
+  return std::string(reinterpret_cast<const char *>(data_ + first - 1), static_cast<size_t>(last - first + 1));
+}
+
+sol::optional<size_t> LuaContentBuffer::find(const std::string &needle, sol::optional<int64_t> init) const {
+  checkValid();
+  auto size = static_cast<int64_t>(size_);
+  auto first = init ? startPosition(*init, size) : 1;
+  if (first > size + 1) {
+    return sol::nullopt;
+  }
+  auto begin = reinterpret_cast<const char *>(data_);
+  auto end = begin + size_;
+  auto match = std::search(begin + first - 1, end, needle.begin(), needle.end());
+  if (match == end && !needle.empty()) {
+    return sol::nullopt;
+  }
+  return static_cast<size_t>(match - begin) + 1;
+}
+
+std::string LuaContentBuffer::toString() const {
+  checkValid();
+  return std::string(reinterpret_cast<const char *>(data_), static_cast<size_t>(size_));
+}
+
+void LuaContentBuffer::release() {
+  valid_ = false;
+  data_ = nullptr;
+  size_ = 0;
+}
+
+void LuaContentBuffer::checkValid() const {
+  if (!valid_) {
+    throw std::runtime_error("Access of content buffer after its callback returned");
+  }
+}
+
+} /* namespace lua */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,81 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NIFI_MINIFI_CPP_LUACONTENTBUFFER_H
+#define NIFI_MINIFI_CPP_LUACONTENTBUFFER_H
+
+#include <cstdint>
+#include <string>
+#include <sol.hpp>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace lua {
+
+/**
+ * Userdata over the content of a flow file, as mapped by the content repository. Scripts can inspect and slice
+ * the content without it being copied into a Lua string first; only the slices they take are copied.
+ *
+ * Indices are 1-based and negative indices count from the end, as with Lua strings. The buffer is only valid
+ * during the callback it is passed to.
+ */
+class LuaContentBuffer {
+ public:
+  LuaContentBuffer(const uint8_t *data, uint64_t size);
+
+  size_t len() const;
+
+  /**
+   * Byte at position i
+   */
+  int byte(int64_t i) const;
+
+  /**
+   * Copies the bytes from i to j (the end by default) into a string, following string.sub
+   */
+  std::string sub(int64_t i, sol::optional<int64_t> j) const;
+
+  /**
+   * Plain search for needle, starting at init
+   * @return position of the first match, or nil
+   */
+  sol::optional<size_t> find(const std::string &needle, sol::optional<int64_t> init) const;
+
+  std::string toString() const;
+
+  /**
+   * Invalidates the buffer once the content it refers to is unmapped.
+   */
+  void release();
+
+ private:
+  void checkValid() const;
+
+  const uint8_t *data_;
+  uint64_t size_;
+  bool valid_;
+};
+
+} /* namespace lua */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif //NIFI_MINIFI_CPP_LUACONTENTBUFFER_H
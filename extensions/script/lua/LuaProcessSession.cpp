@@ -77,6 +77,22 @@ void LuaProcessSession::read(const std::shared_ptr<script::ScriptFlowFile> &scri
   session_->read(flow_file, &lua_callback);
 }
 
+void LuaProcessSession::readBuffer(const std::shared_ptr<script::ScriptFlowFile> &script_flow_file,
+                                   sol::table input_buffer_callback) {
+  if (!session_) {
+    throw std::runtime_error("Access of ProcessSession after it has been released");
+  }
+
+  auto flow_file = script_flow_file->getFlowFile();
+
+  if (!flow_file) {
+    throw std::runtime_error("Access of FlowFile after it has been released");
+  }
+
+  LuaInputBufferCallback lua_callback(input_buffer_callback);
+  session_->read(flow_file, &lua_callback);
+}
+
 void LuaProcessSession::write(const std::shared_ptr<script::ScriptFlowFile> &script_flow_file,
                               sol::table output_stream_callback) {
   if (!session_) {
@@ -25,6 +25,7 @@
 #include "../ScriptFlowFile.h"
 
 #include "LuaBaseStream.h"
+#include "LuaContentBuffer.h"
 
 namespace org {
 namespace apache {
@@ -41,6 +42,7 @@ class LuaProcessSession {
   std::shared_ptr<script::ScriptFlowFile> create(const std::shared_ptr<script::ScriptFlowFile> &flow_file);
   void transfer(const std::shared_ptr<script::ScriptFlowFile> &flow_file, core::Relationship relationship);
   void read(const std::shared_ptr<script::ScriptFlowFile> &script_flow_file, sol::table input_stream_callback);
+  void readBuffer(const std::shared_ptr<script::ScriptFlowFile> &script_flow_file, sol::table input_buffer_callback);
   void write(const std::shared_ptr<script::ScriptFlowFile> &flow_file, sol::table output_stream_callback);
 
   /**
@@ -69,6 +71,34 @@ class LuaProcessSession {
     sol::table lua_callback_;
   };
 
+  /**
+   * Hands the content to the script as a ContentBuffer over the mapped content, without copying it.
+   * The buffer is released once process returns, as the content is unmapped afterwards.
+   */
+  class LuaInputBufferCallback : public InputBufferCallback {
+   public:
+    explicit LuaInputBufferCallback(const sol::table &input_buffer_callback) {
+      lua_callback_ = input_buffer_callback;
+    }
+
+    int64_t process(const uint8_t *data, uint64_t size) override {
+      auto lua_buffer = std::make_shared<LuaContentBuffer>(data, size);
+      sol::function callback = lua_callback_["process"];
+      int64_t result;
+      try {
+        result = callback(lua_callback_, lua_buffer);
+      } catch (...) {
+        lua_buffer->release();
+        throw;
+      }
+      lua_buffer->release();
+      return result;
+    }
+
+   private:
+    sol::table lua_callback_;
+  };
+
   class LuaOutputStreamCallback : public OutputStreamCallback {
    public:
     explicit LuaOutputStreamCallback(const sol::table &output_stream_callback) {
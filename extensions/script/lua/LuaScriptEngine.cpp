@@ -48,6 +48,7 @@ LuaScriptEngine::LuaScriptEngine()
       "create", static_cast<std::shared_ptr<script::ScriptFlowFile> (lua::LuaProcessSession::*)()>(&lua::LuaProcessSession::create),
       "get", &lua::LuaProcessSession::get,
       "read", &lua::LuaProcessSession::read,
+      "readBuffer", &lua::LuaProcessSession::readBuffer,
       "write", &lua::LuaProcessSession::write,
       "transfer", &lua::LuaProcessSession::transfer);
   lua_.new_usertype<script::ScriptFlowFile>(
@@ -60,6 +61,15 @@ LuaScriptEngine::LuaScriptEngine()
       "BaseStream",
       "read", &lua::LuaBaseStream::read,
       "write", &lua::LuaBaseStream::write);
+  lua_.new_usertype<lua::LuaContentBuffer>(
+      "ContentBuffer",
+      "len", &lua::LuaContentBuffer::len,
+      "byte", &lua::LuaContentBuffer::byte,
+      "sub", &lua::LuaContentBuffer::sub,
+      "find", &lua::LuaContentBuffer::find,
+      "toString", &lua::LuaContentBuffer::toString,
+      sol::meta_function::length, &lua::LuaContentBuffer::len,
+      sol::meta_function::to_string, &lua::LuaContentBuffer::toString);
 }
 
 void LuaScriptEngine::eval(const std::string &script) {
@@ -55,10 +55,46 @@ py::bytes PyBaseStream::read(size_t len) {
   return result;
 }
 
-size_t PyBaseStream::write(py::bytes buf) {
-  const auto &&buf_str = buf.operator std::string();
-  return static_cast<size_t>(stream_->writeData(reinterpret_cast<uint8_t *>(const_cast<char *>(buf_str.data())),
-                                                static_cast<int>(buf_str.length())));
+size_t PyBaseStream::readAllInto(py::object buf) {
+  if (!PyByteArray_Check(buf.ptr())) {
+    throw std::invalid_argument("readAllInto expects a bytearray");
+  }
+
+  auto len = static_cast<Py_ssize_t>(stream_->getSize());
+
+  if (PyByteArray_Resize(buf.ptr(), len) != 0) {
+    throw py::error_already_set();
+  }
+
+  if (len == 0) {
+    return 0;
+  }
+
+  auto read = stream_->readData(reinterpret_cast<uint8_t *>(PyByteArray_AsString(buf.ptr())), static_cast<int>(len));
+
+  if (read < 0) {
+    read = 0;
+  }
+
+  if (read != len && PyByteArray_Resize(buf.ptr(), read) != 0) {
+    throw py::error_already_set();
+  }
+
+  return static_cast<size_t>(read);
+}
+
+size_t PyBaseStream::write(py::buffer buf) {
+  Py_buffer view;
+
+  // PyBUF_SIMPLE only accepts contiguous byte buffers, which can be handed to the stream as they are
+  if (PyObject_GetBuffer(buf.ptr(), &view, PyBUF_SIMPLE) != 0) {
+    throw py::error_already_set();
+  }
+
+  auto written = stream_->writeData(reinterpret_cast<uint8_t *>(view.buf), static_cast<int>(view.len));
+  PyBuffer_Release(&view);
+
+  return static_cast<size_t>(written);
 }
 
 } /* namespace python */
@@ -37,7 +37,18 @@ class PyBaseStream {
 
   py::bytes read();
   py::bytes read(size_t len = 0);
-  size_t write(py::bytes buf);
+
+  /**
+   * Reads the remaining content directly into the storage of a bytearray, resizing it to fit,
+   * so large payloads are not copied into an intermediate bytes object.
+   * @return number of bytes read
+   */
+  size_t readAllInto(py::object buf);
+
+  /**
+   * Writes any object supporting the buffer protocol (bytes, bytearray, memoryview) without copying it first.
+   */
+  size_t write(py::buffer buf);
 
  private:
   std::shared_ptr<io::BaseStream> stream_;
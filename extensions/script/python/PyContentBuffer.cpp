@@ -0,0 +1,70 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <utility>
+
+#include "PyContentBuffer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace python {
+
+PyContentBuffer::PyContentBuffer(std::shared_ptr<io::ContentBuffer> buffer)
+    : buffer_(std::move(buffer)) {
+}
+
+size_t PyContentBuffer::len() const {
+  return static_cast<size_t>(buffer_->size());
+}
+
+void PyContentBuffer::enableBufferProtocol(py::handle type) {
+  auto heap_type = reinterpret_cast<PyHeapTypeObject *>(type.ptr());
+  heap_type->as_buffer.bf_getbuffer = &PyContentBuffer::getBuffer;
+  heap_type->as_buffer.bf_releasebuffer = nullptr;
+  heap_type->ht_type.tp_as_buffer = &heap_type->as_buffer;
+#if PY_MAJOR_VERSION < 3
+  heap_type->ht_type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+}
+
+int PyContentBuffer::getBuffer(PyObject *obj, Py_buffer *view, int flags) {
+  // empty content may have no storage, while exports need a valid pointer
+  static uint8_t empty = 0;
+
+  PyContentBuffer *content;
+  try {
+    content = py::cast<PyContentBuffer *>(py::handle(obj));
+  } catch (const py::cast_error &) {
+    view->obj = nullptr;
+    PyErr_SetString(PyExc_BufferError, "Object is not a content buffer");
+    return -1;
+  }
+
+  auto data = content->buffer_->size() > 0 ? const_cast<uint8_t *>(content->buffer_->data()) : &empty;
+  // fails with a BufferError if a writable buffer is requested, and references obj from the view otherwise
+  return PyBuffer_FillInfo(view, obj, data, static_cast<Py_ssize_t>(content->buffer_->size()), 1, flags);
+}
+
+} /* namespace python */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,63 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NIFI_MINIFI_CPP_PYCONTENTBUFFER_H
+#define NIFI_MINIFI_CPP_PYCONTENTBUFFER_H
+
+#include <pybind11/embed.h>
+
+#include <io/ContentBuffer.h>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace python {
+
+namespace py = pybind11;
+
+/**
+ * Exports the content of a flow file read only through the buffer protocol. Every export holds a reference
+ * to the exporting object, so memoryviews, slices of them and arrays created by numpy.frombuffer keep the
+ * content, and a mapping of it, alive after the callback they were created in returns.
+ */
+class PyContentBuffer {
+ public:
+  explicit PyContentBuffer(std::shared_ptr<io::ContentBuffer> buffer);
+
+  size_t len() const;
+
+  /**
+   * Installs the buffer protocol on the bound type. py::buffer_protocol is not used, as it exports writable
+   * buffers regardless of the flags requested, which would let scripts write to read only mappings.
+   */
+  static void enableBufferProtocol(py::handle type);
+
+ private:
+  static int getBuffer(PyObject *obj, Py_buffer *view, int flags);
+
+  std::shared_ptr<io::ContentBuffer> buffer_;
+};
+
+} /* namespace python */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif //NIFI_MINIFI_CPP_PYCONTENTBUFFER_H
@@ -83,6 +83,22 @@ void PyProcessSession::read(std::shared_ptr<script::ScriptFlowFile> script_flow_
   session_->read(flow_file, &py_callback);
 }
 
+void PyProcessSession::readBuffer(std::shared_ptr<script::ScriptFlowFile> script_flow_file,
+                                  py::object input_buffer_callback) {
+  if (!session_) {
+    throw std::runtime_error("Access of ProcessSession after it has been released");
+  }
+
+  auto flow_file = script_flow_file->getFlowFile();
+
+  if (!flow_file) {
+    throw std::runtime_error("Access of FlowFile after it has been released");
+  }
+
+  PyInputBufferCallback py_callback(input_buffer_callback);
+  session_->read(flow_file, &py_callback);
+}
+
 void PyProcessSession::write(std::shared_ptr<script::ScriptFlowFile> script_flow_file,
                              py::object output_stream_callback) {
   if (!session_) {
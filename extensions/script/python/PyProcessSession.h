@@ -26,6 +26,7 @@
 #include "../ScriptFlowFile.h"
 
 #include "PyBaseStream.h"
+#include "PyContentBuffer.h"
 
 namespace org {
 namespace apache {
@@ -44,6 +45,7 @@ class PyProcessSession {
   std::shared_ptr<script::ScriptFlowFile> create(std::shared_ptr<script::ScriptFlowFile> flow_file);
   void transfer(std::shared_ptr<script::ScriptFlowFile> flow_file, core::Relationship relationship);
   void read(std::shared_ptr<script::ScriptFlowFile> flow_file, py::object input_stream_callback);
+  void readBuffer(std::shared_ptr<script::ScriptFlowFile> flow_file, py::object input_buffer_callback);
   void write(std::shared_ptr<script::ScriptFlowFile> flow_file, py::object output_stream_callback);
 
   /**
@@ -71,6 +73,34 @@ class PyProcessSession {
     py::object py_callback_;
   };
 
+  /**
+   * Hands the content to the script as a read only memoryview over a ContentBuffer, which keeps the content
+   * alive for as long as the view or anything derived from it is referenced. Mapped content is not copied;
+   * pieces of content that cannot be mapped are only valid during the call, so they are copied.
+   */
+  class PyInputBufferCallback : public InputBufferCallback {
+   public:
+    explicit PyInputBufferCallback(const py::object &input_buffer_callback) {
+      py_callback_ = input_buffer_callback;
+    }
+
+    int64_t process(const uint8_t *data, uint64_t size) override {
+      return processBuffer(std::make_shared<io::ContentBuffer>(std::vector<uint8_t>(data, data + size)));
+    }
+
+    int64_t processBuffer(const std::shared_ptr<io::ContentBuffer> &buffer) override {
+      auto content = py::cast(std::make_shared<PyContentBuffer>(buffer));
+      auto view = py::reinterpret_steal<py::object>(PyMemoryView_FromObject(content.ptr()));
+      if (!view) {
+        throw py::error_already_set();
+      }
+      return py_callback_.attr("process")(view).cast<int64_t>();
+    }
+
+   private:
+    py::object py_callback_;
+  };
+
   class PyOutputStreamCallback : public OutputStreamCallback {
    public:
     explicit PyOutputStreamCallback(const py::object &output_stream_callback) {
@@ -32,6 +32,7 @@
 #include "PyProcessSession.h"
 #include "PythonProcessor.h"
 #include "PyBaseStream.h"
+#include "PyContentBuffer.h"
 
 PYBIND11_EMBEDDED_MODULE(minifi_native, m) { // NOLINT
   namespace py = pybind11;
@@ -53,6 +54,7 @@ PYBIND11_EMBEDDED_MODULE(minifi_native, m) { // NOLINT
       .def("create",
            static_cast<std::shared_ptr<script::ScriptFlowFile> (python::PyProcessSession::*)(std::shared_ptr<script::ScriptFlowFile>)>(&python::PyProcessSession::create))
       .def("read", &python::PyProcessSession::read)
+      .def("readBuffer", &python::PyProcessSession::readBuffer)
       .def("write", &python::PyProcessSession::write)
       .def("transfer", &python::PyProcessSession::transfer);
 
@@ -77,7 +79,12 @@ PYBIND11_EMBEDDED_MODULE(minifi_native, m) { // NOLINT
   py::class_<python::PyBaseStream, std::shared_ptr<python::PyBaseStream>>(m, "BaseStream")
       .def("read", static_cast<py::bytes (python::PyBaseStream::*)()>(&python::PyBaseStream::read))
       .def("read", static_cast<py::bytes (python::PyBaseStream::*)(size_t)>(&python::PyBaseStream::read))
+      .def("readAllInto", &python::PyBaseStream::readAllInto)
       .def("write", &python::PyBaseStream::write);
+
+  py::class_<python::PyContentBuffer, std::shared_ptr<python::PyContentBuffer>> content_buffer(m, "ContentBuffer");
+  content_buffer.def("__len__", &python::PyContentBuffer::len);
+  python::PyContentBuffer::enableBufferProtocol(content_buffer);
 }
 
 #endif //NIFI_MINIFI_CPP_PYTHONBINDINGS_H
@@ -0,0 +1,123 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CSVSQLWriter.h"
+
+#include <cstdio>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sql {
+
+CSVSQLWriter::CSVSQLWriter() {
+}
+
+CSVSQLWriter::~CSVSQLWriter() {}
+
+void CSVSQLWriter::beginStream(const std::shared_ptr<io::BaseStream>& stream) {
+  buffer_.reset(stream);
+  headerColumns_ = 0;
+}
+
+int64_t CSVSQLWriter::endStream() {
+  buffer_.Flush();
+  return buffer_.getWritten();
+}
+
+void CSVSQLWriter::beginProcessRow() {
+  columns_ = 0;
+}
+
+void CSVSQLWriter::endProcessRow() {
+  buffer_.Put('\n');
+}
+
+// The column names are processed with the first row of each flow file.
+void CSVSQLWriter::processColumnName(const std::string& name) {
+  if (headerColumns_ > 0) {
+    buffer_.Put(',');
+  }
+  writeField(name);
+  headerColumns_++;
+}
+
+void CSVSQLWriter::processColumn(const std::string& name, const std::string& value) {
+  beginColumn();
+  writeField(value);
+}
+
+void CSVSQLWriter::processColumn(const std::string& name, double value) {
+  beginColumn();
+  char formatted[32];
+  const auto size = std::snprintf(formatted, sizeof(formatted), "%.17g", value);
+  buffer_.write(formatted, size);
+}
+
+void CSVSQLWriter::processColumn(const std::string& name, int value) {
+  beginColumn();
+  buffer_.write(std::to_string(value));
+}
+
+void CSVSQLWriter::processColumn(const std::string& name, long long value) {
+  beginColumn();
+  buffer_.write(std::to_string(value));
+}
+
+void CSVSQLWriter::processColumn(const std::string& name, unsigned long long value) {
+  beginColumn();
+  buffer_.write(std::to_string(value));
+}
+
+void CSVSQLWriter::processColumn(const std::string& name, const char* value) {
+  beginColumn();
+}
+
+void CSVSQLWriter::beginColumn() {
+  if (columns_ == 0 && headerColumns_ > 0) {
+    // end the header line
+    buffer_.Put('\n');
+    headerColumns_ = 0;
+  }
+  if (columns_ > 0) {
+    buffer_.Put(',');
+  }
+  columns_++;
+}
+
+void CSVSQLWriter::writeField(const std::string& value) {
+  if (value.find_first_of(",\"\r\n") == std::string::npos) {
+    buffer_.write(value);
+    return;
+  }
+  buffer_.Put('"');
+  for (const auto c : value) {
+    if (c == '"') {
+      buffer_.Put('"');
+    }
+    buffer_.Put(c);
+  }
+  buffer_.Put('"');
+}
+
+} /* namespace sql */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,62 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "SQLWriter.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sql {
+
+// Writes the rows as RFC 4180 CSV with a header line, NULL values are left empty.
+class CSVSQLWriter: public SQLWriter {
+ public:
+  CSVSQLWriter();
+  virtual ~CSVSQLWriter();
+
+  void beginStream(const std::shared_ptr<io::BaseStream>& stream) override;
+  int64_t endStream() override;
+
+private:
+  void beginProcessRow() override;
+  void endProcessRow() override;
+  void processColumnName(const std::string& name) override;
+  void processColumn(const std::string& name, const std::string& value) override;
+  void processColumn(const std::string& name, double value) override;
+  void processColumn(const std::string& name, int value) override;
+  void processColumn(const std::string& name, long long value) override;
+  void processColumn(const std::string& name, unsigned long long value) override;
+  void processColumn(const std::string& name, const char* value) override;
+
+  void beginColumn();
+  void writeField(const std::string& value);
+
+ private:
+  SQLStreamBuffer buffer_;
+  size_t headerColumns_{};
+  size_t columns_{};
+};
+
+} /* namespace sql */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <soci/soci.h>
 
@@ -81,6 +82,21 @@ class Session {
     session_ << statement;
   }
 
+  /**
+   * Executes the statement once for each row of parameters in a single bulk operation.
+   * The parameters are given by column, one for each placeholder of the statement.
+   */
+  void executeBatch(const std::string &statement, std::vector<std::vector<std::string>>& parameters, std::vector<std::vector<soci::indicator>>& indicators) {
+    soci::statement st(session_);
+    for (size_t i = 0; i < parameters.size(); i++) {
+      st.exchange(soci::use(parameters[i], indicators[i]));
+    }
+    st.alloc();
+    st.prepare(statement);
+    st.define_and_bind();
+    st.execute(true);
+  }
+
 protected:
   soci::session& session_;
 };
@@ -92,6 +108,11 @@ class Connection {
   virtual bool connected(std::string& exception) const = 0;
   virtual std::unique_ptr<Statement> prepareStatement(const std::string &query) const = 0;
   virtual std::unique_ptr<Session> getSession() const = 0;
+
+  // whether a statement that failed with error may succeed when it is retried, e.g. after a timeout
+  virtual bool isTransient(const std::exception& /*error*/) const {
+    return false;
+  }
 };
 
 } /* namespace sql */
@@ -17,9 +17,6 @@
  */
 
 #include "JSONSQLWriter.h"
-#include "rapidjson/writer.h"
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/prettywriter.h"
 #include "Exception.h"
 #include "Utils.h"
 
@@ -30,73 +27,90 @@ namespace minifi {
 namespace sql {
 
 JSONSQLWriter::JSONSQLWriter(bool pretty)
-  : pretty_(pretty), jsonPayload_(rapidjson::kArrayType) {
+  : pretty_(pretty), writer_(buffer_), prettyWriter_(buffer_) {
 }
 
 JSONSQLWriter::~JSONSQLWriter() {}
 
+template <typename Function>
+void JSONSQLWriter::write(Function function) {
+  if (pretty_) {
+    function(prettyWriter_);
+  } else {
+    function(writer_);
+  }
+}
+
+void JSONSQLWriter::beginStream(const std::shared_ptr<io::BaseStream>& stream) {
+  buffer_.reset(stream);
+  write([this](auto& writer) {
+    writer.Reset(buffer_);
+    writer.StartArray();
+  });
+}
+
+int64_t JSONSQLWriter::endStream() {
+  write([](auto& writer) {
+    writer.EndArray();
+  });
+  buffer_.Flush();
+  return buffer_.getWritten();
+}
+
 void JSONSQLWriter::beginProcessRow() {
-  jsonRow_ = rapidjson::kObjectType;
+  write([](auto& writer) {
+    writer.StartObject();
+  });
 }
 
 void JSONSQLWriter::endProcessRow() {
-  jsonPayload_.PushBack(jsonRow_, jsonPayload_.GetAllocator());
+  write([](auto& writer) {
+    writer.EndObject();
+  });
 }
 
 void JSONSQLWriter::processColumnName(const std::string& name) {}
 
 void JSONSQLWriter::processColumn(const std::string& name, const std::string& value) {
-  addToJSONRow(name, std::move(toJSONString(value)));
+  write([&](auto& writer) {
+    writer.Key(name.c_str(), name.size());
+    writer.String(value.c_str(), value.size());
+  });
 }
 
 void JSONSQLWriter::processColumn(const std::string& name, double value) {
-  addToJSONRow(name, std::move(rapidjson::Value().SetDouble(value)));
+  write([&](auto& writer) {
+    writer.Key(name.c_str(), name.size());
+    writer.Double(value);
+  });
 }
 
 void JSONSQLWriter::processColumn(const std::string& name, int value) {
-  addToJSONRow(name, std::move(rapidjson::Value().SetInt(value)));
+  write([&](auto& writer) {
+    writer.Key(name.c_str(), name.size());
+    writer.Int(value);
+  });
 }
 
 void JSONSQLWriter::processColumn(const std::string& name, long long value) {
-  addToJSONRow(name, std::move(rapidjson::Value().SetInt64(value)));
+  write([&](auto& writer) {
+    writer.Key(name.c_str(), name.size());
+    writer.Int64(value);
+  });
 }
 
 void JSONSQLWriter::processColumn(const std::string& name, unsigned long long value) {
-  addToJSONRow(name, std::move(rapidjson::Value().SetUint64(value)));
+  write([&](auto& writer) {
+    writer.Key(name.c_str(), name.size());
+    writer.Uint64(value);
+  });
 }
 
 void JSONSQLWriter::processColumn(const std::string& name, const char* value) {
-  addToJSONRow(name, std::move(toJSONString(value)));
-}
-
-void JSONSQLWriter::addToJSONRow(const std::string& columnName, rapidjson::Value&& jsonValue) {
-  jsonRow_.AddMember(toJSONString(columnName), std::move(jsonValue), jsonPayload_.GetAllocator());
-}
-
-rapidjson::Value JSONSQLWriter::toJSONString(const std::string& s) {
-  rapidjson::Value jsonValue;
-  jsonValue.SetString(s.c_str(), s.size(), jsonPayload_.GetAllocator());
-
-  return jsonValue;
-}
-
-std::string JSONSQLWriter::toString() {
-  rapidjson::StringBuffer buffer;
-
-  if (pretty_) {
-    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-    jsonPayload_.Accept(writer);
-  } else {
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    jsonPayload_.Accept(writer);
-  }
-
-  std::stringstream outputStream;
-  outputStream << buffer.GetString();
-
-  jsonPayload_ = rapidjson::Document(rapidjson::kArrayType);
-
-  return outputStream.str();
+  write([&](auto& writer) {
+    writer.Key(name.c_str(), name.size());
+    writer.String(value);
+  });
 }
 
 } /* namespace sql */
@@ -18,7 +18,8 @@
 
 #pragma once
 
-#include "rapidjson/document.h"
+#include "rapidjson/writer.h"
+#include "rapidjson/prettywriter.h"
 
 #include "SQLWriter.h"
 
@@ -28,12 +29,14 @@ namespace nifi {
 namespace minifi {
 namespace sql {
 
+// Writes the rows as a JSON array of objects, one flow file content at a time.
 class JSONSQLWriter: public SQLWriter {
  public:
   explicit JSONSQLWriter(bool pretty);
   virtual ~JSONSQLWriter();
 
-  std::string toString() override;
+  void beginStream(const std::shared_ptr<io::BaseStream>& stream) override;
+  int64_t endStream() override;
 
 private:
   void beginProcessRow() override;
@@ -46,14 +49,15 @@ private:
   void processColumn(const std::string& name, unsigned long long value) override;
   void processColumn(const std::string& name, const char* value) override;
 
-  void addToJSONRow(const std::string& columnName, rapidjson::Value&& jsonValue);
-
-  rapidjson::Value toJSONString(const std::string& s);
+  // Calls the function with the SAX writer of the output format.
+  template <typename Function>
+  void write(Function function);
 
  private:
   bool pretty_;
-  rapidjson::Document jsonPayload_;
-  rapidjson::Value jsonRow_;
+  SQLStreamBuffer buffer_;
+  rapidjson::Writer<SQLStreamBuffer> writer_;
+  rapidjson::PrettyWriter<SQLStreamBuffer> prettyWriter_;
 };
 
 } /* namespace sql */
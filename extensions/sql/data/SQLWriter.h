@@ -19,9 +19,10 @@
 #pragma once
 
 #include <string>
-#include <iostream>
+#include <memory>
+#include <vector>
 
-#include <soci/soci.h>
+#include "io/BaseStream.h"
 
 #include "SQLRowSubscriber.h"
 
@@ -31,9 +32,91 @@ namespace nifi {
 namespace minifi {
 namespace sql {
 
+/**
+ * Buffers the characters written by an SQLWriter and passes them to the flow file content in blocks,
+ * so a result set never has to fit into memory. Usable as a rapidjson output stream.
+ */
+class SQLStreamBuffer {
+ public:
+  typedef char Ch;
+
+  explicit SQLStreamBuffer(size_t capacity = 64 * 1024)
+    : capacity_(capacity) {
+    buffer_.reserve(capacity_);
+  }
+
+  void reset(const std::shared_ptr<io::BaseStream>& stream) {
+    stream_ = stream;
+    buffer_.clear();
+    written_ = 0;
+    failed_ = false;
+  }
+
+  void Put(char c) {
+    buffer_.push_back(c);
+    if (buffer_.size() >= capacity_) {
+      Flush();
+    }
+  }
+
+  void write(const char* data, size_t size) {
+    if (buffer_.size() + size > capacity_) {
+      Flush();
+    }
+    if (size >= capacity_) {
+      writeToStream(data, size);
+    } else {
+      buffer_.insert(buffer_.end(), data, data + size);
+    }
+  }
+
+  void write(const std::string& s) {
+    write(s.data(), s.size());
+  }
+
+  void Flush() {
+    if (!buffer_.empty()) {
+      writeToStream(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+  // Bytes passed to the stream, or -1 if the stream failed.
+  int64_t getWritten() const {
+    return failed_ ? -1 : written_;
+  }
+
+ private:
+  void writeToStream(const char* data, size_t size) {
+    if (failed_ || !stream_) {
+      failed_ = true;
+      return;
+    }
+    const auto ret = stream_->write(reinterpret_cast<uint8_t*>(const_cast<char*>(data)), static_cast<int>(size));
+    if (ret < 0 || static_cast<size_t>(ret) != size) {
+      failed_ = true;
+      return;
+    }
+    written_ += ret;
+  }
+
+  size_t capacity_;
+  std::vector<char> buffer_;
+  std::shared_ptr<io::BaseStream> stream_;
+  int64_t written_{};
+  bool failed_{};
+};
+
+/**
+ * Writes the rows straight into flow file content as they are processed.
+ */
 struct SQLWriter: public SQLRowSubscriber
 {
-  virtual std::string toString() = 0;
+  // Starts the content of a flow file.
+  virtual void beginStream(const std::shared_ptr<io::BaseStream>& stream) = 0;
+
+  // Ends the content of the flow file, returns the bytes written or -1 on failure.
+  virtual int64_t endStream() = 0;
 };
 
 
@@ -42,4 +125,3 @@ struct SQLWriter: public SQLRowSubscriber
 } /* namespace nifi */
 } /* namespace apache */
 } /* namespace org */
-
@@ -18,29 +18,46 @@
 
 #pragma once
 
-#include <string>
+#include <memory>
 
 #include "FlowFileRecord.h"
+#include "SQLRowsetProcessor.h"
+#include "SQLWriter.h"
 
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 
+// Writes the next rows of a rowset into the flow file content as they are fetched.
 class WriteCallback : public OutputStreamCallback {
 public:
-  explicit WriteCallback(const std::string& data)
-    : data_(data) {
+  WriteCallback(sql::SQLRowsetProcessor& rowsetProcessor, sql::SQLWriter& writer, size_t maxRows)
+    : rowsetProcessor_(rowsetProcessor), writer_(writer), maxRows_(maxRows) {
   }
 
  int64_t process(std::shared_ptr<io::BaseStream> stream) {
-    if (data_.empty())
-      return 0;
-
-    return stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(data_.c_str())), data_.size());
+    writer_.beginStream(stream);
+    rowCount_ = rowsetProcessor_.process(maxRows_);
+    written_ = writer_.endStream();
+    return written_;
   }
 
- const std::string& data_;
+ size_t getRowCount() const {
+   return rowCount_;
+ }
+
+ // Whether rows were written, the session is rolled back otherwise.
+ explicit operator bool() const {
+   return rowCount_ > 0 && written_ >= 0;
+ }
+
+ private:
+  sql::SQLRowsetProcessor& rowsetProcessor_;
+  sql::SQLWriter& writer_;
+  size_t maxRows_;
+  size_t rowCount_{};
+  int64_t written_{-1};
 };
 
 } /* namespace minifi */
@@ -39,7 +39,6 @@
 #include "Exception.h"
 #include "utils/OsUtils.h"
 #include "data/DatabaseConnectors.h"
-#include "data/JSONSQLWriter.h"
 #include "data/SQLRowsetProcessor.h"
 #include "data/WriteCallback.h"
 
@@ -93,27 +92,20 @@ void ExecuteSQL::processOnTrigger(core::ProcessSession& session) {
 
   auto rowset = statement->execute();
 
-  int count = 0;
-  size_t rowCount = 0;
-  sql::JSONSQLWriter sqlWriter(isJSONPretty());
-  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, { &sqlWriter });
-
-  // Process rowset.
-  do {
-    rowCount = sqlRowsetProcessor.process(max_rows_ == 0 ? std::numeric_limits<size_t>::max() : max_rows_);
-    count++;
-    if (rowCount == 0)
-      break;
-
-    const auto output = sqlWriter.toString();
-    if (!output.empty()) {
-      WriteCallback writer(output);
-      auto newflow = session.create();
-      newflow->addAttribute(ResultRowCount, std::to_string(rowCount));
-      session.write(newflow, &writer);
-      session.transfer(newflow, s_success);
+  auto sqlWriter = createSQLWriter();
+  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, { sqlWriter.get() });
+
+  // Process rowset, the rows are written to the flow files as they are fetched.
+  while (sqlRowsetProcessor.hasMoreRows()) {
+    WriteCallback writer(sqlRowsetProcessor, *sqlWriter, max_rows_ == 0 ? std::numeric_limits<size_t>::max() : max_rows_);
+    auto newflow = session.create();
+    session.write(newflow, &writer);
+    if (!writer) {
+      throw minifi::Exception(PROCESSOR_EXCEPTION, "ExecuteSQL: failed to write the result rows.");
     }
-  } while (rowCount > 0);
+    newflow->addAttribute(ResultRowCount, std::to_string(writer.getRowCount()));
+    session.transfer(newflow, s_success);
+  }
 }
 
 } /* namespace processors */
@@ -17,6 +17,9 @@
 
 #include "OutputFormat.h"
 
+#include "data/CSVSQLWriter.h"
+#include "data/JSONSQLWriter.h"
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -25,13 +28,14 @@ namespace processors {
 
 const std::string s_outputFormatJSON = "JSON";
 const std::string s_outputFormatJSONPretty = "JSON-Pretty";
+const std::string s_outputFormatCSV = "CSV";
 
 const core::Property& OutputFormat::outputFormat() {
   static const core::Property s_outputFormat =
       core::PropertyBuilder::createProperty("Output Format")->
           isRequired(true)->
           withDefaultValue(s_outputFormatJSONPretty)->
-          withAllowableValues<std::string>({ s_outputFormatJSON, s_outputFormatJSONPretty })->
+          withAllowableValues<std::string>({ s_outputFormatJSON, s_outputFormatJSONPretty, s_outputFormatCSV })->
           withDescription("Set the output format type.")->
           build();
 
@@ -46,6 +50,17 @@ bool OutputFormat::isJSONPretty() const {
   return outputFormat_ == s_outputFormatJSONPretty;
 }
 
+bool OutputFormat::isCSVFormat() const {
+  return outputFormat_ == s_outputFormatCSV;
+}
+
+std::unique_ptr<sql::SQLWriter> OutputFormat::createSQLWriter() const {
+  if (isCSVFormat()) {
+    return std::unique_ptr<sql::SQLWriter>(new sql::CSVSQLWriter());
+  }
+  return std::unique_ptr<sql::SQLWriter>(new sql::JSONSQLWriter(isJSONPretty()));
+}
+
 void OutputFormat::initOutputFormat(const core::ProcessContext& context) {
   context.getProperty(outputFormat().getName(), outputFormat_);
 }
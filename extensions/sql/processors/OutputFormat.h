@@ -23,8 +23,11 @@
 #include "core/Core.h"
 #include "core/Processor.h"
 
+#include <memory>
 #include <string>
 
+#include "data/SQLWriter.h"
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -39,6 +42,10 @@ class OutputFormat {
 
   bool isJSONPretty() const;
 
+  bool isCSVFormat() const;
+
+  std::unique_ptr<sql::SQLWriter> createSQLWriter() const;
+
   void initOutputFormat(const core::ProcessContext& context);
 
  protected:
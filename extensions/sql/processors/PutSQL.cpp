@@ -30,6 +30,9 @@
 #include <iostream>
 #include <memory>
 #include <codecvt>
+#include <algorithm>
+#include <cinttypes>
+#include <limits>
 
 #include <soci/soci.h>
 
@@ -39,7 +42,6 @@
 #include "Exception.h"
 #include "utils/OsUtils.h"
 #include "data/DatabaseConnectors.h"
-#include "data/JSONSQLWriter.h"
 
 namespace org {
 namespace apache {
@@ -49,6 +51,43 @@ namespace processors {
 
 const std::string PutSQL::ProcessorName("PutSQL");
 
+static const std::string ArgumentPrefix = "sql.args.";
+static const std::string ArgumentSuffix = ".value";
+
+// The N of a sql.args.N.value attribute, or 0 if the attribute is not an argument. Large values are capped, not wrapped.
+static uint64_t argumentIndex(const std::string& key) {
+  if (key.compare(0, ArgumentPrefix.size(), ArgumentPrefix) != 0 || key.size() <= ArgumentPrefix.size() + ArgumentSuffix.size()
+      || key.compare(key.size() - ArgumentSuffix.size(), ArgumentSuffix.size(), ArgumentSuffix) != 0) {
+    return 0;
+  }
+  uint64_t index = 0;
+  for (size_t i = ArgumentPrefix.size(); i < key.size() - ArgumentSuffix.size(); i++) {
+    if (key[i] < '0' || key[i] > '9') {
+      return 0;
+    }
+    index = (std::min)(index * 10 + (key[i] - '0'), static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()));
+  }
+  return index;
+}
+
+// Counts the '?' placeholders of a statement, skipping those in quoted literals and identifiers.
+static size_t countPlaceholders(const std::string& statement) {
+  size_t placeholders = 0;
+  char quote = 0;
+  for (const char c : statement) {
+    if (quote) {
+      if (c == quote) {
+        quote = 0;
+      }
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+    } else if (c == '?') {
+      placeholders++;
+    }
+  }
+  return placeholders;
+}
+
 const core::Property PutSQL::s_sqlStatements(
   core::PropertyBuilder::createProperty("SQL statements")->isRequired(true)->withDefaultValue("System")->withDescription(
     "A semicolon-delimited list of SQL statements to execute. The statement can be empty, a constant value, or built from attributes using Expression Language. "
@@ -56,7 +95,20 @@ const core::Property PutSQL::s_sqlStatements(
     "If this property is empty, the content of the incoming flow file is expected to contain a valid SQL statements, to be issued by the processor to the database.")
     ->supportsExpressionLanguage(true)->build());
 
+const core::Property PutSQL::s_parameterizedStatement(
+  core::PropertyBuilder::createProperty("Parameterized SQL Statement")->isRequired(false)->withDescription(
+    "A SQL statement with '?' placeholders, executed for each incoming flow file. The placeholders are bound in order to the flow file attributes "
+    "sql.args.1.value, sql.args.2.value and so on, a missing attribute is bound as NULL. "
+    "If this property is specified, the flow files are processed in batches: every batch is bound to the statement at once and committed in a single transaction. "
+    "If the database refuses a batch, its flow files are inserted one at a time and the refused ones are routed to failure, as are flow files with arguments beyond the placeholders. "
+    "The SQL statements property is ignored.")->build());
+
+const core::Property PutSQL::s_batchSize(
+  core::PropertyBuilder::createProperty("Batch Size")->isRequired(true)->withDefaultValue<int>(100)->withDescription(
+    "The maximum number of flow files bound to the Parameterized SQL Statement in a single transaction.")->build());
+
 const core::Relationship PutSQL::s_success("success", "Database is successfully updated.");
+const core::Relationship PutSQL::s_failure("failure", "Flow files whose parameters the database refused, when the Parameterized SQL Statement is used.");
 
 PutSQL::PutSQL(const std::string& name, utils::Identifier uuid)
   : SQLProcessor(name, uuid) {
@@ -67,19 +119,35 @@ PutSQL::~PutSQL() {
 
 void PutSQL::initialize() {
   //! Set the supported properties
-  setSupportedProperties( { dbControllerService(), s_sqlStatements });
+  setSupportedProperties( { dbControllerService(), s_sqlStatements, s_parameterizedStatement, s_batchSize });
 
   //! Set the supported relationships
-  setSupportedRelationships( { s_success });
+  setSupportedRelationships( { s_success, s_failure });
 }
 
 void PutSQL::processOnSchedule(core::ProcessContext& context) {
   std::string sqlStatements;
   context.getProperty(s_sqlStatements.getName(), sqlStatements);
   sqlStatements_ = utils::StringUtils::split(sqlStatements, ";");
+
+  context.getProperty(s_parameterizedStatement.getName(), parameterizedStatement_);
+  context.getProperty(s_batchSize.getName(), batchSize_);
+  if (batchSize_ <= 0) {
+    throw minifi::Exception(PROCESSOR_EXCEPTION, "PutSQL: 'Batch Size' must be positive");
+  }
+
+  placeholders_ = countPlaceholders(parameterizedStatement_);
+  if (!parameterizedStatement_.empty()) {
+    logger_->log_info("PutSQL: binding sql.args.1.value to sql.args.%zu.value of the flow files to the statement", placeholders_);
+  }
 }
 
 void PutSQL::processOnTrigger(core::ProcessSession& session) {
+  if (!parameterizedStatement_.empty()) {
+    processBatch(session);
+    return;
+  }
+
   const auto dbSession = connection_->getSession();
 
   try {
@@ -95,6 +163,93 @@ void PutSQL::processOnTrigger(core::ProcessSession& session) {
   }
 }
 
+void PutSQL::processBatch(core::ProcessSession& session) {
+  const auto flowFiles = session.get(batchSize_);
+  if (flowFiles.empty()) {
+    return;
+  }
+
+  // arguments without a placeholder cannot be bound, and would fail every batch they are in
+  std::vector<std::shared_ptr<core::FlowFile>> bindable;
+  bindable.reserve(flowFiles.size());
+  for (const auto& flowFile : flowFiles) {
+    uint64_t highest = 0;
+    for (const auto& attribute : flowFile->getAttributes()) {
+      highest = (std::max)(highest, argumentIndex(attribute.first));
+    }
+    if (highest > placeholders_) {
+      logger_->log_error("PutSQL: flow file %s has the argument sql.args.%" PRIu64 ".value, but the statement has %zu placeholders",
+                         flowFile->getUUIDStr(), highest, placeholders_);
+      session.transfer(flowFile, s_failure);
+    } else {
+      bindable.push_back(flowFile);
+    }
+  }
+  if (bindable.empty()) {
+    return;
+  }
+
+  std::string error;
+  if (insert(bindable, error)) {
+    logger_->log_debug("PutSQL: inserted a batch of %zu flow files", bindable.size());
+    for (const auto& flowFile : bindable) {
+      session.transfer(flowFile, s_success);
+    }
+    return;
+  }
+  logger_->log_error("SQL statement error: %s", error);
+
+  // the database refused a row of the batch, which is found by inserting the flow files one at a time
+  for (const auto& flowFile : bindable) {
+    if (bindable.size() > 1 && insert({ flowFile }, error)) {
+      session.transfer(flowFile, s_success);
+    } else {
+      logger_->log_error("PutSQL: could not insert flow file %s: %s", flowFile->getUUIDStr(), error);
+      session.transfer(flowFile, s_failure);
+    }
+  }
+}
+
+bool PutSQL::insert(const std::vector<std::shared_ptr<core::FlowFile>>& flowFiles, std::string& error) {
+  // The parameters are bound by column, each flow file is a row. Arguments are bound to placeholders in order, missing ones as NULL.
+  std::vector<std::vector<std::string>> parameters(placeholders_, std::vector<std::string>(flowFiles.size()));
+  std::vector<std::vector<soci::indicator>> indicators(placeholders_, std::vector<soci::indicator>(flowFiles.size(), soci::i_null));
+  for (size_t row = 0; row < flowFiles.size(); row++) {
+    for (const auto& attribute : flowFiles[row]->getAttributes()) {
+      const auto index = argumentIndex(attribute.first);
+      if (index == 0 || index > placeholders_) {
+        continue;
+      }
+      parameters[index - 1][row] = attribute.second;
+      indicators[index - 1][row] = soci::i_ok;
+    }
+  }
+
+  const auto dbSession = connection_->getSession();
+
+  try {
+    dbSession->begin();
+    if (parameters.empty()) {
+      for (size_t row = 0; row < flowFiles.size(); row++) {
+        dbSession->execute(parameterizedStatement_);
+      }
+    } else {
+      dbSession->executeBatch(parameterizedStatement_, parameters, indicators);
+    }
+    dbSession->commit();
+  } catch (std::exception& e) {
+    dbSession->rollback();
+    // the flow files are tried again later, rather than routed to failure, when the failure is not caused by them
+    std::string exception;
+    if (connection_->isTransient(e) || !connection_->connected(exception)) {
+      throw minifi::Exception(PROCESSOR_EXCEPTION, std::string("PutSQL: ") + e.what());
+    }
+    error = e.what();
+    return false;
+  }
+  return true;
+}
+
 } /* namespace processors */
 } /* namespace minifi */
 } /* namespace nifi */
@@ -51,11 +51,24 @@ class PutSQL: public SQLProcessor<PutSQL> {
   void initialize() override;
 
   static const core::Property s_sqlStatements;
+  static const core::Property s_parameterizedStatement;
+  static const core::Property s_batchSize;
 
   static const core::Relationship s_success;
+  static const core::Relationship s_failure;
+
+ private:
+   void processBatch(core::ProcessSession &session);
+
+   // Inserts the flow files in a single transaction, which is rolled back on failure.
+   // Throws if the failure is transient or the connection is lost, so that the flow files are retried.
+   bool insert(const std::vector<std::shared_ptr<core::FlowFile>>& flowFiles, std::string& error);
 
  private:
    std::vector<std::string> sqlStatements_;
+   std::string parameterizedStatement_;
+   int batchSize_{};
+   size_t placeholders_{};
 };
 
 REGISTER_RESOURCE(PutSQL, "PutSQL to execute SQL command via ODBC.");
@@ -41,7 +41,6 @@
 #include "Exception.h"
 #include "utils/OsUtils.h"
 #include "data/DatabaseConnectors.h"
-#include "data/JSONSQLWriter.h"
 #include "data/SQLRowsetProcessor.h"
 #include "data/WriteCallback.h"
 #include "data/MaxCollector.h"
@@ -331,29 +330,22 @@ void QueryDatabaseTable::processOnTrigger(core::ProcessSession& session) {
 
   auto rowset = statement->execute();
 
-  int count = 0;
-  size_t rowCount = 0;
   sql::MaxCollector maxCollector(selectQuery, maxValueColumnNames_, mapState_);
-  sql::JSONSQLWriter sqlWriter(isJSONPretty());
-  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, {&sqlWriter, &maxCollector});
-
-  // Process rowset.
-  do {
-    rowCount = sqlRowsetProcessor.process(maxRowsPerFlowFile_ == 0 ? std::numeric_limits<size_t>::max() : maxRowsPerFlowFile_);
-    count++;
-    if (rowCount == 0)
-      break;
-
-    const auto output = sqlWriter.toString();
-    if (!output.empty()) {
-      WriteCallback writer(output);
-      auto newflow = session.create();
-      newflow->addAttribute(ResultRowCount, std::to_string(rowCount));
-      newflow->addAttribute(ResultTableName, tableName_);
-      session.write(newflow, &writer);
-      session.transfer(newflow, s_success);
+  auto sqlWriter = createSQLWriter();
+  sql::SQLRowsetProcessor sqlRowsetProcessor(rowset, {sqlWriter.get(), &maxCollector});
+
+  // Process rowset, the rows are written to the flow files as they are fetched.
+  while (sqlRowsetProcessor.hasMoreRows()) {
+    WriteCallback writer(sqlRowsetProcessor, *sqlWriter, maxRowsPerFlowFile_ == 0 ? std::numeric_limits<size_t>::max() : maxRowsPerFlowFile_);
+    auto newflow = session.create();
+    session.write(newflow, &writer);
+    if (!writer) {
+      throw minifi::Exception(PROCESSOR_EXCEPTION, "QueryDatabaseTable: failed to write the result rows.");
     }
-  } while (rowCount > 0);
+    newflow->addAttribute(ResultRowCount, std::to_string(writer.getRowCount()));
+    newflow->addAttribute(ResultTableName, tableName_);
+    session.transfer(newflow, s_success);
+  }
 
   const auto mapState = mapState_;
   if (maxCollector.updateMapState()) {
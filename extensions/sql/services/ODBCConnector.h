@@ -70,6 +70,17 @@ class ODBCConnection : public sql::Connection {
     return std::make_unique<sql::Session>(*session_);
   }
 
+  bool isTransient(const std::exception& error) const override {
+    const auto odbcError = dynamic_cast<const soci::odbc_soci_error*>(&error);
+    if (!odbcError) {
+      return false;
+    }
+    // SQLSTATE classes 08 (connection exception) and 40 (transaction rollback, e.g. deadlock or serialization failure),
+    // and the timeouts HYT00 and HYT01
+    const std::string state(reinterpret_cast<const char*>(odbcError->odbc_error_code()));
+    return state.compare(0, 2, "08") == 0 || state.compare(0, 2, "40") == 0 || state == "HYT00" || state == "HYT01";
+  }
+
  private:
    soci::connection_parameters getSessionParameters() const {
      static const soci::backend_factory &backEnd = *soci::factory_odbc();
@@ -0,0 +1,226 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <soci/soci.h>
+#include <soci/odbc/soci-odbc.h>
+
+#include "../../../libminifi/test/TestBase.h"
+#include "processors/PutSQL.h"
+#include "services/ODBCConnector.h"
+
+namespace {
+
+/**
+ * Runs PutSQL against a SQLite database through the SQLite ODBC driver, feeding it flow files through
+ * an incoming connection and collecting them from connections for its success and failure relationships.
+ */
+class PutSQLTestController {
+ public:
+  PutSQLTestController() {
+    LogTestController::getInstance().setDebug<processors::PutSQL>();
+    char format[] = "/tmp/putsql.XXXXXX";
+    connection_string_ = "Driver=libsqlite3odbc.so;Database=" + test_controller_.createTempDirectory(format) + "/test.db";
+    database_ = std::make_unique<soci::session>(*soci::factory_odbc(), connection_string_);
+    *database_ << "CREATE TABLE test_table (id INTEGER NOT NULL CHECK (id > 0), name TEXT)";
+
+    plan_ = test_controller_.createPlan();
+    auto service = plan_->addController("ODBCService", "ODBCService");
+    plan_->setProperty(service, minifi::sql::controllers::DatabaseService::ConnectionString.getName(), connection_string_);
+    // the final connection TestPlan adds carries a relationship PutSQL does not have
+    put_ = plan_->addProcessor("PutSQL", "PutSQL", core::Relationship("unused", ""));
+    plan_->setProperty(put_, "DB Controller Service", "ODBCService");
+
+    input_ = connect(nullptr, put_, core::Relationship("success", ""));
+    success_ = connect(put_, nullptr, processors::PutSQL::s_success);
+    failure_ = connect(put_, nullptr, processors::PutSQL::s_failure);
+  }
+
+  ~PutSQLTestController() {
+    LogTestController::getInstance().reset();
+  }
+
+  std::shared_ptr<TestPlan> plan() const {
+    return plan_;
+  }
+
+  std::shared_ptr<core::Processor> putSQL() const {
+    return put_;
+  }
+
+  std::shared_ptr<core::FlowFile> enqueue(const std::map<std::string, std::string>& attributes) {
+    std::shared_ptr<core::FlowFile> flowFile = std::make_shared<minifi::FlowFileRecord>(plan_->getFlowRepo(), plan_->getContentRepo(), attributes);
+    input_->put(flowFile);
+    return flowFile;
+  }
+
+  void trigger() {
+    if (triggered_) {
+      plan_->runCurrentProcessor();
+    } else {
+      plan_->runNextProcessor();
+      triggered_ = true;
+    }
+  }
+
+  // UUIDs of the flow files routed to the relationship
+  std::set<std::string> routed(const core::Relationship& relationship) const {
+    const auto& connection = relationship.getName() == processors::PutSQL::s_success.getName() ? success_ : failure_;
+    std::set<std::string> uuids;
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    while (const auto flowFile = connection->poll(expired)) {
+      uuids.insert(flowFile->getUUIDStr());
+    }
+    return uuids;
+  }
+
+  int count(const std::string& condition) const {
+    int count = 0;
+    *database_ << "SELECT COUNT(*) FROM test_table WHERE " + condition, soci::into(count);
+    return count;
+  }
+
+ private:
+  std::shared_ptr<minifi::Connection> connect(const std::shared_ptr<core::Processor>& source, const std::shared_ptr<core::Processor>& destination,
+                                              const core::Relationship& relationship) {
+    auto connection = std::make_shared<minifi::Connection>(plan_->getFlowRepo(), plan_->getContentRepo(), relationship.getName());
+    connection->addRelationship(relationship);
+    utils::Identifier uuid;
+    if (source) {
+      connection->setSource(source);
+      source->getUUID(uuid);
+      connection->setSourceUUID(uuid);
+      source->addConnection(connection);
+    }
+    if (destination) {
+      connection->setDestination(destination);
+      destination->getUUID(uuid);
+      connection->setDestinationUUID(uuid);
+      destination->addConnection(connection);
+    }
+    return connection;
+  }
+
+  TestController test_controller_;
+  std::string connection_string_;
+  std::unique_ptr<soci::session> database_;
+  std::shared_ptr<TestPlan> plan_;
+  std::shared_ptr<core::Processor> put_;
+  std::shared_ptr<minifi::Connection> input_;
+  std::shared_ptr<minifi::Connection> success_;
+  std::shared_ptr<minifi::Connection> failure_;
+  bool triggered_ = false;
+};
+
+std::map<std::string, std::string> arguments(const std::string& id, const std::string& name) {
+  return { { "sql.args.1.value", id }, { "sql.args.2.value", name } };
+}
+
+}  // namespace
+
+TEST_CASE("PutSQL inserts a batch of flow files in one transaction", "[putsql]") {
+  PutSQLTestController controller;
+  controller.plan()->setProperty(controller.putSQL(), processors::PutSQL::s_parameterizedStatement.getName(), "INSERT INTO test_table (id, name) VALUES (?, ?)");
+  controller.plan()->setProperty(controller.putSQL(), processors::PutSQL::s_batchSize.getName(), "10");
+
+  std::set<std::string> expected;
+  for (int id = 1; id <= 3; id++) {
+    expected.insert(controller.enqueue(arguments(std::to_string(id), "name " + std::to_string(id)))->getUUIDStr());
+  }
+  controller.trigger();
+
+  REQUIRE(LogTestController::getInstance().contains("inserted a batch of 3 flow files"));
+  REQUIRE(expected == controller.routed(processors::PutSQL::s_success));
+  REQUIRE(controller.routed(processors::PutSQL::s_failure).empty());
+  REQUIRE(3 == controller.count("name LIKE 'name %'"));
+  REQUIRE(1 == controller.count("id = 2 AND name = 'name 2'"));
+}
+
+TEST_CASE("PutSQL binds a missing argument as NULL", "[putsql]") {
+  PutSQLTestController controller;
+  controller.plan()->setProperty(controller.putSQL(), processors::PutSQL::s_parameterizedStatement.getName(), "INSERT INTO test_table (id, name) VALUES (?, ?)");
+
+  controller.enqueue({ { "sql.args.1.value", "7" } });
+  controller.enqueue(arguments("8", "eight"));
+  controller.trigger();
+
+  REQUIRE(2 == controller.routed(processors::PutSQL::s_success).size());
+  REQUIRE(1 == controller.count("id = 7 AND name IS NULL"));
+  REQUIRE(1 == controller.count("id = 8 AND name = 'eight'"));
+}
+
+TEST_CASE("PutSQL routes the rows the database refuses to failure", "[putsql]") {
+  PutSQLTestController controller;
+  controller.plan()->setProperty(controller.putSQL(), processors::PutSQL::s_parameterizedStatement.getName(), "INSERT INTO test_table (id, name) VALUES (?, ?)");
+
+  const auto first = controller.enqueue(arguments("1", "first"))->getUUIDStr();
+  // violates the check constraint of the table
+  const auto refused = controller.enqueue(arguments("-1", "refused"))->getUUIDStr();
+  const auto last = controller.enqueue(arguments("3", "last"))->getUUIDStr();
+  controller.trigger();
+
+  const std::set<std::string> inserted{ first, last };
+  REQUIRE(inserted == controller.routed(processors::PutSQL::s_success));
+  const std::set<std::string> failed{ refused };
+  REQUIRE(failed == controller.routed(processors::PutSQL::s_failure));
+  REQUIRE(2 == controller.count("1 = 1"));
+  REQUIRE(0 == controller.count("name = 'refused'"));
+}
+
+TEST_CASE("PutSQL routes flow files with more arguments than placeholders to failure", "[putsql]") {
+  PutSQLTestController controller;
+  controller.plan()->setProperty(controller.putSQL(), processors::PutSQL::s_parameterizedStatement.getName(), "INSERT INTO test_table (id, name) VALUES (?, '?')");
+
+  const auto bound = controller.enqueue({ { "sql.args.1.value", "1" } })->getUUIDStr();
+  const auto extra = controller.enqueue(arguments("2", "two"))->getUUIDStr();
+  // neither allocates nor wraps around
+  const auto huge = controller.enqueue({ { "sql.args.1.value", "3" }, { "sql.args.2000000000.value", "huge" } })->getUUIDStr();
+  const auto wrapped = controller.enqueue({ { "sql.args.1.value", "4" }, { "sql.args.4294967297.value", "wrapped" } })->getUUIDStr();
+  controller.trigger();
+
+  REQUIRE(LogTestController::getInstance().contains("has the argument sql.args.2.value, but the statement has 1 placeholders"));
+  const std::set<std::string> inserted{ bound };
+  REQUIRE(inserted == controller.routed(processors::PutSQL::s_success));
+  const std::set<std::string> failed{ extra, huge, wrapped };
+  REQUIRE(failed == controller.routed(processors::PutSQL::s_failure));
+  REQUIRE(1 == controller.count("id = 1 AND name = '?'"));
+  REQUIRE(1 == controller.count("1 = 1"));
+}
+
+TEST_CASE("PutSQL executes the SQL statements without a parameterized statement", "[putsql]") {
+  PutSQLTestController controller;
+  controller.plan()->setProperty(controller.putSQL(), processors::PutSQL::s_sqlStatements.getName(),
+                                 "INSERT INTO test_table (id, name) VALUES (1, 'one');INSERT INTO test_table (id, name) VALUES (2, 'two')");
+
+  controller.enqueue(arguments("5", "five"));
+  controller.trigger();
+
+  // the statements do not depend on flow files, which are left in the queue
+  REQUIRE(2 == controller.count("1 = 1"));
+  REQUIRE(1 == controller.count("id = 2 AND name = 'two'"));
+  REQUIRE(controller.routed(processors::PutSQL::s_success).empty());
+  REQUIRE(controller.routed(processors::PutSQL::s_failure).empty());
+
+  controller.trigger();
+  REQUIRE(4 == controller.count("1 = 1"));
+}
@@ -0,0 +1,217 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../../libminifi/test/TestBase.h"
+#include "rapidjson/document.h"
+#include "data/CSVSQLWriter.h"
+#include "data/JSONSQLWriter.h"
+#include "data/SQLWriter.h"
+
+namespace {
+
+std::string contentOf(const std::shared_ptr<minifi::io::BaseStream> &stream) {
+  return std::string(reinterpret_cast<const char*>(stream->getBuffer()), stream->getSize());
+}
+
+// passes the rows the way SQLRowsetProcessor does, with the column names along with the first row of a flow file
+void writeRow(minifi::sql::SQLRowSubscriber &writer, bool first, int id, const std::string &name) {
+  writer.beginProcessRow();
+  if (first) {
+    writer.processColumnName("id");
+    writer.processColumnName("name");
+  }
+  writer.processColumn("id", id);
+  writer.processColumn("name", name);
+  writer.endProcessRow();
+}
+
+// records the size of every write
+class RecordingStream : public minifi::io::BaseStream {
+ public:
+  int writeData(uint8_t *value, int size) override {
+    writes.push_back(size);
+    return minifi::io::BaseStream::writeData(value, size);
+  }
+
+  std::vector<int> writes;
+};
+
+class FailingStream : public minifi::io::BaseStream {
+ public:
+  int writeData(uint8_t *value, int size) override {
+    return -1;
+  }
+};
+
+}  // namespace
+
+TEST_CASE("CSVSQLWriter escapes fields as RFC 4180 requires", "[sqlwriter]") {
+  minifi::sql::CSVSQLWriter csv;
+  minifi::sql::SQLWriter &writer = csv;
+  auto stream = std::make_shared<minifi::io::BaseStream>();
+  writer.beginStream(stream);
+  writer.beginProcessRow();
+  writer.processColumnName("plain");
+  writer.processColumnName("comma, name");
+  writer.processColumnName("quote");
+  writer.processColumnName("lines");
+  writer.processColumnName("nothing");
+  writer.processColumn("plain", std::string("value"));
+  writer.processColumn("comma, name", std::string("a,b"));
+  writer.processColumn("quote", std::string("say \"hi\""));
+  writer.processColumn("lines", std::string("one\r\ntwo"));
+  writer.processColumn("nothing", "NULL");
+  writer.endProcessRow();
+  const auto written = writer.endStream();
+
+  const std::string expected = "plain,\"comma, name\",quote,lines,nothing\n"
+      "value,\"a,b\",\"say \"\"hi\"\"\",\"one\r\ntwo\",\n";
+  REQUIRE(expected == contentOf(stream));
+  REQUIRE(static_cast<int64_t>(expected.size()) == written);
+}
+
+TEST_CASE("CSVSQLWriter writes numbers without quotes", "[sqlwriter]") {
+  minifi::sql::CSVSQLWriter csv;
+  minifi::sql::SQLWriter &writer = csv;
+  auto stream = std::make_shared<minifi::io::BaseStream>();
+  writer.beginStream(stream);
+  writer.beginProcessRow();
+  writer.processColumnName("d");
+  writer.processColumnName("i");
+  writer.processColumnName("ll");
+  writer.processColumnName("ull");
+  writer.processColumn("d", 1.5);
+  writer.processColumn("i", -7);
+  writer.processColumn("ll", -5000000000LL);
+  writer.processColumn("ull", 18446744073709551615ULL);
+  writer.endProcessRow();
+  writer.endStream();
+
+  REQUIRE("d,i,ll,ull\n1.5,-7,-5000000000,18446744073709551615\n" == contentOf(stream));
+}
+
+TEST_CASE("CSVSQLWriter starts every flow file with a header", "[sqlwriter]") {
+  minifi::sql::CSVSQLWriter csv;
+  minifi::sql::SQLWriter &writer = csv;
+
+  auto first = std::make_shared<minifi::io::BaseStream>();
+  writer.beginStream(first);
+  writeRow(writer, true, 1, "a");
+  writeRow(writer, false, 2, "b");
+  REQUIRE(writer.endStream() > 0);
+
+  auto second = std::make_shared<minifi::io::BaseStream>();
+  writer.beginStream(second);
+  writeRow(writer, true, 3, "c");
+  REQUIRE(writer.endStream() > 0);
+
+  REQUIRE("id,name\n1,a\n2,b\n" == contentOf(first));
+  REQUIRE("id,name\n3,c\n" == contentOf(second));
+}
+
+TEST_CASE("JSONSQLWriter writes an array per flow file", "[sqlwriter]") {
+  minifi::sql::JSONSQLWriter json(false);
+  minifi::sql::SQLWriter &writer = json;
+
+  auto first = std::make_shared<minifi::io::BaseStream>();
+  writer.beginStream(first);
+  writeRow(writer, true, 1, "a");
+  writeRow(writer, false, 2, "b\"");
+  const auto written = writer.endStream();
+
+  auto second = std::make_shared<minifi::io::BaseStream>();
+  writer.beginStream(second);
+  writeRow(writer, true, 3, "c");
+  writer.endStream();
+
+  auto empty = std::make_shared<minifi::io::BaseStream>();
+  writer.beginStream(empty);
+  writer.endStream();
+
+  REQUIRE("[{\"id\":1,\"name\":\"a\"},{\"id\":2,\"name\":\"b\\\"\"}]" == contentOf(first));
+  REQUIRE(static_cast<int64_t>(contentOf(first).size()) == written);
+  REQUIRE("[{\"id\":3,\"name\":\"c\"}]" == contentOf(second));
+  REQUIRE("[]" == contentOf(empty));
+}
+
+TEST_CASE("JSONSQLWriter writes pretty arrays per flow file", "[sqlwriter]") {
+  minifi::sql::JSONSQLWriter json(true);
+  minifi::sql::SQLWriter &writer = json;
+
+  for (int flow_file = 0; flow_file < 3; flow_file++) {
+    auto stream = std::make_shared<minifi::io::BaseStream>();
+    writer.beginStream(stream);
+    writeRow(writer, true, flow_file, "a");
+    writeRow(writer, false, flow_file + 1, "b");
+    REQUIRE(writer.endStream() > 0);
+
+    const auto content = contentOf(stream);
+    REQUIRE("[\n    {\n        \"id\": " + std::to_string(flow_file) + ",\n        \"name\": \"a\"\n    },\n" == content.substr(0, content.find("    {", 6)));
+    rapidjson::Document document;
+    document.Parse(content.c_str());
+    REQUIRE_FALSE(document.HasParseError());
+    REQUIRE(document.IsArray());
+    REQUIRE(2 == document.Size());
+    REQUIRE(flow_file + 1 == document[1]["id"].GetInt());
+    REQUIRE(std::string("b") == document[1]["name"].GetString());
+  }
+}
+
+TEST_CASE("SQLStreamBuffer passes the content to the stream in blocks", "[sqlwriter]") {
+  auto stream = std::make_shared<RecordingStream>();
+  minifi::sql::SQLStreamBuffer buffer(4);
+  buffer.reset(stream);
+  buffer.write("ab");
+  buffer.write("cd");
+  REQUIRE(stream->writes.empty());
+  // does not fit the buffer, so it is written after the buffered characters
+  buffer.write("efghij");
+  buffer.Put('k');
+  buffer.Flush();
+
+  REQUIRE((std::vector<int>{4, 6, 1}) == stream->writes);
+  REQUIRE("abcdefghijk" == contentOf(stream));
+  REQUIRE(11 == buffer.getWritten());
+
+  auto next = std::make_shared<RecordingStream>();
+  buffer.reset(next);
+  REQUIRE(0 == buffer.getWritten());
+  buffer.Put('x');
+  buffer.Flush();
+  REQUIRE("x" == contentOf(next));
+}
+
+TEST_CASE("SQLWriters report failed streams", "[sqlwriter]") {
+  minifi::sql::CSVSQLWriter csv;
+  minifi::sql::JSONSQLWriter json(false);
+  for (minifi::sql::SQLWriter *writer : std::vector<minifi::sql::SQLWriter*>{&csv, &json}) {
+    writer->beginStream(std::make_shared<FailingStream>());
+    writeRow(*writer, true, 1, "a");
+    REQUIRE(-1 == writer->endStream());
+
+    // a failed flow file does not affect the next one
+    auto stream = std::make_shared<minifi::io::BaseStream>();
+    writer->beginStream(stream);
+    writeRow(*writer, true, 2, "b");
+    REQUIRE(static_cast<int64_t>(stream->getSize()) == writer->endStream());
+  }
+}
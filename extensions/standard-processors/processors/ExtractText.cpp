@@ -17,7 +17,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <memory>
 #include <set>
@@ -40,7 +42,6 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
-#define MAX_BUFFER_SIZE 4096
 #define MAX_CAPTURE_GROUP_SIZE 1024
 
 core::Property ExtractText::Attribute(core::PropertyBuilder::createProperty("Attribute")->withDescription("Attribute to set from content")->build());
@@ -112,8 +113,6 @@ void ExtractText::onTrigger(core::ProcessContext *context, core::ProcessSession
 }
 
 int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> stream) {
-  int64_t ret = 0;
-  uint64_t read_size = 0;
   bool regex_mode;
   uint64_t size_limit = flowFile_->getSize();
 
@@ -127,11 +126,12 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
   else if (sizeLimitStr != "0")
     size_limit = std::stoi(sizeLimitStr);
 
-  std::ostringstream contentStream;
+  // Don't read more than config limit, the content is read directly into the string it is matched in
+  std::string contentStr(std::min<uint64_t>(size_limit, flowFile_->getSize()), '\0');
+  uint64_t read_size = 0;
 
-  while (read_size < size_limit) {
-    // Don't read more than config limit or the size of the buffer
-    ret = stream->readData(buffer_, std::min<uint64_t>(size_limit - read_size, buffer_.size()));
+  while (read_size < contentStr.size()) {
+    const int ret = stream->readData(reinterpret_cast<uint8_t*>(&contentStr[read_size]), static_cast<int>(std::min<uint64_t>(contentStr.size() - read_size, std::numeric_limits<int>::max())));
 
     if (ret < 0) {
       return -1;  // Stream error
@@ -139,12 +139,9 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
       break;  // End of stream, no more data
     }
 
-    contentStream.write(reinterpret_cast<const char*>(buffer_.data()), ret);
     read_size += ret;
-    if (contentStream.fail()) {
-      return -1;
-    }
   }
+  contentStr.resize(read_size);
 
   if (regex_mode) {
     std::vector<utils::Regex::Mode> rgx_mode;
@@ -163,21 +160,20 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
     int maxCaptureSize;
     ctx_->getProperty(MaxCaptureGroupLen.getName(), maxCaptureSize);
 
-    std::string contentStr = contentStream.str();
-
     std::map<std::string, std::string> regexAttributes;
 
     for (const auto& k : ctx_->getDynamicPropertyKeys()) {
       std::string value;
       ctx_->getDynamicProperty(k, value);
 
-      std::string workStr = contentStr;
+      // the suffix of the last match, it is only replaced by the next match
+      const std::string *workStr = &contentStr;
 
       int matchcount = 0;
 
       try {
         utils::Regex rgx(value, rgx_mode);
-        while (rgx.match(workStr)) {
+        while (rgx.match(*workStr)) {
           const std::vector<std::string> &matches = rgx.getResult();
           size_t i = ignoregroupzero ? 1 : 0;
 
@@ -194,7 +190,7 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
           if (!repeatingcapture) {
             break;
           }
-          workStr = rgx.getSuffix();
+          workStr = &rgx.getSuffix();
         }
       } catch (const Exception &e) {
         logger_->log_error("%s error encountered when trying to construct regular expression from property (key: %s) value: %s",
@@ -207,7 +203,7 @@ int64_t ExtractText::ReadCallback::process(std::shared_ptr<io::BaseStream> strea
       flowFile_->setAttribute(kv.first, kv.second);
     }
   } else {
-    flowFile_->setAttribute(attrKey, contentStream.str());
+    flowFile_->setAttribute(attrKey, contentStr);
   }
   return read_size;
 }
@@ -216,7 +212,6 @@ ExtractText::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile
     : flowFile_(std::move(flowFile)),
       ctx_(ctx),
       logger_(std::move(lgr)) {
-  buffer_.resize(std::min<uint64_t>(flowFile_->getSize(), MAX_BUFFER_SIZE));
 }
 
 } /* namespace processors */
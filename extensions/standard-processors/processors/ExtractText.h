@@ -80,7 +80,6 @@ public:
     private:
         std::shared_ptr<core::FlowFile> flowFile_;
         core::ProcessContext *ctx_;
-        std::vector<uint8_t> buffer_;
         std::shared_ptr<logging::Logger> logger_;
     };
 
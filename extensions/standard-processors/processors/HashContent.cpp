@@ -88,25 +88,32 @@ void HashContent::onTrigger(core::ProcessContext *, core::ProcessSession *sessio
   logger_->log_trace("attempting read");
   ReadCallback cb(flowFile, *this);
   session->read(flowFile, &cb);
+  cb.finish();
   session->transfer(flowFile, Success);
 }
 
-int64_t HashContent::ReadCallback::process(std::shared_ptr<io::BaseStream> stream) {
-  // This throws in case algo is not found, but that's fine
-  parent_.logger_->log_trace("Searching for %s", parent_.algoName_);
-  auto algo = HashAlgos.at(parent_.algoName_);
-
-  const auto& ret_val = algo(stream);
-
-  flowFile_->setAttribute(parent_.attrKey_, ret_val.first);
+int64_t HashContent::ReadCallback::process(const uint8_t *data, uint64_t size) {
+  read_ = true;
+  if (size > 0) {
+    hasher_->update(data, size);
+    read_size_ += size;
+  }
+  return size;
+}
 
-  return ret_val.second;
+void HashContent::ReadCallback::finish() {
+  if (read_) {
+    flowFile_->setAttribute(parent_.attrKey_, read_size_ > 0 ? hasher_->digest() : "");
+  }
 }
 
 HashContent::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, const HashContent& parent)
   : flowFile_(flowFile),
-    parent_(parent)
-  {}
+    parent_(parent) {
+  // This throws in case algo is not found, but that's fine
+  parent_.logger_->log_trace("Searching for %s", parent_.algoName_);
+  hasher_ = HashAlgos.at(parent_.algoName_)();
+}
 
 } /* namespace processors */
 } /* namespace minifi */
@@ -40,81 +40,44 @@
 #include "io/BaseStream.h"
 #include "utils/StringUtils.h"
 
-using HashReturnType = std::pair<std::string, int64_t>;
-
 namespace {
-#define HASH_BUFFER_SIZE 16384
-
-  HashReturnType MD5Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
-    HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
-    MD5_CTX context;
-    MD5_Init(&context);
-
-    size_t ret = 0;
-    do {
-      ret = stream->readData(buffer, HASH_BUFFER_SIZE);
-      if(ret > 0) {
-        MD5_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while(ret > 0);
-
-    if (ret_val.second > 0) {
-      unsigned char digest[MD5_DIGEST_LENGTH];
-      MD5_Final(digest, &context);
-      ret_val.first = utils::StringUtils::to_hex(digest, MD5_DIGEST_LENGTH, true /*uppercase*/);
+  // hashes content piece by piece, as it is handed to an InputBufferCallback
+  class Hasher {
+   public:
+    virtual ~Hasher() = default;
+    virtual void update(const uint8_t *data, uint64_t size) = 0;
+    // uppercase hex digest of the pieces so far
+    virtual std::string digest() = 0;
+  };
+
+  template<typename Context, int Init(Context*), int Update(Context*, const void*, size_t), int Final(unsigned char*, Context*), size_t DigestLength>
+  class DigestHasher : public Hasher {
+   public:
+    DigestHasher() {
+      Init(&context_);
     }
-    return ret_val;
-  }
 
-  HashReturnType SHA1Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
-    HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
-    SHA_CTX context;
-    SHA1_Init(&context);
-
-    size_t ret = 0;
-    do {
-      ret = stream->readData(buffer, HASH_BUFFER_SIZE);
-      if(ret > 0) {
-        SHA1_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while(ret > 0);
-
-    if (ret_val.second > 0) {
-      unsigned char digest[SHA_DIGEST_LENGTH];
-      SHA1_Final(digest, &context);
-      ret_val.first = utils::StringUtils::to_hex(digest, SHA_DIGEST_LENGTH, true /*uppercase*/);
+    void update(const uint8_t *data, uint64_t size) override {
+      Update(&context_, data, size);
     }
-    return ret_val;
-  }
 
-  HashReturnType SHA256Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
-    HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
-    SHA256_CTX context;
-    SHA256_Init(&context);
-
-    size_t ret ;
-    do {
-      ret = stream->readData(buffer, HASH_BUFFER_SIZE);
-      if(ret > 0) {
-        SHA256_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while(ret > 0);
-
-    if (ret_val.second > 0) {
-      unsigned char digest[SHA256_DIGEST_LENGTH];
-      SHA256_Final(digest, &context);
-      ret_val.first = utils::StringUtils::to_hex(digest, SHA256_DIGEST_LENGTH, true /*uppercase*/);
+    std::string digest() override {
+      unsigned char digest[DigestLength];
+      Final(digest, &context_);
+      return utils::StringUtils::to_hex(digest, DigestLength, true /*uppercase*/);
     }
-    return ret_val;
+
+   private:
+    Context context_;
+  };
+
+  using MD5Hasher = DigestHasher<MD5_CTX, MD5_Init, MD5_Update, MD5_Final, MD5_DIGEST_LENGTH>;
+  using SHA1Hasher = DigestHasher<SHA_CTX, SHA1_Init, SHA1_Update, SHA1_Final, SHA_DIGEST_LENGTH>;
+  using SHA256Hasher = DigestHasher<SHA256_CTX, SHA256_Init, SHA256_Update, SHA256_Final, SHA256_DIGEST_LENGTH>;
+
+  template<typename T>
+  std::unique_ptr<Hasher> createHasher() {
+    return std::unique_ptr<Hasher>(new T());
   }
 }
 
@@ -125,8 +88,8 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
-static const std::map<std::string, const std::function<HashReturnType(const std::shared_ptr<io::BaseStream>&)>> HashAlgos =
-  { {"MD5",  MD5Hash}, {"SHA1", SHA1Hash}, {"SHA256", SHA256Hash} };
+static const std::map<std::string, const std::function<std::unique_ptr<Hasher>()>> HashAlgos =
+  { {"MD5",  createHasher<MD5Hasher>}, {"SHA1", createHasher<SHA1Hasher>}, {"SHA256", createHasher<SHA256Hasher>} };
 
 //! HashContent Class
 class HashContent : public core::Processor {
@@ -157,15 +120,21 @@ class HashContent : public core::Processor {
   //! Initialize, over write by NiFi HashContent
   void initialize(void);  // override
 
-  class ReadCallback : public InputStreamCallback {
+  // hashes the pieces of the content, see ProcessSession::read(const std::shared_ptr<core::FlowFile>&, InputBufferCallback*)
+  class ReadCallback : public InputBufferCallback {
    public:
     ReadCallback(std::shared_ptr<core::FlowFile> flowFile, const HashContent& parent);
     ~ReadCallback() {}
-    int64_t process(std::shared_ptr<io::BaseStream> stream);
+    int64_t process(const uint8_t *data, uint64_t size);
+    // sets the hash attribute once all pieces are read
+    void finish();
 
    private:
     std::shared_ptr<core::FlowFile> flowFile_;
     const HashContent& parent_;
+    std::unique_ptr<Hasher> hasher_;
+    bool read_ = false;
+    uint64_t read_size_ = 0;
    };
 
  protected:
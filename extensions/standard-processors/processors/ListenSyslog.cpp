@@ -19,11 +19,12 @@
  */
 #include "ListenSyslog.h"
 #include <stdio.h>
+#include <string.h>
 #include <memory>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <set>
-#include <queue>
 #include "utils/TimeUtil.h"
 #include "utils/StringUtils.h"
 #include "core/ProcessContext.h"
@@ -49,7 +50,17 @@ core::Property ListenSyslog::MaxConnections(
         ->withDefaultValue<int>(2)->build());
 
 core::Property ListenSyslog::MaxBatchSize(
-    core::PropertyBuilder::createProperty("Max Batch Size")->withDescription("The maximum number of Syslog events to add to a single FlowFile.")->withDefaultValue<int>(1)->build());
+    core::PropertyBuilder::createProperty("Max Batch Size")->withDescription("The maximum number of Syslog events to add to a single FlowFile. "
+                                                                             "If set to 0, all the queued events are added to a single FlowFile.")->withDefaultValue<int>(1)->build());
+
+core::Property ListenSyslog::MaxQueueSize(
+    core::PropertyBuilder::createProperty("Max Size of Message Queue")->withDescription("The maximum number of Syslog events that can be held in memory before they are "
+                                                                                        "written to FlowFiles. Events received while the queue is full are dropped.")
+        ->withDefaultValue<int>(10000)->build());
+
+core::Property ListenSyslog::Receivers(
+    core::PropertyBuilder::createProperty("Number of Receivers")->withDescription("The number of sockets receiving Syslog messages in UDP mode. They are bound to the same port, "
+                                                                                  "so that the operating system can spread the datagrams over them.")->withDefaultValue<int>(1)->build());
 
 core::Property ListenSyslog::MessageDelimiter(
     core::PropertyBuilder::createProperty("Message Delimiter")->withDescription("Specifies the delimiter to place between Syslog messages when multiple "
@@ -76,6 +87,8 @@ void ListenSyslog::initialize() {
   properties.insert(MaxSocketBufSize);
   properties.insert(MaxConnections);
   properties.insert(MaxBatchSize);
+  properties.insert(MaxQueueSize);
+  properties.insert(Receivers);
   properties.insert(MessageDelimiter);
   properties.insert(ParseMessages);
   properties.insert(Protocol);
@@ -88,164 +101,244 @@ void ListenSyslog::initialize() {
   setSupportedRelationships(relationships);
 }
 
-void ListenSyslog::startSocketThread() {
-  if (_thread != NULL)
+void ListenSyslog::startListening() {
+  if (nullptr == reactor_)
+    reactor_ = io::EventReactor::getInstance();
+  if (_protocol != "TCP") {
+    while (_receiverSockets.size() < (uint64_t) _receivers) {
+      if (!addReceiver())
+        return;
+    }
+    return;
+  }
+  if (_serverSocket > 0)
     return;
 
-  logger_->log_trace("ListenSysLog Socket Thread Start");
-  _serverTheadRunning = true;
-  _thread = new std::thread(run, this);
-  _thread->detach();
+  uint16_t portno = _port;
+  struct sockaddr_in serv_addr;
+  int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+  if (sockfd < 0) {
+    logger_->log_error("ListenSysLog Server socket creation failed");
+    return;
+  }
+  bzero(reinterpret_cast<char *>(&serv_addr), sizeof(serv_addr));
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = INADDR_ANY;
+  serv_addr.sin_port = htons(portno);
+  if (bind(sockfd, (struct sockaddr *) &serv_addr, sizeof(serv_addr)) < 0) {
+    logger_->log_error("ListenSysLog Server socket bind failed");
+    close(sockfd);
+    return;
+  }
+  listen(sockfd, 5);
+  io::EventReactor::setNonBlocking(sockfd);
+  {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    _serverSocket = sockfd;
+  }
+  if (!reactor_->add(sockfd, io::EventReactor::READ, [this](uint32_t) { acceptClients(); })) {
+    logger_->log_error("ListenSysLog Server socket %d could not be registered", sockfd);
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    close(sockfd);
+    _serverSocket = 0;
+    return;
+  }
+  logger_->log_info("ListenSysLog Server socket %d bind OK to port %d", sockfd, portno);
 }
 
-void ListenSyslog::run(ListenSyslog *process) {
-  process->runThread();
+bool ListenSyslog::addReceiver() {
+  uint16_t portno = _port;
+  struct sockaddr_in serv_addr;
+  int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sockfd < 0) {
+    logger_->log_error("ListenSysLog Server socket creation failed");
+    return false;
+  }
+#ifdef SO_REUSEPORT
+  // the receivers share the port, the datagrams are spread over them by the kernel
+  if (_receivers > 1) {
+    int reuse = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0)
+      logger_->log_warn("ListenSysLog Server socket %d could not share port %d", sockfd, portno);
+  }
+#endif
+  int socketBufSize = _maxSocketBufSize;
+  if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &socketBufSize, sizeof(socketBufSize)) < 0)
+    logger_->log_warn("ListenSysLog Server socket %d buffer size could not be set to %d", sockfd, socketBufSize);
+  bzero(reinterpret_cast<char *>(&serv_addr), sizeof(serv_addr));
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = INADDR_ANY;
+  serv_addr.sin_port = htons(portno);
+  if (bind(sockfd, (struct sockaddr *) &serv_addr, sizeof(serv_addr)) < 0) {
+    logger_->log_error("ListenSysLog Server socket bind failed");
+    close(sockfd);
+    return false;
+  }
+  io::EventReactor::setNonBlocking(sockfd);
+
+  std::unique_ptr<Receiver> receiver(new Receiver());
+  receiver->socket = sockfd;
+  receiver->bufferSize = _recvBufSize;
+  receiver->buffers.resize(LISTEN_SYSLOG_RECEIVE_BATCH * receiver->bufferSize);
+#ifdef __linux__
+  receiver->headers.resize(LISTEN_SYSLOG_RECEIVE_BATCH);
+  receiver->iovecs.resize(LISTEN_SYSLOG_RECEIVE_BATCH);
+  for (int i = 0; i < LISTEN_SYSLOG_RECEIVE_BATCH; i++) {
+    receiver->iovecs[i].iov_base = receiver->buffers.data() + i * receiver->bufferSize;
+    receiver->iovecs[i].iov_len = receiver->bufferSize;
+    bzero(reinterpret_cast<char *>(&receiver->headers[i]), sizeof(struct mmsghdr));
+    receiver->headers[i].msg_hdr.msg_iov = &receiver->iovecs[i];
+    receiver->headers[i].msg_hdr.msg_iovlen = 1;
+  }
+#endif
+  Receiver *handled = receiver.get();
+  {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    _receiverSockets.push_back(std::move(receiver));
+  }
+  if (!reactor_->add(sockfd, io::EventReactor::READ, [this, handled](uint32_t) { receiveDatagrams(handled); })) {
+    logger_->log_error("ListenSysLog Server socket %d could not be registered", sockfd);
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    close(sockfd);
+    _receiverSockets.pop_back();
+    return false;
+  }
+  logger_->log_info("ListenSysLog Server socket %d bind OK to port %d", sockfd, portno);
+  return true;
 }
 
-void ListenSyslog::runThread() {
-  while (_serverTheadRunning) {
-    if (_resetServerSocket) {
-      _resetServerSocket = false;
-      // need to reset the socket
-      std::vector<int>::iterator it;
-      for (it = _clientSockets.begin(); it != _clientSockets.end(); ++it) {
-        int clientSocket = *it;
-        close(clientSocket);
-      }
-      _clientSockets.clear();
-      if (_serverSocket > 0) {
-        close(_serverSocket);
-        _serverSocket = 0;
-      }
+void ListenSyslog::stopListening() {
+  if (nullptr == reactor_)
+    return;
+  // once removed, no more clients are accepted
+  if (_serverSocket > 0)
+    reactor_->remove(_serverSocket);
+  std::vector<int> sockets;
+  {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    for (const auto &client : _clientSockets) {
+      sockets.push_back(client.first);
     }
+    for (const auto &receiver : _receiverSockets) {
+      sockets.push_back(receiver->socket);
+    }
+  }
+  // waits for the handlers receiving from the sockets
+  for (int socket : sockets) {
+    reactor_->remove(socket);
+  }
+  std::lock_guard<std::mutex> lock(socket_mutex_);
+  for (const auto &client : _clientSockets) {
+    close(client.first);
+  }
+  _clientSockets.clear();
+  for (const auto &receiver : _receiverSockets) {
+    logger_->log_debug("ListenSysLog Server socket %d close", receiver->socket);
+    close(receiver->socket);
+  }
+  _receiverSockets.clear();
+  if (_serverSocket > 0) {
+    logger_->log_debug("ListenSysLog Server socket %d close", _serverSocket);
+    close(_serverSocket);
+    _serverSocket = 0;
+  }
+}
 
-    if (_serverSocket <= 0) {
-      uint16_t portno = _port;
-      struct sockaddr_in serv_addr;
-      int sockfd;
-      if (_protocol == "TCP")
-        sockfd = socket(AF_INET, SOCK_STREAM, 0);
-      else
-        sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-      if (sockfd < 0) {
-        logger_->log_error("ListenSysLog Server socket creation failed");
-        break;
+void ListenSyslog::acceptClients() {
+  while (true) {
+    socklen_t clilen;
+    struct sockaddr_in cli_addr;
+    clilen = sizeof(cli_addr);
+    int newsockfd = accept(_serverSocket, reinterpret_cast<struct sockaddr *>(&cli_addr), &clilen);
+    if (newsockfd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        // e.g. out of descriptors, the pending connections are not notified again
+        logger_->log_error("ListenSysLog accept failed: %s", strerror(errno));
+        reactor_->pause(_serverSocket, REACTOR_ACCEPT_RETRY_PERIOD);
       }
-      bzero(reinterpret_cast<char *>(&serv_addr), sizeof(serv_addr));
-      serv_addr.sin_family = AF_INET;
-      serv_addr.sin_addr.s_addr = INADDR_ANY;
-      serv_addr.sin_port = htons(portno);
-      if (bind(sockfd, (struct sockaddr *) &serv_addr, sizeof(serv_addr)) < 0) {
-        logger_->log_error("ListenSysLog Server socket bind failed");
-        break;
-      }
-      if (_protocol == "TCP")
-        listen(sockfd, 5);
-      _serverSocket = sockfd;
-      logger_->log_info("ListenSysLog Server socket %d bind OK to port %d", _serverSocket, portno);
-    }
-    FD_ZERO(&_readfds);
-    FD_SET(_serverSocket, &_readfds);
-    _maxFds = _serverSocket;
-    std::vector<int>::iterator it;
-    for (it = _clientSockets.begin(); it != _clientSockets.end(); ++it) {
-      int clientSocket = *it;
-      if (clientSocket >= _maxFds)
-        _maxFds = clientSocket;
-      FD_SET(clientSocket, &_readfds);
+      return;
     }
-    fd_set fds;
-    struct timeval tv;
-    int retval;
-    fds = _readfds;
-    tv.tv_sec = 0;
-    // 100 msec
-    tv.tv_usec = 100000;
-    retval = select(_maxFds + 1, &fds, NULL, NULL, &tv);
-    if (retval < 0)
-      break;
-    if (retval == 0)
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    if (_clientSockets.size() >= (uint64_t) _maxConnections) {
+      close(newsockfd);
       continue;
-    if (FD_ISSET(_serverSocket, &fds)) {
-      // server socket, either we have UDP datagram or TCP connection request
-      if (_protocol == "TCP") {
-        socklen_t clilen;
-        struct sockaddr_in cli_addr;
-        clilen = sizeof(cli_addr);
-        int newsockfd = accept(_serverSocket, reinterpret_cast<struct sockaddr *>(&cli_addr), &clilen);
-        if (newsockfd > 0) {
-          if (_clientSockets.size() < (uint64_t) _maxConnections) {
-            _clientSockets.push_back(newsockfd);
-            logger_->log_info("ListenSysLog new client socket %d connection", newsockfd);
-            continue;
-          } else {
-            close(newsockfd);
-          }
-        }
-      } else {
-        socklen_t clilen;
-        struct sockaddr_in cli_addr;
-        clilen = sizeof(cli_addr);
-        int recvlen = recvfrom(_serverSocket, _buffer, sizeof(_buffer), 0, (struct sockaddr *) &cli_addr, &clilen);
-        if (recvlen > 0 && (uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
-          uint8_t *payload = new uint8_t[recvlen];
-          memcpy(payload, _buffer, recvlen);
-          putEvent(payload, recvlen);
-        }
-      }
     }
-    it = _clientSockets.begin();
-    while (it != _clientSockets.end()) {
-      int clientSocket = *it;
-      if (FD_ISSET(clientSocket, &fds)) {
-        int recvlen = readline(clientSocket, _buffer, sizeof(_buffer));
-        if (recvlen <= 0) {
-          close(clientSocket);
-          logger_->log_debug("ListenSysLog client socket %d close", clientSocket);
-          it = _clientSockets.erase(it);
-        } else {
-          if ((uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
-            uint8_t *payload = new uint8_t[recvlen];
-            memcpy(payload, _buffer, recvlen);
-            putEvent(payload, recvlen);
-          }
-          ++it;
-        }
-      }
+    io::EventReactor::setNonBlocking(newsockfd);
+    _clientSockets[newsockfd] = "";
+    if (!reactor_->add(newsockfd, io::EventReactor::READ, [this, newsockfd](uint32_t) { receiveLines(newsockfd); })) {
+      _clientSockets.erase(newsockfd);
+      close(newsockfd);
+      continue;
     }
+    logger_->log_info("ListenSysLog new client socket %d connection", newsockfd);
   }
-  return;
 }
 
-int ListenSyslog::readline(int fd, char *bufptr, size_t len) {
-  char *bufx = bufptr;
-  static char *bp;
-  static int cnt = 0;
-  static char b[2048];
-  char c;
+void ListenSyslog::receiveDatagrams(Receiver *receiver) {
+  while (true) {
+#ifdef __linux__
+    // fills as many buffers as there are pending datagrams with a single call
+    int count = recvmmsg(receiver->socket, receiver->headers.data(), LISTEN_SYSLOG_RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
+    if (count < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    for (int i = 0; i < count; i++) {
+      if (receiver->headers[i].msg_len > 0)
+        putEvent(receiver->buffers.data() + i * receiver->bufferSize, receiver->headers[i].msg_len);
+    }
+#else
+    int recvlen = recv(receiver->socket, receiver->buffers.data(), receiver->bufferSize, 0);
+    if (recvlen < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    if (recvlen > 0)
+      putEvent(receiver->buffers.data(), recvlen);
+#endif
+  }
+}
 
-  while (--len > 0) {
-    if (--cnt <= 0) {
-      cnt = recv(fd, b, sizeof(b), 0);
-      if (cnt < 0) {
-        if (errno == EINTR) {
-          len++; /* the while will decrement */
+void ListenSyslog::receiveLines(int clientSocket) {
+  std::string *line;
+  {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    auto client = _clientSockets.find(clientSocket);
+    if (client == _clientSockets.end())
+      return;
+    line = &client->second;
+  }
+  char buffer[2048];
+  while (true) {
+    int recvlen = recv(clientSocket, buffer, sizeof(buffer), 0);
+    if (recvlen < 0 && errno == EINTR)
+      continue;
+    if (recvlen < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      return;
+    if (recvlen <= 0) {
+      reactor_->remove(clientSocket);
+      std::lock_guard<std::mutex> lock(socket_mutex_);
+      _clientSockets.erase(clientSocket);
+      close(clientSocket);
+      logger_->log_debug("ListenSysLog client socket %d close", clientSocket);
+      return;
+    }
+    for (int i = 0; i < recvlen; i++) {
+      // the lines are queued without their \n, lines longer than the receive buffer are split
+      if (buffer[i] != '\n') {
+        line->push_back(buffer[i]);
+        if (line->size() < (uint64_t) _recvBufSize)
           continue;
-        }
-        return -1;
       }
-      if (cnt == 0)
-        return 0;
-      bp = b;
-    }
-    c = *bp++;
-    *bufptr++ = c;
-    if (c == '\n') {
-      *bufptr = '\n';
-      return bufptr - bufx + 1;
+      if (!line->empty())
+        putEvent(line->data(), line->size());
+      line->clear();
     }
   }
-  return -1;
 }
 
 void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
@@ -257,7 +350,10 @@ void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession
     _protocol = value;
   }
   if (context->getProperty(RecvBufSize.getName(), value)) {
+    int64_t oldRecvBufSize = _recvBufSize;
     core::Property::StringToInt(value, _recvBufSize);
+    if (_recvBufSize != oldRecvBufSize)
+      needResetServerSocket = true;
   }
   if (context->getProperty(MaxSocketBufSize.getName(), value)) {
     core::Property::StringToInt(value, _maxSocketBufSize);
@@ -280,42 +376,54 @@ void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession
   if (context->getProperty(MaxBatchSize.getName(), value)) {
     core::Property::StringToInt(value, _maxBatchSize);
   }
+  if (context->getProperty(MaxQueueSize.getName(), value)) {
+    core::Property::StringToInt(value, _maxQueueSize);
+  }
+  if (context->getProperty(Receivers.getName(), value)) {
+    int64_t oldReceivers = _receivers;
+    core::Property::StringToInt(value, _receivers);
+    if (_receivers < 1)
+      _receivers = 1;
+    if (_receivers != oldReceivers)
+      needResetServerSocket = true;
+  }
 
   if (needResetServerSocket)
-    _resetServerSocket = true;
+    stopListening();
+
+  startListening();
 
-  startSocketThread();
+  uint64_t droppedEvents = _droppedEvents.exchange(0);
+  if (droppedEvents > 0)
+    logger_->log_warn("ListenSysLog dropped %llu messages, the queue of %lld messages was full", droppedEvents, _maxQueueSize);
 
-  // read from the event queue
-  if (isEventQueueEmpty()) {
+  // the events received while writing are left to the next trigger
+  size_t availableEvents = _eventQueue.size_approx();
+  if (availableEvents == 0) {
     context->yield();
     return;
   }
-
-  std::queue<SysLogEvent> eventQueue;
-  pollEvent(eventQueue, _maxBatchSize);
-  bool firstEvent = true;
-  std::shared_ptr<FlowFileRecord> flowFile = NULL;
-  while (!eventQueue.empty()) {
-    SysLogEvent event = eventQueue.front();
-    eventQueue.pop();
-    if (firstEvent) {
-      flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-      if (!flowFile)
-        return;
-      ListenSyslog::WriteCallback callback(event.payload, event.len);
-      session->write(flowFile, &callback);
-      delete[] event.payload;
-      firstEvent = false;
-    } else {
-      ListenSyslog::WriteCallback callback(event.payload, event.len);
-      session->append(flowFile, &callback);
-      delete[] event.payload;
+  size_t batchSize = _maxBatchSize > 0 ? (size_t) _maxBatchSize : availableEvents;
+  std::vector<std::string> events(std::min(batchSize, availableEvents));
+  while (availableEvents > 0) {
+    size_t count = _eventQueue.try_dequeue_bulk(events.begin(), std::min(events.size(), availableEvents));
+    if (count == 0)
+      break;
+    availableEvents -= std::min(count, availableEvents);
+    std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
+    if (!flowFile)
+      return;
+    ListenSyslog::WriteCallback callback(events, count, _messageDelimiter);
+    session->write(flowFile, &callback);
+    flowFile->addAttribute("syslog.protocol", _protocol);
+    flowFile->addAttribute("syslog.port", std::to_string(_port));
+    session->transfer(flowFile, Success);
+    // the strings keep their capacity for the next messages received
+    for (size_t i = 0; i < count; i++) {
+      if (_bufferPool.size_approx() < (size_t) _maxQueueSize)
+        _bufferPool.enqueue(std::move(events[i]));
     }
   }
-  flowFile->addAttribute("syslog.protocol", _protocol);
-  flowFile->addAttribute("syslog.port", std::to_string(_port));
-  session->transfer(flowFile, Success);
 }
 #endif
 } /* namespace processors */
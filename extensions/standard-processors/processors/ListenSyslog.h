@@ -26,21 +26,27 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
-#include <sys/select.h>
 #include <sys/time.h>
 #else
 #include <WinSock2.h>
 #endif
 #include <errno.h>
 #include <sys/types.h>
+#include <atomic>
 #include <chrono>
-#include <thread>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "concurrentqueue.h"
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "core/Core.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "io/EventReactor.h"
 
 #ifndef WIN32
 
@@ -51,11 +57,8 @@ namespace minifi {
 namespace processors {
 
 
-// SyslogEvent
-typedef struct {
-  char *payload;
-  uint64_t len;
-} SysLogEvent;
+// datagrams received with a single call by a UDP receiver
+#define LISTEN_SYSLOG_RECEIVE_BATCH 32
 
 // ListenSyslog Class
 class ListenSyslog : public core::Processor {
@@ -67,40 +70,22 @@ class ListenSyslog : public core::Processor {
   ListenSyslog(std::string name,  utils::Identifier uuid = utils::Identifier())
       : Processor(name, uuid),
         logger_(logging::LoggerFactory<ListenSyslog>::getLogger()) {
-    _eventQueueByteSize = 0;
-    _serverSocket = 0;
     _recvBufSize = 65507;
     _maxSocketBufSize = 1024 * 1024;
     _maxConnections = 2;
     _maxBatchSize = 1;
+    _maxQueueSize = 10000;
+    _receivers = 1;
     _messageDelimiter = "\n";
     _protocol = "UDP";
     _port = 514;
     _parseMessages = false;
     _serverSocket = 0;
-    _maxFds = 0;
-    FD_ZERO(&_readfds);
-    _thread = NULL;
-    _resetServerSocket = false;
-    _serverTheadRunning = false;
+    _droppedEvents = 0;
   }
   // Destructor
   virtual ~ListenSyslog() {
-    _serverTheadRunning = false;
-    if (this->_thread)
-      delete this->_thread;
-    // need to reset the socket
-    std::vector<int>::iterator it;
-    for (it = _clientSockets.begin(); it != _clientSockets.end(); ++it) {
-      int clientSocket = *it;
-      close(clientSocket);
-    }
-    _clientSockets.clear();
-    if (_serverSocket > 0) {
-      logger_->log_debug("ListenSysLog Server socket %d close", _serverSocket);
-      close(_serverSocket);
-      _serverSocket = 0;
-    }
+    stopListening();
   }
   // Processor Name
   static constexpr char const *ProcessorName = "ListenSyslog";
@@ -109,6 +94,8 @@ class ListenSyslog : public core::Processor {
   static core::Property MaxSocketBufSize;
   static core::Property MaxConnections;
   static core::Property MaxBatchSize;
+  static core::Property MaxQueueSize;
+  static core::Property Receivers;
   static core::Property MessageDelimiter;
   static core::Property ParseMessages;
   static core::Property Protocol;
@@ -119,18 +106,30 @@ class ListenSyslog : public core::Processor {
   // Nest Callback Class for write stream
   class WriteCallback : public OutputStreamCallback {
    public:
-    WriteCallback(char *data, uint64_t size)
-        : _data(reinterpret_cast<uint8_t*>(data)),
-          _dataSize(size) {
+    WriteCallback(std::vector<std::string> &events, size_t count, const std::string &delimiter)
+        : events_(events),
+          count_(count),
+          delimiter_(delimiter) {
     }
-    uint8_t *_data;
-    uint64_t _dataSize;
     int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      int64_t ret = 0;
-      if (_data && _dataSize > 0)
-        ret = stream->write(_data, _dataSize);
-      return ret;
+      // the messages and the delimiters between them are written at once
+      std::vector<io::IoVec> buffers;
+      buffers.reserve(2 * count_);
+      for (size_t i = 0; i < count_; i++) {
+        if (i > 0 && !delimiter_.empty())
+          buffers.push_back(io::IoVec{reinterpret_cast<uint8_t*>(const_cast<char*>(delimiter_.data())), delimiter_.size()});
+        if (!events_[i].empty())
+          buffers.push_back(io::IoVec{reinterpret_cast<uint8_t*>(&events_[i][0]), events_[i].size()});
+      }
+      if (buffers.empty())
+        return 0;
+      return stream->writev(buffers.data(), buffers.size());
     }
+
+   private:
+    std::vector<std::string> &events_;
+    size_t count_;
+    const std::string &delimiter_;
   };
 
  public:
@@ -144,73 +143,61 @@ class ListenSyslog : public core::Processor {
  private:
   // Logger
   std::shared_ptr<logging::Logger> logger_;
-  // Run function for the thread
-  static void run(ListenSyslog *process);
-  // Run Thread
-  void runThread();
-  // Queue for store syslog event
-  std::queue<SysLogEvent> _eventQueue;
-  // Size of Event queue in bytes
-  uint64_t _eventQueueByteSize;
-  // Get event queue size
-  uint64_t getEventQueueSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return _eventQueue.size();
-  }
-  // Get event queue byte size
-  uint64_t getEventQueueByteSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return _eventQueueByteSize;
-  }
-  // Whether the event queue  is empty
-  bool isEventQueueEmpty() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return _eventQueue.empty();
-  }
-  // Put event into directory listing
-  void putEvent(uint8_t *payload, uint64_t len) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    SysLogEvent event;
-    event.payload = reinterpret_cast<char*>(payload);
-    event.len = len;
-    _eventQueue.push(event);
-    _eventQueueByteSize += len;
-  }
-  // Read \n terminated line from TCP socket
-  int readline(int fd, char *bufptr, size_t len);
-  // start server socket and handling client socket
-  void startSocketThread();
-  // Poll event
-  void pollEvent(std::queue<SysLogEvent> &list, int maxSize) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    while (!_eventQueue.empty() && (maxSize == 0 || list.size() < maxSize)) {
-      SysLogEvent event = _eventQueue.front();
-      _eventQueue.pop();
-      _eventQueueByteSize -= event.len;
-      list.push(event);
+  // preallocated buffers of a UDP socket, filled by a single call
+  struct Receiver {
+    int socket;
+    size_t bufferSize;
+    std::vector<char> buffers;
+#ifdef __linux__
+    std::vector<struct mmsghdr> headers;
+    std::vector<struct iovec> iovecs;
+#endif
+  };
+  // received messages, handed over from the reactor threads to onTrigger
+  moodycamel::ConcurrentQueue<std::string> _eventQueue;
+  // strings of written messages, reused for the received ones
+  moodycamel::ConcurrentQueue<std::string> _bufferPool;
+  // messages dropped because the queue was full
+  std::atomic<uint64_t> _droppedEvents;
+  // queue a received message
+  void putEvent(const char *data, size_t len) {
+    if (_eventQueue.size_approx() >= (size_t) _maxQueueSize) {
+      _droppedEvents++;
+      return;
     }
-    return;
+    std::string event;
+    _bufferPool.try_dequeue(event);
+    event.assign(data, len);
+    _eventQueue.enqueue(std::move(event));
   }
-  // Mutex for protection of the directory listing
-  std::mutex mutex_;
+  // open the server socket and register it with the reactor
+  void startListening();
+  // unregister and close the server and client sockets
+  void stopListening();
+  // accept the pending TCP connections
+  void acceptClients();
+  // open a UDP socket bound to the port, shared by the receivers
+  bool addReceiver();
+  // receive the pending UDP datagrams
+  void receiveDatagrams(Receiver *receiver);
+  // receive the pending data of a TCP client, queueing its \n terminated lines
+  void receiveLines(int clientSocket);
   int64_t _recvBufSize;
   int64_t _maxSocketBufSize;
   int64_t _maxConnections;
   int64_t _maxBatchSize;
+  int64_t _maxQueueSize;
+  int64_t _receivers;
   std::string _messageDelimiter;
   std::string _protocol;
   int64_t _port;bool _parseMessages;
+  // guards the sockets, which are used by the reactor threads
+  std::mutex socket_mutex_;
   int _serverSocket;
-  std::vector<int> _clientSockets;
-  int _maxFds;
-  fd_set _readfds;
-  // thread
-  std::thread *_thread;
-  // whether to reset the server socket
-  bool _resetServerSocket;bool _serverTheadRunning;
-  // buffer for read socket
-  char _buffer[2048];
+  // client sockets with the incomplete line received from them
+  std::map<int, std::string> _clientSockets;
+  std::vector<std::unique_ptr<Receiver>> _receiverSockets;
+  std::shared_ptr<io::EventReactor> reactor_;
 };
 
 REGISTER_RESOURCE(ListenSyslog,"Listens for Syslog messages being sent to a given port over TCP or UDP. Incoming messages are checked against regular expressions for RFC5424 and RFC3164 formatted messages. "
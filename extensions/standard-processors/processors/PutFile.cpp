@@ -247,36 +247,15 @@ PutFile::ReadCallback::ReadCallback(const std::string &tmp_file, const std::stri
       dest_file_(dest_file) {
 }
 
-// Copy the entire file contents to the temporary file
-int64_t PutFile::ReadCallback::process(std::shared_ptr<io::BaseStream> stream) {
-  // Copy file contents into tmp file
-  write_succeeded_ = false;
-  size_t size = 0;
-  uint8_t buffer[1024];
-
-  std::ofstream tmp_file_os(tmp_file_, std::ios::out | std::ios::binary);
-
-  do {
-    int read = stream->read(buffer, 1024);
-
-    if (read < 0) {
-      return -1;
-    }
-
-    if (read == 0) {
-      break;
-    }
-
-    tmp_file_os.write(reinterpret_cast<char *>(buffer), read);
-    size += read;
-  } while (size < stream->getSize());
-
-  tmp_file_os.close();
-
-  if (tmp_file_os) {
-    write_succeeded_ = true;
+// Copy the pieces of the file contents to the temporary file
+int64_t PutFile::ReadCallback::process(const uint8_t *data, uint64_t size) {
+  if (!tmp_file_os_.is_open()) {
+    tmp_file_os_.open(tmp_file_, std::ios::out | std::ios::binary);
   }
 
+  tmp_file_os_.write(reinterpret_cast<const char *>(data), size);
+  write_succeeded_ = static_cast<bool>(tmp_file_os_);
+
   return size;
 }
 
@@ -287,6 +266,11 @@ bool PutFile::ReadCallback::commit() {
 
   logger_->log_info("PutFile committing put file operation to %s", dest_file_);
 
+  if (tmp_file_os_.is_open()) {
+    tmp_file_os_.close();
+    write_succeeded_ = write_succeeded_ && static_cast<bool>(tmp_file_os_);
+  }
+
   if (write_succeeded_) {
     if (rename(tmp_file_.c_str(), dest_file_.c_str())) {
       logger_->log_info("PutFile commit put file operation to %s failed because rename() call failed", dest_file_);
@@ -304,6 +288,9 @@ bool PutFile::ReadCallback::commit() {
 // Clean up resources
 PutFile::ReadCallback::~ReadCallback() {
   // Clean up tmp file, if necessary
+  if (tmp_file_os_.is_open()) {
+    tmp_file_os_.close();
+  }
   unlink(tmp_file_.c_str());
 }
 
@@ -20,6 +20,8 @@
 #ifndef __PUT_FILE_H__
 #define __PUT_FILE_H__
 
+#include <fstream>
+#include <string>
 #include <utility>
 
 #include "FlowFileRecord.h"
@@ -75,15 +77,17 @@ class PutFile : public core::Processor {
   void onTrigger(core::ProcessContext *context, core::ProcessSession *session) override;
   void initialize() override;
 
-  class ReadCallback : public InputStreamCallback {
+  class ReadCallback : public InputBufferCallback {
    public:
     ReadCallback(const std::string &tmp_file, const std::string &dest_file);
     ~ReadCallback() override;
-    int64_t process(std::shared_ptr<io::BaseStream> stream) override;
+    int64_t process(const uint8_t *data, uint64_t size) override;
     bool commit();
 
    private:
     std::shared_ptr<logging::Logger> logger_{ logging::LoggerFactory<PutFile::ReadCallback>::getLogger() };
+    // the pieces of the content are appended as they are read
+    std::ofstream tmp_file_os_;
     bool write_succeeded_ = false;
     std::string tmp_file_;
     std::string dest_file_;
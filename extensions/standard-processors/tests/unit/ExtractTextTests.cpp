@@ -15,6 +15,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <chrono>
 #include <list>
 #include <fstream>
 #include <map>
@@ -23,6 +25,8 @@
 #include <string>
 #include <set>
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 #include "TestBase.h"
 #include "core/Core.h"
@@ -32,6 +36,8 @@
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
 #include "core/ProcessorNode.h"
+#include "core/repository/FileSystemRepository.h"
+#include "utils/RegexUtils.h"
 
 #include "GetFile.h"
 #include "ExtractText.h"
@@ -181,3 +187,62 @@ TEST_CASE("Test usage of ExtractText in regex mode", "[extracttextRegexTest]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("ExtractText read path benchmark", "[.][benchmark]") {
+  const int size_mb = 100;
+  TestController testController;
+  char format[] = "/var/tmp/extract.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(configuration));
+
+  // the only match is at the end of the content
+  std::string line = "Speed limit unknown\n";
+  std::string block;
+  while (block.size() < 1024 * 1024) {
+    block += line;
+  }
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  auto stream = content_repo->write(claim);
+  for (int i = 0; i < size_mb; i++) {
+    REQUIRE(static_cast<int>(block.size()) == stream->writeData(reinterpret_cast<uint8_t*>(&block[0]), static_cast<int>(block.size())));
+  }
+  std::string last = REGEX_TEST_TEXT;
+  stream->writeData(reinterpret_cast<uint8_t*>(&last[0]), static_cast<int>(last.size()));
+  stream->closeStream();
+  const uint64_t size = static_cast<uint64_t>(size_mb) * block.size() + last.size();
+
+  // the stream read path, reading 4096 bytes at a time into a string stream
+  auto start = std::chrono::steady_clock::now();
+  stream = content_repo->read(claim);
+  std::ostringstream contentStream;
+  std::vector<uint8_t> buffer(4096);
+  int ret;
+  while ((ret = stream->readData(buffer, static_cast<int>(buffer.size()))) > 0) {
+    contentStream.write(reinterpret_cast<const char*>(buffer.data()), ret);
+  }
+  utils::Regex streamed_regex("Speed limit ([0-9]+)");
+  REQUIRE(streamed_regex.match(contentStream.str()));
+  auto streamed_done = std::chrono::steady_clock::now();
+
+  // the current read path, reading the content directly into one string
+  stream = content_repo->read(claim);
+  std::string content(size, '\0');
+  uint64_t read_size = 0;
+  while (read_size < size && (ret = stream->readData(reinterpret_cast<uint8_t*>(&content[read_size]), static_cast<int>(size - read_size))) > 0) {
+    read_size += ret;
+  }
+  utils::Regex direct_regex("Speed limit ([0-9]+)");
+  REQUIRE(direct_regex.match(content));
+  auto direct_done = std::chrono::steady_clock::now();
+  REQUIRE("130" == direct_regex.getResult()[1]);
+  REQUIRE(streamed_regex.getResult() == direct_regex.getResult());
+
+  auto megabytesPerSecond = [size_mb](std::chrono::steady_clock::duration elapsed) {
+    return size_mb * 1000 / (std::max)(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()), static_cast<int64_t>(1));
+  };
+  std::cout << "Regex extraction from " << size_mb << " MB: streamed " << megabytesPerSecond(streamed_done - start) << " MB/s, direct "
+            << megabytesPerSecond(direct_done - streamed_done) << " MB/s" << std::endl;
+}
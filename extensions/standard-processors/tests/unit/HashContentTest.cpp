@@ -18,6 +18,8 @@
 
 #ifdef OPENSSL_SUPPORT
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -25,6 +27,7 @@
 #include <string>
 #include <set>
 #include <iostream>
+#include <vector>
 
 #include "TestBase.h"
 #include "core/Core.h"
@@ -34,6 +37,7 @@
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
 #include "core/ProcessorNode.h"
+#include "core/repository/FileSystemRepository.h"
 #include "utils/ScopeGuard.h"
 
 #include "GetFile.h"
@@ -133,4 +137,96 @@ TEST_CASE("Test usage of ExtractText", "[extracttextTest]") {
   REQUIRE(LogTestController::getInstance().contains(log_check));
 }
 
+TEST_CASE("HashContent hashes content read in several pieces", "[HashContentPieces]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  char dir[] = "/tmp/gt.XXXXXX";
+  auto tempdir = testController.createTempDirectory(dir);
+  REQUIRE(!tempdir.empty());
+
+  std::shared_ptr<core::Processor> getfile = plan->addProcessor("GetFile", "getfileCreate2");
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::Directory.getName(), tempdir);
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::KeepSourceFile.getName(), "true");
+
+  std::shared_ptr<core::Processor> sha2processor = plan->addProcessor("HashContent", "HashContentSHA256",
+      core::Relationship("success", "description"), true);
+  plan->setProperty(sha2processor, org::apache::nifi::minifi::processors::HashContent::HashAttribute.getName(), SHA256_ATTR);
+  plan->setProperty(sha2processor, org::apache::nifi::minifi::processors::HashContent::HashAlgorithm.getName(), "SHA256");
+
+  plan->addProcessor("LogAttribute", "outputLogAttribute", core::Relationship("success", "description"), true);
+
+  // the volatile repository of the test plan cannot map content, so this is read in several pieces
+  std::string content;
+  for (int i = 0; i < 100000; i++) {
+    content += static_cast<char>(i * 31);
+  }
+  std::ofstream test_file(tempdir + utils::file::FileUtils::get_separator() + TEST_FILE, std::ios::binary);
+  test_file.write(content.data(), content.size());
+  test_file.close();
+
+  for (int i = 0; i < 3; ++i) {
+    plan->runNextProcessor();
+  }
+
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const unsigned char*>(content.data()), content.size(), digest);
+  std::stringstream log_check;
+  log_check << "key:" << SHA256_ATTR << " value:" << utils::StringUtils::to_hex(digest, SHA256_DIGEST_LENGTH, true /*uppercase*/);
+  REQUIRE(LogTestController::getInstance().contains(log_check.str()));
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("HashContent read path benchmark", "[.][benchmark]") {
+  const int size_mb = 100;
+  TestController testController;
+  char format[] = "/var/tmp/hash.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(configuration));
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  std::vector<uint8_t> block(1024 * 1024);
+  for (size_t i = 0; i < block.size(); i++) {
+    block[i] = static_cast<uint8_t>(i * 31);
+  }
+  auto stream = content_repo->write(claim);
+  for (int i = 0; i < size_mb; i++) {
+    REQUIRE(static_cast<int>(block.size()) == stream->writeData(block.data(), static_cast<int>(block.size())));
+  }
+  stream->closeStream();
+
+  // the stream read path, reading into a stack buffer of the former HASH_BUFFER_SIZE
+  auto start = std::chrono::steady_clock::now();
+  stream = content_repo->read(claim);
+  uint8_t buffer[16384];
+  SHA256_CTX context;
+  SHA256_Init(&context);
+  int ret;
+  while ((ret = stream->readData(buffer, sizeof(buffer))) > 0) {
+    SHA256_Update(&context, buffer, ret);
+  }
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256_Final(digest, &context);
+  const std::string streamed = utils::StringUtils::to_hex(digest, SHA256_DIGEST_LENGTH, true /*uppercase*/);
+  auto streamed_done = std::chrono::steady_clock::now();
+
+  auto content = content_repo->map(claim, 0, static_cast<uint64_t>(size_mb) * block.size());
+  SHA256Hasher hasher;
+  hasher.update(content->data(), content->size());
+  const std::string mapped = hasher.digest();
+  auto mapped_done = std::chrono::steady_clock::now();
+  REQUIRE(streamed == mapped);
+
+  auto megabytesPerSecond = [size_mb](std::chrono::steady_clock::duration elapsed) {
+    return size_mb * 1000 / (std::max)(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()), static_cast<int64_t>(1));
+  };
+  std::cout << "SHA256 of " << size_mb << " MB: streamed " << megabytesPerSecond(streamed_done - start) << " MB/s, mapped " << megabytesPerSecond(mapped_done - streamed_done) << " MB/s"
+            << std::endl;
+}
+
 #endif  // OPENSSL_SUPPORT
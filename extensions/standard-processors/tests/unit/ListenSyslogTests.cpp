@@ -0,0 +1,167 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WIN32
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TestBase.h"
+#include "utils/file/FileUtils.h"
+#include "processors/ListenSyslog.h"
+#include "processors/PutFile.h"
+
+namespace {
+
+// the lines of each file written to the directory
+std::vector<std::vector<std::string>> readFiles(const std::string &dir) {
+  std::vector<std::vector<std::string>> files;
+  DIR *d = opendir(dir.c_str());
+  if (d == nullptr)
+    return files;
+  while (struct dirent *entry = readdir(d)) {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..")
+      continue;
+    std::ifstream file(dir + utils::file::FileUtils::get_separator() + name);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+      lines.push_back(line);
+    }
+    files.push_back(lines);
+  }
+  closedir(d);
+  return files;
+}
+
+size_t countLines(const std::vector<std::vector<std::string>> &files) {
+  size_t count = 0;
+  for (const auto &file : files) {
+    count += file.size();
+  }
+  return count;
+}
+
+struct sockaddr_in localAddress(uint16_t port) {
+  struct sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  return address;
+}
+
+}  // namespace
+
+TEST_CASE("ListenSyslog batches UDP messages into FlowFiles", "[listensyslog]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::ListenSyslog>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> listensyslog = plan->addProcessor("ListenSyslog", "listensyslog");
+  std::shared_ptr<core::Processor> putfile = plan->addProcessor("PutFile", "putfile", core::Relationship("success", "description"), true);
+
+  char format[] = "/tmp/ls.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  plan->setProperty(listensyslog, minifi::processors::ListenSyslog::Port.getName(), "10514");
+  plan->setProperty(listensyslog, minifi::processors::ListenSyslog::MaxBatchSize.getName(), "10");
+  plan->setProperty(listensyslog, minifi::processors::ListenSyslog::Receivers.getName(), "2");
+  plan->setProperty(putfile, minifi::processors::PutFile::Directory.getName(), dir);
+
+  // the first trigger binds the receivers
+  testController.runSession(plan, false);
+
+  int client = socket(AF_INET, SOCK_DGRAM, 0);
+  REQUIRE(client >= 0);
+  auto address = localAddress(10514);
+  std::set<std::string> expected;
+  for (int i = 0; i < 100; i++) {
+    std::string message = "<34>Oct 11 22:14:15 mymachine su: message " + std::to_string(i);
+    REQUIRE((ssize_t) message.size() == sendto(client, message.data(), message.size(), 0, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)));
+    expected.insert(message);
+  }
+  close(client);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  // PutFile writes a single FlowFile per trigger
+  std::vector<std::vector<std::string>> files;
+  for (int i = 0; i < 100 && countLines(files) < expected.size(); i++) {
+    plan->reset();
+    testController.runSession(plan, true);
+    files = readFiles(dir);
+  }
+
+  std::set<std::string> received;
+  for (const auto &file : files) {
+    REQUIRE(file.size() <= 10);
+    received.insert(file.begin(), file.end());
+  }
+  REQUIRE(expected == received);
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("ListenSyslog splits the TCP stream into messages", "[listensyslog]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::ListenSyslog>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> listensyslog = plan->addProcessor("ListenSyslog", "listensyslog");
+  std::shared_ptr<core::Processor> putfile = plan->addProcessor("PutFile", "putfile", core::Relationship("success", "description"), true);
+
+  char format[] = "/tmp/ls.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  plan->setProperty(listensyslog, minifi::processors::ListenSyslog::Protocol.getName(), "TCP");
+  plan->setProperty(listensyslog, minifi::processors::ListenSyslog::Port.getName(), "10515");
+  plan->setProperty(listensyslog, minifi::processors::ListenSyslog::MaxBatchSize.getName(), "0");
+  plan->setProperty(putfile, minifi::processors::PutFile::Directory.getName(), dir);
+
+  testController.runSession(plan, false);
+
+  int client = socket(AF_INET, SOCK_STREAM, 0);
+  REQUIRE(client >= 0);
+  auto address = localAddress(10515);
+  REQUIRE(0 == connect(client, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)));
+  // the messages span the writes
+  std::string first = "<34>first\n<34>sec";
+  std::string second = "ond\n<34>third\n<34>incomplete";
+  REQUIRE((ssize_t) first.size() == send(client, first.data(), first.size(), 0));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  REQUIRE((ssize_t) second.size() == send(client, second.data(), second.size(), 0));
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  plan->reset();
+  testController.runSession(plan, true);
+  auto files = readFiles(dir);
+  close(client);
+
+  // all the complete messages are written to a single FlowFile
+  REQUIRE(1 == files.size());
+  std::vector<std::string> expected = { "<34>first", "<34>second", "<34>third" };
+  REQUIRE(expected == files[0]);
+  LogTestController::getInstance().reset();
+}
+#endif /* !WIN32 */
@@ -33,6 +33,8 @@
 #include "core/Connectable.h"
 #include "core/FlowFile.h"
 #include "core/Repository.h"
+#include "core/FlowFilePrioritizer.h"
+#include "FlowFileQueue.h"
 
 namespace org {
 namespace apache {
@@ -139,13 +141,26 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
     return drop_empty_;
   }
 
+  // Set the prioritizer deciding the dequeue order, nullptr means first in first out
+  void setPrioritizer(const std::shared_ptr<core::FlowFilePrioritizer> &prioritizer) {
+    queue_.setPrioritizer(prioritizer);
+  }
+
+  std::shared_ptr<core::FlowFilePrioritizer> getPrioritizer() const {
+    return queue_.getPrioritizer();
+  }
+
+  // Get the number of queued flow files that are currently penalized
+  uint64_t getPenalizedQueueSize() const {
+    return queue_.getPenalizedSize();
+  }
+
   // Check whether the queue is empty
-  bool isEmpty();
+  bool isEmpty() const;
   // Check whether the queue is full to apply back pressure
-  bool isFull();
-  // Get queue size
-  uint64_t getQueueSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
+  bool isFull() const;
+  // Get queue size, does not block producers or consumers
+  uint64_t getQueueSize() const {
     return queue_.size();
   }
   // Get queue data size
@@ -166,6 +181,17 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   void multiPut(std::vector<std::shared_ptr<core::FlowFile>>& flows);
   // Poll the flow file from queue, the expired flow file record also being returned
   std::shared_ptr<core::FlowFile> poll(std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords);
+  /**
+   * Polls up to max_count flow files from the queue in a single critical section.
+   * @param flows receives the dequeued flow files in queue order
+   * @param max_count maximum number of flow files to return
+   * @param max_bytes maximum total content size to return, 0 means unlimited. At least one
+   * flow file is returned if available, even if it is larger than max_bytes.
+   * @param expiredFlowRecords receives the flow files that expired while queued
+   * @return number of flow files added to flows
+   */
+  size_t pollBatch(std::vector<std::shared_ptr<core::FlowFile>> &flows, size_t max_count, uint64_t max_bytes,
+                   std::vector<std::shared_ptr<core::FlowFile>> &expiredFlowRecords);
   // Drain the flow records
   void drain();
 
@@ -205,12 +231,10 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
 
  private:
   bool drop_empty_;
-  // Mutex for protection
-  std::mutex mutex_;
   // Queued data size
   std::atomic<uint64_t> queued_data_size_;
   // Queue for the Flow File
-  std::queue<std::shared_ptr<core::FlowFile>> queue_;
+  FlowFileQueue queue_;
   // flow repository
   // Logger
   std::shared_ptr<logging::Logger> logger_;
@@ -0,0 +1,134 @@
+/**
+ * @file FlowFileQueue.h
+ * FlowFileQueue class declaration
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_FLOWFILEQUEUE_H_
+#define LIBMINIFI_INCLUDE_FLOWFILEQUEUE_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "core/FlowFile.h"
+#include "core/FlowFilePrioritizer.h"
+#include "utils/TwoLockQueue.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+
+/**
+ * Queue of a connection.
+ *
+ * FlowFiles that are ready to be processed are kept in FIFO order in a two-lock queue, or, when a
+ * prioritizer is set, in a binary heap ordered by the prioritizer (ties are broken by insertion order).
+ * Penalized FlowFiles are kept in a separate heap ordered by their penalty expiration, so they never
+ * block the ready ones; they are moved back among the ready FlowFiles once their penalty expires.
+ * Both enqueue and dequeue are O(log n) at worst.
+ */
+class FlowFileQueue {
+ public:
+  /**
+   * Called with each ready FlowFile in priority order. Returns true if it took the FlowFile
+   * (it may move from the argument), false to stop, leaving the FlowFile in the queue.
+   */
+  using Consumer = std::function<bool(std::shared_ptr<core::FlowFile>&)>;
+
+  FlowFileQueue();
+
+  FlowFileQueue(const FlowFileQueue &other) = delete;
+  FlowFileQueue &operator=(const FlowFileQueue &other) = delete;
+
+  /**
+   * Sets the prioritizer, nullptr restores FIFO ordering. Should be set before the queue is used
+   * by several threads; FlowFiles already queued are reordered.
+   */
+  void setPrioritizer(const std::shared_ptr<core::FlowFilePrioritizer> &prioritizer);
+
+  std::shared_ptr<core::FlowFilePrioritizer> getPrioritizer() const {
+    return prioritizer_;
+  }
+
+  void push(const std::shared_ptr<core::FlowFile> &flow);
+
+  void push(const std::vector<std::shared_ptr<core::FlowFile>> &flows);
+
+  /**
+   * Offers the ready FlowFiles to consumer in priority order. Penalized FlowFiles are skipped and
+   * FlowFiles whose penalty expired are made available first.
+   * @return number of FlowFiles taken by consumer
+   */
+  size_t consume(const Consumer &consumer);
+
+  /**
+   * Removes all FlowFiles, calling func on each of them.
+   */
+  void clear(const std::function<void(std::shared_ptr<core::FlowFile>&)> &func);
+
+  // Total number of queued FlowFiles, including the penalized ones. Does not lock.
+  size_t size() const {
+    return fifo_.size() + prioritized_size_.load(std::memory_order_acquire) + penalized_size_.load(std::memory_order_acquire);
+  }
+
+  size_t getPenalizedSize() const {
+    return penalized_size_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<core::FlowFile> flow;
+    uint64_t sequence;
+  };
+
+  void pushReady(std::vector<std::shared_ptr<core::FlowFile>> &flows);
+  void pushPenalized(std::vector<std::shared_ptr<core::FlowFile>> &flows);
+  void releasePenalized(uint64_t now);
+  // ordering of the prioritized heap, true if lhs is dequeued after rhs
+  bool after(const Entry &lhs, const Entry &rhs) const;
+
+  std::shared_ptr<core::FlowFilePrioritizer> prioritizer_;
+  bool fifo_mode_;
+  std::atomic<uint64_t> sequence_;
+
+  // ready FlowFiles in FIFO mode
+  utils::TwoLockQueue<std::shared_ptr<core::FlowFile>> fifo_;
+
+  // ready FlowFiles with a prioritizer
+  std::mutex prioritized_mutex_;
+  std::vector<Entry> prioritized_;
+  std::atomic<size_t> prioritized_size_;
+
+  // penalized FlowFiles, min-heap on penalty expiration
+  std::mutex penalized_mutex_;
+  std::vector<Entry> penalized_;
+  std::atomic<size_t> penalized_size_;
+  // earliest penalty expiration, lets consumers skip the penalty heap without locking
+  std::atomic<uint64_t> next_release_;
+};
+
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+#endif /* LIBMINIFI_INCLUDE_FLOWFILEQUEUE_H_ */
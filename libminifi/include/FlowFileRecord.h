@@ -90,6 +90,23 @@ class InputStreamCallback {
 
   virtual int64_t process(std::shared_ptr<io::BaseStream> stream) = 0;
 };
+// Reads the content without copying it through a stream. Content the repository can memory map arrives
+// in one piece, other content in consecutive pieces of bounded size, so it is never held in memory at once
+class InputBufferCallback {
+ public:
+  virtual ~InputBufferCallback() {
+
+  }
+
+  // called once per piece, data is only valid during the call
+  virtual int64_t process(const uint8_t *data, uint64_t size) = 0;
+
+  // called instead of process(data, size) with content the repository could map; callbacks that hand the
+  // content on beyond the call keep the buffer, and with it the mapping
+  virtual int64_t processBuffer(const std::shared_ptr<io::ContentBuffer> &buffer) {
+    return process(buffer->data(), buffer->size());
+  }
+};
 class OutputStreamCallback {
  public:
   virtual ~OutputStreamCallback() {
@@ -131,7 +148,21 @@ class FlowFileRecord : public core::FlowFile, public io::Serializable {
   // getAttribute key is enum
   bool getKeyedAttribute(FlowAttribute key, std::string &value);
 
-  bool Serialize(io::DataStream &outStream);
+  /**
+   * Record formats. Compact records start with a marker byte and a schema version, they store UUIDs
+   * in binary, lengths as varints and refer to the content through the content path dictionary of
+   * the FlowFile repository. Both formats can be read.
+   */
+  enum class RecordFormat {
+    LEGACY,
+    COMPACT
+  };
+
+  bool Serialize(io::DataStream &outStream, RecordFormat format);
+
+  bool Serialize(io::DataStream &outStream) {
+    return Serialize(outStream, RecordFormat::COMPACT);
+  }
 
   //! Serialize and Persistent to the repository
   bool Serialize();
@@ -177,6 +208,11 @@ class FlowFileRecord : public core::FlowFile, public io::Serializable {
   FlowFileRecord(const FlowFileRecord &parent) = delete;
 
  protected:
+  bool SerializeLegacy(io::DataStream &outStream);
+
+  bool DeSerializeLegacy(const uint8_t *buffer, const int bufferSize);
+
+  bool DeSerializeCompact(const uint8_t *buffer, const int bufferSize);
 
   // connection uuid
   std::string uuid_connection_;
@@ -20,6 +20,7 @@
 #ifndef __REMOTE_PROCESSOR_GROUP_PORT_H__
 #define __REMOTE_PROCESSOR_GROUP_PORT_H__
 
+#include <map>
 #include <mutex>
 #include <memory>
 #include <stack>
@@ -29,9 +30,11 @@
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "sitetosite/SiteToSiteClient.h"
+#include "sitetosite/PeerSelector.h"
 #include "io/StreamFactory.h"
 #include "controllers/SSLContextService.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "core/state/nodes/MetricsBase.h"
 
 namespace org {
 namespace apache {
@@ -72,7 +75,51 @@ struct RPG {
 };
 
 // RemoteProcessorGroupPort Class
-class RemoteProcessorGroupPort : public core::Processor {
+/**
+ * Counts the bytes of the data packets moved by a port, before and after compression.
+ */
+class RemoteProcessorGroupPortMetrics : public state::response::ResponseNode {
+ public:
+  RemoteProcessorGroupPortMetrics()
+      : state::response::ResponseNode("RemoteProcessorGroupPortMetrics") {
+    raw_bytes_ = 0;
+    compressed_bytes_ = 0;
+  }
+
+  virtual ~RemoteProcessorGroupPortMetrics() {
+  }
+
+  virtual std::string getName() const {
+    return core::Connectable::getName();
+  }
+
+  virtual std::vector<state::response::SerializedResponseNode> serialize() {
+    std::vector<state::response::SerializedResponseNode> resp;
+
+    state::response::SerializedResponseNode raw_bytes;
+    raw_bytes.name = "RawBytes";
+    raw_bytes.value = (uint64_t) raw_bytes_.load();
+
+    resp.push_back(raw_bytes);
+
+    // equal to the raw bytes when the port does not use compression
+    state::response::SerializedResponseNode compressed_bytes;
+    compressed_bytes.name = "CompressedBytes";
+    compressed_bytes.value = (uint64_t) compressed_bytes_.load();
+
+    resp.push_back(compressed_bytes);
+
+    return resp;
+  }
+
+ protected:
+  friend class RemoteProcessorGroupPort;
+
+  std::atomic<uint64_t> raw_bytes_;
+  std::atomic<uint64_t> compressed_bytes_;
+};
+
+class RemoteProcessorGroupPort : public core::Processor, public state::response::MetricsNodeSource {
  public:
   // Constructor
   /*!
@@ -86,13 +133,17 @@ class RemoteProcessorGroupPort : public core::Processor {
         timeout_(0),
         http_enabled_(false),
         bypass_rest_api_(false),
+        use_compression_(false),
+        peer_refresh_interval_msec_(SITE2SITE_PEER_REFRESH_INTERVAL_MSEC),
+        next_peer_refresh_msec_(0),
+        max_transactions_per_peer_(0),
         ssl_service(nullptr),
         logger_(logging::LoggerFactory<RemoteProcessorGroupPort>::getLogger()) {
     client_type_ = sitetosite::CLIENT_TYPE::RAW;
     stream_factory_ = stream_factory;
     protocol_uuid_ = uuid;
     site2site_secure_ = false;
-    peer_index_ = -1;
+    metrics_ = std::make_shared<RemoteProcessorGroupPortMetrics>();
     // REST API port and host
     setURL(url);
   }
@@ -131,6 +182,33 @@ class RemoteProcessorGroupPort : public core::Processor {
   void setTransmitting(bool val) {
     transmitting_ = val;
   }
+  /**
+   * Compresses the data packets sent or received, takes effect on the next schedule.
+   */
+  void setUseCompression(bool use_compression) {
+    use_compression_ = use_compression;
+  }
+  bool getUseCompression() {
+    return use_compression_;
+  }
+  /**
+   * Sets how often the peer list is refreshed, 0 refreshes it only when there are no peers.
+   */
+  void setPeerRefreshInterval(uint64_t interval_msec) {
+    peer_refresh_interval_msec_ = interval_msec;
+  }
+  uint64_t getPeerRefreshInterval() {
+    return peer_refresh_interval_msec_;
+  }
+  /**
+   * Limits the transactions in flight with a single peer, 0 leaves it to the concurrent tasks.
+   */
+  void setMaxTransactionsPerPeer(uint32_t max_transactions) {
+    max_transactions_per_peer_ = max_transactions;
+  }
+  uint32_t getMaxTransactionsPerPeer() {
+    return max_transactions_per_peer_;
+  }
   // setInterface
   void setInterface(const std::string &ifc) {
     local_network_interface_ = ifc;
@@ -178,6 +256,8 @@ class RemoteProcessorGroupPort : public core::Processor {
     client_type_ = sitetosite::HTTP;
   }
 
+  int16_t getMetricNodes(std::vector<std::shared_ptr<state::response::ResponseNode>> &metric_vector);
+
  protected:
 
   /**
@@ -193,11 +273,69 @@ class RemoteProcessorGroupPort : public core::Processor {
     }
   }
 
+  /**
+   * Idle clients of a peer and the transactions in flight with it.
+   */
+  struct PeerProtocols {
+    moodycamel::ConcurrentQueue<std::unique_ptr<sitetosite::SiteToSiteClient>> available_protocols_;
+    std::atomic<uint32_t> active_transactions_ { 0 };
+    // set once the peer left, its clients are not reused anymore
+    std::atomic<bool> removed_ { false };
+  };
+
+  /**
+   * A client checked out for a transaction. It holds the clients of the peer it was checked out from, so it is
+   * accounted to them when it returns even if its peer was dropped and added again meanwhile.
+   */
+  class PooledProtocol {
+   public:
+    PooledProtocol() = default;
+
+    PooledProtocol(std::unique_ptr<sitetosite::SiteToSiteClient> protocol, std::shared_ptr<PeerProtocols> peer)
+        : protocol_(std::move(protocol)),
+          peer_(std::move(peer)) {
+    }
+
+    sitetosite::SiteToSiteClient *operator->() const {
+      return protocol_.get();
+    }
+
+    explicit operator bool() const {
+      return nullptr != protocol_;
+    }
+
+   private:
+    friend class RemoteProcessorGroupPort;
+
+    std::unique_ptr<sitetosite::SiteToSiteClient> protocol_;
+    std::shared_ptr<PeerProtocols> peer_;
+  };
+
   std::shared_ptr<io::StreamFactory> stream_factory_;
-  std::unique_ptr<sitetosite::SiteToSiteClient> getNextProtocol(bool create);
-  void returnProtocol(std::unique_ptr<sitetosite::SiteToSiteClient> protocol);
+  /**
+   * Provides a client of the peer selected for the next transaction.
+   * @param create creates a client if the selected peer has no idle one
+   * @return client, which is empty if no peer can take another transaction
+   */
+  PooledProtocol getNextProtocol(bool create);
+  /**
+   * Returns a client after its transaction, to be reused for the next transaction with its peer.
+   */
+  void returnProtocol(PooledProtocol protocol);
+  /**
+   * Releases a client whose transaction failed, without reusing it.
+   */
+  void releaseProtocol(PooledProtocol protocol);
 
-  moodycamel::ConcurrentQueue<std::unique_ptr<sitetosite::SiteToSiteClient>> available_protocols_;
+  /**
+   * Provides the clients of a peer.
+   * @param create creates the clients of a peer that has none
+   */
+  std::shared_ptr<PeerProtocols> getPeerProtocols(const std::string &host, uint16_t port, bool create);
+
+  // clients by the host and port of their peers
+  std::map<std::string, std::shared_ptr<PeerProtocols>> peer_protocols_;
+  std::mutex protocol_mutex_;
 
   std::shared_ptr<Configure> configure_;
   // Transaction Direction
@@ -220,18 +358,25 @@ class RemoteProcessorGroupPort : public core::Processor {
 
   bool bypass_rest_api_;
 
+  std::atomic<bool> use_compression_;
+
   sitetosite::CLIENT_TYPE client_type_;
 
   // Remote Site2Site Info
   bool site2site_secure_;
   std::vector<sitetosite::PeerStatus> peers_;
-  std::atomic<int> peer_index_;
+  sitetosite::PeerSelector peer_selector_;
   std::mutex peer_mutex_;
+  uint64_t peer_refresh_interval_msec_;
+  std::atomic<uint64_t> next_peer_refresh_msec_;
+  uint32_t max_transactions_per_peer_;
   std::string rest_user_name_;
   std::string rest_password_;
 
   std::shared_ptr<controllers::SSLContextService> ssl_service;
 
+  std::shared_ptr<RemoteProcessorGroupPortMetrics> metrics_;
+
  private:
   // Logger
   std::shared_ptr<logging::Logger> logger_;
@@ -82,6 +82,15 @@ class ResourceClaim : public std::enable_shared_from_this<ResourceClaim> {
   // Set the content full path
   void setContentFullPath(std::string path) {
     _contentFullPath = path;
+    claim_id_ = 0;
+  }
+  // ID of the content path assigned by the claim manager, 0 if there is none yet
+  uint64_t getClaimId() const {
+    return claim_id_;
+  }
+
+  void setClaimId(uint64_t claim_id) {
+    claim_id_ = claim_id;
   }
 
   void deleteClaim() {
@@ -112,6 +121,8 @@ class ResourceClaim : public std::enable_shared_from_this<ResourceClaim> {
   // Full path to the content
   std::string _contentFullPath;
 
+  std::atomic<uint64_t> claim_id_;
+
   std::shared_ptr<core::StreamManager<ResourceClaim>> claim_manager_;
 
  private:
@@ -0,0 +1,84 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_CONTENTPATHDICTIONARY_H_
+#define LIBMINIFI_INCLUDE_CORE_CONTENTPATHDICTIONARY_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+class Repository;
+
+/**
+ * Interns the prefixes of content claim paths, so that FlowFile records can refer to their content
+ * with a small numeric ID instead of the full path.
+ *
+ * Content paths are made of the content directory and a per process prefix, followed by a counter,
+ * so a repository only ever sees a handful of distinct prefixes. Each prefix is stored once in the
+ * repository the records are stored in, under a key starting with KEY_PREFIX, and cached in memory.
+ * IDs are derived from the prefix, so they stay stable across restarts. Prefixes of repositories
+ * that are not persistent are only kept in memory.
+ */
+class ContentPathDictionary {
+ public:
+  static constexpr const char *KEY_PREFIX = "minifi.content.path.";
+
+  /**
+   * Looks up or registers prefix in repo.
+   * @return false if the prefix could not be stored, in which case the path has to be stored as is
+   */
+  bool intern(Repository &repo, const std::string &prefix, uint32_t &id);
+
+  /**
+   * Resolves an ID returned by intern, possibly by an earlier run of the agent.
+   * @return false if the ID is unknown to repo
+   */
+  bool resolve(Repository &repo, uint32_t id, std::string &prefix);
+
+  static bool isDictionaryKey(const std::string &key) {
+    return key.compare(0, std::char_traits<char>::length(KEY_PREFIX), KEY_PREFIX) == 0;
+  }
+
+ private:
+  // number of IDs tried when the ID of a prefix is taken by another one
+  static constexpr uint32_t MAX_PROBES = 8;
+
+  static uint32_t hash(const std::string &prefix);
+
+  static std::string getKey(uint32_t id) {
+    return KEY_PREFIX + std::to_string(id);
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::unordered_map<uint32_t, std::string> prefixes_;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_CONTENTPATHDICTIONARY_H_ */
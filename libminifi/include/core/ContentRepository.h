@@ -18,8 +18,16 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_CONTENTREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_CORE_CONTENTREPOSITORY_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "properties/Configure.h"
 #include "ResourceClaim.h"
+#include "io/ContentBuffer.h"
 #include "io/DataStream.h"
 #include "io/BaseStream.h"
 #include "StreamManager.h"
@@ -31,6 +39,22 @@ namespace nifi {
 namespace minifi {
 namespace core {
 
+#define CONTENT_REPOSITORY_COUNT_SHARDS 64
+// file name prefix of composite claims, see ContentRepository::createComposite
+#define COMPOSITE_CLAIM_PREFIX "composite."
+// file name prefix of the claims holding the ranges of composite claims
+#define COMPOSITE_RANGES_PREFIX "ranges."
+#define COMPOSITE_COPY_BUFFER_SIZE (64 * 1024)
+
+/**
+ * Range of the content of a claim.
+ */
+struct ContentRange {
+  std::shared_ptr<minifi::ResourceClaim> claim;
+  uint64_t offset;
+  uint64_t length;
+};
+
 /**
  * Content repository definition that extends StreamManager.
  */
@@ -58,63 +82,109 @@ class ContentRepository : public StreamManager<minifi::ResourceClaim> {
   /**
    * Removes an item if it was orphan
    */
-  virtual bool removeIfOrphaned(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    const std::string str = streamId->getContentFullPath();
-    auto count = count_map_.find(str);
-    if (count != count_map_.end()) {
-      if (count_map_[str] == 0) {
-        remove(streamId);
-        count_map_.erase(str);
-        return true;
-      } else {
-        return false;
-      }
-    } else {
-      remove(streamId);
-      return true;
-    }
-  }
+  virtual bool removeIfOrphaned(const std::shared_ptr<minifi::ResourceClaim> &streamId);
 
-  virtual uint32_t getStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    auto cnt = count_map_.find(streamId->getContentFullPath());
-    if (cnt != count_map_.end()) {
-      return cnt->second;
-    } else {
-      return 0;
-    }
-  }
+  virtual uint32_t getStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId);
 
-  virtual void incrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    const std::string str = streamId->getContentFullPath();
-    auto count = count_map_.find(str);
-    if (count != count_map_.end()) {
-      count_map_[str] = count->second + 1;
-    } else {
-      count_map_[str] = 1;
-    }
-  }
+  virtual void incrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId);
 
-  virtual void decrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    const std::string str = streamId->getContentFullPath();
-    auto count = count_map_.find(str);
-    if (count != count_map_.end() && count->second > 0) {
-      count_map_[str] = count->second - 1;
-    } else {
-	count_map_.erase(str);
-    }
-  }
+  virtual void decrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId);
+
+  /**
+   * Makes claim, a new claim, a composite claim: its content is the concatenation of the given ranges,
+   * which is read from the claims they refer to instead of being copied. Ranges of other composite
+   * claims are resolved to the ranges they refer to. The claims referred to are counted until the
+   * composite claim is removed. The ranges are stored as the content of a claim of their own, so that
+   * composite claims are restored after a restart.
+   * @return false if the ranges could not be stored
+   */
+  bool createComposite(const std::shared_ptr<minifi::ResourceClaim> &claim, const std::vector<ContentRange> &ranges);
+
+  /**
+   * Copies length bytes from offset of the content of claim into target, e.g. for writers that need
+   * the content of a composite claim in one piece.
+   */
+  bool copy(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length, const std::shared_ptr<minifi::ResourceClaim> &target);
+
+  static bool isComposite(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
+  /**
+   * Maps length bytes from offset of the content of claim into memory in one piece. Repositories storing
+   * content in files override this; the content of the others and of composite claims is read through read().
+   * @return nullptr if the content cannot be mapped
+   */
+  virtual std::shared_ptr<io::ContentBuffer> map(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length);
 
  protected:
 
+  /**
+   * Implementations of read, exists and remove hand composite claims to these, their content is
+   * neither written nor stored by the implementations.
+   */
+  std::shared_ptr<io::BaseStream> readComposite(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
+  bool compositeExists(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
+  bool removeComposite(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
   std::string directory_;
 
-  std::mutex count_map_mutex_;
+ private:
+
+  /**
+   * Reference counts are kept by claim ID, in shards with a lock of their own. Claims learn the ID of
+   * their content path the first time they are counted, claims of the same path share it; only then
+   * is the path hashed, to look it up in the path shards. The count of an ID and its path entry are
+   * only added and removed together, with the lock of the path shard taken first.
+   */
+  struct CountShard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, uint32_t> counts;
+  };
+
+  struct PathShard {
+    std::mutex mutex;
+    std::unordered_map<std::string, uint64_t> ids;
+  };
+
+  CountShard &getCountShard(uint64_t id) {
+    return count_shards_[id % CONTENT_REPOSITORY_COUNT_SHARDS];
+  }
+
+  PathShard &getPathShard(const std::string &path) {
+    return path_shards_[std::hash<std::string>()(path) % CONTENT_REPOSITORY_COUNT_SHARDS];
+  }
+
+  struct Composite {
+    std::vector<ContentRange> ranges;
+    // offset of each range in the content of the composite claim
+    std::vector<uint64_t> starts;
+    uint64_t size;
+  };
+
+  friend class CompositeStream;
+
+  static std::shared_ptr<minifi::ResourceClaim> getRangesClaim(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
+  // claims held by the repository, which are only counted and read through it
+  static std::shared_ptr<minifi::ResourceClaim> getRangeClaim(const std::string &path);
+
+  /**
+   * Returns the ranges of a composite claim. Claims created before a restart are loaded from their
+   * ranges claim the first time they are used, which counts the claims they refer to.
+   * @return nullptr if the ranges cannot be read
+   */
+  std::shared_ptr<const Composite> getComposite(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
+  std::atomic<uint64_t> next_claim_id_{1};
+
+  CountShard count_shards_[CONTENT_REPOSITORY_COUNT_SHARDS];
+
+  PathShard path_shards_[CONTENT_REPOSITORY_COUNT_SHARDS];
 
-  std::map<std::string, uint32_t> count_map_;
+  std::mutex composites_mutex_;
+  // composite claims by content path
+  std::unordered_map<std::string, std::shared_ptr<const Composite>> composites_;
 };
 
 } /* namespace core */
@@ -0,0 +1,128 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
+#define LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
+
+#include <memory>
+#include <string>
+#include "core/Core.h"
+#include "core/FlowFile.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: Decides the order in which FlowFiles are dequeued from a connection.
+ *
+ * Justification: Mirrors NiFi's FlowFilePrioritizer. Extensions may provide their own
+ * prioritizers by registering a subclass with the ClassLoader.
+ */
+class FlowFilePrioritizer : public CoreComponent {
+ public:
+  explicit FlowFilePrioritizer(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : CoreComponent(name, uuid) {
+  }
+
+  virtual ~FlowFilePrioritizer() = default;
+
+  /**
+   * @return true if lhs has to be dequeued before rhs. FlowFiles that are equivalent
+   * according to the prioritizer are dequeued in insertion order.
+   */
+  virtual bool prioritize(const FlowFile &lhs, const FlowFile &rhs) const = 0;
+
+  /**
+   * @return true if the prioritizer keeps the insertion order, which lets connections skip sorting
+   */
+  virtual bool isFirstInFirstOut() const {
+    return false;
+  }
+};
+
+// Dequeues FlowFiles in the order they were queued
+class FirstInFirstOutPrioritizer : public FlowFilePrioritizer {
+ public:
+  explicit FirstInFirstOutPrioritizer(const std::string &name = "FirstInFirstOutPrioritizer", utils::Identifier uuid = utils::Identifier())
+      : FlowFilePrioritizer(name, uuid) {
+  }
+
+  bool prioritize(const FlowFile &lhs, const FlowFile &rhs) const override {
+    return false;
+  }
+
+  bool isFirstInFirstOut() const override {
+    return true;
+  }
+};
+
+// Dequeues the FlowFile whose lineage started first
+class OldestFlowFileFirstPrioritizer : public FlowFilePrioritizer {
+ public:
+  explicit OldestFlowFileFirstPrioritizer(const std::string &name = "OldestFlowFileFirstPrioritizer", utils::Identifier uuid = utils::Identifier())
+      : FlowFilePrioritizer(name, uuid) {
+  }
+
+  bool prioritize(const FlowFile &lhs, const FlowFile &rhs) const override {
+    return lhs.getlineageStartDate() < rhs.getlineageStartDate();
+  }
+};
+
+// Dequeues the FlowFile whose lineage started last
+class NewestFlowFileFirstPrioritizer : public FlowFilePrioritizer {
+ public:
+  explicit NewestFlowFileFirstPrioritizer(const std::string &name = "NewestFlowFileFirstPrioritizer", utils::Identifier uuid = utils::Identifier())
+      : FlowFilePrioritizer(name, uuid) {
+  }
+
+  bool prioritize(const FlowFile &lhs, const FlowFile &rhs) const override {
+    return lhs.getlineageStartDate() > rhs.getlineageStartDate();
+  }
+};
+
+/**
+ * Orders FlowFiles by their "priority" attribute. Numeric priorities are compared numerically
+ * and come before textual ones, which are compared lexicographically. FlowFiles without the
+ * attribute come last. Lower values are dequeued first.
+ */
+class PriorityAttributePrioritizer : public FlowFilePrioritizer {
+ public:
+  static constexpr const char *PRIORITY_ATTRIBUTE = "priority";
+
+  explicit PriorityAttributePrioritizer(const std::string &name = "PriorityAttributePrioritizer", utils::Identifier uuid = utils::Identifier())
+      : FlowFilePrioritizer(name, uuid) {
+  }
+
+  bool prioritize(const FlowFile &lhs, const FlowFile &rhs) const override;
+};
+
+/**
+ * Creates the prioritizer identified by class_name, which can be either a fully qualified NiFi
+ * class name (org.apache.nifi.prioritizer.OldestFlowFileFirstPrioritizer) or the simple class name.
+ * @return the prioritizer or nullptr if it is unknown
+ */
+std::shared_ptr<FlowFilePrioritizer> createFlowFilePrioritizer(const std::string &class_name);
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_ */
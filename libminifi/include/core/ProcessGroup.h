@@ -111,6 +111,24 @@ class ProcessGroup {
   std::string getTransportProtocol() {
     return transport_protocol_;
   }
+  void setUseCompression(bool use_compression) {
+    use_compression_ = use_compression;
+  }
+  bool getUseCompression() {
+    return use_compression_;
+  }
+  void setPeerRefreshInterval(uint64_t interval_msec) {
+    peer_refresh_interval_msec_ = interval_msec;
+  }
+  uint64_t getPeerRefreshInterval() {
+    return peer_refresh_interval_msec_;
+  }
+  void setMaxTransactionsPerPeer(uint32_t max_transactions) {
+    max_transactions_per_peer_ = max_transactions;
+  }
+  uint32_t getMaxTransactionsPerPeer() {
+    return max_transactions_per_peer_;
+  }
   void setHttpProxyHost(std::string &host) {
     proxy_.host = host;
   }
@@ -259,6 +277,12 @@ class ProcessGroup {
   // http proxy
   utils::HTTPProxy proxy_;
   std::string transport_protocol_;
+  // whether the site-to-site data packets are compressed
+  std::atomic<bool> use_compression_;
+  // how often the site-to-site peers are refreshed
+  std::atomic<uint64_t> peer_refresh_interval_msec_;
+  // site-to-site transactions in flight with a single peer, 0 for no limit
+  std::atomic<uint32_t> max_transactions_per_peer_;
 
   // controller services
 
@@ -72,6 +72,13 @@ class ProcessSession : public ReferenceContainer {
   //
   // Get the FlowFile from the highest priority queue
   virtual std::shared_ptr<core::FlowFile> get();
+  /**
+   * Gets up to max FlowFiles from the incoming connections, draining each connection in batches.
+   * @param max maximum number of FlowFiles to return
+   * @param max_bytes maximum total content size to return, 0 means unlimited. The first FlowFile
+   * is always returned when available, even if it exceeds this limit.
+   */
+  virtual std::vector<std::shared_ptr<core::FlowFile>> get(size_t max, uint64_t max_bytes = 0);
   // Create a new UUID FlowFile with no content resource claim and without parent
   std::shared_ptr<core::FlowFile> create();
   // Create a new UUID FlowFile with no content resource claim and inherit all attributes from parent
@@ -94,10 +101,17 @@ class ProcessSession : public ReferenceContainer {
   void remove(const std::shared_ptr<core::FlowFile> &flow);
   // Execute the given read callback against the content
   void read(const std::shared_ptr<core::FlowFile> &flow, InputStreamCallback *callback);
+  // Execute the given read callback against the content, in one piece
+  void read(const std::shared_ptr<core::FlowFile> &flow, InputBufferCallback *callback);
   // Execute the given write callback against the content
   void write(const std::shared_ptr<core::FlowFile> &flow, OutputStreamCallback *callback);
   // Execute the given write/append callback against the content
   void append(const std::shared_ptr<core::FlowFile> &flow, OutputStreamCallback *callback);
+  /**
+   * Replaces the content of flow with the concatenation of the given ranges, e.g. of the content of other
+   * Flow Files, which is referred to instead of copied; see ContentRepository::createComposite.
+   */
+  void concatenate(const std::shared_ptr<core::FlowFile> &flow, const std::vector<ContentRange> &ranges);
   // Penalize the flow
   void penalize(const std::shared_ptr<core::FlowFile> &flow);
 
@@ -153,6 +167,10 @@ class ProcessSession : public ReferenceContainer {
  private:
 // Clone the flow file during transfer to multiple connections for a relationship
   std::shared_ptr<core::FlowFile> cloneDuringTransfer(std::shared_ptr<core::FlowFile> &parent);
+  // Register a FlowFile polled from an incoming connection with the session
+  void track(const std::shared_ptr<core::FlowFile> &flow);
+  // Report a FlowFile that expired in an incoming connection
+  void expire(const std::shared_ptr<core::FlowFile> &flow);
   // ProcessContext
   std::shared_ptr<ProcessContext> process_context_;
   // Logger
@@ -30,6 +30,7 @@
 #include <thread>
 #include <vector>
 #include "core/ContentRepository.h"
+#include "core/ContentPathDictionary.h"
 #include "core/SerializableComponent.h"
 #include "properties/Configure.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -65,6 +66,10 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
       : core::SerializableComponent(repo_name),
         thread_(),
         repo_size_(0),
+        recovering_(false),
+        recovered_count_(0),
+        discarded_count_(0),
+        recovery_duration_millis_(0),
         logger_(logging::LoggerFactory<Repository>::getLogger()) {
     directory_ = directory;
     max_partition_millis_ = maxPartitionMillis;
@@ -83,6 +88,13 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
     return true;
   }
 
+  /**
+   * @return true if the repository keeps its contents across restarts
+   */
+  virtual bool isPersistent() {
+    return false;
+  }
+
   virtual void flush();
 
   // initialize
@@ -221,6 +233,33 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
 
   virtual uint64_t getRepoSize();
 
+  // whether the records stored by an earlier run are being recovered
+  bool isRecovering() const {
+    return recovering_;
+  }
+
+  // number of records recovered so far
+  uint64_t getRecoveredCount() const {
+    return recovered_count_;
+  }
+
+  // number of stored records dropped during recovery, as they were unreadable or their connection is gone
+  uint64_t getDiscardedCount() const {
+    return discarded_count_;
+  }
+
+  // duration of the last recovery
+  uint64_t getRecoveryDurationMillis() const {
+    return recovery_duration_millis_;
+  }
+
+  /**
+   * Interned content path prefixes of the records stored in this repository.
+   */
+  ContentPathDictionary &getContentPathDictionary() {
+    return content_path_dictionary_;
+  }
+
   // Prevent default copy constructor and assignment operation
   // Only support pass by reference or pointer
   Repository(const Repository &parent) = delete;
@@ -248,6 +287,12 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
 
   // size of the directory
   std::atomic<uint64_t> repo_size_;
+  ContentPathDictionary content_path_dictionary_;
+  // recovery progress
+  std::atomic<bool> recovering_;
+  std::atomic<uint64_t> recovered_count_;
+  std::atomic<uint64_t> discarded_count_;
+  std::atomic<uint64_t> recovery_duration_millis_;
   // Run function for the thread
   void threadExecutor() {
     run();
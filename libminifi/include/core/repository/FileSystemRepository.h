@@ -53,6 +53,9 @@ class FileSystemRepository : public core::ContentRepository, public core::CoreCo
 
   virtual std::shared_ptr<io::BaseStream> read(const std::shared_ptr<minifi::ResourceClaim> &claim);
 
+  // maps the range of the file of the claim into memory
+  virtual std::shared_ptr<io::ContentBuffer> map(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length);
+
   virtual bool close(const std::shared_ptr<minifi::ResourceClaim> &claim) {
     return remove(claim);
   }
@@ -0,0 +1,309 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_SLABCONTENTREPOSITORY_H_
+#define LIBMINIFI_INCLUDE_CORE_REPOSITORY_SLABCONTENTREPOSITORY_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "core/Core.h"
+#include "../ContentRepository.h"
+#include "io/BaseStream.h"
+#include "properties/Configure.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+#define SLAB_CONTENT_REPOSITORY_CONTAINER_SIZE (8 * 1024 * 1024)
+#define SLAB_CONTENT_REPOSITORY_COMPACTION_THRESHOLD (50)
+#define SLAB_CONTENT_REPOSITORY_COMPACTION_PERIOD (1000)
+// content up to this size is written to its container at once, when its stream is closed
+#define SLAB_CONTENT_REPOSITORY_STREAM_BUFFER_SIZE (64 * 1024)
+
+class SlabContentRepository;
+
+/**
+ * Append-only file holding the content of many claims, see SlabContentRepository.
+ */
+class SlabContainer {
+ public:
+  SlabContainer(uint64_t id, std::string path, uint64_t size);
+
+  SlabContainer(const SlabContainer &other) = delete;
+  SlabContainer &operator=(const SlabContainer &other) = delete;
+
+  // removes the file of discarded containers, once the last stream reading it is gone
+  ~SlabContainer();
+
+  uint64_t getId() const {
+    return id_;
+  }
+
+  const std::string &getPath() const {
+    return path_;
+  }
+
+  /**
+   * Returns an input stream on the container, reusing the ones returned earlier.
+   * @return nullptr if the file cannot be opened
+   */
+  std::unique_ptr<std::ifstream> borrowReader();
+
+  void returnReader(std::unique_ptr<std::ifstream> reader);
+
+ private:
+  friend class SlabContentRepository;
+  friend class SlabStream;
+
+  const uint64_t id_;
+  const std::string path_;
+
+  std::mutex readers_mutex_;
+  std::vector<std::unique_ptr<std::ifstream>> readers_;
+
+  // only used by the holder of the lease
+  std::ofstream writer_;
+  // end of the last record, written by the holder of the lease
+  uint64_t size_;
+
+  // the fields below are guarded by the mutex of the repository
+  bool leased_;
+  // no longer written, either full or recovered after a restart
+  bool sealed_;
+  bool discarded_;
+  // bytes of the records that are still referenced
+  uint64_t live_bytes_;
+  // sequence numbers of the deleted records, which have a tombstone in some container
+  std::vector<uint64_t> dead_sequences_;
+};
+
+/**
+ * Stream on a single claim of a SlabContentRepository.
+ *
+ * Written content is buffered until it exceeds SLAB_CONTENT_REPOSITORY_STREAM_BUFFER_SIZE, so a small
+ * claim only holds a container for a single write when its stream is closed. Larger claims hold one
+ * until they are closed. The claim becomes readable when its stream is closed.
+ */
+class SlabStream : public io::BaseStream {
+ public:
+  /**
+   * Write stream, the repository has to outlive it.
+   * @param expected_sequence see SlabContentRepository::commitRecord
+   */
+  SlabStream(SlabContentRepository *repository, std::string path, uint64_t expected_sequence = 0);
+
+  // read stream
+  SlabStream(std::shared_ptr<SlabContainer> container, uint64_t data_offset, uint64_t length);
+
+  ~SlabStream() override {
+    closeStream();
+  }
+
+  void closeStream() override;
+
+  void seek(uint64_t offset) override;
+
+  const uint64_t getSize() const override {
+    return size_;
+  }
+
+  int read(uint16_t &value, bool is_little_endian) override;
+
+  int read(uint32_t &value, bool is_little_endian) override;
+
+  int read(uint64_t &value, bool is_little_endian) override;
+
+  int readData(std::vector<uint8_t> &buf, int buflen) override;
+
+  int readData(uint8_t *buf, int buflen) override;
+
+  virtual int writeData(std::vector<uint8_t> &buf, int buflen);
+
+  int writeData(uint8_t *value, int size) override;
+
+ private:
+  friend class SlabContentRepository;
+
+  // moves the buffered content to a leased container
+  bool spill();
+
+  SlabContentRepository *repository_;
+  const std::string path_;
+  std::shared_ptr<SlabContainer> container_;
+  std::unique_ptr<std::ifstream> reader_;
+  std::vector<uint8_t> buffer_;
+  uint64_t record_offset_;
+  uint64_t data_offset_;
+  uint64_t sequence_;
+  uint64_t expected_sequence_;
+  uint64_t size_;
+  // position of the next read
+  uint64_t offset_;
+  bool write_enable_;
+  bool closed_;
+  bool failed_;
+};
+
+/**
+ * Content repository that packs the content of many claims into large, append-only container files.
+ *
+ * FileSystemRepository creates and unlinks a file per claim, which limits it to a few thousand small
+ * claims per second. Here each claim is a record in a container, found through an in-memory index of
+ * the claims; writing a claim appends to an open container and removing it only updates the index
+ * and appends a small tombstone record, so that it stays removed after a restart. Containers are
+ * written by one stream at a time; once a container reaches the configured size it is sealed. A
+ * background thread compacts sealed containers whose live content dropped below the configured
+ * percentage, by copying their live records to other containers and deleting the file.
+ *
+ * The index is rebuilt by reading the record headers of the containers on startup.
+ */
+class SlabContentRepository : public core::ContentRepository, public core::CoreComponent {
+ public:
+  explicit SlabContentRepository(std::string name = getClassName<SlabContentRepository>())
+      : core::CoreComponent(name),
+        container_size_(SLAB_CONTENT_REPOSITORY_CONTAINER_SIZE),
+        compaction_threshold_(SLAB_CONTENT_REPOSITORY_COMPACTION_THRESHOLD),
+        compaction_period_(SLAB_CONTENT_REPOSITORY_COMPACTION_PERIOD),
+        next_container_id_(0),
+        next_sequence_(1),
+        running_(false),
+        logger_(logging::LoggerFactory<SlabContentRepository>::getLogger()) {
+  }
+
+  virtual ~SlabContentRepository() {
+    stop();
+  }
+
+  virtual bool initialize(const std::shared_ptr<minifi::Configure> &configuration);
+
+  virtual void stop();
+
+  virtual bool exists(const std::shared_ptr<minifi::ResourceClaim> &streamId);
+
+  virtual std::shared_ptr<io::BaseStream> write(const std::shared_ptr<minifi::ResourceClaim> &claim, bool append = false);
+
+  virtual std::shared_ptr<io::BaseStream> read(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
+  // maps the record of the claim within its container into memory
+  virtual std::shared_ptr<io::ContentBuffer> map(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length);
+
+  virtual bool close(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+    return remove(claim);
+  }
+
+  virtual bool remove(const std::shared_ptr<minifi::ResourceClaim> &claim);
+
+  /**
+   * Compacts the sealed containers that qualify for it and writes the pending tombstones. Called
+   * periodically by the compaction thread.
+   * @return number of containers compacted
+   */
+  size_t compact();
+
+  size_t getContainerCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return containers_.size();
+  }
+
+ protected:
+  friend class SlabStream;
+
+  struct Location {
+    std::shared_ptr<SlabContainer> container;
+    uint64_t sequence;
+    uint64_t record_offset;
+    uint64_t data_offset;
+    uint64_t length;
+  };
+
+  // leases a container for writing, creating a new one if none is free
+  std::shared_ptr<SlabContainer> leaseContainer();
+
+  // seal: no more records may be appended, e.g. because an incomplete one was left behind
+  void releaseContainer(const std::shared_ptr<SlabContainer> &container, bool seal = false);
+
+  uint64_t nextSequence() {
+    return next_sequence_++;
+  }
+
+  /**
+   * Makes a complete record the content of path. Called with the container of the record leased;
+   * writes the pending tombstones into it, so they are flushed with the record.
+   * @param expected_sequence if non-zero, the record only replaces the record with this sequence
+   * number, otherwise it is discarded
+   */
+  void commitRecord(const std::string &path, const Location &location, uint64_t expected_sequence = 0);
+
+  // removes the record at location from the accounting, called with mutex_ locked
+  void discardRecord(const Location &location);
+
+  void writeTombstones(const std::shared_ptr<SlabContainer> &container);
+
+  void flushTombstones();
+
+  bool recover();
+
+  void compact(const std::shared_ptr<SlabContainer> &container);
+
+  void run();
+
+  uint64_t container_size_;
+  uint64_t compaction_threshold_;
+  uint64_t compaction_period_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Location> index_;
+  std::map<uint64_t, std::shared_ptr<SlabContainer>> containers_;
+  std::vector<std::shared_ptr<SlabContainer>> writable_;
+  // container IDs of the deleted records that are still on disk, by sequence number
+  std::unordered_map<uint64_t, uint64_t> dead_records_;
+  std::vector<uint64_t> pending_tombstones_;
+  uint64_t next_container_id_;
+  std::atomic<uint64_t> next_sequence_;
+
+  std::mutex compaction_mutex_;
+  std::mutex run_mutex_;
+  std::condition_variable run_condition_;
+  bool running_;
+  std::thread compaction_thread_;
+
+ private:
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_REPOSITORY_SLABCONTENTREPOSITORY_H_ */
@@ -82,6 +82,30 @@ class RepositoryMetrics : public ResponseNode {
       parent.children.push_back(datasizemax);
       parent.children.push_back(queuesize);
 
+      // only persistent repositories recover records on startup
+      if (repo->isPersistent()) {
+        SerializedResponseNode recovering;
+        recovering.name = "recovering";
+        recovering.value = repo->isRecovering();
+
+        SerializedResponseNode recovered;
+        recovered.name = "recoveredCount";
+        recovered.value = std::to_string(repo->getRecoveredCount());
+
+        SerializedResponseNode discarded;
+        discarded.name = "discardedCount";
+        discarded.value = std::to_string(repo->getDiscardedCount());
+
+        SerializedResponseNode duration;
+        duration.name = "recoveryDurationMillis";
+        duration.value = std::to_string(repo->getRecoveryDurationMillis());
+
+        parent.children.push_back(recovering);
+        parent.children.push_back(recovered);
+        parent.children.push_back(discarded);
+        parent.children.push_back(duration);
+      }
+
       serialized.push_back(parent);
     }
     return serialized;
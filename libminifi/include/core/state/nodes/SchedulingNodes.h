@@ -19,8 +19,13 @@
 #define LIBMINIFI_INCLUDE_CORE_STATE_NODES_SCHEDULINGNODES_H_
 
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "MetricsBase.h"
 #include "core/ProcessorConfig.h"
+#include "utils/TimerWheel.h"
 
 namespace org {
 namespace apache {
@@ -93,6 +98,59 @@ class SchedulingDefaults : public DeviceInformation {
 
 };
 
+/**
+ * Justification and Purpose: Provides the lateness of the delayed processor triggers, which shows
+ * whether the flow engine threads keep up with the scheduling periods.
+ */
+class SchedulingMetrics : public ResponseNode {
+ public:
+  SchedulingMetrics(const std::string &name, utils::Identifier &uuid)
+      : ResponseNode(name, uuid) {
+  }
+
+  SchedulingMetrics(const std::string &name)
+      : ResponseNode(name) {
+  }
+
+  SchedulingMetrics()
+      : ResponseNode("SchedulingMetrics") {
+  }
+
+  virtual std::string getName() const {
+    return "SchedulingMetrics";
+  }
+
+  void setTimerLateness(const std::shared_ptr<utils::TimerLateness> &timer_lateness) {
+    timer_lateness_ = timer_lateness;
+  }
+
+  std::vector<SerializedResponseNode> serialize() {
+    std::vector<SerializedResponseNode> serialized;
+    if (nullptr == timer_lateness_) {
+      return serialized;
+    }
+
+    SerializedResponseNode expired;
+    expired.name = "delayedTriggers";
+    expired.value = std::to_string(timer_lateness_->getExpiredCount());
+
+    SerializedResponseNode average;
+    average.name = "averageLatenessMicros";
+    average.value = std::to_string(timer_lateness_->getAverage().count());
+
+    SerializedResponseNode max;
+    max.name = "maxLatenessMicros";
+    max.value = std::to_string(timer_lateness_->getMax().count());
+
+    serialized.push_back(expired);
+    serialized.push_back(average);
+    serialized.push_back(max);
+    return serialized;
+  }
+
+ protected:
+  std::shared_ptr<utils::TimerLateness> timer_lateness_;
+};
 
 } /* namespace metrics */
 } /* namespace state */
@@ -194,6 +194,22 @@ class Socket : public BaseStream {
    */
   virtual int writeData(uint8_t *value, int size);
 
+  int64_t readv(const IoVec *buffers, size_t count) override {
+    return readv(buffers, count, true);
+  }
+
+  /**
+   * Reads into the buffers with as few calls as possible, by scattering the received data.
+   * @param retrieve_all_bytes determines if we should fill all buffers before returning
+   * @return bytes read, -1 on error, -2 if the socket would block
+   */
+  virtual int64_t readv(const IoVec *buffers, size_t count, bool retrieve_all_bytes);
+
+  /**
+   * Writes the buffers with as few calls as possible, by gathering them into a single send.
+   */
+  int64_t writev(const IoVec *buffers, size_t count) override;
+
   /**
    * Writes a system word
    * @param value value to write
@@ -280,6 +296,14 @@ class Socket : public BaseStream {
    */
   virtual int16_t select_descriptor(uint16_t msec);
 
+  /**
+   * Accepts the connections pending on a non-blocking server socket, until it would block.
+   * @param drained set to false if accepting failed before all pending connections were accepted,
+   * in which case the server socket has to be paused and retried since it is not notified again
+   * @returns the accepted connections, to be made blocking by whoever serves them
+   */
+  std::vector<SocketDescriptor> accept_connections(bool &drained);
+
   std::recursive_mutex selection_mutex_;
 
   std::string requested_hostname_;
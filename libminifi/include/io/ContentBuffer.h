@@ -0,0 +1,83 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_IO_CONTENTBUFFER_H_
+#define LIBMINIFI_INCLUDE_IO_CONTENTBUFFER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/**
+ * Read-only range of content in one contiguous piece, e.g. for hashing or matching it without copying
+ * it through a stream into small buffers first. The range is either a memory mapped range of a file or
+ * a copy of the content held by the buffer.
+ */
+class ContentBuffer {
+ public:
+  // takes ownership of a copy of the content
+  explicit ContentBuffer(std::vector<uint8_t> data);
+
+  ContentBuffer(const ContentBuffer &other) = delete;
+  ContentBuffer &operator=(const ContentBuffer &other) = delete;
+
+  ~ContentBuffer();
+
+  /**
+   * Maps length bytes from offset of the file at path into memory. The range is cut at the end of the
+   * file. The file must not be truncated while the buffer is in use; it may be unlinked.
+   * @return nullptr if the file cannot be mapped, e.g. on platforms without mmap
+   */
+  static std::unique_ptr<ContentBuffer> map(const std::string &path, uint64_t offset, uint64_t length);
+
+  const uint8_t *data() const {
+    return data_;
+  }
+
+  uint64_t size() const {
+    return size_;
+  }
+
+  bool isMapped() const {
+    return mapping_ != nullptr;
+  }
+
+ private:
+  ContentBuffer(void *mapping, uint64_t mapping_size, const uint8_t *data, uint64_t size);
+
+  std::vector<uint8_t> owned_;
+  // the mapping starts at the page boundary before data_
+  void *mapping_;
+  uint64_t mapping_size_;
+  const uint8_t *data_;
+  uint64_t size_;
+};
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_IO_CONTENTBUFFER_H_ */
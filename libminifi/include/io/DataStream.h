@@ -20,6 +20,7 @@
 #define LIBMINIFI_INCLUDE_IO_DATASTREAM_H_
 
 #include <iostream>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include "EndianCheck.h"
@@ -28,6 +29,14 @@ namespace apache {
 namespace nifi {
 namespace minifi {
 namespace io {
+/**
+ * Buffer of a vectored read or write, see DataStream::readv and DataStream::writev.
+ */
+struct IoVec {
+  uint8_t *data;
+  uint64_t length;
+};
+
 /**
  * DataStream defines the mechanism through which
  * binary data will be written to a sink
@@ -43,7 +52,9 @@ class DataStream {
    * Constructor
    **/
   explicit DataStream(const uint8_t *buf, const uint32_t buflen) {
-    writeData((uint8_t*) buf, buflen);
+    if (buf != nullptr) {
+      buffer.assign(buf, buf + buflen);
+    }
   }
 
   virtual short initialize() {
@@ -78,6 +89,31 @@ class DataStream {
    */
   virtual int writeData(uint8_t *value, int size);
 
+  /**
+   * Reads into the buffers in order, like readv(2). Unlike readData, the lengths are 64 bit.
+   * This implementation reads through readData, streams override it to read the buffers at once.
+   * @param buffers buffers to fill
+   * @param count number of buffers
+   * @return bytes read, fewer than the buffers hold at the end of the stream; -1 on error
+   */
+  virtual int64_t readv(const IoVec *buffers, size_t count);
+
+  /**
+   * Writes the buffers in order, like writev(2). Unlike writeData, the lengths are 64 bit.
+   * This implementation writes through writeData, streams override it to write the buffers at once.
+   * @param buffers buffers to write
+   * @param count number of buffers
+   * @return bytes written; -1 on error
+   */
+  virtual int64_t writev(const IoVec *buffers, size_t count);
+
+  /**
+   * Reserves room in the buffer for size bytes in total, ahead of writing them.
+   */
+  void reserve(uint64_t size) {
+    buffer.reserve(size);
+  }
+
   /**
    * Reads a system word
    * @param value value to write
@@ -117,7 +153,7 @@ class DataStream {
   std::vector<uint8_t> buffer;
 
   // read offset to buffer
-  uint32_t readBuffer = 0;
+  uint64_t readBuffer = 0;
 
  private:
 
@@ -0,0 +1,209 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_IO_EVENTREACTOR_H_
+#define LIBMINIFI_INCLUDE_IO_EVENTREACTOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "io/ClientSocket.h"
+#include "core/logging/Logger.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+#define REACTOR_DEFAULT_THREADS 2
+#define REACTOR_DEFAULT_WORKERS 8
+// tasks waiting for a worker, beyond which submitting fails
+#define REACTOR_MAX_PENDING_TASKS 4096
+// receive and send timeout of connections served by the workers, in milliseconds
+#define REACTOR_CONNECTION_TIMEOUT 30000
+// pause of a listening socket whose connections cannot be accepted for now, e.g. for lack of descriptors
+#define REACTOR_ACCEPT_RETRY_PERIOD 1000
+// events returned by a single wait of a reactor thread
+#define REACTOR_MAX_EVENTS 64
+// where there is no epoll, registration changes are picked up by the waiting threads within this many milliseconds
+#define REACTOR_POLL_PERIOD 100
+
+/**
+ * Notifies the handlers of registered sockets when they become readable or writable.
+ *
+ * The sockets are spread over a fixed number of threads. On Linux each of them waits on an epoll instance
+ * of its own, and notifications are edge triggered: once notified, a handler has to read or write until the
+ * socket would block, otherwise it is not notified again. Elsewhere the threads poll() their sockets and
+ * handlers are notified as long as their sockets are ready, which suits the same handlers.
+ *
+ * Handlers run on the thread of their socket, one at a time per socket, so they must not block. Work that
+ * blocks, such as serving a connection with a blocking stream handler, is submitted to the bounded pool of
+ * workers of the reactor instead.
+ */
+class EventReactor {
+ public:
+  enum Event : uint32_t {
+    READ = 1,
+    WRITE = 2,
+    // the peer closed the connection or the socket failed, reported whatever the registered events are
+    HANGUP = 4
+  };
+
+  // called with the events that occurred
+  using Handler = std::function<void(uint32_t events)>;
+
+  explicit EventReactor(size_t threads = REACTOR_DEFAULT_THREADS, size_t workers = REACTOR_DEFAULT_WORKERS);
+
+  EventReactor(const EventReactor &other) = delete;
+  EventReactor &operator=(const EventReactor &other) = delete;
+
+  ~EventReactor();
+
+  /**
+   * Returns the reactor shared by the sockets of the agent, which is created on demand and stopped once
+   * its last user releases it.
+   */
+  static std::shared_ptr<EventReactor> getInstance();
+
+  /**
+   * Sets the number of threads of the shared reactor, from the next time it is created.
+   */
+  static void setThreadCount(size_t threads);
+
+  /**
+   * Sets the number of workers of the shared reactor, from the next time it is created.
+   */
+  static void setWorkerCount(size_t workers);
+
+  /**
+   * Sets or clears the non-blocking flag of a socket. Registered sockets are usually non-blocking, so that
+   * their handlers can tell when they were drained.
+   */
+  static bool setNonBlocking(SocketDescriptor fd, bool non_blocking = true);
+
+  /**
+   * Sets the receive and send timeout of a blocking socket, so that a client that stops sending or
+   * receiving holds a worker for a bounded time only.
+   */
+  static bool setTimeout(SocketDescriptor fd, uint32_t timeout_ms = REACTOR_CONNECTION_TIMEOUT);
+
+  /**
+   * Registers a socket.
+   * @param events READ and/or WRITE
+   * @return false if the socket is already registered or cannot be waited on
+   */
+  bool add(SocketDescriptor fd, uint32_t events, Handler handler);
+
+  /**
+   * Changes the events a registered socket is waited for. The handler is notified if the socket is ready
+   * for any of them.
+   */
+  bool modify(SocketDescriptor fd, uint32_t events);
+
+  /**
+   * Unregisters a socket. Once this returns its handler is neither running nor called again, unless it is
+   * called from the handler itself. The socket may be closed afterwards.
+   */
+  void remove(SocketDescriptor fd);
+
+  /**
+   * Stops notifying the handler of a registered socket for delay_ms milliseconds. Afterwards the handler is
+   * notified again if the socket is ready, which suits handlers that cannot drain their socket for now.
+   */
+  void pause(SocketDescriptor fd, uint32_t delay_ms);
+
+  /**
+   * Runs a task on one of the workers, which may block, unlike handlers.
+   * @return false if REACTOR_MAX_PENDING_TASKS tasks are waiting for a worker already
+   */
+  bool submit(std::function<void()> task);
+
+  size_t getThreadCount() const {
+    return loops_.size();
+  }
+
+  size_t getWorkerCount() const {
+    return workers_.size();
+  }
+
+ private:
+  struct Registration {
+    SocketDescriptor fd;
+    uint64_t id;
+    uint32_t events;
+    Handler handler;
+  };
+
+  struct Loop {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable dispatched;
+    std::unordered_map<uint64_t, std::shared_ptr<Registration>> registrations;
+    // registration of the handler being called
+    uint64_t dispatching{0};
+#ifdef __linux__
+    int epoll_fd{-1};
+    int wakeup_fd{-1};
+#endif
+  };
+
+  void run(Loop *loop);
+
+  void dispatch(Loop *loop, uint64_t id, uint32_t events);
+
+  void work();
+
+  // runs a task on a worker once the delay passed, regardless of REACTOR_MAX_PENDING_TASKS
+  void schedule(std::function<void()> task, std::chrono::steady_clock::time_point when);
+
+  // sets the events of a registration unless it was removed meanwhile
+  bool modify(SocketDescriptor fd, uint64_t id, uint32_t events);
+
+  std::vector<std::unique_ptr<Loop>> loops_;
+
+  std::mutex mutex_;
+  // loop and registration ID of the sockets
+  std::unordered_map<SocketDescriptor, std::pair<Loop*, uint64_t>> sockets_;
+  uint64_t next_id_;
+  size_t next_loop_;
+  std::atomic<bool> running_;
+
+  std::vector<std::thread> workers_;
+  std::mutex tasks_mutex_;
+  std::condition_variable tasks_available_;
+  // tasks by the time they are due
+  std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> tasks_;
+  bool working_;
+
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+#endif /* LIBMINIFI_INCLUDE_IO_EVENTREACTOR_H_ */
@@ -42,7 +42,7 @@ class FileStream : public io::BaseStream {
    * File Stream constructor that accepts an fstream shared pointer.
    * It must already be initialized for read and write.
    */
-  explicit FileStream(const std::string &path, uint32_t offset, bool write_enable = false);
+  explicit FileStream(const std::string &path, uint64_t offset, bool write_enable = false);
 
   /**
    * File Stream constructor that accepts an fstream shared pointer.
@@ -96,6 +96,13 @@ class FileStream : public io::BaseStream {
    */
   int writeData(uint8_t *value, int size) override;
 
+  int64_t readv(const IoVec *buffers, size_t count) override;
+
+  /**
+   * Writes the buffers and flushes the file once
+   */
+  int64_t writev(const IoVec *buffers, size_t count) override;
+
   /**
    * Returns the underlying buffer
    * @return vector's array
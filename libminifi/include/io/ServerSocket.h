@@ -18,7 +18,14 @@
 #ifndef LIBMINIFI_INCLUDE_IO_SERVERSOCKET_H_
 #define LIBMINIFI_INCLUDE_IO_SERVERSOCKET_H_
 
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
 #include "io/ClientSocket.h"
+#include "io/EventReactor.h"
 
 namespace org {
 namespace apache {
@@ -55,17 +62,37 @@ class ServerSocket : public BaseServerSocket, public Socket {
   }
 
   /**
-   * Registers a call back and starts the read for the server socket.
+   * Registers a call back and starts the read for the server socket. Connections are accepted by the
+   * shared EventReactor and the handler is called on its workers once a connection sent data, with
+   * REACTOR_CONNECTION_TIMEOUT applied to the reads and writes of the connection.
    */
   virtual void registerCallback(std::function<bool()> accept_function, std::function<void(io::BaseStream *)> handler);
 
  private:
+  // registers the connections accepted by the reactor
+  void on_accept();
 
-  void close_fd(int fd );
+  // hands a connection that has data to a worker
+  void on_read(SocketDescriptor fd);
 
-  std::atomic<bool> running_;
+  // calls the handler for a connection, on a worker
+  void serve(SocketDescriptor fd);
 
-  std::thread server_read_thread_;
+  void finish_serving();
+
+  void close_fd(int fd);
+
+  std::shared_ptr<EventReactor> reactor_;
+
+  std::function<void(io::BaseStream *)> handler_;
+
+  std::mutex connections_mutex_;
+  // accepted connections, closed by whoever removes them
+  std::set<SocketDescriptor> connections_;
+  // connections handed to the workers
+  size_t serving_{0};
+  bool closing_{false};
+  std::condition_variable served_;
 
   std::shared_ptr<logging::Logger> logger_;
 };
@@ -76,9 +76,14 @@ class ZlibCompressStream : public ZlibBaseStream {
 
   int writeData(uint8_t* value, int size) override;
 
+  int64_t writev(const IoVec *buffers, size_t count) override;
+
   void closeStream() override;
 
  private:
+  // runs deflate on the input and writes its output to the underlying stream
+  bool compress(uint8_t* value, uint64_t size, int flush);
+
   std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<ZlibCompressStream>::getLogger()};
 };
 
@@ -96,7 +101,12 @@ class ZlibDecompressStream : public ZlibBaseStream {
 
   int writeData(uint8_t *value, int size) override;
 
+  int64_t writev(const IoVec *buffers, size_t count) override;
+
  private:
+  // runs inflate on the input and writes its output to the underlying stream
+  bool decompress(uint8_t* value, uint64_t size);
+
   std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<ZlibDecompressStream>::getLogger()};
 };
 
@@ -18,7 +18,16 @@
 #ifndef LIBMINIFI_INCLUDE_IO_TLSSERVERSOCKET_H_
 #define LIBMINIFI_INCLUDE_IO_TLSSERVERSOCKET_H_
 
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 #include "TLSSocket.h"
+#include "../EventReactor.h"
 #include "../ServerSocket.h"
 
 namespace org {
@@ -27,6 +36,9 @@ namespace nifi {
 namespace minifi {
 namespace io {
 
+// period of sending data to the connections of a broadcasting server socket, in milliseconds
+#define TLS_SERVER_BROADCAST_PERIOD 3000
+
 /**
  * Purpose: Server socket abstraction that makes focusing the accept/block paradigm
  * simpler.
@@ -47,23 +59,57 @@ class TLSServerSocket : public BaseServerSocket, public TLSSocket {
   }
 
   /**
-   * Registers a call back and starts the read for the server socket.
+   * Registers a call back and starts the read for the server socket. The handler provides the data that is
+   * sent to each accepted connection once its handshake completed on a worker of the shared EventReactor, and then to all of them every TLS_SERVER_BROADCAST_PERIOD milliseconds,
+   * as long as accept_function returns true.
    */
   void registerCallback(std::function<bool()> accept_function, std::function<int(std::vector<uint8_t>*,int *)> handler);
 
   /**
-   * Initializes the socket
-   * @return result of the creation operation.
+   * Registers a call back and starts the read for the server socket. Connections are accepted by the
+   * shared EventReactor and the handshake and the handler run on its workers once a connection sent data,
+   * with REACTOR_CONNECTION_TIMEOUT applied to the reads and writes of the connection.
    */
   virtual void registerCallback(std::function<bool()> accept_function, std::function<void(io::BaseStream *)> handler);
 
  private:
+  // registers the connections accepted by the reactor
+  void on_accept();
+
+  // hands a connection that has data to a worker
+  void on_read(SocketDescriptor fd);
+
+  // performs the handshake and calls the handler for a connection, on a worker
+  void serve(SocketDescriptor fd);
+
+  // marks a connection as handed to a worker, unless the server socket is closing
+  bool start_serving(SocketDescriptor fd);
+
+  // makes a connection blocking with a timeout, on a worker
+  bool prepare(SocketDescriptor fd);
+
+  void finish_serving(SocketDescriptor fd);
+
+  // sends the data of the handler to a connection, closing it on failure
+  bool send_data(const std::function<int(std::vector<uint8_t>*, int *)> &handler, SocketDescriptor fd);
+
+  void close_fd(int fd);
+
+  std::shared_ptr<EventReactor> reactor_;
 
-  std::function<void(std::function<bool()> accept_function, std::function<int(std::vector<uint8_t>*,int *)> handler)> fx;
+  std::function<void(io::BaseStream *)> handler_;
 
-  void close_fd(int fd );
+  std::mutex connections_mutex_;
+  // accepted connections, closed by whoever removes them
+  std::set<SocketDescriptor> connections_;
+  // connections handed to the workers
+  std::set<SocketDescriptor> serving_;
+  bool closing_{false};
+  std::condition_variable served_;
 
-  std::atomic<bool> running_;
+  std::mutex running_mutex_;
+  std::condition_variable running_condition_;
+  bool running_;
 
   std::thread server_read_thread_;
 
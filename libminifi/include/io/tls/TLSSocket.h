@@ -33,6 +33,9 @@ namespace nifi {
 namespace minifi {
 namespace io {
 
+// buffers written together are sent in a single TLS record up to this size
+#define TLS_GATHER_BUFFER_SIZE (16 * 1024)
+
 #define TLS_GOOD 0
 #define TLS_ERROR_CONTEXT 1
 #define TLS_ERROR_PEM_MISSING 2
@@ -158,6 +161,15 @@ class TLSSocket : public Socket {
    */
   int writeData(uint8_t *value, int size);
 
+  int64_t readv(const IoVec *buffers, size_t count) override;
+
+  int64_t readv(const IoVec *buffers, size_t count, bool retrieve_all_bytes) override;
+
+  /**
+   * Writes the buffers; small buffers are gathered into a single TLS record.
+   */
+  int64_t writev(const IoVec *buffers, size_t count) override;
+
   void closeStream();  // override
 
  protected:
@@ -174,8 +186,15 @@ class TLSSocket : public Socket {
     }
   }
 
+  // frees the SSL of an accepted connection and closes it
   void close_ssl(int fd);
 
+  /**
+   * Performs the handshake on an accepted connection.
+   * @return the SSL of the connection, nullptr if the handshake failed
+   */
+  SSL *accept_ssl(int fd);
+
   std::atomic<bool> connected_{ false };
   std::shared_ptr<TLSContext> context_;
   SSL* ssl_{ nullptr };
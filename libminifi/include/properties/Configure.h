@@ -59,6 +59,9 @@ class Configure : public Properties {
   static const char *nifi_flow_engine_threads;
   static const char *nifi_flow_engine_alert_period;
   static const char *nifi_flow_engine_event_driven_time_slice;
+  static const char *nifi_flow_engine_work_stealing;
+  static const char *nifi_io_reactor_threads;
+  static const char *nifi_io_reactor_workers;
   static const char *nifi_administrative_yield_duration;
   static const char *nifi_bored_yield_duration;
   static const char *nifi_graceful_shutdown_seconds;
@@ -77,8 +80,15 @@ class Configure : public Properties {
   static const char *nifi_provenance_repository_enable;
   static const char *nifi_flowfile_repository_max_storage_time;
   static const char *nifi_dbcontent_repository_directory_default;
+  static const char *nifi_slab_content_repository_directory_default;
+  static const char *nifi_slab_content_repository_container_size;
+  static const char *nifi_slab_content_repository_compaction_threshold;
+  static const char *nifi_slab_content_repository_compaction_period;
   static const char *nifi_flowfile_repository_max_storage_size;
   static const char *nifi_flowfile_repository_directory_default;
+  static const char *nifi_flowfile_repository_commit_window;
+  static const char *nifi_flowfile_repository_sync_writes;
+  static const char *nifi_flowfile_repository_recovery_threads;
   static const char *nifi_flowfile_repository_enable;
   static const char *nifi_remote_input_secure;
   static const char *nifi_remote_input_http;
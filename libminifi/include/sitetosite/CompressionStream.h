@@ -0,0 +1,121 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_SITETOSITE_COMPRESSIONSTREAM_H_
+#define LIBMINIFI_INCLUDE_SITETOSITE_COMPRESSIONSTREAM_H_
+
+#include <zlib.h>
+#include <cstdint>
+#include <vector>
+
+#include "io/BaseStream.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sitetosite {
+
+// raw bytes compressed at once, as in NiFi's CompressionOutputStream
+#define SITE2SITE_COMPRESSION_BUFFER_SIZE 65536
+// largest chunk accepted from a peer
+#define SITE2SITE_COMPRESSION_MAX_CHUNK_SIZE (1 << 24)
+
+/**
+ * Purpose and Justification: When compression is negotiated, NiFi compresses every data packet of a transaction
+ * on its own. A packet is written as a sequence of chunks, each made of the bytes "SYNC", the raw and compressed
+ * lengths and the zlib compressed bytes, and chunks are separated by a 1 and ended by a 0. The response codes
+ * exchanged between the packets are not compressed.
+ *
+ * The stream frames the packets written to it and unframes the packets read from it. Without compression it
+ * passes the bytes through, so a transaction reads and writes its packets the same way either way.
+ */
+class CompressionStream : public io::BaseStream {
+ public:
+  /**
+   * Raw pointer because the caller guarantees that it will exceed our lifetime.
+   */
+  CompressionStream(io::BaseStream *stream, bool compress, int level = Z_BEST_SPEED);
+
+  ~CompressionStream() override = default;
+
+  io::BaseStream *getstream() const {
+    return stream_;
+  }
+
+  bool isCompressing() const {
+    return compress_;
+  }
+
+  int readData(std::vector<uint8_t> &buf, int buflen) override;
+
+  int readData(uint8_t *buf, int buflen) override;
+
+  int writeData(uint8_t *value, int size) override;
+
+  /**
+   * Writes the rest of the packet written so far and ends it.
+   * @return 0 on success, -1 if the packet could not be written
+   */
+  int finishPacket();
+
+  /**
+   * Bytes of the packets, before compression.
+   */
+  uint64_t getRawBytes() const {
+    return raw_bytes_;
+  }
+
+  /**
+   * Bytes of the packets as sent or received, which are the raw bytes without compression.
+   */
+  uint64_t getCompressedBytes() const {
+    return compressed_bytes_;
+  }
+
+ private:
+  // compresses the buffered bytes as a chunk
+  int writeChunk();
+
+  // reads the next chunk of a packet into the buffer
+  int readChunk();
+
+  // reads exactly buflen bytes of the underlying stream
+  int readFully(uint8_t *buf, int buflen);
+
+  io::BaseStream *stream_;
+  bool compress_;
+  int level_;
+
+  // raw bytes of the current chunk, and how far they were read
+  std::vector<uint8_t> buffer_;
+  size_t position_;
+  std::vector<uint8_t> compressed_;
+  // whether a chunk of the current packet was written
+  bool chunk_written_;
+
+  uint64_t raw_bytes_;
+  uint64_t compressed_bytes_;
+};
+
+} /* namespace sitetosite */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_SITETOSITE_COMPRESSIONSTREAM_H_ */
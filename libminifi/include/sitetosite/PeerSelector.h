@@ -0,0 +1,96 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_SITETOSITE_PEERSELECTOR_H_
+#define LIBMINIFI_INCLUDE_SITETOSITE_PEERSELECTOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Peer.h"
+#include "SiteToSite.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sitetosite {
+
+// entries of the destination list NiFi distributes among the peers
+#define SITE2SITE_PEER_SELECTOR_DESTINATIONS 128
+// refresh period of the peer list, as in NiFi
+#define SITE2SITE_PEER_REFRESH_INTERVAL_MSEC 60000
+
+/**
+ * Purpose and Justification: Selects the peer of the next transaction by the load the peers report, as NiFi's
+ * PeerSelector does. Sending favors the peers with the fewest queued flow files, receiving favors the peers with
+ * the most. Each peer gets a weight from its share of the total flow file count, and the peers are visited in a
+ * smooth weighted round robin so that a heavily weighted peer is not selected in bursts.
+ *
+ * The selector is thread safe.
+ */
+class PeerSelector {
+ public:
+  PeerSelector() = default;
+
+  /**
+   * Replaces the peers and their weights.
+   * @param peers peers as reported by the remote instance
+   * @param direction direction of the transactions
+   */
+  void setPeers(std::vector<PeerStatus> &peers, TransferDirection direction);
+
+  /**
+   * Selects the next peer.
+   * @return peer, or nullptr if there are no peers
+   */
+  std::shared_ptr<Peer> getNextPeer();
+
+  /**
+   * Provides the peers, in the order they were set.
+   */
+  std::vector<std::shared_ptr<Peer>> getPeers();
+
+  size_t size();
+
+  bool empty() {
+    return size() == 0;
+  }
+
+  /**
+   * Weight of a peer from its flow file count, out of SITE2SITE_PEER_SELECTOR_DESTINATIONS.
+   */
+  static uint32_t calculateWeight(uint64_t flow_file_count, uint64_t total_flow_file_count, size_t peer_count, TransferDirection direction);
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<Peer>> peers_;
+  std::vector<int64_t> weights_;
+  // smooth weighted round robin state
+  std::vector<int64_t> current_weights_;
+  int64_t total_weight_ = 0;
+};
+
+} /* namespace sitetosite */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_SITETOSITE_PEERSELECTOR_H_ */
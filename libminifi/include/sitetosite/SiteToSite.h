@@ -24,6 +24,7 @@
 #include "properties/Configure.h"
 #include "io/CRCStream.h"
 #include "io/StreamFactory.h"
+#include "CompressionStream.h"
 #include "utils/Id.h"
 #include "utils/HTTPClient.h"
 
@@ -231,9 +232,10 @@ class Transaction {
   /*!
    * Create a new transaction
    */
-  explicit Transaction(TransferDirection direction, org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> &stream)
+  explicit Transaction(TransferDirection direction, org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> &stream, bool use_compression = false)
       : closed_(false),
-        crcStream(std::move(stream)) {
+        compressionStream(stream.getstream(), use_compression),
+        crcStream(&compressionStream) {
     _state = TRANSACTION_STARTED;
     _direction = direction;
     _dataAvailable = false;
@@ -289,10 +291,31 @@ class Transaction {
     crcStream.updateCRC(buffer, length);
   }
 
-  org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> &getStream() {
+  // the CRC is computed over the packets before compression
+  org::apache::nifi::minifi::io::CRCStream<CompressionStream> &getStream() {
     return crcStream;
   }
 
+  bool useCompression() const {
+    return compressionStream.isCompressing();
+  }
+
+  /**
+   * Ends the data packet written to the stream.
+   * @return 0 on success, -1 otherwise
+   */
+  int finishPacket() {
+    return compressionStream.finishPacket();
+  }
+
+  uint64_t getRawBytes() const {
+    return compressionStream.getRawBytes();
+  }
+
+  uint64_t getCompressedBytes() const {
+    return compressionStream.getCompressedBytes();
+  }
+
   Transaction(const Transaction &parent) = delete;
   Transaction &operator=(const Transaction &parent) = delete;
 
@@ -314,7 +337,10 @@ class Transaction {
 
  protected:
 
-  org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> crcStream;
+  // frames the data packets when compression is used
+  CompressionStream compressionStream;
+
+  org::apache::nifi::minifi::io::CRCStream<CompressionStream> crcStream;
 
  private:
 
@@ -335,7 +361,8 @@ class SiteToSiteClientConfiguration {
       : stream_factory_(stream_factory),
         peer_(peer),
         local_network_interface_(ifc),
-        ssl_service_(nullptr) {
+        ssl_service_(nullptr),
+        use_compression_(false) {
     client_type_ = type;
   }
 
@@ -375,6 +402,14 @@ class SiteToSiteClientConfiguration {
     return this->proxy_;
   }
 
+  void setUseCompression(bool use_compression) {
+    use_compression_ = use_compression;
+  }
+
+  bool getUseCompression() const {
+    return use_compression_;
+  }
+
  protected:
 
   std::shared_ptr<io::StreamFactory> stream_factory_;
@@ -390,6 +425,9 @@ class SiteToSiteClientConfiguration {
   std::shared_ptr<controllers::SSLContextService> ssl_service_;
 
   utils::HTTPProxy proxy_;
+
+  // whether the data packets are compressed
+  bool use_compression_;
 };
 #if defined(__GNUC__) || defined(__GNUG__)
 #pragma GCC diagnostic pop
@@ -59,6 +59,9 @@ class SiteToSiteClient : public core::Connectable {
       : core::Connectable("SitetoSiteClient"),
         peer_state_(IDLE),
         _batchSendNanos(5000000000),
+        use_compression_(false),
+        raw_bytes_(0),
+        compressed_bytes_(0),
         ssl_context_service_(nullptr),
         logger_(logging::LoggerFactory<SiteToSiteClient>::getLogger()) {
     _supportedVersion[0] = 5;
@@ -81,6 +84,31 @@ class SiteToSiteClient : public core::Connectable {
     ssl_context_service_ = context_service;
   }
 
+  /**
+   * Compresses the data packets, which is negotiated with the peer when the client connects.
+   */
+  void setUseCompression(bool use_compression) {
+    use_compression_ = use_compression;
+  }
+
+  bool getUseCompression() const {
+    return use_compression_;
+  }
+
+  /**
+   * Provides the bytes of the data packets of the finished transactions, before compression.
+   */
+  uint64_t getRawBytes() const {
+    return raw_bytes_;
+  }
+
+  /**
+   * Provides the bytes of the data packets of the finished transactions as moved over the wire.
+   */
+  uint64_t getCompressedBytes() const {
+    return compressed_bytes_;
+  }
+
   /**
    * Creates a transaction using the transaction ID and the direction
    * @param transactionID transaction identifier
@@ -157,6 +185,13 @@ class SiteToSiteClient : public core::Connectable {
     peer_ = std::move(peer);
   }
 
+  /**
+   * Provides the peer the client transfers with.
+   */
+  const std::unique_ptr<SiteToSitePeer> &getPeer() const {
+    return peer_;
+  }
+
   /**
    * Provides a reference to the port identifier
    * @returns port identifier
@@ -257,6 +292,12 @@ class SiteToSiteClient : public core::Connectable {
   // BATCH_SEND_NANOS
   uint64_t _batchSendNanos;
 
+  bool use_compression_;
+
+  // data packet bytes of the finished transactions
+  uint64_t raw_bytes_;
+  uint64_t compressed_bytes_;
+
   /***
    * versioning
    */
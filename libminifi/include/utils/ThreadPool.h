@@ -17,7 +17,11 @@
 #ifndef LIBMINIFI_INCLUDE_THREAD_POOL_H
 #define LIBMINIFI_INCLUDE_THREAD_POOL_H
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
 #include <sstream>
 #include <iostream>
 #include <atomic>
@@ -32,6 +36,7 @@
 #include "BackTrace.h"
 #include "MinifiConcurrentQueue.h"
 #include "Monitors.h"
+#include "TimerWheel.h"
 #include "core/expect.h"
 #include "controllers/ThreadManagementService.h"
 #include "core/controller/ControllerService.h"
@@ -133,14 +138,6 @@ protected:
   std::shared_ptr<std::promise<T>> promise;
 };
 
-template<typename T>
-class DelayedTaskComparator {
- public:
-  bool operator()(Worker<T> &a, Worker<T> &b) {
-    return a.getNextExecutionTime() > b.getNextExecutionTime();
-  }
-};
-
 template<typename T>
 Worker<T>& Worker<T>::operator =(Worker<T> && other) noexcept {
   task = std::move(other.task);
@@ -156,6 +153,135 @@ std::shared_ptr<std::promise<T>> Worker<T>::getPromise() const {
   return promise;
 }
 
+/**
+ * Task queue of a worker thread in the work stealing mode of the ThreadPool.
+ * Purpose: The owner takes ready tasks from the front, idle workers steal them from the back.
+ * Delayed tasks are kept in a timer wheel next to the ready ones and are released by whoever
+ * takes from the queue next, so there is no need for a dedicated scheduler thread.
+ */
+template<typename T>
+class WorkStealingQueue {
+ public:
+  explicit WorkStealingQueue(const std::shared_ptr<TimerLateness> &lateness = nullptr)
+      : delayed_(lateness),
+        ready_size_(0),
+        next_delayed_(NO_DELAYED_TASK),
+        claimed_(false) {
+  }
+
+  WorkStealingQueue(const WorkStealingQueue<T> &other) = delete;
+  WorkStealingQueue<T>& operator=(const WorkStealingQueue<T> &other) = delete;
+
+  void push(Worker<T> &&task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.push_back(std::move(task));
+    ready_size_ = ready_.size();
+  }
+
+  /**
+   * @return true if the task became the earliest delayed task of this queue
+   */
+  bool pushDelayed(Worker<T> &&task) {
+    const auto next_execution_time = task.getNextExecutionTime();
+    std::lock_guard<std::mutex> lock(mutex_);
+    delayed_.schedule(std::move(task), next_execution_time);
+    const int64_t next_execution = toTicks(delayed_.nextExpiration());
+    if (next_execution < next_delayed_) {
+      next_delayed_ = next_execution;
+      return true;
+    }
+    return false;
+  }
+
+  // takes the oldest ready task, used by the owner
+  bool pop(Worker<T> &task, std::chrono::time_point<std::chrono::steady_clock> now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseDelayed(now);
+    if (ready_.empty()) {
+      return false;
+    }
+    task = std::move(ready_.front());
+    ready_.pop_front();
+    ready_size_ = ready_.size();
+    return true;
+  }
+
+  // takes the newest ready task, used by the other workers
+  bool steal(Worker<T> &task, std::chrono::time_point<std::chrono::steady_clock> now) {
+    if (ready_size_ == 0 && next_delayed_ > toTicks(now)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseDelayed(now);
+    if (ready_.empty()) {
+      return false;
+    }
+    task = std::move(ready_.back());
+    ready_.pop_back();
+    ready_size_ = ready_.size();
+    return true;
+  }
+
+  bool hasReadyTask() const {
+    return ready_size_ > 0;
+  }
+
+  // next time the delayed tasks have to be checked, time_point::max() if there are none
+  std::chrono::time_point<std::chrono::steady_clock> getNextDelayedTime() const {
+    const int64_t next_delayed = next_delayed_;
+    if (next_delayed == NO_DELAYED_TASK) {
+      return std::chrono::time_point<std::chrono::steady_clock>::max();
+    }
+    return std::chrono::time_point<std::chrono::steady_clock>(std::chrono::steady_clock::duration(next_delayed));
+  }
+
+  bool claim() {
+    bool expected = false;
+    return claimed_.compare_exchange_strong(expected, true);
+  }
+
+  void release() {
+    claimed_ = false;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.clear();
+    delayed_.clear();
+    ready_size_ = 0;
+    next_delayed_ = NO_DELAYED_TASK;
+  }
+
+ private:
+  static constexpr int64_t NO_DELAYED_TASK = std::numeric_limits<int64_t>::max();
+
+  static int64_t toTicks(std::chrono::time_point<std::chrono::steady_clock> time) {
+    return time.time_since_epoch().count();
+  }
+
+  void releaseDelayed(std::chrono::time_point<std::chrono::steady_clock> now) {
+    if (next_delayed_ > toTicks(now)) {
+      return;
+    }
+    delayed_.expire(now, [this](Worker<T> &&task) {
+      ready_.push_back(std::move(task));
+    });
+    ready_size_ = ready_.size();
+    next_delayed_ = delayed_.empty() ? NO_DELAYED_TASK : toTicks(delayed_.nextExpiration());
+  }
+
+  std::mutex mutex_;
+  std::deque<Worker<T>> ready_;
+  TimerWheel<Worker<T>> delayed_;
+  // mirror the state of the queue so that thieves and idle workers can check it without locking
+  std::atomic<size_t> ready_size_;
+  std::atomic<int64_t> next_delayed_;
+  std::atomic<bool> claimed_;
+};
+
+template<typename T>
+constexpr int64_t WorkStealingQueue<T>::NO_DELAYED_TASK;
+
 class WorkerThread {
  public:
   explicit WorkerThread(std::thread thread, const std::string &name = "NamelessWorker")
@@ -192,6 +318,11 @@ class ThreadPool {
         adjust_threads_(false),
         running_(false),
         controller_service_provider_(controller_service_provider),
+        timer_lateness_(std::make_shared<TimerLateness>()),
+        delayed_worker_queue_(timer_lateness_),
+        work_stealing_(false),
+        next_queue_(0),
+        idle_workers_(0),
         name_(name) {
     current_workers_ = 0;
     task_count_ = 0;
@@ -239,6 +370,13 @@ class ThreadPool {
     return running_.load();
   }
 
+  /**
+   * Returns how late the delayed tasks were released compared to their scheduled execution time.
+   */
+  std::shared_ptr<TimerLateness> getTimerLateness() const {
+    return timer_lateness_;
+  }
+
   std::vector<BackTrace> getTraces() {
     std::vector<BackTrace> traces;
     std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
@@ -276,10 +414,32 @@ class ThreadPool {
       shutdown();
     }
     max_worker_threads_ = max;
+    createStealingQueues();
     if (was_running)
       start();
   }
 
+  /**
+   * Switches between the shared worker queue and the work stealing mode, where every worker
+   * has its own queue of ready and delayed tasks and idle workers steal from the busy ones.
+   * Restarts the pool if it is running; the tasks that were already submitted are dropped.
+   */
+  void setWorkStealing(bool work_stealing) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
+    bool was_running = running_;
+    if (was_running) {
+      shutdown();
+    }
+    work_stealing_ = work_stealing;
+    createStealingQueues();
+    if (was_running)
+      start();
+  }
+
+  bool isWorkStealing() const {
+    return work_stealing_;
+  }
+
   void setControllerServiceProvider(std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider) {
     std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
     bool was_running = running_;
@@ -304,6 +464,7 @@ class ThreadPool {
    */
   void drain() {
     worker_queue_.stop();
+    notifyIdleWorkers(true);
     while (current_workers_ > 0) {
       // The sleeping workers were waken up and stopped, but we have to wait 
       // the ones that actually worked on something when the queue was stopped.
@@ -337,13 +498,23 @@ class ThreadPool {
   ConcurrentQueue<std::shared_ptr<WorkerThread>> deceased_thread_queue_;
 // worker queue of worker objects
   ConditionConcurrentQueue<Worker<T>> worker_queue_;
-  std::priority_queue<Worker<T>, std::vector<Worker<T>>, DelayedTaskComparator<T>> delayed_worker_queue_;
+  std::shared_ptr<TimerLateness> timer_lateness_;
+// tasks to be put back to the worker queue once their next execution time is reached
+  TimerWheel<Worker<T>> delayed_worker_queue_;
 // mutex to  protect task status and delayed queue 
   std::mutex worker_queue_mutex_;
 // notification for new delayed tasks that's before the current ones
   std::condition_variable delayed_task_available_;
 // map to identify if a task should be
   std::map<std::string, bool> task_status_;
+// work stealing mode: one queue per worker thread
+  bool work_stealing_;
+  std::vector<std::unique_ptr<WorkStealingQueue<T>>> stealing_queues_;
+  std::atomic<size_t> next_queue_;
+// idle workers of the work stealing mode wait here for new or due tasks
+  std::mutex idle_mutex_;
+  std::condition_variable idle_condition_;
+  std::atomic<int> idle_workers_;
 // manager mutex
   std::recursive_mutex manager_mutex_;
   // thread pool name
@@ -365,6 +536,24 @@ class ThreadPool {
   void run_tasks(std::shared_ptr<WorkerThread> thread);
 
   void manage_delayed_queue();
+
+  /**
+   * Runs worker tasks in the work stealing mode
+   */
+  void run_stealing_tasks(std::shared_ptr<WorkerThread> thread);
+
+  bool isTaskActive(const std::string &identifier) {
+    std::unique_lock<std::mutex> lock(worker_queue_mutex_);
+    return task_status_[identifier];
+  }
+
+  void createStealingQueues();
+
+  bool stealTask(size_t own_queue, Worker<T> &task, std::chrono::time_point<std::chrono::steady_clock> now);
+
+  void waitForTask();
+
+  void notifyIdleWorkers(bool all = false);
 };
 
 } /* namespace utils */
@@ -0,0 +1,304 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_TIMERWHEEL_H_
+#define LIBMINIFI_INCLUDE_UTILS_TIMERWHEEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Lateness of expired timers: how much later than their due time they were handed out.
+ * Can be shared by several timer wheels and read from any thread.
+ */
+class TimerLateness {
+ public:
+  TimerLateness()
+      : expired_(0),
+        total_us_(0),
+        max_us_(0) {
+  }
+
+  void record(std::chrono::steady_clock::duration lateness) {
+    const uint64_t lateness_us = (std::max)(static_cast<int64_t>(0), static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(lateness).count()));
+    expired_++;
+    total_us_ += lateness_us;
+    uint64_t max = max_us_.load();
+    while (lateness_us > max && !max_us_.compare_exchange_weak(max, lateness_us)) {
+    }
+  }
+
+  uint64_t getExpiredCount() const {
+    return expired_;
+  }
+
+  std::chrono::microseconds getAverage() const {
+    const uint64_t expired = expired_;
+    return std::chrono::microseconds(expired == 0 ? 0 : total_us_ / expired);
+  }
+
+  std::chrono::microseconds getMax() const {
+    return std::chrono::microseconds(max_us_.load());
+  }
+
+ private:
+  std::atomic<uint64_t> expired_;
+  std::atomic<uint64_t> total_us_;
+  std::atomic<uint64_t> max_us_;
+};
+
+/**
+ * Hierarchical timing wheel.
+ *
+ * Four levels of 64 slots each cover 64^4 ticks (about 4.6 hours with the default 1 ms tick), timers
+ * further away are parked in the last slot of the top level and placed again when they get closer.
+ * Scheduling and expiring a timer is O(1); a timer is moved down at most once per level. Timers are
+ * stored in recycled nodes, so scheduling does not allocate once the wheel has warmed up.
+ * Timers never expire early, but they may be late by up to one tick.
+ *
+ * Not thread safe, callers are expected to provide the locking.
+ */
+template<typename T>
+class TimerWheel {
+ public:
+  using time_point = std::chrono::time_point<std::chrono::steady_clock>;
+
+  explicit TimerWheel(std::shared_ptr<TimerLateness> lateness = nullptr, std::chrono::steady_clock::duration tick = std::chrono::milliseconds(1))
+      : tick_(tick),
+        start_(std::chrono::steady_clock::now()),
+        current_tick_(0),
+        size_(0),
+        free_nodes_(nullptr),
+        lateness_(std::move(lateness)) {
+    for (auto &level : slots_) {
+      std::fill(std::begin(level), std::end(level), nullptr);
+    }
+    std::fill(std::begin(occupied_), std::end(occupied_), 0);
+  }
+
+  TimerWheel(const TimerWheel &other) = delete;
+  TimerWheel &operator=(const TimerWheel &other) = delete;
+
+  void schedule(T &&value, time_point due) {
+    Node *node = free_nodes_;
+    if (node != nullptr) {
+      free_nodes_ = node->next;
+    } else {
+      nodes_.emplace_back(new Node());
+      node = nodes_.back().get();
+    }
+    node->value = std::move(value);
+    node->due = due;
+    // round up, so that timers never expire early
+    node->due_tick = due <= start_ ? 0 : static_cast<uint64_t>((due - start_ + tick_ - std::chrono::steady_clock::duration(1)) / tick_);
+    place(node);
+    size_++;
+  }
+
+  /**
+   * Expires the timers that are due at now, handing their values to func in due order (timers
+   * due within the same tick are handed out in no particular order).
+   * @return the number of expired timers
+   */
+  template<typename Func>
+  size_t expire(time_point now, Func &&func) {
+    if (now < start_) {
+      return 0;
+    }
+    const uint64_t target = static_cast<uint64_t>((now - start_) / tick_);
+    if (size_ == 0) {
+      current_tick_ = (std::max)(current_tick_, target + 1);
+      return 0;
+    }
+    size_t expired = 0;
+    while (current_tick_ <= target) {
+      if ((current_tick_ & SLOT_MASK) == 0) {
+        cascade();
+      }
+      const uint64_t slot = current_tick_ & SLOT_MASK;
+      if (occupied_[0] & (uint64_t(1) << slot)) {
+        Node *node = detach(0, slot);
+        while (node != nullptr) {
+          Node *next = node->next;
+          if (lateness_ != nullptr) {
+            lateness_->record(now - node->due);
+          }
+          func(std::move(node->value));
+          node->next = free_nodes_;
+          free_nodes_ = node;
+          size_--;
+          expired++;
+          node = next;
+        }
+      }
+      // jump to the next occupied slot, but stop at the end of the round to cascade
+      const uint64_t rest = slot == SLOT_MASK ? 0 : occupied_[0] >> (slot + 1);
+      const uint64_t next_tick = rest != 0 ? current_tick_ + 1 + countTrailingZeros(rest) : (current_tick_ | SLOT_MASK) + 1;
+      current_tick_ = (std::min)(next_tick, target + 1);
+      if (size_ == 0) {
+        current_tick_ = target + 1;
+      }
+    }
+    return expired;
+  }
+
+  /**
+   * @return the time the wheel has to be expired next, time_point::max() if it is empty. This is
+   * either the due time of the earliest timers or the time when farther timers are moved down.
+   */
+  time_point nextExpiration() const {
+    if (size_ == 0) {
+      return time_point::max();
+    }
+    const uint64_t slot = current_tick_ & SLOT_MASK;
+    const uint64_t rest = occupied_[0] >> slot;
+    uint64_t next_tick = current_tick_;
+    // at the start of a round the upper levels still have to be cascaded
+    if (slot != 0) {
+      next_tick = rest != 0 ? current_tick_ + countTrailingZeros(rest) : (current_tick_ | SLOT_MASK) + 1;
+    }
+    return start_ + tick_ * static_cast<int64_t>(next_tick);
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void clear() {
+    for (size_t level = 0; level < LEVELS; level++) {
+      for (size_t slot = 0; slot < SLOTS; slot++) {
+        Node *node = detach(level, slot);
+        while (node != nullptr) {
+          Node *next = node->next;
+          node->value = T();
+          node->next = free_nodes_;
+          free_nodes_ = node;
+          node = next;
+        }
+      }
+    }
+    size_ = 0;
+  }
+
+ private:
+  static constexpr size_t LEVELS = 4;
+  static constexpr size_t SLOT_BITS = 6;
+  static constexpr size_t SLOTS = 1 << SLOT_BITS;
+  static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+  struct Node {
+    T value;
+    time_point due;
+    uint64_t due_tick;
+    Node *next;
+  };
+
+  static uint64_t countTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return __builtin_ctzll(value);
+#endif
+  }
+
+  void place(Node *node) {
+    const uint64_t delta = node->due_tick > current_tick_ ? node->due_tick - current_tick_ : 0;
+    uint64_t due_tick = (std::max)(node->due_tick, current_tick_);
+    size_t level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << ((level + 1) * SLOT_BITS))) {
+      level++;
+    }
+    if (level == LEVELS - 1 && delta >= (uint64_t(1) << (LEVELS * SLOT_BITS))) {
+      due_tick = current_tick_ + (uint64_t(1) << (LEVELS * SLOT_BITS)) - 1;
+    }
+    const uint64_t slot = (due_tick >> (level * SLOT_BITS)) & SLOT_MASK;
+    node->next = slots_[level][slot];
+    slots_[level][slot] = node;
+    occupied_[level] |= uint64_t(1) << slot;
+  }
+
+  Node *detach(size_t level, uint64_t slot) {
+    Node *node = slots_[level][slot];
+    slots_[level][slot] = nullptr;
+    occupied_[level] &= ~(uint64_t(1) << slot);
+    return node;
+  }
+
+  // moves the timers of the upper level slots that start at the current tick one or more levels down
+  void cascade() {
+    size_t top = 1;
+    while (top < LEVELS - 1 && ((current_tick_ >> (top * SLOT_BITS)) & SLOT_MASK) == 0) {
+      top++;
+    }
+    for (size_t level = top; level > 0; level--) {
+      Node *node = detach(level, (current_tick_ >> (level * SLOT_BITS)) & SLOT_MASK);
+      while (node != nullptr) {
+        Node *next = node->next;
+        place(node);
+        node = next;
+      }
+    }
+  }
+
+  const std::chrono::steady_clock::duration tick_;
+  const time_point start_;
+  // the next tick to expire
+  uint64_t current_tick_;
+  size_t size_;
+  Node *slots_[LEVELS][SLOTS];
+  // bitmap of the non-empty slots of each level
+  uint64_t occupied_[LEVELS];
+  Node *free_nodes_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::shared_ptr<TimerLateness> lateness_;
+};
+
+template<typename T>
+constexpr size_t TimerWheel<T>::LEVELS;
+template<typename T>
+constexpr size_t TimerWheel<T>::SLOT_BITS;
+template<typename T>
+constexpr size_t TimerWheel<T>::SLOTS;
+template<typename T>
+constexpr uint64_t TimerWheel<T>::SLOT_MASK;
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_UTILS_TIMERWHEEL_H_ */
@@ -0,0 +1,204 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_TWOLOCKQUEUE_H_
+#define LIBMINIFI_INCLUDE_UTILS_TWOLOCKQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Unbounded multi-producer/multi-consumer FIFO queue (Michael & Scott two-lock queue).
+ *
+ * Producers only synchronize on the tail lock and consumers only on the head lock, so
+ * enqueueing never contends with dequeueing. The element count is maintained atomically
+ * and can be read without taking either lock.
+ *
+ * Lock ordering: whenever both locks are needed, the head lock is acquired first.
+ */
+template<typename T>
+class TwoLockQueue {
+ public:
+  TwoLockQueue()
+      : size_(0) {
+    head_ = tail_ = new Node();
+  }
+
+  TwoLockQueue(const TwoLockQueue &other) = delete;
+  TwoLockQueue &operator=(const TwoLockQueue &other) = delete;
+
+  ~TwoLockQueue() {
+    while (head_ != nullptr) {
+      Node *next = head_->next.load(std::memory_order_relaxed);
+      delete head_;
+      head_ = next;
+    }
+  }
+
+  template<typename... Args>
+  void enqueue(Args&&... args) {
+    Node *node = new Node(std::forward<Args>(args)...);
+    std::lock_guard<std::mutex> lock(tail_mutex_);
+    linkTail(node);
+  }
+
+  /**
+   * Enqueues a range of elements with a single acquisition of the producer lock.
+   */
+  template<typename InputIt>
+  void enqueueRange(InputIt first, InputIt last) {
+    if (first == last) {
+      return;
+    }
+    // build the chain before taking the lock
+    Node *chain_head = new Node(*first);
+    Node *chain_tail = chain_head;
+    size_t count = 1;
+    for (++first; first != last; ++first, ++count) {
+      Node *node = new Node(*first);
+      chain_tail->next.store(node, std::memory_order_relaxed);
+      chain_tail = node;
+    }
+    std::lock_guard<std::mutex> lock(tail_mutex_);
+    size_.fetch_add(count, std::memory_order_release);
+    tail_->next.store(chain_head, std::memory_order_release);
+    tail_ = chain_tail;
+  }
+
+  bool tryDequeue(T &out) {
+    std::lock_guard<std::mutex> lock(head_mutex_);
+    return unlinkHead(out);
+  }
+
+  /**
+   * Offers the elements to consumer in FIFO order under a single acquisition of the consumer lock.
+   * consumer(T&) either takes the element (moving from it as needed) and returns true, or leaves
+   * it untouched and returns false, which stops the iteration and keeps that element at the head.
+   * @return number of elements taken
+   */
+  template<typename Consumer>
+  size_t consume(Consumer &&consumer) {
+    Node *released;
+    size_t count = 0;
+    {
+      std::lock_guard<std::mutex> lock(head_mutex_);
+      released = head_;
+      Node *first;
+      while ((first = head_->next.load(std::memory_order_acquire)) != nullptr && consumer(first->value)) {
+        first->value = T();
+        head_ = first;
+        ++count;
+      }
+      if (count > 0) {
+        size_.fetch_sub(count, std::memory_order_release);
+      }
+    }
+    // the unlinked sentinels are not reachable by anyone else, free them outside of the lock
+    for (size_t i = 0; i < count; ++i) {
+      Node *next = released->next.load(std::memory_order_relaxed);
+      delete released;
+      released = next;
+    }
+    return count;
+  }
+
+  size_t size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * Removes all elements, invoking func on each of them in FIFO order.
+   */
+  template<typename Func>
+  void clear(Func &&func) {
+    std::lock_guard<std::mutex> head_lock(head_mutex_);
+    T item;
+    while (unlinkHead(item)) {
+      func(item);
+    }
+  }
+
+  void clear() {
+    clear([](T&) {});
+  }
+
+ private:
+  struct Node {
+    Node()
+        : value(),
+          next(nullptr) {
+    }
+    template<typename... Args>
+    explicit Node(Args&&... args)
+        : value(std::forward<Args>(args)...),
+          next(nullptr) {
+    }
+    T value;
+    std::atomic<Node*> next;
+  };
+
+  // tail_mutex_ must be held
+  void linkTail(Node *node) {
+    // count before publishing, so a concurrent consumer can never drive the counter below zero
+    size_.fetch_add(1, std::memory_order_release);
+    tail_->next.store(node, std::memory_order_release);
+    tail_ = node;
+  }
+
+  // head_mutex_ must be held
+  bool unlinkHead(T &out) {
+    Node *old_head = head_;
+    Node *first = old_head->next.load(std::memory_order_acquire);
+    if (first == nullptr) {
+      return false;
+    }
+    out = std::move(first->value);
+    first->value = T();
+    head_ = first;
+    size_.fetch_sub(1, std::memory_order_release);
+    delete old_head;
+    return true;
+  }
+
+  // head_ is a sentinel node, the first element lives in head_->next
+  Node *head_;
+  std::mutex head_mutex_;
+  // keep the consumer and producer side on separate cache lines
+  char padding_[64];
+  Node *tail_;
+  std::mutex tail_mutex_;
+  std::atomic<size_t> size_;
+};
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif  // LIBMINIFI_INCLUDE_UTILS_TWOLOCKQUEUE_H_
@@ -30,6 +30,9 @@ const char *Configure::nifi_flow_configuration_file_backup_update = "nifi.flow.c
 const char *Configure::nifi_flow_engine_threads = "nifi.flow.engine.threads";
 const char *Configure::nifi_flow_engine_alert_period = "nifi.flow.engine.alert.period";
 const char *Configure::nifi_flow_engine_event_driven_time_slice = "nifi.flow.engine.event.driven.time.slice";
+const char *Configure::nifi_flow_engine_work_stealing = "nifi.flow.engine.work.stealing";
+const char *Configure::nifi_io_reactor_threads = "nifi.io.reactor.threads";
+const char *Configure::nifi_io_reactor_workers = "nifi.io.reactor.workers";
 const char *Configure::nifi_administrative_yield_duration = "nifi.administrative.yield.duration";
 const char *Configure::nifi_bored_yield_duration = "nifi.bored.yield.duration";
 const char *Configure::nifi_graceful_shutdown_seconds = "nifi.flowcontroller.graceful.shutdown.period";
@@ -48,7 +51,14 @@ const char *Configure::nifi_provenance_repository_directory_default = "nifi.prov
 const char *Configure::nifi_flowfile_repository_max_storage_size = "nifi.flowfile.repository.max.storage.size";
 const char *Configure::nifi_flowfile_repository_max_storage_time = "nifi.flowfile.repository.max.storage.time";
 const char *Configure::nifi_flowfile_repository_directory_default = "nifi.flowfile.repository.directory.default";
+const char *Configure::nifi_flowfile_repository_commit_window = "nifi.flowfile.repository.commit.window";
+const char *Configure::nifi_flowfile_repository_sync_writes = "nifi.flowfile.repository.sync.writes";
+const char *Configure::nifi_flowfile_repository_recovery_threads = "nifi.flowfile.repository.recovery.threads";
 const char *Configure::nifi_dbcontent_repository_directory_default = "nifi.database.content.repository.directory.default";
+const char *Configure::nifi_slab_content_repository_directory_default = "nifi.slabcontent.repository.directory.default";
+const char *Configure::nifi_slab_content_repository_container_size = "nifi.slab.content.repository.container.size";
+const char *Configure::nifi_slab_content_repository_compaction_threshold = "nifi.slab.content.repository.compaction.threshold";
+const char *Configure::nifi_slab_content_repository_compaction_period = "nifi.slab.content.repository.compaction.period";
 const char *Configure::nifi_remote_input_secure = "nifi.remote.input.secure";
 const char *Configure::nifi_remote_input_http = "nifi.remote.input.http.enabled";
 const char *Configure::nifi_security_need_ClientAuth = "nifi.security.need.ClientAuth";
@@ -112,15 +112,11 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   logger_->log_debug("Connection %s created", name_);
 }
 
-bool Connection::isEmpty() {
-  std::lock_guard<std::mutex> lock(mutex_);
-
+bool Connection::isEmpty() const {
   return queue_.empty();
 }
 
-bool Connection::isFull() {
-  std::lock_guard<std::mutex> lock(mutex_);
-
+bool Connection::isFull() const {
   if (max_queue_size_ <= 0 && max_data_queue_size_ <= 0)
     // No back pressure setting
     return false;
@@ -139,15 +135,11 @@ void Connection::put(std::shared_ptr<core::FlowFile> flow) {
     logger_->log_info("Dropping empty flow file: %s", flow->getUUIDStr());
     return;
   }
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
 
-    queue_.push(flow);
+  queued_data_size_ += flow->getSize();
+  queue_.push(flow);
 
-    queued_data_size_ += flow->getSize();
-
-    logger_->log_debug("Enqueue flow file UUID %s to connection %s", flow->getUUIDStr(), name_);
-  }
+  logger_->log_debug("Enqueue flow file UUID %s to connection %s", flow->getUUIDStr(), name_);
 
   if (!flow->isStored()) {
     // Save to the flowfile repo
@@ -169,33 +161,33 @@ void Connection::put(std::shared_ptr<core::FlowFile> flow) {
 
 void Connection::multiPut(std::vector<std::shared_ptr<core::FlowFile>>& flows) {
   std::vector<std::pair<std::string, std::unique_ptr<io::DataStream>>> flowData;
+  std::vector<std::shared_ptr<core::FlowFile>> accepted;
+  accepted.reserve(flows.size());
 
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    for (auto &ff : flows) {
-      if (drop_empty_ && ff->getSize() == 0) {
-        logger_->log_info("Dropping empty flow file: %s", ff->getUUIDStr());
-        continue;
-      }
+  for (auto &ff : flows) {
+    if (drop_empty_ && ff->getSize() == 0) {
+      logger_->log_info("Dropping empty flow file: %s", ff->getUUIDStr());
+      continue;
+    }
 
-      queue_.push(ff);
-      queued_data_size_ += ff->getSize();
+    queued_data_size_ += ff->getSize();
+    accepted.push_back(ff);
 
-      logger_->log_debug("Enqueue flow file UUID %s to connection %s", ff->getUUIDStr(), name_);
+    logger_->log_debug("Enqueue flow file UUID %s to connection %s", ff->getUUIDStr(), name_);
 
-      if (!ff->isStored()) {
-        // Save to the flowfile repo
-        FlowFileRecord event(flow_repository_, content_repo_, ff, this->uuidStr_);
+    if (!ff->isStored()) {
+      // Save to the flowfile repo
+      FlowFileRecord event(flow_repository_, content_repo_, ff, this->uuidStr_);
 
-        std::unique_ptr<io::DataStream> stramptr(new io::DataStream());
-        event.Serialize(*stramptr.get());
+      std::unique_ptr<io::DataStream> stramptr(new io::DataStream());
+      event.Serialize(*stramptr.get());
 
-        flowData.emplace_back(event.getUUIDStr(), std::move(stramptr));
-      }
+      flowData.emplace_back(event.getUUIDStr(), std::move(stramptr));
     }
   }
 
+  queue_.push(accepted);
+
   if (!flow_repository_->MultiPut(flowData)) {
     logger_->log_error("Failed execute multiput on FF repo!");
     throw Exception(PROCESS_SESSION_EXCEPTION, "Failed to put flowfiles to repository");
@@ -216,65 +208,71 @@ void Connection::multiPut(std::vector<std::shared_ptr<core::FlowFile>>& flows) {
 }
 
 std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::shared_ptr<core::FlowFile>> flows;
+  std::vector<std::shared_ptr<core::FlowFile>> expired;
+  pollBatch(flows, 1, 0, expired);
+  expiredFlowRecords.insert(expired.begin(), expired.end());
+  return flows.empty() ? nullptr : flows.front();
+}
 
-  while (!queue_.empty()) {
-    std::shared_ptr<core::FlowFile> item = queue_.front();
-    queue_.pop();
-    queued_data_size_ -= item->getSize();
+size_t Connection::pollBatch(std::vector<std::shared_ptr<core::FlowFile>> &flows, size_t max_count, uint64_t max_bytes,
+                             std::vector<std::shared_ptr<core::FlowFile>> &expiredFlowRecords) {
+  if (max_count == 0) {
+    return 0;
+  }
+  const uint64_t now = getTimeMillis();
+  const uint64_t expiration = expired_duration_;
+  const size_t first_ready = flows.size();
+  const size_t first_expired = expiredFlowRecords.size();
+  size_t ready = 0;
+  uint64_t ready_bytes = 0;
+  uint64_t expired_bytes = 0;
+
+  // penalized flow files are kept aside by the queue, so they are never offered here
+  const size_t taken = queue_.consume([&](std::shared_ptr<core::FlowFile> &item) {
+    if (expiration > 0 && now > (item->getEntryDate() + expiration)) {
+      expired_bytes += item->getSize();
+      expiredFlowRecords.push_back(std::move(item));
+      return true;
+    }
+    if (ready >= max_count || (max_bytes > 0 && ready > 0 && ready_bytes + item->getSize() > max_bytes)) {
+      return false;
+    }
+    ++ready;
+    ready_bytes += item->getSize();
+    flows.push_back(std::move(item));
+    return true;
+  });
 
-    if (expired_duration_ > 0) {
-      // We need to check for flow expiration
-      if (getTimeMillis() > (item->getEntryDate() + expired_duration_)) {
-        // Flow record expired
-        expiredFlowRecords.insert(item);
-        logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
-        if (flow_repository_->Delete(item->getUUIDStr())) {
-          item->setStoredToRepository(false);
-        }
-      } else {
-        // Flow record not expired
-        if (item->isPenalized()) {
-          // Flow record was penalized
-          queue_.push(item);
-          queued_data_size_ += item->getSize();
-          break;
-        }
-        std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
-        item->setOriginalConnection(connectable);
-        logger_->log_debug("Dequeue flow file UUID %s from connection %s", item->getUUIDStr(), name_);
-        return item;
-      }
-    } else {
-      // Flow record not expired
-      if (item->isPenalized()) {
-        // Flow record was penalized
-        queue_.push(item);
-        queued_data_size_ += item->getSize();
-        break;
-      }
-      std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
-      item->setOriginalConnection(connectable);
-      logger_->log_debug("Dequeue flow file UUID %s from connection %s", item->getUUIDStr(), name_);
-      return item;
+  if (taken == 0) {
+    return 0;
+  }
+
+  queued_data_size_ -= (ready_bytes + expired_bytes);
+  for (size_t i = first_expired; i < expiredFlowRecords.size(); ++i) {
+    const auto &item = expiredFlowRecords[i];
+    logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
+    if (flow_repository_->Delete(item->getUUIDStr())) {
+      item->setStoredToRepository(false);
     }
   }
 
-  return NULL;
+  std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
+  for (size_t i = first_ready; i < flows.size(); ++i) {
+    flows[i]->setOriginalConnection(connectable);
+    logger_->log_debug("Dequeue flow file UUID %s from connection %s", flows[i]->getUUIDStr(), name_);
+  }
+  return ready;
 }
 
 void Connection::drain() {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  while (!queue_.empty()) {
-    std::shared_ptr<core::FlowFile> item = queue_.front();
-    queue_.pop();
+  queue_.clear([this](std::shared_ptr<core::FlowFile> &item) {
+    queued_data_size_ -= item->getSize();
     logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
     if (flow_repository_->Delete(item->getUUIDStr())) {
       item->setStoredToRepository(false);
     }
-  }
-  queued_data_size_ = 0;
+  });
   logger_->log_debug("Drain connection %s", name_);
 }
 
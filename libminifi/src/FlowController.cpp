@@ -39,6 +39,7 @@
 #include "core/state/nodes/ProcessMetrics.h"
 #include "core/state/nodes/QueueMetrics.h"
 #include "core/state/nodes/RepositoryMetrics.h"
+#include "core/state/nodes/SchedulingNodes.h"
 #include "core/state/nodes/SystemMetrics.h"
 #include "core/state/ProcessorController.h"
 #include "yaml-cpp/yaml.h"
@@ -53,6 +54,7 @@
 #include "core/logging/LoggerConfiguration.h"
 #include "core/Connectable.h"
 #include "utils/HTTPClient.h"
+#include "io/EventReactor.h"
 #include "io/NetworkPrioritizer.h"
 #include "io/validation.h"
 
@@ -320,8 +322,16 @@ void FlowController::load(const std::shared_ptr<core::ProcessGroup> &root, bool
     if (!thread_pool_.isRunning() || reload) {
       thread_pool_.shutdown();
       thread_pool_.setMaxConcurrentTasks(configuration_->getInt(Configure::nifi_flow_engine_threads, 2));
+      std::string work_stealing_str;
+      bool work_stealing = false;
+      if (configuration_->get(Configure::nifi_flow_engine_work_stealing, work_stealing_str)) {
+        utils::StringUtils::StringToBool(work_stealing_str, work_stealing);
+      }
+      thread_pool_.setWorkStealing(work_stealing);
       thread_pool_.setControllerServiceProvider(base_shared_ptr);
       thread_pool_.start();
+      io::EventReactor::setThreadCount(configuration_->getInt(Configure::nifi_io_reactor_threads, REACTOR_DEFAULT_THREADS));
+      io::EventReactor::setWorkerCount(configuration_->getInt(Configure::nifi_io_reactor_workers, REACTOR_DEFAULT_WORKERS));
     }
 
     if (nullptr == timer_scheduler_ || reload) {
@@ -481,6 +491,10 @@ void FlowController::initializeC2() {
     repoMetrics->addRepository(flow_file_repo_);
 
     device_information_[repoMetrics->getName()] = repoMetrics;
+
+    std::shared_ptr<state::response::SchedulingMetrics> schedulingMetrics = std::make_shared<state::response::SchedulingMetrics>();
+    schedulingMetrics->setTimerLateness(thread_pool_.getTimerLateness());
+    device_information_[schedulingMetrics->getName()] = schedulingMetrics;
   }
 
   if (configuration_->get("nifi.c2.root.classes", class_csv)) {
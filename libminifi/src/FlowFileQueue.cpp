@@ -0,0 +1,226 @@
+/**
+ * @file FlowFileQueue.cpp
+ * FlowFileQueue class implementation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FlowFileQueue.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "utils/TimeUtil.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+
+namespace {
+
+const uint64_t NO_PENALTY = std::numeric_limits<uint64_t>::max();
+
+}  // namespace
+
+FlowFileQueue::FlowFileQueue()
+    : prioritizer_(nullptr),
+      fifo_mode_(true),
+      sequence_(0),
+      prioritized_size_(0),
+      penalized_size_(0),
+      next_release_(NO_PENALTY) {
+}
+
+void FlowFileQueue::setPrioritizer(const std::shared_ptr<core::FlowFilePrioritizer> &prioritizer) {
+  std::vector<std::shared_ptr<core::FlowFile>> queued;
+  fifo_.clear([&queued](std::shared_ptr<core::FlowFile> &flow) {
+    queued.push_back(std::move(flow));
+  });
+  {
+    std::lock_guard<std::mutex> lock(prioritized_mutex_);
+    for (auto &entry : prioritized_) {
+      queued.push_back(std::move(entry.flow));
+    }
+    prioritized_.clear();
+    prioritized_size_ = 0;
+    prioritizer_ = prioritizer;
+    fifo_mode_ = prioritizer == nullptr || prioritizer->isFirstInFirstOut();
+  }
+  pushReady(queued);
+}
+
+void FlowFileQueue::push(const std::shared_ptr<core::FlowFile> &flow) {
+  if (flow->getPenaltyExpiration() > getTimeMillis()) {
+    std::vector<std::shared_ptr<core::FlowFile>> flows{flow};
+    pushPenalized(flows);
+  } else if (fifo_mode_) {
+    fifo_.enqueue(flow);
+  } else {
+    std::vector<std::shared_ptr<core::FlowFile>> flows{flow};
+    pushReady(flows);
+  }
+}
+
+void FlowFileQueue::push(const std::vector<std::shared_ptr<core::FlowFile>> &flows) {
+  const uint64_t now = getTimeMillis();
+  std::vector<std::shared_ptr<core::FlowFile>> ready;
+  std::vector<std::shared_ptr<core::FlowFile>> penalized;
+  ready.reserve(flows.size());
+  for (const auto &flow : flows) {
+    if (flow->getPenaltyExpiration() > now) {
+      penalized.push_back(flow);
+    } else {
+      ready.push_back(flow);
+    }
+  }
+  pushPenalized(penalized);
+  pushReady(ready);
+}
+
+size_t FlowFileQueue::consume(const Consumer &consumer) {
+  const uint64_t now = getTimeMillis();
+  releasePenalized(now);
+
+  size_t taken = 0;
+  // FlowFiles penalized after they were queued are moved to the penalty heap
+  std::vector<std::shared_ptr<core::FlowFile>> penalized;
+  if (fifo_mode_) {
+    fifo_.consume([&](std::shared_ptr<core::FlowFile> &flow) {
+      if (flow->getPenaltyExpiration() > now) {
+        penalized.push_back(std::move(flow));
+        return true;
+      }
+      if (consumer(flow)) {
+        ++taken;
+        return true;
+      }
+      return false;
+    });
+  } else {
+    auto comparator = [this](const Entry &lhs, const Entry &rhs) {
+      return after(lhs, rhs);
+    };
+    std::lock_guard<std::mutex> lock(prioritized_mutex_);
+    while (!prioritized_.empty()) {
+      std::pop_heap(prioritized_.begin(), prioritized_.end(), comparator);
+      Entry &top = prioritized_.back();
+      if (top.flow->getPenaltyExpiration() > now) {
+        penalized.push_back(std::move(top.flow));
+      } else if (consumer(top.flow)) {
+        ++taken;
+      } else {
+        std::push_heap(prioritized_.begin(), prioritized_.end(), comparator);
+        break;
+      }
+      prioritized_.pop_back();
+      prioritized_size_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+  pushPenalized(penalized);
+  return taken;
+}
+
+void FlowFileQueue::clear(const std::function<void(std::shared_ptr<core::FlowFile>&)> &func) {
+  fifo_.clear(func);
+  {
+    std::lock_guard<std::mutex> lock(prioritized_mutex_);
+    for (auto &entry : prioritized_) {
+      func(entry.flow);
+    }
+    prioritized_.clear();
+    prioritized_size_ = 0;
+  }
+  std::lock_guard<std::mutex> lock(penalized_mutex_);
+  for (auto &entry : penalized_) {
+    func(entry.flow);
+  }
+  penalized_.clear();
+  penalized_size_ = 0;
+  next_release_ = NO_PENALTY;
+}
+
+void FlowFileQueue::pushReady(std::vector<std::shared_ptr<core::FlowFile>> &flows) {
+  if (flows.empty()) {
+    return;
+  }
+  if (fifo_mode_) {
+    fifo_.enqueueRange(flows.begin(), flows.end());
+    return;
+  }
+  auto comparator = [this](const Entry &lhs, const Entry &rhs) {
+    return after(lhs, rhs);
+  };
+  std::lock_guard<std::mutex> lock(prioritized_mutex_);
+  for (auto &flow : flows) {
+    prioritized_.push_back(Entry{std::move(flow), sequence_++});
+    std::push_heap(prioritized_.begin(), prioritized_.end(), comparator);
+  }
+  prioritized_size_.fetch_add(flows.size(), std::memory_order_release);
+}
+
+void FlowFileQueue::pushPenalized(std::vector<std::shared_ptr<core::FlowFile>> &flows) {
+  if (flows.empty()) {
+    return;
+  }
+  auto comparator = [](const Entry &lhs, const Entry &rhs) {
+    return lhs.flow->getPenaltyExpiration() > rhs.flow->getPenaltyExpiration();
+  };
+  std::lock_guard<std::mutex> lock(penalized_mutex_);
+  for (auto &flow : flows) {
+    penalized_.push_back(Entry{std::move(flow), 0});
+    std::push_heap(penalized_.begin(), penalized_.end(), comparator);
+  }
+  penalized_size_.fetch_add(flows.size(), std::memory_order_release);
+  next_release_ = penalized_.front().flow->getPenaltyExpiration();
+}
+
+void FlowFileQueue::releasePenalized(uint64_t now) {
+  if (next_release_.load(std::memory_order_acquire) > now) {
+    return;
+  }
+  auto comparator = [](const Entry &lhs, const Entry &rhs) {
+    return lhs.flow->getPenaltyExpiration() > rhs.flow->getPenaltyExpiration();
+  };
+  std::vector<std::shared_ptr<core::FlowFile>> released;
+  {
+    std::lock_guard<std::mutex> lock(penalized_mutex_);
+    while (!penalized_.empty() && penalized_.front().flow->getPenaltyExpiration() <= now) {
+      std::pop_heap(penalized_.begin(), penalized_.end(), comparator);
+      released.push_back(std::move(penalized_.back().flow));
+      penalized_.pop_back();
+    }
+    next_release_ = penalized_.empty() ? NO_PENALTY : penalized_.front().flow->getPenaltyExpiration();
+    // count them as ready before they become visible, so size() never under-reports
+    pushReady(released);
+    penalized_size_.fetch_sub(released.size(), std::memory_order_release);
+  }
+}
+
+bool FlowFileQueue::after(const Entry &lhs, const Entry &rhs) const {
+  if (prioritizer_->prioritize(*rhs.flow, *lhs.flow)) {
+    return true;
+  }
+  if (prioritizer_->prioritize(*lhs.flow, *rhs.flow)) {
+    return false;
+  }
+  return lhs.sequence > rhs.sequence;
+}
+
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
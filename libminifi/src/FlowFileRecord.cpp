@@ -20,6 +20,8 @@
 #include "FlowFileRecord.h"
 #include <time.h>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 #include <vector>
 #include <queue>
 #include <map>
@@ -36,6 +38,192 @@ namespace apache {
 namespace nifi {
 namespace minifi {
 
+namespace {
+
+// first byte of compact records
+const uint8_t COMPACT_RECORD_MARKER = 0xFE;
+// latest version of the compact format
+const uint64_t COMPACT_RECORD_VERSION = 1;
+
+// flags of compact records
+const uint8_t BINARY_UUID = 0x01;
+const uint8_t BINARY_CONNECTION_UUID = 0x02;
+const uint8_t INTERNED_CONTENT = 0x04;
+const uint8_t NO_CONTENT = 0x08;
+
+const size_t UUID_SIZE = 16;
+
+uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+bool isUuidDash(size_t position) {
+  return position == 8 || position == 13 || position == 18 || position == 23;
+}
+
+/**
+ * Parses the canonical lower case form of a UUID. Anything else is stored as a string, so that
+ * it reads back unchanged.
+ */
+bool parseUuid(const std::string &str, uint8_t *uuid) {
+  if (str.size() != 36) {
+    return false;
+  }
+  size_t byte = 0;
+  for (size_t i = 0; i < str.size();) {
+    if (isUuidDash(i)) {
+      if (str[i] != '-') {
+        return false;
+      }
+      i++;
+      continue;
+    }
+    const int high = hexValue(str[i]);
+    const int low = hexValue(str[i + 1]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    uuid[byte++] = static_cast<uint8_t>((high << 4) | low);
+    i += 2;
+  }
+  return true;
+}
+
+std::string formatUuid(const uint8_t *uuid) {
+  static const char digits[] = "0123456789abcdef";
+  std::string str;
+  str.reserve(36);
+  for (size_t byte = 0; byte < UUID_SIZE; byte++) {
+    if (isUuidDash(str.size())) {
+      str.push_back('-');
+    }
+    str.push_back(digits[uuid[byte] >> 4]);
+    str.push_back(digits[uuid[byte] & 0x0F]);
+  }
+  return str;
+}
+
+/**
+ * Splits content paths of the form <prefix><counter>, which is how resource claims name their content.
+ * The counter must read back to the same digits.
+ */
+bool splitContentPath(const std::string &path, std::string &prefix, uint64_t &counter) {
+  size_t digits_start = path.size();
+  while (digits_start > 0 && path[digits_start - 1] >= '0' && path[digits_start - 1] <= '9') {
+    digits_start--;
+  }
+  const size_t digits = path.size() - digits_start;
+  if (digits_start == 0 || digits == 0 || digits > 19 || (digits > 1 && path[digits_start] == '0')) {
+    return false;
+  }
+  counter = std::stoull(path.substr(digits_start));
+  prefix = path.substr(0, digits_start);
+  return true;
+}
+
+class RecordWriter {
+ public:
+  RecordWriter() {
+    buffer_.reserve(256);
+  }
+
+  void writeByte(uint8_t value) {
+    buffer_.push_back(static_cast<char>(value));
+  }
+
+  void writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buffer_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buffer_.push_back(static_cast<char>(value));
+  }
+
+  void writeBytes(const uint8_t *value, size_t size) {
+    buffer_.append(reinterpret_cast<const char*>(value), size);
+  }
+
+  void writeString(const std::string &value) {
+    writeVarint(value.size());
+    buffer_.append(value);
+  }
+
+  const std::string &getBuffer() const {
+    return buffer_;
+  }
+
+ private:
+  std::string buffer_;
+};
+
+// reads from a record in place, every read fails once the record is exhausted
+class RecordReader {
+ public:
+  RecordReader(const uint8_t *buffer, size_t size)
+      : position_(buffer),
+        end_(buffer + size) {
+  }
+
+  bool readByte(uint8_t &value) {
+    if (position_ == end_) {
+      return false;
+    }
+    value = *position_++;
+    return true;
+  }
+
+  bool readVarint(uint64_t &value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && position_ != end_; shift += 7) {
+      const uint8_t byte = *position_++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool readBytes(uint8_t *value, size_t size) {
+    if (static_cast<size_t>(end_ - position_) < size) {
+      return false;
+    }
+    std::memcpy(value, position_, size);
+    position_ += size;
+    return true;
+  }
+
+  bool readString(std::string &value) {
+    uint64_t size = 0;
+    if (!readVarint(size) || static_cast<uint64_t>(end_ - position_) < size) {
+      return false;
+    }
+    value.assign(reinterpret_cast<const char*>(position_), size);
+    position_ += size;
+    return true;
+  }
+
+ private:
+  const uint8_t *position_;
+  const uint8_t *end_;
+};
+
+}  // namespace
+
 std::shared_ptr<logging::Logger> FlowFileRecord::logger_ = logging::LoggerFactory<FlowFileRecord>::getLogger();
 std::atomic<uint64_t> FlowFileRecord::local_flow_seq_number_(0);
 
@@ -215,7 +403,69 @@ bool FlowFileRecord::DeSerialize(std::string key) {
   return ret;
 }
 
-bool FlowFileRecord::Serialize(io::DataStream &outStream) {
+bool FlowFileRecord::Serialize(io::DataStream &outStream, RecordFormat format) {
+  if (format == RecordFormat::LEGACY) {
+    return SerializeLegacy(outStream);
+  }
+
+  RecordWriter writer;
+  writer.writeByte(COMPACT_RECORD_MARKER);
+  writer.writeVarint(COMPACT_RECORD_VERSION);
+  writer.writeVarint(event_time_);
+  writer.writeVarint(zigzag(static_cast<int64_t>(entry_date_ - event_time_)));
+  writer.writeVarint(zigzag(static_cast<int64_t>(lineage_start_date_ - event_time_)));
+
+  uint8_t uuid[UUID_SIZE];
+  uint8_t connection_uuid[UUID_SIZE];
+  uint8_t flags = 0;
+  if (parseUuid(uuidStr_, uuid)) {
+    flags |= BINARY_UUID;
+  }
+  if (parseUuid(uuid_connection_, connection_uuid)) {
+    flags |= BINARY_CONNECTION_UUID;
+  }
+  std::string prefix;
+  uint64_t counter = 0;
+  uint32_t prefix_id = 0;
+  if (content_full_fath_.empty()) {
+    flags |= NO_CONTENT;
+  } else if (flow_repository_ != nullptr && splitContentPath(content_full_fath_, prefix, counter)
+      && flow_repository_->getContentPathDictionary().intern(*flow_repository_, prefix, prefix_id)) {
+    flags |= INTERNED_CONTENT;
+  }
+  writer.writeByte(flags);
+
+  if (flags & BINARY_UUID) {
+    writer.writeBytes(uuid, UUID_SIZE);
+  } else {
+    writer.writeString(uuidStr_);
+  }
+  if (flags & BINARY_CONNECTION_UUID) {
+    writer.writeBytes(connection_uuid, UUID_SIZE);
+  } else {
+    writer.writeString(uuid_connection_);
+  }
+
+  writer.writeVarint(attributes_.size());
+  for (const auto &attribute : attributes_) {
+    writer.writeString(attribute.first);
+    writer.writeString(attribute.second);
+  }
+
+  if (flags & INTERNED_CONTENT) {
+    writer.writeVarint(prefix_id);
+    writer.writeVarint(counter);
+  } else if (!(flags & NO_CONTENT)) {
+    writer.writeString(content_full_fath_);
+  }
+  writer.writeVarint(size_);
+  writer.writeVarint(offset_);
+
+  const std::string &buffer = writer.getBuffer();
+  return outStream.writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(buffer.data())), buffer.size()) == static_cast<int>(buffer.size());
+}
+
+bool FlowFileRecord::SerializeLegacy(io::DataStream &outStream) {
   int ret;
 
   ret = write(this->event_time_, &outStream);
@@ -301,6 +551,95 @@ bool FlowFileRecord::Serialize() {
 }
 
 bool FlowFileRecord::DeSerialize(const uint8_t *buffer, const int bufferSize) {
+  // legacy records start with the big endian event time, whose first byte is never the marker
+  if (bufferSize > 0 && buffer[0] == COMPACT_RECORD_MARKER) {
+    return DeSerializeCompact(buffer, bufferSize);
+  }
+  return DeSerializeLegacy(buffer, bufferSize);
+}
+
+bool FlowFileRecord::DeSerializeCompact(const uint8_t *buffer, const int bufferSize) {
+  RecordReader reader(buffer + 1, bufferSize - 1);
+
+  uint64_t version = 0;
+  if (!reader.readVarint(version)) {
+    return false;
+  }
+  if (version > COMPACT_RECORD_VERSION) {
+    logger_->log_error("FlowFile record version %llu is not supported, the latest supported version is %llu", version, COMPACT_RECORD_VERSION);
+    return false;
+  }
+
+  uint64_t entry_date_delta = 0;
+  uint64_t lineage_start_date_delta = 0;
+  uint8_t flags = 0;
+  if (!reader.readVarint(event_time_) || !reader.readVarint(entry_date_delta) || !reader.readVarint(lineage_start_date_delta) || !reader.readByte(flags)) {
+    return false;
+  }
+  entry_date_ = event_time_ + unzigzag(entry_date_delta);
+  lineage_start_date_ = event_time_ + unzigzag(lineage_start_date_delta);
+
+  uint8_t uuid[UUID_SIZE];
+  if (flags & BINARY_UUID) {
+    if (!reader.readBytes(uuid, UUID_SIZE)) {
+      return false;
+    }
+    uuidStr_ = formatUuid(uuid);
+  } else if (!reader.readString(uuidStr_)) {
+    return false;
+  }
+  if (flags & BINARY_CONNECTION_UUID) {
+    if (!reader.readBytes(uuid, UUID_SIZE)) {
+      return false;
+    }
+    uuid_connection_ = formatUuid(uuid);
+  } else if (!reader.readString(uuid_connection_)) {
+    return false;
+  }
+
+  uint64_t numAttributes = 0;
+  if (!reader.readVarint(numAttributes)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < numAttributes; i++) {
+    std::string key;
+    std::string value;
+    if (!reader.readString(key) || !reader.readString(value)) {
+      return false;
+    }
+    attributes_[std::move(key)] = std::move(value);
+  }
+
+  if (flags & INTERNED_CONTENT) {
+    uint64_t prefix_id = 0;
+    uint64_t counter = 0;
+    if (!reader.readVarint(prefix_id) || !reader.readVarint(counter)) {
+      return false;
+    }
+    std::string prefix;
+    if (flow_repository_ == nullptr || prefix_id > (std::numeric_limits<uint32_t>::max)()
+        || !flow_repository_->getContentPathDictionary().resolve(*flow_repository_, static_cast<uint32_t>(prefix_id), prefix)) {
+      logger_->log_error("Unknown content path prefix %llu in FlowFile record %s", prefix_id, uuidStr_);
+      return false;
+    }
+    content_full_fath_ = prefix + std::to_string(counter);
+  } else if (flags & NO_CONTENT) {
+    content_full_fath_.clear();
+  } else if (!reader.readString(content_full_fath_)) {
+    return false;
+  }
+
+  if (!reader.readVarint(size_) || !reader.readVarint(offset_)) {
+    return false;
+  }
+
+  if (nullptr == claim_) {
+    claim_ = std::make_shared<ResourceClaim>(content_full_fath_, content_repo_, true);
+  }
+  return true;
+}
+
+bool FlowFileRecord::DeSerializeLegacy(const uint8_t *buffer, const int bufferSize) {
   int ret;
 
   io::DataStream outStream(buffer, bufferSize);
@@ -60,57 +60,93 @@ core::Property RemoteProcessorGroupPort::port("Port", "Remote Port", "");
 core::Property RemoteProcessorGroupPort::portUUID("Port UUID", "Specifies remote NiFi Port UUID.", "");
 core::Relationship RemoteProcessorGroupPort::relation;
 
-std::unique_ptr<sitetosite::SiteToSiteClient> RemoteProcessorGroupPort::getNextProtocol(bool create = true) {
-  std::unique_ptr<sitetosite::SiteToSiteClient> nextProtocol = nullptr;
-  if (!available_protocols_.try_dequeue(nextProtocol)) {
-    if (create) {
-      // create
-      if (bypass_rest_api_) {
-        if (nifi_instances_.size() > 0) {
-          auto rpg = nifi_instances_.front();
-          auto host = rpg.host_;
-#ifdef WIN32
-          if ("localhost" == host) {
-            host = org::apache::nifi::minifi::io::Socket::getMyHostName();
-          }
-#endif
-          sitetosite::SiteToSiteClientConfiguration config(stream_factory_, std::make_shared<sitetosite::Peer>(protocol_uuid_, host, rpg.port_, ssl_service != nullptr), this->getInterface(),
-                                                           client_type_);
-          config.setHTTPProxy(this->proxy_);
-          nextProtocol = sitetosite::createClient(config);
-        }
-      } else if (peer_index_ >= 0) {
-        std::lock_guard<std::mutex> lock(peer_mutex_);
-        logger_->log_debug("Creating client from peer %d", peer_index_.load());
-        sitetosite::SiteToSiteClientConfiguration config(stream_factory_, peers_[this->peer_index_].getPeer(), local_network_interface_, client_type_);
-        config.setSecurityContext(ssl_service);
-        peer_index_++;
-        if (peer_index_ >= static_cast<int>(peers_.size())) {
-          peer_index_ = 0;
-        }
-        config.setHTTPProxy(this->proxy_);
-        nextProtocol = sitetosite::createClient(config);
-      } else {
-        logger_->log_debug("Refreshing the peer list since there are none configured.");
-        refreshPeerList();
-      }
+RemoteProcessorGroupPort::PooledProtocol RemoteProcessorGroupPort::getNextProtocol(bool create = true) {
+  if (!bypass_rest_api_ && peer_refresh_interval_msec_ > 0 && getTimeMillis() >= next_peer_refresh_msec_) {
+    // the other threads keep using the current peers while one refreshes them
+    std::unique_lock<std::mutex> lock(peer_mutex_, std::try_to_lock);
+    if (lock.owns_lock() && getTimeMillis() >= next_peer_refresh_msec_) {
+      logger_->log_debug("Refreshing the peer list");
+      refreshPeerList();
     }
   }
-  logger_->log_debug("Obtained protocol from available_protocols_");
+  PooledProtocol nextProtocol;
+  // a peer at its transaction limit is passed over for the next one
+  for (size_t attempts = peer_selector_.size(); attempts > 0 && !nextProtocol; attempts--) {
+    auto peer = peer_selector_.getNextPeer();
+    if (nullptr == peer) {
+      break;
+    }
+    auto protocols = getPeerProtocols(peer->getHost(), peer->getPort(), true);
+    if (++protocols->active_transactions_ > max_transactions_per_peer_ && max_transactions_per_peer_ > 0) {
+      protocols->active_transactions_--;
+      continue;
+    }
+    std::unique_ptr<sitetosite::SiteToSiteClient> protocol;
+    if (!protocols->available_protocols_.try_dequeue(protocol) && create) {
+      logger_->log_debug("Creating client for peer %s:%d", peer->getHost(), peer->getPort());
+      sitetosite::SiteToSiteClientConfiguration config(stream_factory_, peer, local_network_interface_, client_type_);
+      config.setSecurityContext(ssl_service);
+      config.setHTTPProxy(this->proxy_);
+      config.setUseCompression(use_compression_);
+      protocol = sitetosite::createClient(config);
+    }
+    if (nullptr == protocol) {
+      protocols->active_transactions_--;
+      continue;
+    }
+    nextProtocol = PooledProtocol(std::move(protocol), std::move(protocols));
+  }
+  if (!nextProtocol && create && !bypass_rest_api_ && peer_selector_.empty()) {
+    logger_->log_debug("Refreshing the peer list since there are none configured.");
+    std::lock_guard<std::mutex> lock(peer_mutex_);
+    refreshPeerList();
+  }
   return nextProtocol;
 }
 
-void RemoteProcessorGroupPort::returnProtocol(std::unique_ptr<sitetosite::SiteToSiteClient> return_protocol) {
-  auto count = peers_.size();
-  if (max_concurrent_tasks_ > count)
-    count = max_concurrent_tasks_;
-  if (available_protocols_.size_approx() >= count) {
+void RemoteProcessorGroupPort::returnProtocol(PooledProtocol return_protocol) {
+  if (!return_protocol) {
+    return;
+  }
+  auto &protocols = return_protocol.peer_;
+  protocols->active_transactions_--;
+  if (protocols->removed_) {
+    logger_->log_debug("not enqueueing protocol %s, its peer was removed", getUUIDStr());
+    // let the memory be freed
+    return;
+  }
+  size_t count = max_transactions_per_peer_;
+  if (count == 0)
+    count = std::max<size_t>(max_concurrent_tasks_, 1);
+  if (protocols->available_protocols_.size_approx() >= count) {
     logger_->log_debug("not enqueueing protocol %s", getUUIDStr());
     // let the memory be freed
     return;
   }
-  logger_->log_debug("enqueueing protocol %s, have a total of %lu", getUUIDStr(), available_protocols_.size_approx());
-  available_protocols_.enqueue(std::move(return_protocol));
+  logger_->log_debug("enqueueing protocol %s, have a total of %lu", getUUIDStr(), protocols->available_protocols_.size_approx());
+  protocols->available_protocols_.enqueue(std::move(return_protocol.protocol_));
+}
+
+void RemoteProcessorGroupPort::releaseProtocol(PooledProtocol release_protocol) {
+  if (!release_protocol) {
+    return;
+  }
+  release_protocol.peer_->active_transactions_--;
+}
+
+std::shared_ptr<RemoteProcessorGroupPort::PeerProtocols> RemoteProcessorGroupPort::getPeerProtocols(const std::string &host, uint16_t port, bool create) {
+  std::string key = host + ":" + std::to_string(port);
+  std::lock_guard<std::mutex> lock(protocol_mutex_);
+  auto it = peer_protocols_.find(key);
+  if (it != peer_protocols_.end()) {
+    return it->second;
+  }
+  if (!create) {
+    return nullptr;
+  }
+  auto protocols = std::make_shared<PeerProtocols>();
+  peer_protocols_[key] = protocols;
+  return protocols;
 }
 
 void RemoteProcessorGroupPort::initialize() {
@@ -163,8 +199,6 @@ void RemoteProcessorGroupPort::onSchedule(const std::shared_ptr<core::ProcessCon
   std::lock_guard<std::mutex> lock(peer_mutex_);
   if (!nifi_instances_.empty()) {
     refreshPeerList();
-    if (peers_.size() > 0)
-      peer_index_ = 0;
   }
   /**
    * If at this point we have no peers and HTTP support is disabled this means
@@ -179,30 +213,32 @@ void RemoteProcessorGroupPort::onSchedule(const std::shared_ptr<core::ProcessCon
     if (!host.empty() && !portStr.empty() && !portStr.empty() && core::Property::StringToInt(portStr, configured_port)) {
       nifi_instances_.push_back({ host, configured_port, "" });
       bypass_rest_api_ = true;
+#ifdef WIN32
+      if ("localhost" == host) {
+        host = org::apache::nifi::minifi::io::Socket::getMyHostName();
+      }
+#endif
+      peers_.emplace_back(std::make_shared<sitetosite::Peer>(protocol_uuid_, host, configured_port, ssl_service != nullptr), 0, false);
+      peer_selector_.setPeers(peers_, direction_);
     } else {
       // we cannot proceed, so log error and throw an exception
       logger_->log_error("%s/%s/%d -- configuration values after eval of configuration options", host, portStr, configured_port);
       throw(Exception(SITE2SITE_EXCEPTION, "HTTPClient not resolvable. No peers configured or any port specific hostname and port -- cannot schedule"));
     }
   }
-  // populate the site2site protocol for load balancing between them
-  if (peers_.size() > 0) {
-    auto count = peers_.size();
-    if (max_concurrent_tasks_ > count)
-      count = max_concurrent_tasks_;
-    for (uint32_t i = 0; i < count; i++) {
-      std::unique_ptr<sitetosite::SiteToSiteClient> nextProtocol = nullptr;
-      sitetosite::SiteToSiteClientConfiguration config(stream_factory_, peers_[this->peer_index_].getPeer(), this->getInterface(), client_type_);
+  // populate a site2site protocol for each peer, more are created as transactions overlap
+  if (!peer_selector_.empty()) {
+    for (const auto &peer : peer_selector_.getPeers()) {
+      sitetosite::SiteToSiteClientConfiguration config(stream_factory_, peer, this->getInterface(), client_type_);
       config.setSecurityContext(ssl_service);
-      peer_index_++;
-      if (peer_index_ >= static_cast<int>(peers_.size())) {
-        peer_index_ = 0;
-      }
       logger_->log_trace("Creating client");
       config.setHTTPProxy(this->proxy_);
-      nextProtocol = sitetosite::createClient(config);
-      logger_->log_trace("Created client, moving into available protocols");
-      returnProtocol(std::move(nextProtocol));
+      config.setUseCompression(use_compression_);
+      std::unique_ptr<sitetosite::SiteToSiteClient> nextProtocol = sitetosite::createClient(config);
+      if (nullptr != nextProtocol) {
+        logger_->log_trace("Created client, moving into available protocols");
+        getPeerProtocols(peer->getHost(), peer->getPort(), true)->available_protocols_.enqueue(std::move(nextProtocol));
+      }
     }
   } else {
     // we don't have any peers
@@ -216,10 +252,12 @@ void RemoteProcessorGroupPort::notifyStop() {
   // we use the latch
   while (count.getCount() > 0) {
   }
-  std::unique_ptr<sitetosite::SiteToSiteClient> nextProtocol = nullptr;
-  while (available_protocols_.try_dequeue(nextProtocol)) {
-    // clear all protocols now
+  std::lock_guard<std::mutex> lock(protocol_mutex_);
+  // clear all protocols now, the clients still in flight are dropped when they return
+  for (auto &protocols : peer_protocols_) {
+    protocols.second->removed_ = true;
   }
+  peer_protocols_.clear();
 }
 
 void RemoteProcessorGroupPort::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
@@ -234,7 +272,7 @@ void RemoteProcessorGroupPort::onTrigger(const std::shared_ptr<core::ProcessCont
 
   logger_->log_trace("On trigger %s", getUUIDStr());
 
-  std::unique_ptr<sitetosite::SiteToSiteClient> protocol_ = nullptr;
+  PooledProtocol protocol_;
   try {
     logger_->log_trace("get protocol in on trigger");
     protocol_ = getNextProtocol();
@@ -245,22 +283,33 @@ void RemoteProcessorGroupPort::onTrigger(const std::shared_ptr<core::ProcessCont
       return;
     }
 
+    uint64_t raw_bytes = protocol_->getRawBytes();
+    uint64_t compressed_bytes = protocol_->getCompressedBytes();
     if (!protocol_->transfer(direction_, context, session)) {
       logger_->log_warn("protocol transmission failed, yielding");
       context->yield();
     }
+    metrics_->raw_bytes_ += protocol_->getRawBytes() - raw_bytes;
+    metrics_->compressed_bytes_ += protocol_->getCompressedBytes() - compressed_bytes;
 
     returnProtocol(std::move(protocol_));
     return;
   } catch (const minifi::Exception &ex2) {
+    releaseProtocol(std::move(protocol_));
     context->yield();
     session->rollback();
   } catch (...) {
+    releaseProtocol(std::move(protocol_));
     context->yield();
     session->rollback();
   }
 }
 
+int16_t RemoteProcessorGroupPort::getMetricNodes(std::vector<std::shared_ptr<state::response::ResponseNode>> &metric_vector) {
+  metric_vector.push_back(metrics_);
+  return 0;
+}
+
 std::pair<std::string, int> RemoteProcessorGroupPort::refreshRemoteSite2SiteInfo() {
   if (nifi_instances_.empty())
     return std::make_pair("", -1);
@@ -371,14 +420,13 @@ std::pair<std::string, int> RemoteProcessorGroupPort::refreshRemoteSite2SiteInfo
 }
 
 void RemoteProcessorGroupPort::refreshPeerList() {
+  next_peer_refresh_msec_ = getTimeMillis() + peer_refresh_interval_msec_;
   auto connection = refreshRemoteSite2SiteInfo();
   if (connection.second == -1) {
     logger_->log_debug("No port configured");
     return;
   }
 
-  this->peers_.clear();
-
   std::unique_ptr<sitetosite::SiteToSiteClient> protocol;
   sitetosite::SiteToSiteClientConfiguration config(stream_factory_, std::make_shared<sitetosite::Peer>(protocol_uuid_, connection.first, connection.second, ssl_service != nullptr),
                                                    this->getInterface(), client_type_);
@@ -386,13 +434,35 @@ void RemoteProcessorGroupPort::refreshPeerList() {
   config.setHTTPProxy(this->proxy_);
   protocol = sitetosite::createClient(config);
 
+  std::vector<sitetosite::PeerStatus> peers;
   if (protocol)
-    protocol->getPeerList(peers_);
+    protocol->getPeerList(peers);
+
+  // keep transferring with the known peers if the remote instance could not list them
+  if (peers.empty() && !peers_.empty()) {
+    logger_->log_debug("Keeping the %lu known peers", peers_.size());
+    return;
+  }
+
+  peers_ = std::move(peers);
+  peer_selector_.setPeers(peers_, direction_);
 
   logging::LOG_INFO(logger_) << "Have " << peers_.size() << " peers";
 
-  if (peers_.size() > 0)
-    peer_index_ = 0;
+  // the clients of the peers that left are not reused
+  std::set<std::string> keys;
+  for (auto &peer : peers_) {
+    keys.insert(peer.getPeer()->getHost() + ":" + std::to_string(peer.getPeer()->getPort()));
+  }
+  std::lock_guard<std::mutex> lock(protocol_mutex_);
+  for (auto it = peer_protocols_.begin(); it != peer_protocols_.end();) {
+    if (keys.find(it->first) == keys.end()) {
+      it->second->removed_ = true;
+      it = peer_protocols_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 } /* namespace minifi */
@@ -0,0 +1,93 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/ContentPathDictionary.h"
+#include <string>
+#include "core/Repository.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+constexpr const char *ContentPathDictionary::KEY_PREFIX;
+constexpr uint32_t ContentPathDictionary::MAX_PROBES;
+
+bool ContentPathDictionary::intern(Repository &repo, const std::string &prefix, uint32_t &id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto known = ids_.find(prefix);
+  if (known != ids_.end()) {
+    id = known->second;
+    return true;
+  }
+  uint32_t candidate = hash(prefix);
+  for (uint32_t probe = 0; probe < MAX_PROBES; probe++, candidate++) {
+    if (prefixes_.find(candidate) != prefixes_.end()) {
+      continue;
+    }
+    // records of repositories that are not persistent do not outlive the process, neither does their dictionary
+    if (repo.isPersistent()) {
+      std::string stored;
+      if (repo.Get(getKey(candidate), stored)) {
+        if (stored != prefix) {
+          // taken by a prefix of an earlier run
+          prefixes_[candidate] = stored;
+          ids_[stored] = candidate;
+          continue;
+        }
+      } else if (!repo.Put(getKey(candidate), reinterpret_cast<const uint8_t*>(prefix.data()), prefix.size())) {
+        return false;
+      }
+    }
+    prefixes_[candidate] = prefix;
+    ids_[prefix] = candidate;
+    id = candidate;
+    return true;
+  }
+  return false;
+}
+
+bool ContentPathDictionary::resolve(Repository &repo, uint32_t id, std::string &prefix) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto known = prefixes_.find(id);
+  if (known != prefixes_.end()) {
+    prefix = known->second;
+    return true;
+  }
+  if (!repo.isPersistent() || !repo.Get(getKey(id), prefix)) {
+    return false;
+  }
+  prefixes_[id] = prefix;
+  ids_[prefix] = id;
+  return true;
+}
+
+uint32_t ContentPathDictionary::hash(const std::string &prefix) {
+  // FNV-1a, folded to 24 bits to keep the varint encoded IDs short
+  uint32_t hash = 2166136261u;
+  for (char c : prefix) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return (hash >> 24) ^ (hash & 0xFFFFFF);
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
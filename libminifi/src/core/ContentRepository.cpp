@@ -0,0 +1,491 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/ContentRepository.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Exception.h"
+#include "utils/ScopeGuard.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+namespace {
+
+// position of the file name in a content path
+size_t getFileNameStart(const std::string &path) {
+  const size_t separator = path.rfind('/');
+  return separator == std::string::npos ? 0 : separator + 1;
+}
+
+}  // namespace
+
+/**
+ * Read stream on the content of a composite claim, which opens the streams of the claims it refers to
+ * as it reaches their ranges. The repository has to outlive it.
+ */
+class CompositeStream : public io::BaseStream {
+ public:
+  CompositeStream(ContentRepository *repository, std::shared_ptr<const ContentRepository::Composite> composite)
+      : repository_(repository),
+        composite_(std::move(composite)),
+        current_(0),
+        offset_(0),
+        failed_(false) {
+  }
+
+  void closeStream() override {
+    stream_ = nullptr;
+  }
+
+  void seek(uint64_t offset) override {
+    offset_ = (std::min)(offset, composite_->size);
+    stream_ = nullptr;
+  }
+
+  const uint64_t getSize() const override {
+    return composite_->size;
+  }
+
+  int read(uint16_t &value, bool is_little_endian) override {
+    uint8_t buf[2];
+    if (readData(&buf[0], 2) != 2)
+      return -1;
+    if (is_little_endian) {
+      value = (buf[0] << 8) | buf[1];
+    } else {
+      value = buf[0] | buf[1] << 8;
+    }
+    return 2;
+  }
+
+  int read(uint32_t &value, bool is_little_endian) override {
+    uint8_t buf[4];
+    if (readData(&buf[0], 4) != 4)
+      return -1;
+    if (is_little_endian) {
+      value = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+    } else {
+      value = buf[0] | buf[1] << 8 | buf[2] << 16 | buf[3] << 24;
+    }
+    return 4;
+  }
+
+  int read(uint64_t &value, bool is_little_endian) override {
+    uint8_t buf[8];
+    if (readData(&buf[0], 8) != 8)
+      return -1;
+    if (is_little_endian) {
+      value = ((uint64_t) buf[0] << 56) | ((uint64_t) (buf[1] & 255) << 48) | ((uint64_t) (buf[2] & 255) << 40) | ((uint64_t) (buf[3] & 255) << 32) | ((uint64_t) (buf[4] & 255) << 24)
+          | ((uint64_t) (buf[5] & 255) << 16) | ((uint64_t) (buf[6] & 255) << 8) | ((uint64_t) (buf[7] & 255) << 0);
+    } else {
+      value = ((uint64_t) buf[0] << 0) | ((uint64_t) (buf[1] & 255) << 8) | ((uint64_t) (buf[2] & 255) << 16) | ((uint64_t) (buf[3] & 255) << 24) | ((uint64_t) (buf[4] & 255) << 32)
+          | ((uint64_t) (buf[5] & 255) << 40) | ((uint64_t) (buf[6] & 255) << 48) | ((uint64_t) (buf[7] & 255) << 56);
+    }
+    return 8;
+  }
+
+  int readData(std::vector<uint8_t> &buf, int buflen) override {
+    if (buflen < 0) {
+      throw minifi::Exception{ExceptionType::GENERAL_EXCEPTION, "negative buflen"};
+    }
+
+    if (buf.size() < static_cast<size_t>(buflen)) {
+      buf.resize(buflen);
+    }
+    int ret = readData(buf.data(), buflen);
+
+    if (ret < buflen) {
+      buf.resize((std::max)(ret, 0));
+    }
+    return ret;
+  }
+
+  int readData(uint8_t *buf, int buflen) override {
+    if (failed_ || (buf == nullptr && buflen > 0) || buflen < 0) {
+      return -1;
+    }
+    const auto &ranges = composite_->ranges;
+    const auto &starts = composite_->starts;
+    int total = 0;
+    while (total < buflen && offset_ < composite_->size) {
+      if (stream_ == nullptr) {
+        // the last range starting at or before the offset, ranges are never empty
+        current_ = std::upper_bound(starts.begin(), starts.end(), offset_) - starts.begin() - 1;
+        stream_ = repository_->read(ranges[current_].claim);
+        if (stream_ == nullptr) {
+          failed_ = true;
+          return -1;
+        }
+        stream_->seek(ranges[current_].offset + offset_ - starts[current_]);
+      }
+      const uint64_t range_end = starts[current_] + ranges[current_].length;
+      const int amount = static_cast<int>((std::min)(static_cast<uint64_t>(buflen - total), range_end - offset_));
+      const int ret = stream_->readData(buf + total, amount);
+      if (ret <= 0) {
+        failed_ = true;
+        return -1;
+      }
+      total += ret;
+      offset_ += ret;
+      if (offset_ == range_end) {
+        stream_ = nullptr;
+      }
+    }
+    return total;
+  }
+
+  // the content of composite claims is never written
+  int writeData(uint8_t *value, int size) override {
+    return -1;
+  }
+
+ private:
+  ContentRepository *repository_;
+  std::shared_ptr<const ContentRepository::Composite> composite_;
+  // stream on the range the offset is in, if it is open
+  std::shared_ptr<io::BaseStream> stream_;
+  size_t current_;
+  uint64_t offset_;
+  bool failed_;
+};
+
+bool ContentRepository::removeIfOrphaned(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
+  const std::string path = streamId->getContentFullPath();
+  {
+    PathShard &path_shard = getPathShard(path);
+    std::lock_guard<std::mutex> path_lock(path_shard.mutex);
+    auto known = path_shard.ids.find(path);
+    if (known != path_shard.ids.end()) {
+      CountShard &shard = getCountShard(known->second);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto count = shard.counts.find(known->second);
+      if (count->second != 0) {
+        return false;
+      }
+      shard.counts.erase(count);
+      path_shard.ids.erase(known);
+    }
+  }
+  // claims still holding the ID fall back to the path, which is no longer known
+  remove(streamId);
+  return true;
+}
+
+uint32_t ContentRepository::getStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
+  const uint64_t id = streamId->getClaimId();
+  if (id != 0) {
+    CountShard &shard = getCountShard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto count = shard.counts.find(id);
+    if (count != shard.counts.end()) {
+      return count->second;
+    }
+  }
+  const std::string path = streamId->getContentFullPath();
+  PathShard &path_shard = getPathShard(path);
+  std::lock_guard<std::mutex> path_lock(path_shard.mutex);
+  auto known = path_shard.ids.find(path);
+  if (known == path_shard.ids.end()) {
+    return 0;
+  }
+  streamId->setClaimId(known->second);
+  CountShard &shard = getCountShard(known->second);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.counts[known->second];
+}
+
+void ContentRepository::incrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
+  const uint64_t id = streamId->getClaimId();
+  if (id != 0) {
+    CountShard &shard = getCountShard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto count = shard.counts.find(id);
+    if (count != shard.counts.end()) {
+      count->second++;
+      return;
+    }
+  }
+  const std::string path = streamId->getContentFullPath();
+  bool first = false;
+  {
+    PathShard &path_shard = getPathShard(path);
+    std::lock_guard<std::mutex> path_lock(path_shard.mutex);
+    auto known = path_shard.ids.find(path);
+    if (known == path_shard.ids.end()) {
+      known = path_shard.ids.emplace(path, next_claim_id_++).first;
+      first = true;
+    }
+    streamId->setClaimId(known->second);
+    CountShard &shard = getCountShard(known->second);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.counts[known->second]++;
+  }
+  // e.g. the claim of a Flow File restored after a restart, which has to keep the claims it refers to
+  if (first && isComposite(streamId)) {
+    getComposite(streamId);
+  }
+}
+
+void ContentRepository::decrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
+  const uint64_t id = streamId->getClaimId();
+  if (id != 0) {
+    CountShard &shard = getCountShard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto count = shard.counts.find(id);
+    if (count != shard.counts.end() && count->second > 0) {
+      count->second--;
+      return;
+    }
+  }
+  // either unknown or already at zero, which drops the count
+  const std::string path = streamId->getContentFullPath();
+  PathShard &path_shard = getPathShard(path);
+  std::lock_guard<std::mutex> path_lock(path_shard.mutex);
+  auto known = path_shard.ids.find(path);
+  if (known == path_shard.ids.end()) {
+    return;
+  }
+  CountShard &shard = getCountShard(known->second);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto count = shard.counts.find(known->second);
+  if (count->second > 0) {
+    streamId->setClaimId(known->second);
+    count->second--;
+  } else {
+    shard.counts.erase(count);
+    path_shard.ids.erase(known);
+  }
+}
+
+bool ContentRepository::createComposite(const std::shared_ptr<minifi::ResourceClaim> &claim, const std::vector<ContentRange> &ranges) {
+  auto composite = std::make_shared<Composite>();
+  composite->size = 0;
+  auto add = [&composite](const ContentRange &range) {
+    auto &added = composite->ranges;
+    if (!added.empty() && added.back().offset + added.back().length == range.offset && added.back().claim->getContentFullPath() == range.claim->getContentFullPath()) {
+      added.back().length += range.length;
+    } else {
+      composite->starts.push_back(composite->size);
+      added.push_back(range);
+    }
+    composite->size += range.length;
+  };
+  for (const auto &range : ranges) {
+    if (range.claim == nullptr || range.length == 0) {
+      continue;
+    }
+    if (!isComposite(range.claim)) {
+      add(ContentRange{getRangeClaim(range.claim->getContentFullPath()), range.offset, range.length});
+      continue;
+    }
+    auto nested = getComposite(range.claim);
+    if (nested == nullptr) {
+      return false;
+    }
+    const uint64_t end = range.offset + range.length;
+    for (size_t i = 0; i < nested->ranges.size(); i++) {
+      const uint64_t start = nested->starts[i];
+      const uint64_t nested_end = start + nested->ranges[i].length;
+      if (nested_end <= range.offset || start >= end) {
+        continue;
+      }
+      const uint64_t from = (std::max)(start, range.offset);
+      const uint64_t to = (std::min)(nested_end, end);
+      add(ContentRange{nested->ranges[i].claim, nested->ranges[i].offset + (from - start), to - from});
+    }
+  }
+
+  const std::string path = claim->getContentFullPath();
+  const size_t name = getFileNameStart(path);
+  claim->setContentFullPath(path.substr(0, name) + COMPOSITE_CLAIM_PREFIX + path.substr(name));
+
+  io::BaseStream buffer;
+  buffer.write(static_cast<uint32_t>(composite->ranges.size()));
+  for (const auto &range : composite->ranges) {
+    buffer.writeUTF(range.claim->getContentFullPath(), true);
+    buffer.write(range.offset);
+    buffer.write(range.length);
+  }
+  auto ranges_claim = getRangesClaim(claim);
+  auto stream = write(ranges_claim);
+  if (stream == nullptr) {
+    return false;
+  }
+  const int size = static_cast<int>(buffer.getSize());
+  const bool written = stream->writeData(const_cast<uint8_t*>(buffer.getBuffer()), size) == size;
+  stream->closeStream();
+  if (!written) {
+    remove(ranges_claim);
+    return false;
+  }
+
+  // the ranges claim is counted too, so that repositories reclaiming unowned content keep it
+  incrementStreamCount(ranges_claim);
+  for (const auto &range : composite->ranges) {
+    incrementStreamCount(range.claim);
+  }
+  std::lock_guard<std::mutex> lock(composites_mutex_);
+  composites_[claim->getContentFullPath()] = composite;
+  return true;
+}
+
+bool ContentRepository::copy(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length, const std::shared_ptr<minifi::ResourceClaim> &target) {
+  auto source = read(claim);
+  if (source == nullptr) {
+    return false;
+  }
+  auto stream = write(target);
+  if (stream == nullptr) {
+    return false;
+  }
+  utils::ScopeGuard close_target([&stream]() {
+    stream->closeStream();
+  });
+  source->seek(offset);
+  std::vector<uint8_t> buffer(COMPOSITE_COPY_BUFFER_SIZE);
+  while (length > 0) {
+    const int ret = source->readData(buffer.data(), static_cast<int>((std::min)(length, static_cast<uint64_t>(buffer.size()))));
+    if (ret <= 0 || stream->writeData(buffer.data(), ret) != ret) {
+      return false;
+    }
+    length -= ret;
+  }
+  return true;
+}
+
+std::shared_ptr<io::ContentBuffer> ContentRepository::map(const std::shared_ptr<minifi::ResourceClaim>& /*claim*/, uint64_t /*offset*/, uint64_t /*length*/) {
+  // copying the content here would hold all of it in memory, callers stream it instead
+  return nullptr;
+}
+
+bool ContentRepository::isComposite(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  const std::string path = claim->getContentFullPath();
+  return path.compare(getFileNameStart(path), std::strlen(COMPOSITE_CLAIM_PREFIX), COMPOSITE_CLAIM_PREFIX) == 0;
+}
+
+std::shared_ptr<io::BaseStream> ContentRepository::readComposite(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  auto composite = getComposite(claim);
+  if (composite == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<CompositeStream>(this, composite);
+}
+
+bool ContentRepository::compositeExists(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  return exists(getRangesClaim(claim));
+}
+
+bool ContentRepository::removeComposite(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  auto composite = getComposite(claim);
+  if (composite == nullptr) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(composites_mutex_);
+    // only the first removal releases the claims referred to
+    if (composites_.erase(claim->getContentFullPath()) == 0) {
+      return false;
+    }
+  }
+  auto ranges_claim = getRangesClaim(claim);
+  decrementStreamCount(ranges_claim);
+  remove(ranges_claim);
+  for (const auto &range : composite->ranges) {
+    decrementStreamCount(range.claim);
+    removeIfOrphaned(range.claim);
+  }
+  return true;
+}
+
+std::shared_ptr<minifi::ResourceClaim> ContentRepository::getRangesClaim(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  const std::string path = claim->getContentFullPath();
+  const size_t name = getFileNameStart(path);
+  return getRangeClaim(path.substr(0, name) + COMPOSITE_RANGES_PREFIX + path.substr(name + std::strlen(COMPOSITE_CLAIM_PREFIX)));
+}
+
+std::shared_ptr<minifi::ResourceClaim> ContentRepository::getRangeClaim(const std::string &path) {
+  // the repository holds these claims, they must not hold it
+  return std::make_shared<minifi::ResourceClaim>(path, std::shared_ptr<StreamManager<minifi::ResourceClaim>>());
+}
+
+std::shared_ptr<const ContentRepository::Composite> ContentRepository::getComposite(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  const std::string path = claim->getContentFullPath();
+  {
+    std::lock_guard<std::mutex> lock(composites_mutex_);
+    auto found = composites_.find(path);
+    if (found != composites_.end()) {
+      return found->second;
+    }
+  }
+
+  auto ranges_claim = getRangesClaim(claim);
+  auto stream = read(ranges_claim);
+  if (stream == nullptr) {
+    return nullptr;
+  }
+  std::vector<uint8_t> content;
+  std::vector<uint8_t> buffer(4096);
+  int ret;
+  while ((ret = stream->readData(buffer.data(), static_cast<int>(buffer.size()))) > 0) {
+    content.insert(content.end(), buffer.begin(), buffer.begin() + ret);
+  }
+  io::DataStream data(content.data(), static_cast<uint32_t>(content.size()));
+  io::BaseStream reader(&data);
+  auto composite = std::make_shared<Composite>();
+  composite->size = 0;
+  uint32_t count = 0;
+  if (reader.read(count) != 4) {
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    std::string range_path;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    if (reader.readUTF(range_path, true) <= 0 || reader.read(offset) != 8 || reader.read(length) != 8) {
+      return nullptr;
+    }
+    composite->starts.push_back(composite->size);
+    composite->ranges.push_back(ContentRange{getRangeClaim(range_path), offset, length});
+    composite->size += length;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(composites_mutex_);
+    auto inserted = composites_.emplace(path, composite);
+    if (!inserted.second) {
+      return inserted.first->second;
+    }
+  }
+  incrementStreamCount(ranges_claim);
+  for (const auto &range : composite->ranges) {
+    incrementStreamCount(range.claim);
+  }
+  return composite;
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,95 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/FlowFilePrioritizer.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <cerrno>
+#include <cstdlib>
+#include "core/ClassLoader.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+constexpr const char *PriorityAttributePrioritizer::PRIORITY_ATTRIBUTE;
+
+namespace {
+
+bool parsePriority(const std::string &input, long long &output) {
+  if (input.empty()) {
+    return false;
+  }
+  char *end = nullptr;
+  errno = 0;
+  output = std::strtoll(input.c_str(), &end, 10);
+  return errno == 0 && end == input.c_str() + input.size();
+}
+
+}  // namespace
+
+bool PriorityAttributePrioritizer::prioritize(const FlowFile &lhs, const FlowFile &rhs) const {
+  std::string lhs_priority;
+  std::string rhs_priority;
+  const bool lhs_has = lhs.getAttribute(PRIORITY_ATTRIBUTE, lhs_priority);
+  const bool rhs_has = rhs.getAttribute(PRIORITY_ATTRIBUTE, rhs_priority);
+  if (!lhs_has || !rhs_has) {
+    return lhs_has && !rhs_has;
+  }
+
+  long long lhs_value = 0;
+  long long rhs_value = 0;
+  const bool lhs_numeric = parsePriority(lhs_priority, lhs_value);
+  const bool rhs_numeric = parsePriority(rhs_priority, rhs_value);
+  if (lhs_numeric && rhs_numeric) {
+    return lhs_value < rhs_value;
+  }
+  if (lhs_numeric != rhs_numeric) {
+    return lhs_numeric;
+  }
+  return lhs_priority < rhs_priority;
+}
+
+std::shared_ptr<FlowFilePrioritizer> createFlowFilePrioritizer(const std::string &class_name) {
+  // accept both the NiFi class name and the simple one
+  std::string simple_name = class_name.substr(class_name.find_last_of('.') + 1);
+
+  auto ptr = core::ClassLoader::getDefaultClassLoader().instantiate<FlowFilePrioritizer>(simple_name, simple_name);
+  if (nullptr != ptr) {
+    return ptr;
+  }
+
+  std::transform(simple_name.begin(), simple_name.end(), simple_name.begin(), ::tolower);
+  if (simple_name == "firstinfirstoutprioritizer") {
+    return std::make_shared<FirstInFirstOutPrioritizer>();
+  } else if (simple_name == "oldestflowfilefirstprioritizer") {
+    return std::make_shared<OldestFlowFileFirstPrioritizer>();
+  } else if (simple_name == "newestflowfilefirstprioritizer") {
+    return std::make_shared<NewestFlowFileFirstPrioritizer>();
+  } else if (simple_name == "priorityattributeprioritizer") {
+    return std::make_shared<PriorityAttributePrioritizer>();
+  }
+  return nullptr;
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
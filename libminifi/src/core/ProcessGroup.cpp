@@ -29,6 +29,7 @@
 #include <thread>
 #include "core/Processor.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "sitetosite/PeerSelector.h"
 
 namespace org {
 namespace apache {
@@ -67,6 +68,9 @@ ProcessGroup::ProcessGroup(ProcessGroupType type, std::string name, utils::Ident
   }
   transmitting_ = false;
   transport_protocol_ = "RAW";
+  use_compression_ = false;
+  peer_refresh_interval_msec_ = SITE2SITE_PEER_REFRESH_INTERVAL_MSEC;
+  max_transactions_per_peer_ = 0;
 
   logger_->log_debug("ProcessGroup %s created", name_);
 }
@@ -83,6 +87,9 @@ ProcessGroup::ProcessGroup(ProcessGroupType type, std::string name)
   onschedule_retry_msec_ = ONSCHEDULE_RETRY_INTERVAL;
   transmitting_ = false;
   transport_protocol_ = "RAW";
+  use_compression_ = false;
+  peer_refresh_interval_msec_ = SITE2SITE_PEER_REFRESH_INTERVAL_MSEC;
+  max_transactions_per_peer_ = 0;
 
   logger_->log_debug("ProcessGroup %s created", name_);
 }
@@ -306,6 +306,22 @@ void ProcessSession::append(const std::shared_ptr<core::FlowFile> &flow, OutputS
 
   try {
     uint64_t startTime = getTimeMillis();
+    if (ContentRepository::isComposite(claim)) {
+      // the content of composite claims is never written, it is copied into a claim of its own first
+      std::shared_ptr<ResourceClaim> copy = std::make_shared<ResourceClaim>(process_context_->getContentRepository());
+      copy->increaseFlowFileRecordOwnedCount();
+      if (!process_context_->getContentRepository()->copy(claim, flow->getOffset(), flow->getSize(), copy)) {
+        copy->decreaseFlowFileRecordOwnedCount();
+        process_context_->getContentRepository()->removeIfOrphaned(copy);
+        rollback();
+        return;
+      }
+      claim->decreaseFlowFileRecordOwnedCount();
+      flow->clearResourceClaim();
+      flow->setResourceClaim(copy);
+      flow->setOffset(0);
+      claim = copy;
+    }
     std::shared_ptr<io::BaseStream> stream = process_context_->getContentRepository()->write(claim, true);
     if (nullptr == stream) {
       rollback();
@@ -337,6 +353,36 @@ void ProcessSession::append(const std::shared_ptr<core::FlowFile> &flow, OutputS
   }
 }
 
+void ProcessSession::concatenate(const std::shared_ptr<core::FlowFile> &flow, const std::vector<ContentRange> &ranges) {
+  uint64_t startTime = getTimeMillis();
+  std::shared_ptr<ResourceClaim> claim = std::make_shared<ResourceClaim>(process_context_->getContentRepository());
+  if (!process_context_->getContentRepository()->createComposite(claim, ranges)) {
+    throw Exception(FILE_OPERATION_EXCEPTION, "Failed to store the ranges of concatenated content");
+  }
+  claim->increaseFlowFileRecordOwnedCount();
+
+  uint64_t size = 0;
+  for (const auto &range : ranges) {
+    if (range.claim != nullptr) {
+      size += range.length;
+    }
+  }
+  flow->setSize(size);
+  flow->setOffset(0);
+  std::shared_ptr<ResourceClaim> flow_claim = flow->getResourceClaim();
+  if (flow_claim != nullptr) {
+    // Remove the old claim, which the ranges may still refer to
+    flow_claim->decreaseFlowFileRecordOwnedCount();
+    flow->clearResourceClaim();
+  }
+  flow->setResourceClaim(claim);
+
+  std::stringstream details;
+  details << process_context_->getProcessorNode()->getName() << " concatenate flow record content " << flow->getUUIDStr();
+  uint64_t endTime = getTimeMillis();
+  provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+}
+
 void ProcessSession::read(const std::shared_ptr<core::FlowFile> &flow, InputStreamCallback *callback) {
   try {
     std::shared_ptr<ResourceClaim> claim = nullptr;
@@ -374,6 +420,68 @@ void ProcessSession::read(const std::shared_ptr<core::FlowFile> &flow, InputStre
   }
 }
 
+void ProcessSession::read(const std::shared_ptr<core::FlowFile> &flow, InputBufferCallback *callback) {
+  try {
+    std::shared_ptr<ResourceClaim> claim = nullptr;
+
+    if (flow->getResourceClaim() == nullptr) {
+      // No existed claim for read, we throw exception
+      logger_->log_debug("For %s, no resource claim but size is %d", flow->getUUIDStr(), flow->getSize());
+      if (flow->getSize() == 0) {
+        return;
+      }
+      throw Exception(FILE_OPERATION_EXCEPTION, "No Content Claim existed for read");
+    }
+
+    claim = flow->getResourceClaim();
+
+    std::shared_ptr<io::ContentBuffer> buffer = process_context_->getContentRepository()->map(claim, flow->getOffset(), flow->getSize());
+
+    if (nullptr != buffer) {
+      if (callback->processBuffer(buffer) < 0) {
+        rollback();
+      }
+      return;
+    }
+
+    // the content cannot be mapped, hand it over in pieces rather than holding all of it
+    std::shared_ptr<io::BaseStream> stream = process_context_->getContentRepository()->read(claim);
+
+    if (nullptr == stream) {
+      rollback();
+      return;
+    }
+
+    stream->seek(flow->getOffset());
+
+    uint64_t remaining = flow->getSize();
+    std::vector<uint8_t> piece((std::min)(remaining, static_cast<uint64_t>(COMPOSITE_COPY_BUFFER_SIZE)));
+    do {
+      int ret = 0;
+      if (remaining > 0) {
+        ret = stream->readData(piece.data(), static_cast<int>((std::min)(remaining, static_cast<uint64_t>(piece.size()))));
+        if (ret < 0) {
+          throw Exception(FILE_OPERATION_EXCEPTION, "Failed to read content");
+        }
+        if (ret == 0) {
+          break;
+        }
+        remaining -= ret;
+      }
+      if (callback->process(piece.data(), ret) < 0) {
+        rollback();
+        return;
+      }
+    } while (remaining > 0);
+  } catch (std::exception &exception) {
+    logger_->log_debug("Caught Exception %s", exception.what());
+    throw;
+  } catch (...) {
+    logger_->log_debug("Caught Exception during process session read");
+    throw;
+  }
+}
+
 /**
  * Imports a file from the data stream
  * @param stream incoming data stream that contains the data to store into a file
@@ -927,31 +1035,11 @@ std::shared_ptr<core::FlowFile> ProcessSession::get() {
   do {
     std::set<std::shared_ptr<core::FlowFile> > expired;
     std::shared_ptr<core::FlowFile> ret = current->poll(expired);
-    if (expired.size() > 0) {
-      // Remove expired flow record
-      for (std::set<std::shared_ptr<core::FlowFile> >::iterator it = expired.begin(); it != expired.end(); ++it) {
-        std::shared_ptr<core::FlowFile> record = *it;
-        std::stringstream details;
-        details << process_context_->getProcessorNode()->getName() << " expire flow record " << record->getUUIDStr();
-        provenance_report_->expire(record, details.str());
-      }
+    for (const auto &record : expired) {
+      expire(record);
     }
     if (ret) {
-      // add the flow record to the current process session update map
-      ret->setDeleted(false);
-      _updatedFlowFiles[ret->getUUIDStr()] = ret;
-      std::map<std::string, std::string> empty;
-      std::shared_ptr<core::FlowFile> snapshot = std::make_shared<FlowFileRecord>(process_context_->getFlowFileRepository(), process_context_->getContentRepository(), empty);
-      auto flow_version = process_context_->getProcessorNode()->getFlowIdentifier();
-      if (flow_version != nullptr) {
-        auto flow_id = flow_version->getFlowId();
-        std::string attr = FlowAttributeKey(FLOW_ID);
-        snapshot->setAttribute(attr, flow_version->getFlowId());
-      }
-      logger_->log_debug("Create Snapshot FlowFile with UUID %s", snapshot->getUUIDStr());
-      snapshot = ret;
-      // save a snapshot
-      _originalFlowFiles[snapshot->getUUIDStr()] = snapshot;
+      track(ret);
       return ret;
     }
     current = std::static_pointer_cast<Connection>(process_context_->getProcessorNode()->getNextIncomingConnection());
@@ -960,6 +1048,62 @@ std::shared_ptr<core::FlowFile> ProcessSession::get() {
   return NULL;
 }
 
+std::vector<std::shared_ptr<core::FlowFile>> ProcessSession::get(size_t max, uint64_t max_bytes) {
+  std::vector<std::shared_ptr<core::FlowFile>> flows;
+  std::shared_ptr<Connectable> first = process_context_->getProcessorNode()->getNextIncomingConnection();
+
+  if (first == NULL || max == 0) {
+    logger_->log_trace("Get is null for %s", process_context_->getProcessorNode()->getName());
+    return flows;
+  }
+
+  std::shared_ptr<Connection> current = std::static_pointer_cast<Connection>(first);
+  std::vector<std::shared_ptr<core::FlowFile>> expired;
+  uint64_t bytes = 0;
+
+  do {
+    const size_t offset = flows.size();
+    uint64_t remaining_bytes = 0;
+    if (max_bytes > 0) {
+      // the first flow file of a batch is always returned, so stop once the byte budget is used up
+      if (bytes >= max_bytes) {
+        break;
+      }
+      remaining_bytes = max_bytes - bytes;
+    }
+    current->pollBatch(flows, max - offset, remaining_bytes, expired);
+    for (size_t i = offset; i < flows.size(); ++i) {
+      bytes += flows[i]->getSize();
+      track(flows[i]);
+    }
+    if (flows.size() >= max) {
+      break;
+    }
+    current = std::static_pointer_cast<Connection>(process_context_->getProcessorNode()->getNextIncomingConnection());
+  } while (current != NULL && current != first);
+
+  for (const auto &record : expired) {
+    expire(record);
+  }
+
+  return flows;
+}
+
+void ProcessSession::track(const std::shared_ptr<core::FlowFile> &flow) {
+  // add the flow record to the current process session update map
+  flow->setDeleted(false);
+  _updatedFlowFiles[flow->getUUIDStr()] = flow;
+  // save a snapshot
+  _originalFlowFiles[flow->getUUIDStr()] = flow;
+}
+
+void ProcessSession::expire(const std::shared_ptr<core::FlowFile> &flow) {
+  // Remove expired flow record
+  std::stringstream details;
+  details << process_context_->getProcessorNode()->getName() << " expire flow record " << flow->getUUIDStr();
+  provenance_report_->expire(flow, details.str());
+}
+
 bool ProcessSession::outgoingConnectionsFull(const std::string& relationship) {
   std::set<std::shared_ptr<Connectable>> connections = process_context_->getProcessorNode()->getOutGoingConnections(relationship);
   Connection * connection = nullptr;
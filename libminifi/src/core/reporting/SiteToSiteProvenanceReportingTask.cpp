@@ -178,6 +178,7 @@ void SiteToSiteProvenanceReportingTask::onTrigger(const std::shared_ptr<core::Pr
     }
   } catch (...) {
     // if transfer bytes failed, return instead of purge the provenance records
+    releaseProtocol(std::move(protocol_));
     return;
   }
 
@@ -47,15 +47,34 @@ std::shared_ptr<io::BaseStream> FileSystemRepository::write(const std::shared_pt
 }
 
 bool FileSystemRepository::exists(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
+  if (isComposite(streamId)) {
+    return compositeExists(streamId);
+  }
   std::ifstream file(streamId->getContentFullPath());
   return file.good();
 }
 
 std::shared_ptr<io::BaseStream> FileSystemRepository::read(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (isComposite(claim)) {
+    return readComposite(claim);
+  }
   return std::make_shared<io::FileStream>(claim->getContentFullPath(), 0, false);
 }
 
+std::shared_ptr<io::ContentBuffer> FileSystemRepository::map(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length) {
+  if (!isComposite(claim)) {
+    std::shared_ptr<io::ContentBuffer> buffer = io::ContentBuffer::map(claim->getContentFullPath(), offset, length);
+    if (buffer != nullptr) {
+      return buffer;
+    }
+  }
+  return ContentRepository::map(claim, offset, length);
+}
+
 bool FileSystemRepository::remove(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (isComposite(claim)) {
+    return removeComposite(claim);
+  }
   std::remove(claim->getContentFullPath().c_str());
   return true;
 }
@@ -0,0 +1,813 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/repository/SlabContentRepository.h"
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "core/Property.h"
+#include "utils/file/FileUtils.h"
+#include <Exception.h>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+namespace {
+
+/**
+ * Containers are a sequence of records, integers are stored little endian:
+ *   data:      'D' | sequence (8) | path length (4) | path | content length (8) | content
+ *   tombstone: 'T' | sequence of the removed data record (8)
+ * Sequence numbers identify the data records. The content length of a record that is still being
+ * written is UNKNOWN_LENGTH.
+ */
+const char DATA_RECORD = 'D';
+const char TOMBSTONE_RECORD = 'T';
+const uint64_t UNKNOWN_LENGTH = std::numeric_limits<uint64_t>::max();
+const uint64_t DATA_HEADER_SIZE = 1 + 8 + 4 + 8;
+const uint64_t TOMBSTONE_SIZE = 1 + 8;
+const char CONTAINER_EXTENSION[] = ".slab";
+// readers kept open per container for later streams
+const size_t MAX_IDLE_READERS = 4;
+
+void appendUint32(std::string &out, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+void appendUint64(std::string &out, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+template<typename T>
+bool readInteger(std::istream &in, T &value) {
+  uint8_t buf[sizeof(T)];
+  if (!in.read(reinterpret_cast<char*>(buf), sizeof(T))) {
+    return false;
+  }
+  value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    value |= static_cast<T>(buf[i]) << (8 * i);
+  }
+  return true;
+}
+
+std::string encodeDataHeader(uint64_t sequence, const std::string &path, uint64_t length) {
+  std::string header;
+  header.reserve(DATA_HEADER_SIZE + path.size());
+  header.push_back(DATA_RECORD);
+  appendUint64(header, sequence);
+  appendUint32(header, static_cast<uint32_t>(path.size()));
+  header.append(path);
+  appendUint64(header, length);
+  return header;
+}
+
+struct Record {
+  char type;
+  uint64_t sequence;
+  std::string path;
+  uint64_t data_offset;
+  uint64_t length;
+  uint64_t end;
+};
+
+/**
+ * Reads the header of the record at offset, in is expected to be positioned there.
+ * @param size end of the container
+ * @return false if there is no complete record at offset
+ */
+bool readRecord(std::istream &in, uint64_t offset, uint64_t size, Record &record) {
+  char type;
+  if (!in.get(type) || !readInteger(in, record.sequence)) {
+    return false;
+  }
+  record.type = type;
+  if (type == TOMBSTONE_RECORD) {
+    record.end = offset + TOMBSTONE_SIZE;
+    return record.end <= size;
+  }
+  uint32_t path_length;
+  if (type != DATA_RECORD || !readInteger(in, path_length) || path_length > size - offset) {
+    return false;
+  }
+  record.path.resize(path_length);
+  if (path_length > 0 && !in.read(&record.path[0], path_length)) {
+    return false;
+  }
+  if (!readInteger(in, record.length) || record.length == UNKNOWN_LENGTH) {
+    return false;
+  }
+  record.data_offset = offset + DATA_HEADER_SIZE + path_length;
+  if (record.data_offset > size || record.length > size - record.data_offset) {
+    return false;
+  }
+  record.end = record.data_offset + record.length;
+  return true;
+}
+
+void skipContent(std::istream &in, const Record &record) {
+  if (record.length <= SLAB_CONTENT_REPOSITORY_STREAM_BUFFER_SIZE) {
+    // keeps the buffer of the stream, unlike seeking
+    in.ignore(record.length);
+  } else {
+    in.seekg(record.end);
+  }
+}
+
+}  // namespace
+
+SlabContainer::SlabContainer(uint64_t id, std::string path, uint64_t size)
+    : id_(id),
+      path_(std::move(path)),
+      size_(size),
+      leased_(false),
+      sealed_(false),
+      discarded_(false),
+      live_bytes_(0) {
+}
+
+SlabContainer::~SlabContainer() {
+  if (discarded_) {
+    readers_.clear();
+    writer_.close();
+    std::remove(path_.c_str());
+  }
+}
+
+std::unique_ptr<std::ifstream> SlabContainer::borrowReader() {
+  {
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    if (!readers_.empty()) {
+      std::unique_ptr<std::ifstream> reader = std::move(readers_.back());
+      readers_.pop_back();
+      return reader;
+    }
+  }
+  std::unique_ptr<std::ifstream> reader(new std::ifstream(path_, std::ios::in | std::ios::binary));
+  if (!reader->is_open()) {
+    return nullptr;
+  }
+  return reader;
+}
+
+void SlabContainer::returnReader(std::unique_ptr<std::ifstream> reader) {
+  std::lock_guard<std::mutex> lock(readers_mutex_);
+  if (readers_.size() < MAX_IDLE_READERS) {
+    readers_.push_back(std::move(reader));
+  }
+}
+
+SlabStream::SlabStream(SlabContentRepository *repository, std::string path, uint64_t expected_sequence)
+    : repository_(repository),
+      path_(std::move(path)),
+      record_offset_(0),
+      data_offset_(0),
+      sequence_(0),
+      expected_sequence_(expected_sequence),
+      size_(0),
+      offset_(0),
+      write_enable_(true),
+      closed_(false),
+      failed_(false) {
+}
+
+SlabStream::SlabStream(std::shared_ptr<SlabContainer> container, uint64_t data_offset, uint64_t length)
+    : repository_(nullptr),
+      container_(std::move(container)),
+      record_offset_(0),
+      data_offset_(data_offset),
+      sequence_(0),
+      expected_sequence_(0),
+      size_(length),
+      offset_(0),
+      write_enable_(false),
+      closed_(false),
+      failed_(false) {
+  reader_ = container_->borrowReader();
+  failed_ = reader_ == nullptr;
+  seek(0);
+}
+
+void SlabStream::closeStream() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  if (!write_enable_) {
+    if (reader_ != nullptr) {
+      container_->returnReader(std::move(reader_));
+    }
+    container_ = nullptr;
+    return;
+  }
+  if (failed_) {
+    if (container_ != nullptr) {
+      // the incomplete record stays in the container, nothing may follow it
+      repository_->releaseContainer(container_, true);
+      container_ = nullptr;
+    }
+    return;
+  }
+  if (container_ == nullptr) {
+    container_ = repository_->leaseContainer();
+    if (container_ == nullptr) {
+      return;
+    }
+    sequence_ = repository_->nextSequence();
+    record_offset_ = container_->size_;
+    const std::string header = encodeDataHeader(sequence_, path_, size_);
+    data_offset_ = record_offset_ + header.size();
+    container_->writer_.write(header.data(), header.size());
+    if (!buffer_.empty()) {
+      container_->writer_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+    }
+  } else {
+    std::string length;
+    appendUint64(length, size_);
+    container_->writer_.seekp(data_offset_ - length.size());
+    container_->writer_.write(length.data(), length.size());
+    container_->writer_.seekp(data_offset_ + size_);
+  }
+  // readers have their own handles, the record has to reach the file before it is committed
+  if (container_->writer_.flush()) {
+    container_->size_ = data_offset_ + size_;
+    repository_->commitRecord(path_, SlabContentRepository::Location{container_, sequence_, record_offset_, data_offset_, size_}, expected_sequence_);
+  }
+  repository_->releaseContainer(container_);
+  container_ = nullptr;
+  buffer_.clear();
+}
+
+bool SlabStream::spill() {
+  container_ = repository_->leaseContainer();
+  if (container_ == nullptr) {
+    return false;
+  }
+  sequence_ = repository_->nextSequence();
+  record_offset_ = container_->size_;
+  const std::string header = encodeDataHeader(sequence_, path_, UNKNOWN_LENGTH);
+  data_offset_ = record_offset_ + header.size();
+  container_->writer_.write(header.data(), header.size());
+  if (!buffer_.empty()) {
+    container_->writer_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+  }
+  std::vector<uint8_t>().swap(buffer_);
+  return container_->writer_.good();
+}
+
+void SlabStream::seek(uint64_t offset) {
+  // written content is only ever appended
+  if (write_enable_ || reader_ == nullptr) {
+    return;
+  }
+  offset_ = (std::min)(offset, size_);
+  reader_->clear();
+  reader_->seekg(data_offset_ + offset_);
+}
+
+int SlabStream::writeData(std::vector<uint8_t> &buf, int buflen) {
+  if (buflen < 0) {
+    throw minifi::Exception{ExceptionType::GENERAL_EXCEPTION, "negative buflen"};
+  }
+
+  if (buf.size() < static_cast<size_t>(buflen)) {
+    return -1;
+  }
+  return writeData(buf.data(), buflen);
+}
+
+int SlabStream::writeData(uint8_t *value, int size) {
+  if (!write_enable_ || closed_ || failed_ || (value == nullptr && size > 0) || size < 0) {
+    return -1;
+  }
+  if (container_ == nullptr && buffer_.size() + size <= SLAB_CONTENT_REPOSITORY_STREAM_BUFFER_SIZE) {
+    buffer_.insert(buffer_.end(), value, value + size);
+    size_ += size;
+    return size;
+  }
+  if ((container_ == nullptr && !spill()) || !container_->writer_.write(reinterpret_cast<const char*>(value), size)) {
+    failed_ = true;
+    return -1;
+  }
+  size_ += size;
+  return size;
+}
+
+int SlabStream::readData(std::vector<uint8_t> &buf, int buflen) {
+  if (buflen < 0) {
+    throw minifi::Exception{ExceptionType::GENERAL_EXCEPTION, "negative buflen"};
+  }
+
+  if (buf.size() < static_cast<size_t>(buflen)) {
+    buf.resize(buflen);
+  }
+  int ret = readData(buf.data(), buflen);
+
+  if (ret < buflen) {
+    buf.resize((std::max)(ret, 0));
+  }
+  return ret;
+}
+
+int SlabStream::readData(uint8_t *buf, int buflen) {
+  if (write_enable_ || failed_ || reader_ == nullptr || (buf == nullptr && buflen > 0) || buflen < 0) {
+    return -1;
+  }
+  const int amount = static_cast<int>((std::min)(static_cast<uint64_t>(buflen), size_ - offset_));
+  if (amount == 0) {
+    return 0;
+  }
+  if (!reader_->read(reinterpret_cast<char*>(buf), amount)) {
+    failed_ = true;
+    return -1;
+  }
+  offset_ += amount;
+  return amount;
+}
+
+int SlabStream::read(uint16_t &value, bool is_little_endian) {
+  uint8_t buf[2];
+  if (readData(&buf[0], 2) != 2)
+    return -1;
+  if (is_little_endian) {
+    value = (buf[0] << 8) | buf[1];
+  } else {
+    value = buf[0] | buf[1] << 8;
+  }
+  return 2;
+}
+
+int SlabStream::read(uint32_t &value, bool is_little_endian) {
+  uint8_t buf[4];
+  if (readData(&buf[0], 4) != 4)
+    return -1;
+  if (is_little_endian) {
+    value = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+  } else {
+    value = buf[0] | buf[1] << 8 | buf[2] << 16 | buf[3] << 24;
+  }
+  return 4;
+}
+
+int SlabStream::read(uint64_t &value, bool is_little_endian) {
+  uint8_t buf[8];
+  if (readData(&buf[0], 8) != 8)
+    return -1;
+  if (is_little_endian) {
+    value = ((uint64_t) buf[0] << 56) | ((uint64_t) (buf[1] & 255) << 48) | ((uint64_t) (buf[2] & 255) << 40) | ((uint64_t) (buf[3] & 255) << 32) | ((uint64_t) (buf[4] & 255) << 24)
+        | ((uint64_t) (buf[5] & 255) << 16) | ((uint64_t) (buf[6] & 255) << 8) | ((uint64_t) (buf[7] & 255) << 0);
+  } else {
+    value = ((uint64_t) buf[0] << 0) | ((uint64_t) (buf[1] & 255) << 8) | ((uint64_t) (buf[2] & 255) << 16) | ((uint64_t) (buf[3] & 255) << 24) | ((uint64_t) (buf[4] & 255) << 32)
+        | ((uint64_t) (buf[5] & 255) << 40) | ((uint64_t) (buf[6] & 255) << 48) | ((uint64_t) (buf[7] & 255) << 56);
+  }
+  return 8;
+}
+
+bool SlabContentRepository::initialize(const std::shared_ptr<minifi::Configure> &configuration) {
+  std::string value;
+  if (configuration->get(Configure::nifi_slab_content_repository_directory_default, value)) {
+    directory_ = value;
+  } else {
+    directory_ = configuration->getHome() + "/slabcontentrepository";
+  }
+  if (configuration->get(Configure::nifi_slab_content_repository_container_size, value)) {
+    uint64_t container_size;
+    if (core::Property::StringToInt(value, container_size) && container_size > 0) {
+      container_size_ = container_size;
+    }
+  }
+  if (configuration->get(Configure::nifi_slab_content_repository_compaction_threshold, value)) {
+    uint64_t compaction_threshold;
+    if (core::Property::StringToInt(value, compaction_threshold)) {
+      compaction_threshold_ = (std::min)(compaction_threshold, static_cast<uint64_t>(100));
+    }
+  }
+  if (configuration->get(Configure::nifi_slab_content_repository_compaction_period, value)) {
+    int64_t compaction_period;
+    TimeUnit unit;
+    if (core::Property::StringToTime(value, compaction_period, unit) && core::Property::ConvertTimeUnitToMS(compaction_period, unit, compaction_period) && compaction_period > 0) {
+      compaction_period_ = compaction_period;
+    }
+  }
+  logger_->log_debug("Slab content repository containers of %llu bytes in %s", container_size_, directory_);
+  utils::file::FileUtils::create_dir(directory_);
+  if (!recover()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  if (!running_) {
+    running_ = true;
+    compaction_thread_ = std::thread(&SlabContentRepository::run, this);
+  }
+  return true;
+}
+
+void SlabContentRepository::stop() {
+  {
+    std::lock_guard<std::mutex> lock(run_mutex_);
+    running_ = false;
+  }
+  run_condition_.notify_all();
+  if (compaction_thread_.joinable()) {
+    compaction_thread_.join();
+  }
+  flushTombstones();
+}
+
+bool SlabContentRepository::exists(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
+  if (isComposite(streamId)) {
+    return compositeExists(streamId);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return index_.find(streamId->getContentFullPath()) != index_.end();
+}
+
+std::shared_ptr<io::BaseStream> SlabContentRepository::write(const std::shared_ptr<minifi::ResourceClaim> &claim, bool append) {
+  if (nullptr == claim) {
+    return nullptr;
+  }
+  auto stream = std::make_shared<SlabStream>(this, claim->getContentFullPath());
+  if (append) {
+    // records are immutable, the appended content goes into a new record after a copy of the current one
+    auto current = read(claim);
+    if (current != nullptr) {
+      std::vector<uint8_t> buffer(SLAB_CONTENT_REPOSITORY_STREAM_BUFFER_SIZE);
+      int read_size;
+      while ((read_size = current->readData(buffer.data(), static_cast<int>(buffer.size()))) > 0) {
+        if (stream->writeData(buffer.data(), read_size) != read_size) {
+          // the partial copy must not replace the claim
+          stream->failed_ = true;
+          return nullptr;
+        }
+      }
+    }
+  }
+  return stream;
+}
+
+std::shared_ptr<io::BaseStream> SlabContentRepository::read(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (nullptr == claim) {
+    return nullptr;
+  }
+  if (isComposite(claim)) {
+    return readComposite(claim);
+  }
+  Location location;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(claim->getContentFullPath());
+    if (found == index_.end()) {
+      logger_->log_debug("%s does not exist", claim->getContentFullPath());
+      return nullptr;
+    }
+    location = found->second;
+  }
+  return std::make_shared<SlabStream>(location.container, location.data_offset, location.length);
+}
+
+std::shared_ptr<io::ContentBuffer> SlabContentRepository::map(const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset, uint64_t length) {
+  if (nullptr == claim) {
+    return nullptr;
+  }
+  if (isComposite(claim)) {
+    return ContentRepository::map(claim, offset, length);
+  }
+  Location location;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(claim->getContentFullPath());
+    if (found == index_.end()) {
+      logger_->log_debug("%s does not exist", claim->getContentFullPath());
+      return nullptr;
+    }
+    location = found->second;
+  }
+  // records are not modified once committed, and the container keeps its file while it is held here
+  offset = (std::min)(offset, location.length);
+  std::shared_ptr<io::ContentBuffer> buffer = io::ContentBuffer::map(location.container->getPath(), location.data_offset + offset, (std::min)(length, location.length - offset));
+  if (buffer != nullptr) {
+    return buffer;
+  }
+  return ContentRepository::map(claim, offset, length);
+}
+
+bool SlabContentRepository::remove(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (nullptr == claim) {
+    return false;
+  }
+  if (isComposite(claim)) {
+    return removeComposite(claim);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(claim->getContentFullPath());
+  if (found == index_.end()) {
+    return false;
+  }
+  discardRecord(found->second);
+  index_.erase(found);
+  return true;
+}
+
+size_t SlabContentRepository::compact() {
+  std::lock_guard<std::mutex> compaction_lock(compaction_mutex_);
+  std::vector<std::shared_ptr<SlabContainer>> candidates;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &entry : containers_) {
+      const auto &container = entry.second;
+      if (!container->sealed_ || container->leased_) {
+        continue;
+      }
+      // small ones are left behind by restarts, they are merged into the written containers
+      if (container->live_bytes_ * 100 < container->size_ * compaction_threshold_ || container->size_ < container_size_ / 4) {
+        candidates.push_back(container);
+      }
+    }
+  }
+  flushTombstones();
+  for (const auto &container : candidates) {
+    compact(container);
+  }
+  return candidates.size();
+}
+
+std::shared_ptr<SlabContainer> SlabContentRepository::leaseContainer() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!writable_.empty()) {
+    auto container = writable_.back();
+    writable_.pop_back();
+    container->leased_ = true;
+    return container;
+  }
+  const uint64_t id = next_container_id_++;
+  auto container = std::make_shared<SlabContainer>(id, directory_ + utils::file::FileUtils::get_separator() + std::to_string(id) + CONTAINER_EXTENSION, 0);
+  container->writer_.open(container->getPath(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!container->writer_.is_open()) {
+    logger_->log_error("Could not create content container %s", container->getPath());
+    return nullptr;
+  }
+  container->leased_ = true;
+  containers_[id] = container;
+  return container;
+}
+
+void SlabContentRepository::releaseContainer(const std::shared_ptr<SlabContainer> &container, bool seal) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  container->leased_ = false;
+  if (seal || !container->writer_.good() || container->size_ >= container_size_) {
+    container->sealed_ = true;
+    container->writer_.close();
+  } else {
+    writable_.push_back(container);
+  }
+}
+
+void SlabContentRepository::commitRecord(const std::string &path, const Location &location, uint64_t expected_sequence) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    location.container->live_bytes_ += location.data_offset - location.record_offset + location.length;
+    auto current = index_.find(path);
+    if (expected_sequence != 0 && (current == index_.end() || current->second.sequence != expected_sequence)) {
+      // removed or rewritten while it was being copied
+      discardRecord(location);
+    } else if (current != index_.end()) {
+      discardRecord(current->second);
+      current->second = location;
+    } else {
+      index_.emplace(path, location);
+    }
+  }
+  writeTombstones(location.container);
+}
+
+void SlabContentRepository::discardRecord(const Location &location) {
+  location.container->live_bytes_ -= location.data_offset - location.record_offset + location.length;
+  location.container->dead_sequences_.push_back(location.sequence);
+  dead_records_[location.sequence] = location.container->getId();
+  pending_tombstones_.push_back(location.sequence);
+}
+
+void SlabContentRepository::writeTombstones(const std::shared_ptr<SlabContainer> &container) {
+  std::vector<uint64_t> tombstones;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tombstones.swap(pending_tombstones_);
+  }
+  if (tombstones.empty()) {
+    return;
+  }
+  std::string records;
+  records.reserve(tombstones.size() * TOMBSTONE_SIZE);
+  for (const auto sequence : tombstones) {
+    records.push_back(TOMBSTONE_RECORD);
+    appendUint64(records, sequence);
+  }
+  if (container->writer_.write(records.data(), records.size()) && container->writer_.flush()) {
+    container->size_ += records.size();
+  } else {
+    // the container is sealed when it is released, the tombstones go into the next one
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_tombstones_.insert(pending_tombstones_.end(), tombstones.begin(), tombstones.end());
+  }
+}
+
+void SlabContentRepository::flushTombstones() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_tombstones_.empty()) {
+      return;
+    }
+  }
+  auto container = leaseContainer();
+  if (container != nullptr) {
+    writeTombstones(container);
+    releaseContainer(container);
+  }
+}
+
+bool SlabContentRepository::recover() {
+  std::vector<std::pair<uint64_t, std::string>> files;
+  utils::file::FileUtils::list_dir(directory_, [&files](const std::string &dir, const std::string &filename) {
+    const size_t extension_length = sizeof(CONTAINER_EXTENSION) - 1;
+    if (filename.size() > extension_length && filename.compare(filename.size() - extension_length, extension_length, CONTAINER_EXTENSION) == 0) {
+      try {
+        files.emplace_back(std::stoull(filename.substr(0, filename.size() - extension_length)), dir + utils::file::FileUtils::get_separator() + filename);
+      } catch (const std::exception &) {
+      }
+    }
+    return true;
+  }, logger_, false);
+  std::sort(files.begin(), files.end());
+
+  std::vector<std::pair<std::string, Location>> records;
+  std::unordered_set<uint64_t> tombstones;
+  uint64_t max_sequence = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &file : files) {
+    std::ifstream in(file.second, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+      logger_->log_error("Could not open content container %s", file.second);
+      return false;
+    }
+    in.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+    auto container = std::make_shared<SlabContainer>(file.first, file.second, 0);
+    uint64_t offset = 0;
+    Record record;
+    while (offset < file_size && readRecord(in, offset, file_size, record)) {
+      max_sequence = (std::max)(max_sequence, record.sequence);
+      if (record.type == DATA_RECORD) {
+        records.emplace_back(record.path, Location{container, record.sequence, offset, record.data_offset, record.length});
+        skipContent(in, record);
+      } else {
+        tombstones.insert(record.sequence);
+      }
+      offset = record.end;
+    }
+    if (offset < file_size) {
+      logger_->log_warn("Ignoring the incomplete record at %llu of content container %s", offset, file.second);
+    }
+    // recovered containers are not written, they are merged into new ones by the compaction
+    container->size_ = offset;
+    container->sealed_ = true;
+    containers_[file.first] = container;
+    next_container_id_ = (std::max)(next_container_id_, file.first + 1);
+  }
+
+  for (const auto &entry : records) {
+    const Location &location = entry.second;
+    if (tombstones.find(location.sequence) != tombstones.end()) {
+      location.container->dead_sequences_.push_back(location.sequence);
+      dead_records_[location.sequence] = location.container->getId();
+      continue;
+    }
+    location.container->live_bytes_ += location.data_offset - location.record_offset + location.length;
+    auto current = index_.find(entry.first);
+    if (current == index_.end()) {
+      index_.emplace(entry.first, location);
+    } else if (current->second.sequence < location.sequence) {
+      // the agent stopped before the tombstone of the replaced record was written
+      discardRecord(current->second);
+      current->second = location;
+    } else {
+      discardRecord(location);
+    }
+  }
+  next_sequence_ = max_sequence + 1;
+  logger_->log_info("Recovered %llu content claims from %llu containers", index_.size(), containers_.size());
+  return true;
+}
+
+void SlabContentRepository::compact(const std::shared_ptr<SlabContainer> &container) {
+  std::ifstream in(container->getPath(), std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    logger_->log_error("Could not open content container %s for compaction", container->getPath());
+    return;
+  }
+  std::vector<uint8_t> buffer;
+  std::vector<uint64_t> tombstones;
+  uint64_t offset = 0;
+  Record record;
+  while (offset < container->size_ && readRecord(in, offset, container->size_, record)) {
+    if (record.type == DATA_RECORD) {
+      bool live;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto current = index_.find(record.path);
+        live = current != index_.end() && current->second.sequence == record.sequence;
+      }
+      if (live) {
+        SlabStream copy(this, record.path, record.sequence);
+        buffer.resize((std::min)(record.length, static_cast<uint64_t>(SLAB_CONTENT_REPOSITORY_STREAM_BUFFER_SIZE)));
+        for (uint64_t remaining = record.length; remaining > 0 && !copy.failed_;) {
+          const int amount = static_cast<int>((std::min)(remaining, static_cast<uint64_t>(buffer.size())));
+          if (!in.read(reinterpret_cast<char*>(buffer.data()), amount) || copy.writeData(buffer.data(), amount) != amount) {
+            copy.failed_ = true;
+          }
+          remaining -= amount;
+        }
+        if (copy.failed_) {
+          copy.closeStream();
+          logger_->log_warn("Could not copy %s out of content container %s, compaction postponed", record.path, container->getPath());
+          return;
+        }
+        copy.closeStream();
+      } else {
+        skipContent(in, record);
+      }
+    } else {
+      // tombstones stay relevant as long as the record they remove is on disk
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto dead = dead_records_.find(record.sequence);
+      if (dead != dead_records_.end() && dead->second != container->getId()) {
+        tombstones.push_back(record.sequence);
+      }
+    }
+    offset = record.end;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_tombstones_.insert(pending_tombstones_.end(), tombstones.begin(), tombstones.end());
+  }
+  flushTombstones();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto sequence : container->dead_sequences_) {
+    dead_records_.erase(sequence);
+  }
+  containers_.erase(container->getId());
+  // the file is removed once the streams still reading it are closed
+  container->discarded_ = true;
+  logger_->log_debug("Compacted content container %s", container->getPath());
+}
+
+void SlabContentRepository::run() {
+  std::unique_lock<std::mutex> lock(run_mutex_);
+  while (running_) {
+    run_condition_.wait_for(lock, std::chrono::milliseconds(compaction_period_), [this] {
+      return !running_;
+    });
+    if (!running_) {
+      break;
+    }
+    lock.unlock();
+    compact();
+    lock.lock();
+  }
+}
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -131,6 +131,9 @@ std::shared_ptr<io::BaseStream> VolatileContentRepository::write(const std::shar
 }
 
 bool VolatileContentRepository::exists(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (isComposite(claim)) {
+    return compositeExists(claim);
+  }
   std::lock_guard<std::mutex> lock(map_mutex_);
   auto claim_check = master_list_.find(claim->getContentFullPath());
   if (claim_check != master_list_.end()) {
@@ -145,6 +148,9 @@ bool VolatileContentRepository::exists(const std::shared_ptr<minifi::ResourceCla
 }
 
 std::shared_ptr<io::BaseStream> VolatileContentRepository::read(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (isComposite(claim)) {
+    return readComposite(claim);
+  }
   std::lock_guard<std::mutex> lock(map_mutex_);
   auto claim_check = master_list_.find(claim->getContentFullPath());
   if (claim_check != master_list_.end()) {
@@ -159,6 +165,9 @@ std::shared_ptr<io::BaseStream> VolatileContentRepository::read(const std::share
 }
 
 bool VolatileContentRepository::remove(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (isComposite(claim)) {
+    return removeComposite(claim);
+  }
   if (LIKELY(minimize_locking_ == true)) {
     std::lock_guard<std::mutex> lock(map_mutex_);
     auto ent = master_list_.find(claim->getContentFullPath());
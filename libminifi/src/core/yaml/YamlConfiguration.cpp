@@ -23,6 +23,7 @@
 
 #include "core/yaml/YamlConfiguration.h"
 #include "core/state/Value.h"
+#include "core/FlowFilePrioritizer.h"
 #ifdef YAML_CONFIGURATION_USE_REGEX
 #include <regex>
 #endif  // YAML_CONFIGURATION_USE_REGEX
@@ -357,6 +358,34 @@ void YamlConfiguration::parseRemoteProcessGroupYaml(YAML::Node *rpgNode, core::P
           }
         }
 
+        if (currRpgNode["use compression"]) {
+          std::string use_compression = currRpgNode["use compression"].as<std::string>();
+          logger_->log_debug("parseRemoteProcessGroupYaml: use compression => [%s]", use_compression);
+          bool use_compression_value;
+          if (utils::StringUtils::StringToBool(use_compression, use_compression_value)) {
+            group->setUseCompression(use_compression_value);
+          }
+        }
+
+        if (currRpgNode["peer refresh interval"]) {
+          std::string peer_refresh_interval = currRpgNode["peer refresh interval"].as<std::string>();
+          logger_->log_debug("parseRemoteProcessGroupYaml: peer refresh interval => [%s]", peer_refresh_interval);
+          int64_t peer_refresh_interval_value;
+          if (core::Property::StringToTime(peer_refresh_interval, peer_refresh_interval_value, unit)
+              && core::Property::ConvertTimeUnitToMS(peer_refresh_interval_value, unit, peer_refresh_interval_value)) {
+            group->setPeerRefreshInterval(peer_refresh_interval_value);
+          }
+        }
+
+        if (currRpgNode["max transactions per peer"]) {
+          std::string max_transactions = currRpgNode["max transactions per peer"].as<std::string>();
+          logger_->log_debug("parseRemoteProcessGroupYaml: max transactions per peer => [%s]", max_transactions);
+          int32_t max_transactions_value;
+          if (core::Property::StringToInt(max_transactions, max_transactions_value) && max_transactions_value >= 0) {
+            group->setMaxTransactionsPerPeer(max_transactions_value);
+          }
+        }
+
         group->setTransmitting(true);
         group->setURL(url);
 
@@ -682,6 +711,17 @@ void YamlConfiguration::parseConnectionYaml(YAML::Node *connectionsNode, core::P
           }
         }
 
+        if (connectionNode["queue prioritizer class"]) {
+          std::string prioritizerClass = connectionNode["queue prioritizer class"].as<std::string>();
+          auto prioritizer = core::createFlowFilePrioritizer(prioritizerClass);
+          if (prioritizer) {
+            logger_->log_debug("parseConnection: queue prioritizer class => [%s]", prioritizerClass);
+            connection->setPrioritizer(prioritizer);
+          } else {
+            logger_->log_warn("Unknown queue prioritizer class %s for connection %s, falling back to first in first out", prioritizerClass, name);
+          }
+        }
+
         if (connectionNode["drop empty"]) {
           std::string strvalue = connectionNode["drop empty"].as<std::string>();
           bool dropEmpty = false;
@@ -740,6 +780,9 @@ void YamlConfiguration::parsePortYaml(YAML::Node *portNode, core::ProcessGroup *
       port->setHTTPProxy(parent->getHTTPProxy());
   }
   // else defaults to RAW
+  port->setUseCompression(parent->getUseCompression());
+  port->setPeerRefreshInterval(parent->getPeerRefreshInterval());
+  port->setMaxTransactionsPerPeer(parent->getMaxTransactionsPerPeer());
 
   // handle port properties
   YAML::Node nodeVal = portNode->as<YAML::Node>();
@@ -21,12 +21,15 @@
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <ifaddrs.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #else
 #include <WS2tcpip.h>
 #pragma comment(lib, "Ws2_32.lib")
 #endif /* !WIN32 */
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -37,6 +40,7 @@
 #include <cinttypes>
 #include <Exception.h>
 #include <utils/Deleters.h>
+#include "io/EventReactor.h"
 #include "io/validation.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "utils/GeneralUtils.h"
@@ -45,6 +49,41 @@ namespace util = org::apache::nifi::minifi::utils;
 namespace mio = org::apache::nifi::minifi::io;
 
 namespace {
+
+// moves index and offset past amount bytes of the buffers, and past the empty buffers after them
+void advance(const mio::IoVec *buffers, size_t count, size_t &index, uint64_t &offset, uint64_t amount) {
+  offset += amount;
+  while (index < count && offset >= buffers[index].length) {
+    offset -= buffers[index].length;
+    index++;
+  }
+}
+
+uint64_t total_length(const mio::IoVec *buffers, size_t count) {
+  uint64_t length = 0;
+  for (size_t i = 0; i < count; i++) {
+    length += buffers[i].length;
+  }
+  return length;
+}
+
+#ifndef WIN32
+// at most this many buffers are passed to a single readv or writev call
+#define SOCKET_MAX_IOV 64
+
+// fills iov with the buffers from offset of buffers[index] on, returns the number of entries filled
+int fill_iov(struct iovec *iov, const mio::IoVec *buffers, size_t count, size_t index, uint64_t offset) {
+  int filled = 0;
+  for (; index < count && filled < SOCKET_MAX_IOV; index++, offset = 0) {
+    if (buffers[index].length > offset) {
+      iov[filled].iov_base = buffers[index].data + offset;
+      iov[filled].iov_len = buffers[index].length - offset;
+      filled++;
+    }
+  }
+  return filled;
+}
+#endif /* !WIN32 */
 std::string get_last_getaddrinfo_err_str(int getaddrinfo_result) {
 #ifdef WIN32
   (void)getaddrinfo_result;  // against unused warnings on windows
@@ -451,6 +490,39 @@ int16_t Socket::select_descriptor(const uint16_t msec) {
   return -1;
 }
 
+std::vector<SocketDescriptor> Socket::accept_connections(bool &drained) {
+  std::vector<SocketDescriptor> accepted;
+  drained = true;
+  while (true) {
+    const auto fd = accept(socket_file_descriptor_, nullptr, nullptr);
+    if (valid_socket(fd)) {
+      accepted.push_back(fd);
+      continue;
+    }
+#ifdef WIN32
+    const int error = WSAGetLastError();
+    if (error == WSAEWOULDBLOCK) {
+      break;
+    }
+    if (error == WSAECONNRESET) {
+      continue;
+    }
+#else
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      break;
+    }
+    if (errno == EINTR || errno == ECONNABORTED) {
+      continue;
+    }
+#endif /* WIN32 */
+    // e.g. out of descriptors, the pending connections are not notified again
+    logger_->log_error("accept: %s", get_last_socket_error_message());
+    drained = false;
+    break;
+  }
+  return accepted;
+}
+
 int16_t Socket::setSocketOptions(const SocketDescriptor sock) {
   int opt = 1;
 #ifndef WIN32
@@ -504,23 +576,42 @@ int Socket::writeData(std::vector<uint8_t> &buf, int buflen) {
 // data stream overrides
 
 int Socket::writeData(uint8_t *value, int size) {
-  int ret = 0, bytes = 0;
+  if (size < 0) {
+    return -1;
+  }
+  IoVec buffer{value, static_cast<uint64_t>(size)};
+  return static_cast<int>(writev(&buffer, 1));
+}
+
+int64_t Socket::writev(const IoVec *buffers, size_t count) {
+  const uint64_t size = total_length(buffers, count);
+  uint64_t bytes = 0;
+  size_t index = 0;
+  uint64_t offset = 0;
+  advance(buffers, count, index, offset, 0);
 
   int fd = select_descriptor(1000);
   if (fd < 0) { return -1; }
   while (bytes < size) {
-    ret = send(fd, reinterpret_cast<const char*>(value) + bytes, size - bytes, 0);
+#ifndef WIN32
+    struct iovec iov[SOCKET_MAX_IOV];
+    const int64_t ret = ::writev(fd, iov, fill_iov(iov, buffers, count, index, offset));
+#else
+    const int amount = static_cast<int>((std::min)(buffers[index].length - offset, static_cast<uint64_t>((std::numeric_limits<int>::max)())));
+    const int64_t ret = send(fd, reinterpret_cast<const char*>(buffers[index].data) + offset, amount, 0);
+#endif /* !WIN32 */
     // check for errors
     if (ret <= 0) {
       close(fd);
       logger_->log_error("Could not send to %d, error: %s", fd, get_last_socket_error_message());
-      return ret;
+      return -1;
     }
+    advance(buffers, count, index, offset, ret);
     bytes += ret;
   }
 
-  if (ret)
-    logger_->log_trace("Send data size %d over socket %d", size, fd);
+  if (bytes)
+    logger_->log_trace("Send data size %" PRIu64 " over socket %d", bytes, fd);
   total_written_ += bytes;
   return bytes;
 }
@@ -592,18 +683,36 @@ int Socket::readData(std::vector<uint8_t> &buf, int buflen, bool retrieve_all_by
 }
 
 int Socket::readData(uint8_t *buf, int buflen, bool retrieve_all_bytes) {
-  int32_t total_read = 0;
-  while (buflen) {
+  if (buflen < 0) {
+    throw minifi::Exception{ExceptionType::GENERAL_EXCEPTION, "negative buflen"};
+  }
+  IoVec buffer{buf, static_cast<uint64_t>(buflen)};
+  return static_cast<int>(readv(&buffer, 1, retrieve_all_bytes));
+}
+
+int64_t Socket::readv(const IoVec *buffers, size_t count, bool retrieve_all_bytes) {
+  const uint64_t size = total_length(buffers, count);
+  uint64_t total_read = 0;
+  size_t index = 0;
+  uint64_t offset = 0;
+  advance(buffers, count, index, offset, 0);
+  while (total_read < size) {
     int16_t fd = select_descriptor(1000);
     if (fd < 0) {
       if (listeners_ <= 0) {
-        logger_->log_debug("fd %d close %i", fd, buflen);
+        logger_->log_debug("fd %d close %" PRIu64, fd, size - total_read);
         close(socket_file_descriptor_);
       }
       return -1;
     }
-    int bytes_read = recv(fd, reinterpret_cast<char*>(buf), buflen, 0);
-    logger_->log_trace("Recv call %d", bytes_read);
+#ifndef WIN32
+    struct iovec iov[SOCKET_MAX_IOV];
+    const int64_t bytes_read = ::readv(fd, iov, fill_iov(iov, buffers, count, index, offset));
+#else
+    const int amount = static_cast<int>((std::min)(buffers[index].length - offset, static_cast<uint64_t>((std::numeric_limits<int>::max)())));
+    const int64_t bytes_read = recv(fd, reinterpret_cast<char*>(buffers[index].data) + offset, amount, 0);
+#endif /* !WIN32 */
+    logger_->log_trace("Recv call %" PRId64, bytes_read);
     if (bytes_read <= 0) {
       if (bytes_read == 0) {
         logger_->log_debug("Other side hung up on %d", fd);
@@ -616,8 +725,7 @@ int Socket::readData(uint8_t *buf, int buflen, bool retrieve_all_bytes) {
       }
       return -1;
     }
-    buflen -= bytes_read;
-    buf += bytes_read;
+    advance(buffers, count, index, offset, bytes_read);
     total_read += bytes_read;
     if (!retrieve_all_bytes) {
       break;
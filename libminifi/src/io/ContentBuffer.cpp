@@ -0,0 +1,99 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io/ContentBuffer.h"
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* !WIN32 */
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+ContentBuffer::ContentBuffer(std::vector<uint8_t> data)
+    : owned_(std::move(data)),
+      mapping_(nullptr),
+      mapping_size_(0),
+      data_(owned_.data()),
+      size_(owned_.size()) {
+}
+
+ContentBuffer::ContentBuffer(void *mapping, uint64_t mapping_size, const uint8_t *data, uint64_t size)
+    : mapping_(mapping),
+      mapping_size_(mapping_size),
+      data_(data),
+      size_(size) {
+}
+
+ContentBuffer::~ContentBuffer() {
+#ifndef WIN32
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+#endif /* !WIN32 */
+}
+
+std::unique_ptr<ContentBuffer> ContentBuffer::map(const std::string &path, uint64_t offset, uint64_t length) {
+#ifndef WIN32
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return nullptr;
+  }
+  const uint64_t file_size = file_stat.st_size;
+  if (offset >= file_size || length == 0) {
+    // nothing to map, mmap refuses empty ranges
+    close(fd);
+    return std::unique_ptr<ContentBuffer>(new ContentBuffer(std::vector<uint8_t>()));
+  }
+  length = std::min(length, file_size - offset);
+  // mappings start at a page boundary
+  const uint64_t page_offset = offset % static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  const uint64_t mapping_size = length + page_offset;
+  void *mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, offset - page_offset);
+  // the mapping stays valid without the descriptor
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+  madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+  return std::unique_ptr<ContentBuffer>(new ContentBuffer(mapping, mapping_size, static_cast<const uint8_t*>(mapping) + page_offset, length));
+#else
+  return nullptr;
+#endif /* !WIN32 */
+}
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <iterator>
 #include <cassert>
+#include <limits>
 #include <Exception.h>
 
 namespace org {
@@ -33,10 +34,46 @@ namespace io {
 int DataStream::writeData(uint8_t *value, int size) {
   if (value == nullptr)
     return 0;
-  std::copy(value, value + size, std::back_inserter(buffer));
+  buffer.insert(buffer.end(), value, value + size);
   return size;
 }
 
+int64_t DataStream::readv(const IoVec *buffers, size_t count) {
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    for (uint64_t done = 0; done < buffers[i].length;) {
+      // readData is limited to int lengths
+      const int amount = static_cast<int>((std::min)(buffers[i].length - done, static_cast<uint64_t>((std::numeric_limits<int>::max)())));
+      const int ret = readData(buffers[i].data + done, amount);
+      if (ret < 0) {
+        return -1;
+      }
+      done += ret;
+      total += ret;
+      if (ret < amount) {
+        return total;
+      }
+    }
+  }
+  return total;
+}
+
+int64_t DataStream::writev(const IoVec *buffers, size_t count) {
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    for (uint64_t done = 0; done < buffers[i].length;) {
+      // writeData is limited to int lengths
+      const int amount = static_cast<int>((std::min)(buffers[i].length - done, static_cast<uint64_t>((std::numeric_limits<int>::max)())));
+      if (writeData(buffers[i].data + done, amount) != amount) {
+        return -1;
+      }
+      done += amount;
+      total += amount;
+    }
+  }
+  return total;
+}
+
 int DataStream::read(uint64_t &value, bool is_little_endian) {
   if ((8 + readBuffer) > buffer.size()) {
     // if read exceed
@@ -0,0 +1,473 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "io/EventReactor.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#ifndef WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif /* !WIN32 */
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+namespace {
+
+std::mutex instance_mutex;
+std::weak_ptr<EventReactor> instance;
+size_t instance_threads = REACTOR_DEFAULT_THREADS;
+size_t instance_workers = REACTOR_DEFAULT_WORKERS;
+
+#ifdef __linux__
+uint32_t toEpollEvents(uint32_t events) {
+  uint32_t epoll_events = EPOLLET;
+  if (events & EventReactor::READ) {
+    epoll_events |= EPOLLIN | EPOLLRDHUP;
+  }
+  if (events & EventReactor::WRITE) {
+    epoll_events |= EPOLLOUT;
+  }
+  return epoll_events;
+}
+
+uint32_t fromEpollEvents(uint32_t epoll_events) {
+  uint32_t events = 0;
+  if (epoll_events & EPOLLIN) {
+    events |= EventReactor::READ;
+  }
+  if (epoll_events & EPOLLOUT) {
+    events |= EventReactor::WRITE;
+  }
+  if (epoll_events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) {
+    events |= EventReactor::HANGUP;
+  }
+  return events;
+}
+#else
+int16_t toPollEvents(uint32_t events) {
+  int16_t poll_events = 0;
+  if (events & EventReactor::READ) {
+    poll_events |= POLLIN;
+  }
+  if (events & EventReactor::WRITE) {
+    poll_events |= POLLOUT;
+  }
+  return poll_events;
+}
+
+uint32_t fromPollEvents(int16_t poll_events) {
+  uint32_t events = 0;
+  if (poll_events & POLLIN) {
+    events |= EventReactor::READ;
+  }
+  if (poll_events & POLLOUT) {
+    events |= EventReactor::WRITE;
+  }
+  if (poll_events & (POLLHUP | POLLERR | POLLNVAL)) {
+    events |= EventReactor::HANGUP;
+  }
+  return events;
+}
+#endif /* __linux__ */
+
+}  // namespace
+
+EventReactor::EventReactor(size_t threads, size_t workers)
+    : next_id_(1),
+      next_loop_(0),
+      running_(true),
+      working_(true),
+      logger_(logging::LoggerFactory<EventReactor>::getLogger()) {
+  for (size_t i = 0; i < (std::max)(threads, static_cast<size_t>(1)); i++) {
+    std::unique_ptr<Loop> loop(new Loop());
+#ifdef __linux__
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    loop->wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (loop->epoll_fd < 0 || loop->wakeup_fd < 0) {
+      logger_->log_error("Could not create the event loop: %s", std::strerror(errno));
+      if (loop->epoll_fd >= 0) {
+        close(loop->epoll_fd);
+      }
+      if (loop->wakeup_fd >= 0) {
+        close(loop->wakeup_fd);
+      }
+      continue;
+    }
+    // the wakeup descriptor has registration ID 0
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = 0;
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wakeup_fd, &event);
+#endif
+    loops_.push_back(std::move(loop));
+  }
+  for (auto &loop : loops_) {
+    loop->thread = std::thread(&EventReactor::run, this, loop.get());
+  }
+  for (size_t i = 0; i < (std::max)(workers, static_cast<size_t>(1)); i++) {
+    workers_.emplace_back(&EventReactor::work, this);
+  }
+  logger_->log_debug("Started event reactor with %d threads and %d workers", loops_.size(), workers_.size());
+}
+
+EventReactor::~EventReactor() {
+  {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    working_ = false;
+  }
+  tasks_available_.notify_all();
+  // the pending tasks are run before the workers stop, their submitters may be waiting for them
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  running_ = false;
+  for (auto &loop : loops_) {
+#ifdef __linux__
+    uint64_t wakeup = 1;
+    if (write(loop->wakeup_fd, &wakeup, sizeof(wakeup)) < 0) {
+      logger_->log_warn("Could not wake up the event loop: %s", std::strerror(errno));
+    }
+#endif
+    if (loop->thread.joinable()) {
+      loop->thread.join();
+    }
+#ifdef __linux__
+    close(loop->epoll_fd);
+    close(loop->wakeup_fd);
+#endif
+  }
+}
+
+std::shared_ptr<EventReactor> EventReactor::getInstance() {
+  std::lock_guard<std::mutex> lock(instance_mutex);
+  auto reactor = instance.lock();
+  if (nullptr == reactor) {
+    reactor = std::make_shared<EventReactor>(instance_threads, instance_workers);
+    instance = reactor;
+  }
+  return reactor;
+}
+
+void EventReactor::setThreadCount(size_t threads) {
+  std::lock_guard<std::mutex> lock(instance_mutex);
+  instance_threads = threads;
+}
+
+void EventReactor::setWorkerCount(size_t workers) {
+  std::lock_guard<std::mutex> lock(instance_mutex);
+  instance_workers = workers;
+}
+
+bool EventReactor::setNonBlocking(SocketDescriptor fd, bool non_blocking) {
+#ifndef WIN32
+  const int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0) {
+    return false;
+  }
+  return fcntl(fd, F_SETFL, non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) >= 0;
+#else
+  u_long mode = non_blocking ? 1 : 0;
+  return ioctlsocket(fd, FIONBIO, &mode) != SOCKET_ERROR;
+#endif /* !WIN32 */
+}
+
+bool EventReactor::setTimeout(SocketDescriptor fd, uint32_t timeout_ms) {
+#ifndef WIN32
+  struct timeval timeout;
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_usec = (timeout_ms % 1000) * 1000;
+  const char *value = reinterpret_cast<const char*>(&timeout);
+  const socklen_t length = sizeof(timeout);
+#else
+  DWORD timeout = timeout_ms;
+  const char *value = reinterpret_cast<const char*>(&timeout);
+  const int length = sizeof(timeout);
+#endif /* !WIN32 */
+  return setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, value, length) == 0 && setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, value, length) == 0;
+}
+
+bool EventReactor::add(SocketDescriptor fd, uint32_t events, Handler handler) {
+  if (loops_.empty() || !valid_socket(fd)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (sockets_.find(fd) != sockets_.end()) {
+    return false;
+  }
+  Loop *loop = loops_[next_loop_++ % loops_.size()].get();
+  auto registration = std::make_shared<Registration>();
+  registration->fd = fd;
+  registration->id = next_id_++;
+  registration->events = events;
+  registration->handler = std::move(handler);
+  {
+    std::lock_guard<std::mutex> loop_lock(loop->mutex);
+    loop->registrations[registration->id] = registration;
+  }
+#ifdef __linux__
+  epoll_event event{};
+  event.events = toEpollEvents(events);
+  event.data.u64 = registration->id;
+  if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+    logger_->log_error("Could not register socket %d: %s", fd, std::strerror(errno));
+    std::lock_guard<std::mutex> loop_lock(loop->mutex);
+    loop->registrations.erase(registration->id);
+    return false;
+  }
+#endif
+  sockets_[fd] = std::make_pair(loop, registration->id);
+  return true;
+}
+
+bool EventReactor::modify(SocketDescriptor fd, uint32_t events) {
+  return modify(fd, 0, events);
+}
+
+bool EventReactor::modify(SocketDescriptor fd, uint64_t id, uint32_t events) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto socket = sockets_.find(fd);
+  // the descriptor may have been reused by another registration
+  if (socket == sockets_.end() || (id != 0 && socket->second.second != id)) {
+    return false;
+  }
+  Loop *loop = socket->second.first;
+  {
+    std::lock_guard<std::mutex> loop_lock(loop->mutex);
+    loop->registrations[socket->second.second]->events = events;
+  }
+#ifdef __linux__
+  epoll_event event{};
+  event.events = toEpollEvents(events);
+  event.data.u64 = socket->second.second;
+  if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_MOD, fd, &event) < 0) {
+    logger_->log_error("Could not modify the events of socket %d: %s", fd, std::strerror(errno));
+    return false;
+  }
+#endif
+  return true;
+}
+
+void EventReactor::remove(SocketDescriptor fd) {
+  std::pair<Loop*, uint64_t> registration;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto socket = sockets_.find(fd);
+    if (socket == sockets_.end()) {
+      return;
+    }
+    registration = socket->second;
+    sockets_.erase(socket);
+  }
+  Loop *loop = registration.first;
+  const uint64_t id = registration.second;
+#ifdef __linux__
+  epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+  std::unique_lock<std::mutex> loop_lock(loop->mutex);
+  loop->registrations.erase(id);
+  if (std::this_thread::get_id() != loop->thread.get_id()) {
+    loop->dispatched.wait(loop_lock, [loop, id] {
+      return loop->dispatching != id;
+    });
+  }
+}
+
+void EventReactor::pause(SocketDescriptor fd, uint32_t delay_ms) {
+  uint64_t id;
+  uint32_t events;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto socket = sockets_.find(fd);
+    if (socket == sockets_.end()) {
+      return;
+    }
+    id = socket->second.second;
+    Loop *loop = socket->second.first;
+    std::lock_guard<std::mutex> loop_lock(loop->mutex);
+    auto registration = loop->registrations.find(id);
+    if (registration == loop->registrations.end()) {
+      return;
+    }
+    events = registration->second->events;
+  }
+  modify(fd, id, 0);
+  // setting the events again notifies the handler if the socket is ready by then
+  schedule([this, fd, id, events] { modify(fd, id, events); }, std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms));
+}
+
+bool EventReactor::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    if (!working_ || tasks_.size() >= REACTOR_MAX_PENDING_TASKS) {
+      return false;
+    }
+    tasks_.emplace(std::chrono::steady_clock::now(), std::move(task));
+  }
+  tasks_available_.notify_one();
+  return true;
+}
+
+void EventReactor::schedule(std::function<void()> task, std::chrono::steady_clock::time_point when) {
+  {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    if (!working_) {
+      return;
+    }
+    tasks_.emplace(when, std::move(task));
+  }
+  tasks_available_.notify_one();
+}
+
+void EventReactor::work() {
+  std::unique_lock<std::mutex> lock(tasks_mutex_);
+  while (true) {
+    if (tasks_.empty()) {
+      if (!working_) {
+        break;
+      }
+      tasks_available_.wait(lock);
+      continue;
+    }
+    auto next = tasks_.begin();
+    // once stopping, delayed tasks are not waited for
+    if (working_ && next->first > std::chrono::steady_clock::now()) {
+      tasks_available_.wait_until(lock, next->first);
+      continue;
+    }
+    auto task = std::move(next->second);
+    tasks_.erase(next);
+    lock.unlock();
+    try {
+      task();
+    } catch (const std::exception &exception) {
+      logger_->log_error("Reactor task failed: %s", exception.what());
+    } catch (...) {
+      logger_->log_error("Reactor task failed");
+    }
+    lock.lock();
+  }
+}
+
+void EventReactor::dispatch(Loop *loop, uint64_t id, uint32_t events) {
+  std::shared_ptr<Registration> registration;
+  {
+    std::lock_guard<std::mutex> lock(loop->mutex);
+    auto found = loop->registrations.find(id);
+    // the socket may have been removed since the wait returned
+    if (found == loop->registrations.end()) {
+      return;
+    }
+    registration = found->second;
+    loop->dispatching = id;
+  }
+  try {
+    registration->handler(events);
+  } catch (const std::exception &exception) {
+    logger_->log_error("Handler of socket %d failed: %s", registration->fd, exception.what());
+  } catch (...) {
+    logger_->log_error("Handler of socket %d failed", registration->fd);
+  }
+  {
+    std::lock_guard<std::mutex> lock(loop->mutex);
+    loop->dispatching = 0;
+  }
+  loop->dispatched.notify_all();
+}
+
+#ifdef __linux__
+void EventReactor::run(Loop *loop) {
+  epoll_event events[REACTOR_MAX_EVENTS];
+  while (running_) {
+    const int ready = epoll_wait(loop->epoll_fd, events, REACTOR_MAX_EVENTS, -1);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger_->log_error("Waiting for events failed: %s", std::strerror(errno));
+      break;
+    }
+    for (int i = 0; i < ready && running_; i++) {
+      if (events[i].data.u64 != 0) {
+        dispatch(loop, events[i].data.u64, fromEpollEvents(events[i].events));
+      }
+    }
+  }
+}
+#else
+void EventReactor::run(Loop *loop) {
+  std::vector<pollfd> descriptors;
+  std::vector<uint64_t> ids;
+  while (running_) {
+    descriptors.clear();
+    ids.clear();
+    {
+      std::lock_guard<std::mutex> lock(loop->mutex);
+      for (const auto &registration : loop->registrations) {
+        pollfd descriptor{};
+        descriptor.fd = registration.second->fd;
+        descriptor.events = toPollEvents(registration.second->events);
+        descriptors.push_back(descriptor);
+        ids.push_back(registration.first);
+      }
+    }
+    if (descriptors.empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(REACTOR_POLL_PERIOD));
+      continue;
+    }
+#ifdef WIN32
+    const int ready = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), REACTOR_POLL_PERIOD);
+#else
+    const int ready = poll(descriptors.data(), descriptors.size(), REACTOR_POLL_PERIOD);
+#endif /* WIN32 */
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger_->log_error("Waiting for events failed: %s", get_last_socket_error_message());
+      break;
+    }
+    for (size_t i = 0; i < descriptors.size() && running_; i++) {
+      if (descriptors[i].revents != 0) {
+        dispatch(loop, ids[i], fromPollEvents(descriptors[i].revents));
+      }
+    }
+  }
+}
+#endif /* __linux__ */
+
+} /* namespace io */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -40,7 +40,7 @@ FileStream::FileStream(const std::string &path, bool append)
     file_stream_->open(path.c_str(), std::fstream::out | std::fstream::binary);
   file_stream_->seekg(0, file_stream_->end);
   file_stream_->seekp(0, file_stream_->end);
-  int len = file_stream_->tellg();
+  const std::streamoff len = file_stream_->tellg();
   if (len > 0) {
     length_ = len;
   } else {
@@ -49,7 +49,7 @@ FileStream::FileStream(const std::string &path, bool append)
   seek(offset_);
 }
 
-FileStream::FileStream(const std::string &path, uint32_t offset, bool write_enable)
+FileStream::FileStream(const std::string &path, uint64_t offset, bool write_enable)
     : logger_(logging::LoggerFactory<FileStream>::getLogger()),
       path_(path),
       offset_(offset) {
@@ -61,7 +61,7 @@ FileStream::FileStream(const std::string &path, uint32_t offset, bool write_enab
   }
   file_stream_->seekg(0, file_stream_->end);
   file_stream_->seekp(0, file_stream_->end);
-  int len = file_stream_->tellg();
+  const std::streamoff len = file_stream_->tellg();
   if (len > 0) {
     length_ = len;
   } else {
@@ -100,22 +100,32 @@ int FileStream::writeData(std::vector<uint8_t> &buf, int buflen) {
 // data stream overrides
 
 int FileStream::writeData(uint8_t *value, int size) {
-  if (!IsNullOrEmpty(value)) {
-    std::lock_guard<std::recursive_mutex> lock(file_lock_);
-    if (file_stream_->write(reinterpret_cast<const char*>(value), size)) {
-      offset_ += size;
-      if (offset_ > length_) {
-        length_ = offset_;
-      }
-      file_stream_->seekg(offset_);
-      file_stream_->flush();
-      return size;
-    } else {
+  if (IsNullOrEmpty(value) || size < 0) {
+    return -1;
+  }
+  IoVec buffer{value, static_cast<uint64_t>(size)};
+  return static_cast<int>(writev(&buffer, 1));
+}
+
+int64_t FileStream::writev(const IoVec *buffers, size_t count) {
+  std::lock_guard<std::recursive_mutex> lock(file_lock_);
+  if (!file_stream_) {
+    return -1;
+  }
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!file_stream_->write(reinterpret_cast<const char*>(buffers[i].data), buffers[i].length)) {
       return -1;
     }
-  } else {
-    return -1;
+    total += buffers[i].length;
   }
+  offset_ += total;
+  if (offset_ > length_) {
+    length_ = offset_;
+  }
+  file_stream_->seekg(offset_);
+  file_stream_->flush();
+  return total;
 }
 
 template<typename T>
@@ -143,31 +153,40 @@ int FileStream::readData(std::vector<uint8_t> &buf, int buflen) {
 }
 
 int FileStream::readData(uint8_t *buf, int buflen) {
-  if (!IsNullOrEmpty(buf)) {
-    std::lock_guard<std::recursive_mutex> lock(file_lock_);
-    if (!file_stream_) {
-      return -1;
-    }
-    file_stream_->read(reinterpret_cast<char*>(buf), buflen);
-    if ((file_stream_->rdstate() & (file_stream_->eofbit | file_stream_->failbit)) != 0) {
+  if (IsNullOrEmpty(buf) || buflen < 0) {
+    return -1;
+  }
+  IoVec buffer{buf, static_cast<uint64_t>(buflen)};
+  return static_cast<int>(readv(&buffer, 1));
+}
+
+int64_t FileStream::readv(const IoVec *buffers, size_t count) {
+  std::lock_guard<std::recursive_mutex> lock(file_lock_);
+  if (!file_stream_) {
+    return -1;
+  }
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    file_stream_->read(reinterpret_cast<char*>(buffers[i].data), buffers[i].length);
+    const std::streamsize read = file_stream_->gcount();
+    total += read;
+    offset_ += read;
+    if (static_cast<uint64_t>(read) < buffers[i].length) {
+      // eof, the stream has to be cleared for further reads and writes
       file_stream_->clear();
       file_stream_->seekg(0, file_stream_->end);
       file_stream_->seekp(0, file_stream_->end);
-      int len = file_stream_->tellg();
-      size_t ret = len - offset_;
-      offset_ = len;
-      length_ = len;
+      const std::streamoff len = file_stream_->tellg();
+      if (len >= 0) {
+        offset_ = len;
+        length_ = len;
+      }
       logging::LOG_DEBUG(logger_) << path_ << " eof bit, ended at " << offset_;
-      return ret;
-    } else {
-      offset_ += buflen;
-      file_stream_->seekp(offset_);
-      return buflen;
+      return total;
     }
-
-  } else {
-    return -1;
   }
+  file_stream_->seekp(offset_);
+  return total;
 }
 
 } /* namespace io */
@@ -28,6 +28,7 @@
 #pragma comment(lib, "Ws2_32.lib")
 #endif /* !WIN32 */
 #include <memory>
+#include <set>
 #include <utility>
 #include <string>
 #include "io/validation.h"
@@ -41,38 +42,113 @@ namespace io {
 
 ServerSocket::ServerSocket(const std::shared_ptr<SocketContext> &context, const std::string &hostname, const uint16_t port, const uint16_t listeners = -1)
     : Socket(context, hostname, port, listeners),
-      running_(true),
       logger_(logging::LoggerFactory<ServerSocket>::getLogger()) {
 }
 
 ServerSocket::~ServerSocket() {
-  running_ = false;
-  if (server_read_thread_.joinable())
-    server_read_thread_.join();
+  if (nullptr == reactor_)
+    return;
+  reactor_->remove(socket_file_descriptor_);
+  std::set<SocketDescriptor> connections;
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    closing_ = true;
+    connections = connections_;
+  }
+  for (auto fd : connections) {
+    // waits for the read handler if it is handing the connection to a worker
+    reactor_->remove(fd);
+    // wakes up the worker if it is blocked on the connection
+#ifdef WIN32
+    shutdown(fd, SD_BOTH);
+#else
+    shutdown(fd, SHUT_RDWR);
+#endif /* WIN32 */
+  }
+  {
+    std::unique_lock<std::mutex> lock(connections_mutex_);
+    served_.wait(lock, [this] { return serving_ == 0; });
+    connections = connections_;
+  }
+  for (auto fd : connections) {
+    close_fd(fd);
+  }
 }
 
-/**
- * Initializes the socket
- * @return result of the creation operation.
- */
-void ServerSocket::registerCallback(std::function<bool()> accept_function, std::function<void(io::BaseStream *)> handler) {
-  auto fx = [this](std::function<bool()> accept_function, std::function<void(io::BaseStream *stream)> handler) {
-    while (running_) {
-      int fd = select_descriptor(1000);
-      if (fd >= 0) {
-        io::DescriptorStream stream(fd);
-        handler(&stream);
-        close_fd(fd);
-      }
+void ServerSocket::registerCallback(std::function<bool()> /*accept_function*/, std::function<void(io::BaseStream *)> handler) {
+  handler_ = std::move(handler);
+  reactor_ = EventReactor::getInstance();
+  EventReactor::setNonBlocking(socket_file_descriptor_);
+  if (!reactor_->add(socket_file_descriptor_, EventReactor::READ, [this](uint32_t) { on_accept(); })) {
+    logger_->log_error("Could not register server socket %d", socket_file_descriptor_);
+  }
+}
+
+void ServerSocket::on_accept() {
+  bool drained;
+  for (auto fd : accept_connections(drained)) {
+    {
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      connections_.insert(fd);
+    }
+    if (!reactor_->add(fd, EventReactor::READ, [this, fd](uint32_t) { on_read(fd); })) {
+      close_fd(fd);
     }
-  };
-  server_read_thread_ = std::thread(fx, std::move(accept_function), std::move(handler));
+  }
+  if (!drained) {
+    reactor_->pause(socket_file_descriptor_, REACTOR_ACCEPT_RETRY_PERIOD);
+  }
+}
+
+void ServerSocket::on_read(SocketDescriptor fd) {
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    if (closing_)
+      return;
+    serving_++;
+  }
+  // the handler blocks, so it runs on a worker instead of the reactor thread
+  reactor_->remove(fd);
+  if (!reactor_->submit([this, fd] { serve(fd); })) {
+    logger_->log_warn("Too many connections waiting to be served, closing %d", fd);
+    close_fd(fd);
+    finish_serving();
+  }
+}
+
+void ServerSocket::serve(SocketDescriptor fd) {
+  bool closing;
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    closing = closing_;
+  }
+  if (!closing && EventReactor::setNonBlocking(fd, false) && EventReactor::setTimeout(fd)) {
+    io::DescriptorStream stream(fd);
+    handler_(&stream);
+  }
+  close_fd(fd);
+  finish_serving();
+}
+
+void ServerSocket::finish_serving() {
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    serving_--;
+  }
+  served_.notify_all();
 }
 
 void ServerSocket::close_fd(int fd) {
-  std::lock_guard<std::recursive_mutex> guard(selection_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    if (connections_.erase(fd) == 0)
+      return;
+  }
+#ifdef WIN32
+  closesocket(fd);
+#else
   close(fd);
-  FD_CLR(fd, &total_list_);
+#endif /* WIN32 */
 }
 
 } /* namespace io */
@@ -17,6 +17,8 @@
  */
 
 #include "io/ZlibStream.h"
+#include <algorithm>
+#include <limits>
 #include "Exception.h"
 
 namespace org {
@@ -73,13 +75,37 @@ ZlibCompressStream::~ZlibCompressStream() {
 }
 
 int ZlibCompressStream::writeData(uint8_t* value, int size) {
+  if (size < 0) {
+    return -1;
+  }
+  IoVec buffer{value, static_cast<uint64_t>(size)};
+  return static_cast<int>(writev(&buffer, 1));
+}
+
+int64_t ZlibCompressStream::writev(const IoVec *buffers, size_t count) {
   if (state_ != ZlibStreamState::INITIALIZED) {
-    logger_->log_error("writeData called in invalid ZlibCompressStream state, state is %hhu", state_);
+    logger_->log_error("writev called in invalid ZlibCompressStream state, state is %hhu", state_);
     return -1;
   }
 
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    // avail_in is limited to unsigned int
+    for (uint64_t done = 0; done < buffers[i].length;) {
+      const uint64_t amount = (std::min)(buffers[i].length - done, static_cast<uint64_t>((std::numeric_limits<unsigned int>::max)()));
+      if (!compress(buffers[i].data + done, amount, Z_NO_FLUSH)) {
+        return -1;
+      }
+      done += amount;
+    }
+    total += buffers[i].length;
+  }
+  return total;
+}
+
+bool ZlibCompressStream::compress(uint8_t* value, uint64_t size, int flush) {
   strm_.next_in = value;
-  strm_.avail_in = size;
+  strm_.avail_in = static_cast<uInt>(size);
 
   /*
    * deflate consumes all input data it can (i.e. if it has enough output buffer it never leaves input data unconsumed)
@@ -95,30 +121,29 @@ int ZlibCompressStream::writeData(uint8_t* value, int size) {
     strm_.next_out = outputBuffer_.data();
     strm_.avail_out = outputBuffer_.size();
 
-    int flush = value == nullptr ? Z_FINISH : Z_NO_FLUSH;
     logger_->log_trace("calling deflate with flush %d", flush);
 
     int ret = deflate(&strm_, flush);
     if (ret == Z_STREAM_ERROR) {
       logger_->log_error("deflate failed, error code: %d", ret);
       state_ = ZlibStreamState::ERRORED;
-      return -1;
+      return false;
     }
     int output_size = outputBuffer_.size() - strm_.avail_out;
     logger_->log_trace("deflate produced %d B of output data", output_size);
     if (BaseStream::writeData(outputBuffer_.data(), output_size) != output_size) {
       logger_->log_error("Failed to write to underlying stream");
       state_ = ZlibStreamState::ERRORED;
-      return -1;
+      return false;
     }
   } while (strm_.avail_out == 0);
 
-  return size;
+  return true;
 }
 
 void ZlibCompressStream::closeStream() {
   if (state_ == ZlibStreamState::INITIALIZED) {
-    if (writeData(nullptr, 0U) == 0) {
+    if (compress(nullptr, 0U, Z_FINISH)) {
       state_ = ZlibStreamState::FINISHED;
     }
   }
@@ -148,13 +173,40 @@ ZlibDecompressStream::~ZlibDecompressStream() {
 }
 
 int ZlibDecompressStream::writeData(uint8_t* value, int size) {
+  if (size < 0) {
+    return -1;
+  }
+  IoVec buffer{value, static_cast<uint64_t>(size)};
+  return static_cast<int>(writev(&buffer, 1));
+}
+
+int64_t ZlibDecompressStream::writev(const IoVec *buffers, size_t count) {
   if (state_ != ZlibStreamState::INITIALIZED) {
-    logger_->log_error("writeData called in invalid ZlibDecompressStream state, state is %hhu", state_);
+    logger_->log_error("writev called in invalid ZlibDecompressStream state, state is %hhu", state_);
     return -1;
   }
 
+  for (size_t i = 0; i < count && state_ == ZlibStreamState::INITIALIZED; i++) {
+    // avail_in is limited to unsigned int
+    for (uint64_t done = 0; done < buffers[i].length && state_ == ZlibStreamState::INITIALIZED;) {
+      const uint64_t amount = (std::min)(buffers[i].length - done, static_cast<uint64_t>((std::numeric_limits<unsigned int>::max)()));
+      if (!decompress(buffers[i].data + done, amount)) {
+        return -1;
+      }
+      done += amount;
+    }
+  }
+  // input after the end of the compressed data is ignored
+  int64_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    total += buffers[i].length;
+  }
+  return total;
+}
+
+bool ZlibDecompressStream::decompress(uint8_t* value, uint64_t size) {
   strm_.next_in = value;
-  strm_.avail_in = size;
+  strm_.avail_in = static_cast<uInt>(size);
 
   /*
    * inflate works similarly to deflate in that it will not leave input data unconsumed, and we have to watch avail_out,
@@ -175,14 +227,14 @@ int ZlibDecompressStream::writeData(uint8_t* value, int size) {
         ret == Z_MEM_ERROR) {
       logger_->log_error("inflate failed, error code: %d", ret);
       state_ = ZlibStreamState::ERRORED;
-      return -1;
+      return false;
     }
     int output_size = outputBuffer_.size() - strm_.avail_out;
     logger_->log_trace("deflate produced %d B of output data", output_size);
     if (BaseStream::writeData(outputBuffer_.data(), output_size) != output_size) {
       logger_->log_error("Failed to write to underlying stream");
       state_ = ZlibStreamState::ERRORED;
-      return -1;
+      return false;
     }
   } while (strm_.avail_out == 0);
 
@@ -190,7 +242,7 @@ int ZlibDecompressStream::writeData(uint8_t* value, int size) {
     state_ = ZlibStreamState::FINISHED;
   }
 
-  return size;
+  return true;
 }
 
 } /* namespace io */
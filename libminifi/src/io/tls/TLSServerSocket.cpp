@@ -39,6 +39,7 @@
 #include <cerrno>
 #include <iostream>
 #include <algorithm>
+#include <set>
 #include <string>
 #include "io/validation.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -56,80 +57,208 @@ TLSServerSocket::TLSServerSocket(const std::shared_ptr<TLSContext> &context, con
 }
 
 TLSServerSocket::~TLSServerSocket() {
-  running_ = false;
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    running_ = false;
+  }
+  running_condition_.notify_all();
   if (server_read_thread_.joinable())
     server_read_thread_.join();
+  if (nullptr == reactor_)
+    return;
+  reactor_->remove(socket_file_descriptor_);
+  std::set<SocketDescriptor> connections;
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    closing_ = true;
+    connections = connections_;
+    connections.insert(serving_.begin(), serving_.end());
+  }
+  for (auto fd : connections) {
+    // waits for the read handler if it is handing the connection to a worker
+    reactor_->remove(fd);
+    // wakes up the worker if it is blocked on the connection
+#ifdef WIN32
+    shutdown(fd, SD_BOTH);
+#else
+    shutdown(fd, SHUT_RDWR);
+#endif /* WIN32 */
+  }
+  {
+    std::unique_lock<std::mutex> lock(connections_mutex_);
+    served_.wait(lock, [this] { return serving_.empty(); });
+    connections = connections_;
+  }
+  for (auto fd : connections) {
+    close_fd(fd);
+  }
 }
 
 /**
  * Initializes the socket
  * @return result of the creation operation.
  */
-void TLSServerSocket::registerCallback(std::function<bool()> accept_function, std::function<void(io::BaseStream *)> handler) {
-  auto fx = [this](std::function<bool()> accept_function, std::function<void(io::BaseStream *)> handler) {
-    while (running_) {
-      int fd = select_descriptor(1000);
-      if (fd >= 0) {
-        auto ssl = get_ssl(fd);
-        if (ssl != nullptr) {
-          io::SecureDescriptorStream stream(fd, ssl);
-          handler(&stream);
-          close_fd(fd);
-        }
-      }
+void TLSServerSocket::registerCallback(std::function<bool()> /*accept_function*/, std::function<void(io::BaseStream *)> handler) {
+  handler_ = std::move(handler);
+  reactor_ = EventReactor::getInstance();
+  EventReactor::setNonBlocking(socket_file_descriptor_);
+  if (!reactor_->add(socket_file_descriptor_, EventReactor::READ, [this](uint32_t) { on_accept(); })) {
+    logger_->log_error("Could not register server socket %d", socket_file_descriptor_);
+  }
+}
+
+void TLSServerSocket::on_accept() {
+  bool drained;
+  for (auto fd : accept_connections(drained)) {
+    {
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      connections_.insert(fd);
     }
-  };
-  server_read_thread_ = std::thread(fx, accept_function, handler);
+    if (!reactor_->add(fd, EventReactor::READ, [this, fd](uint32_t) { on_read(fd); })) {
+      close_fd(fd);
+    }
+  }
+  if (!drained) {
+    reactor_->pause(socket_file_descriptor_, REACTOR_ACCEPT_RETRY_PERIOD);
+  }
+}
+
+void TLSServerSocket::on_read(SocketDescriptor fd) {
+  if (!start_serving(fd))
+    return;
+  // the handshake and the handler block, so they run on a worker instead of the reactor thread
+  reactor_->remove(fd);
+  if (!reactor_->submit([this, fd] { serve(fd); })) {
+    logger_->log_warn("Too many connections waiting to be served, closing %d", fd);
+    close_fd(fd);
+    finish_serving(fd);
+  }
+}
+
+void TLSServerSocket::serve(SocketDescriptor fd) {
+  if (prepare(fd)) {
+    // the handshake waits for the client, which sends its hello first
+    auto ssl = accept_ssl(fd);
+    if (ssl != nullptr) {
+      io::SecureDescriptorStream stream(fd, ssl);
+      handler_(&stream);
+    }
+  }
+  close_fd(fd);
+  finish_serving(fd);
 }
+
 /**
  * Initializes the socket
  * @return result of the creation operation.
  */
 void TLSServerSocket::registerCallback(std::function<bool()> accept_function, std::function<int(std::vector<uint8_t>*, int *)> handler) {
-  fx = [this](std::function<bool()> accept_function, std::function<int(std::vector<uint8_t>*, int *)> handler) {
-    int ret = 0;
-    std::vector<int> fds;
-    int size;
-    while (accept_function()) {
-      int fd = select_descriptor(3000);
-      if (fd > 0) {
-        int fd_remove = 0;
-        std::vector<uint8_t> data;
-        if ( handler(&data, &size) > 0 ) {
-          ret = writeData(data.data(), size, fd);
-          if (ret < 0) {
-            close_ssl(fd_remove);
-          } else {
-            fds.push_back(fd);
-          }
-        }
-      } else {
-        int fd_remove = 0;
-        for (auto &&fd : fds) {
-          std::vector<uint8_t> data;
-          if ( handler(&data, &size) > 0 ) {
-            ret = writeData(data.data(), size, fd);
-            if (ret < 0) {
-              fd_remove = fd;
-              break;
-            }
+  reactor_ = EventReactor::getInstance();
+  EventReactor::setNonBlocking(socket_file_descriptor_);
+  auto on_connection = [this, handler](uint32_t) {
+    bool drained;
+    for (auto fd : accept_connections(drained)) {
+      if (!start_serving(fd)) {
+        close_ssl(fd);
+        continue;
+      }
+      // the handshake blocks, so it runs on a worker instead of the reactor thread
+      auto greet = [this, handler, fd] {
+        if (!prepare(fd) || nullptr == accept_ssl(fd)) {
+          close_ssl(fd);
+        } else {
+          {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            connections_.insert(fd);
           }
+          send_data(handler, fd);
         }
-        if (fd_remove > 0) {
-          close_ssl(fd_remove);
-          fds.erase(std::remove(fds.begin(), fds.end(), fd_remove), fds.end());
-        }
+        finish_serving(fd);
+      };
+      if (!reactor_->submit(greet)) {
+        logger_->log_warn("Too many connections waiting to be served, closing %d", fd);
+        close_ssl(fd);
+        finish_serving(fd);
       }
     }
-    for (auto &&fd : fds) {
-      close_ssl(fd);
+    if (!drained) {
+      reactor_->pause(socket_file_descriptor_, REACTOR_ACCEPT_RETRY_PERIOD);
     }
   };
-  server_read_thread_ = std::thread(fx, accept_function, handler);
+  if (!reactor_->add(socket_file_descriptor_, EventReactor::READ, on_connection)) {
+    logger_->log_error("Could not register server socket %d", socket_file_descriptor_);
+  }
+  server_read_thread_ = std::thread([this, accept_function, handler] {
+    std::unique_lock<std::mutex> lock(running_mutex_);
+    while (running_ && accept_function()) {
+      if (running_condition_.wait_for(lock, std::chrono::milliseconds(TLS_SERVER_BROADCAST_PERIOD), [this] { return !running_; })) {
+        break;
+      }
+      lock.unlock();
+      std::set<SocketDescriptor> connections;
+      {
+        std::lock_guard<std::mutex> connections_lock(connections_mutex_);
+        connections = connections_;
+      }
+      for (auto fd : connections) {
+        send_data(handler, fd);
+      }
+      lock.lock();
+    }
+    lock.unlock();
+    reactor_->remove(socket_file_descriptor_);
+    std::set<SocketDescriptor> connections;
+    {
+      std::lock_guard<std::mutex> connections_lock(connections_mutex_);
+      connections = connections_;
+    }
+    for (auto fd : connections) {
+      close_fd(fd);
+    }
+  });
+}
+
+bool TLSServerSocket::start_serving(SocketDescriptor fd) {
+  std::lock_guard<std::mutex> lock(connections_mutex_);
+  if (closing_)
+    return false;
+  serving_.insert(fd);
+  return true;
+}
+
+bool TLSServerSocket::prepare(SocketDescriptor fd) {
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    if (closing_)
+      return false;
+  }
+  return EventReactor::setNonBlocking(fd, false) && EventReactor::setTimeout(fd);
+}
+
+void TLSServerSocket::finish_serving(SocketDescriptor fd) {
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    serving_.erase(fd);
+  }
+  served_.notify_all();
+}
+
+bool TLSServerSocket::send_data(const std::function<int(std::vector<uint8_t>*, int *)> &handler, SocketDescriptor fd) {
+  std::vector<uint8_t> data;
+  int size;
+  if (handler(&data, &size) > 0 && writeData(data.data(), size, fd) < 0) {
+    close_fd(fd);
+    return false;
+  }
+  return true;
 }
 
 void TLSServerSocket::close_fd(int fd) {
-  std::lock_guard<std::recursive_mutex> guard(selection_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    if (connections_.erase(fd) == 0)
+      return;
+  }
   close_ssl(fd);
 }
 
@@ -21,7 +21,10 @@
 #include <WS2tcpip.h>
 #pragma comment(lib, "Ws2_32.lib")
 #endif /* WIN32 */
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <string>
@@ -262,13 +265,35 @@ void TLSSocket::close_ssl(int fd) {
   FD_CLR(fd, &total_list_);  // add to master set
   if (UNLIKELY(listeners_ > 0)) {
     std::lock_guard<std::mutex> lock(ssl_mutex_);
-    auto fd_ssl = ssl_map_[fd];
-    if (nullptr != fd_ssl) {
-      SSL_free(fd_ssl);
-      ssl_map_[fd] = nullptr;
-      closeStream();
+    auto fd_ssl = ssl_map_.find(fd);
+    if (fd_ssl != ssl_map_.end()) {
+      if (nullptr != fd_ssl->second)
+        SSL_free(fd_ssl->second);
+      ssl_map_.erase(fd_ssl);
     }
+    // the connection is closed, not the server socket
+#ifdef WIN32
+    closesocket(fd);
+#else
+    close(fd);
+#endif /* WIN32 */
+  }
+}
+
+SSL *TLSSocket::accept_ssl(int fd) {
+  auto ssl = SSL_new(context_->getContext());
+  SSL_set_fd(ssl, fd);
+  auto accept_value = SSL_accept(ssl);
+  if (accept_value > 0) {
+    logger_->log_trace("Accepted on %d", fd);
+    std::lock_guard<std::mutex> lock(ssl_mutex_);
+    ssl_map_[fd] = ssl;
+    return ssl;
   }
+  int ssl_err = SSL_get_error(ssl, accept_value);
+  logger_->log_error("Could not accept %d, error code %d", fd, ssl_err);
+  SSL_free(ssl);
+  return nullptr;
 }
 
 int16_t TLSSocket::select_descriptor(const uint16_t msec) {
@@ -309,16 +334,9 @@ int16_t TLSSocket::select_descriptor(const uint16_t msec) {
       if (newfd > socket_max_) {    // keep track of the max
         socket_max_ = newfd;
       }
-      auto ssl = SSL_new(context_->getContext());
-      SSL_set_fd(ssl, newfd);
-      auto accept_value = SSL_accept(ssl);
-      if (accept_value != -1) {
-        logger_->log_trace("Accepted on %d", newfd);
-        ssl_map_[newfd] = ssl;
+      if (nullptr != accept_ssl(newfd)) {
         return newfd;
       }
-      int ssl_err = SSL_get_error(ssl, accept_value);
-      logger_->log_error("Could not accept %d, error code %d", newfd, ssl_err);
       close_ssl(newfd);
       return -1;
     }
@@ -470,62 +488,105 @@ int TLSSocket::writeData(uint8_t *value, int size, int fd) {
 }
 
 int TLSSocket::writeData(uint8_t *value, int size) {
-  int bytes = 0;
-  int sent = 0;
+  if (size < 0) {
+    return -1;
+  }
+  IoVec buffer{value, static_cast<uint64_t>(size)};
+  return static_cast<int>(writev(&buffer, 1));
+}
+
+int64_t TLSSocket::writev(const IoVec *buffers, size_t count) {
   int fd = select_descriptor(1000);
   if (fd < 0) {
     closeStream();
     return -1;
   }
-  auto fd_ssl = get_ssl(fd);
-  if (IsNullOrEmpty(fd_ssl)) {
-    return -1;
+  uint64_t size = 0;
+  for (size_t i = 0; i < count; i++) {
+    size += buffers[i].length;
   }
-  while (bytes < size) {
-    sent = SSL_write(fd_ssl, value + bytes, size - bytes);
-    // check for errors
-    if (sent < 0) {
-      int ret = 0;
-      ret = SSL_get_error(fd_ssl, sent);
-      logger_->log_error("WriteData socket %d send failed %s %d", fd, strerror(errno), ret);
-      return sent;
+  if (count > 1 && size <= TLS_GATHER_BUFFER_SIZE) {
+    // SSL has no vectored writes, and each write is a record of its own
+    uint8_t gathered[TLS_GATHER_BUFFER_SIZE];
+    uint64_t offset = 0;
+    for (size_t i = 0; i < count; i++) {
+      std::memcpy(gathered + offset, buffers[i].data, buffers[i].length);
+      offset += buffers[i].length;
+    }
+    return writeData(gathered, static_cast<int>(size), fd) == static_cast<int>(size) ? static_cast<int64_t>(size) : -1;
+  }
+  for (size_t i = 0; i < count; i++) {
+    for (uint64_t done = 0; done < buffers[i].length;) {
+      const int amount = static_cast<int>((std::min)(buffers[i].length - done, static_cast<uint64_t>((std::numeric_limits<int>::max)())));
+      if (writeData(buffers[i].data + done, amount, fd) != amount) {
+        return -1;
+      }
+      done += amount;
     }
-    bytes += sent;
   }
   return size;
 }
 
 int TLSSocket::readData(uint8_t *buf, int buflen) {
-  int total_read = 0;
-  int status = 0;
-  while (buflen) {
-    int16_t fd = select_descriptor(1000);
-    if (fd < 0) {
-      closeStream();
-      return -1;
-    }
+  if (buflen < 0) {
+    return -1;
+  }
+  IoVec buffer{buf, static_cast<uint64_t>(buflen)};
+  return static_cast<int>(readv(&buffer, 1));
+}
 
-    int sslStatus;
-    do {
-      auto fd_ssl = get_ssl(fd);
-      if (IsNullOrEmpty(fd_ssl)) {
+int64_t TLSSocket::readv(const IoVec *buffers, size_t count) {
+  int64_t total_read = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint64_t loc = 0;
+    while (loc < buffers[i].length) {
+      int16_t fd = select_descriptor(1000);
+      if (fd < 0) {
+        closeStream();
         return -1;
       }
-      status = SSL_read(fd_ssl, buf, buflen);
-      sslStatus = SSL_get_error(fd_ssl, status);
-    } while (status < 0 && sslStatus == SSL_ERROR_WANT_READ);
 
-    if (status < 0)
-      break;
+      int status = 0;
+      int sslStatus;
+      do {
+        auto fd_ssl = get_ssl(fd);
+        if (IsNullOrEmpty(fd_ssl)) {
+          return -1;
+        }
+        status = SSL_read(fd_ssl, buffers[i].data + loc, static_cast<int>((std::min)(buffers[i].length - loc, static_cast<uint64_t>((std::numeric_limits<int>::max)()))));
+        sslStatus = SSL_get_error(fd_ssl, status);
+      } while (status < 0 && sslStatus == SSL_ERROR_WANT_READ);
 
-    buflen -= status;
-    buf += status;
-    total_read += status;
+      if (status < 0)
+        return total_read;
+
+      loc += status;
+      total_read += status;
+    }
   }
 
   return total_read;
 }
 
+int64_t TLSSocket::readv(const IoVec *buffers, size_t count, bool retrieve_all_bytes) {
+  int64_t total_read = 0;
+  for (size_t i = 0; i < count; i++) {
+    for (uint64_t done = 0; done < buffers[i].length;) {
+      const int amount = static_cast<int>((std::min)(buffers[i].length - done, static_cast<uint64_t>((std::numeric_limits<int>::max)())));
+      const int ret = readData(buffers[i].data + done, amount, retrieve_all_bytes);
+      if (ret < 0) {
+        return total_read > 0 ? total_read : ret;
+      }
+      done += ret;
+      total_read += ret;
+      if (ret < amount) {
+        return total_read;
+      }
+    }
+  }
+  return total_read;
+}
+
 } /* namespace io */
 } /* namespace minifi */
 } /* namespace nifi */
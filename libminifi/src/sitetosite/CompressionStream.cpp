@@ -0,0 +1,202 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sitetosite/CompressionStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sitetosite {
+
+namespace {
+
+const uint8_t SYNC_BYTES[] = { 'S', 'Y', 'N', 'C' };
+
+// the sync bytes followed by the raw and compressed lengths
+const size_t CHUNK_HEADER_SIZE = 12;
+
+void putInt(uint8_t *buf, uint32_t value) {
+  buf[0] = static_cast<uint8_t>(value >> 24);
+  buf[1] = static_cast<uint8_t>(value >> 16);
+  buf[2] = static_cast<uint8_t>(value >> 8);
+  buf[3] = static_cast<uint8_t>(value);
+}
+
+uint32_t getInt(const uint8_t *buf) {
+  return (static_cast<uint32_t>(buf[0]) << 24) | (static_cast<uint32_t>(buf[1]) << 16) | (static_cast<uint32_t>(buf[2]) << 8) | buf[3];
+}
+
+}  // namespace
+
+CompressionStream::CompressionStream(io::BaseStream *stream, bool compress, int level)
+    : stream_(stream),
+      compress_(compress),
+      level_(level),
+      position_(0),
+      chunk_written_(false),
+      raw_bytes_(0),
+      compressed_bytes_(0) {
+  if (compress_) {
+    buffer_.reserve(SITE2SITE_COMPRESSION_BUFFER_SIZE);
+  }
+}
+
+int CompressionStream::readData(std::vector<uint8_t> &buf, int buflen) {
+  if (buflen < 0) {
+    return -1;
+  }
+  if (buf.size() < static_cast<size_t>(buflen))
+    buf.resize(buflen);
+  return readData(buf.data(), buflen);
+}
+
+int CompressionStream::readData(uint8_t *buf, int buflen) {
+  if (!compress_) {
+    int ret = stream_->read(buf, buflen);
+    if (ret > 0) {
+      raw_bytes_ += ret;
+      compressed_bytes_ += ret;
+    }
+    return ret;
+  }
+  int total = 0;
+  while (total < buflen) {
+    if (position_ >= buffer_.size() && readChunk() <= 0) {
+      return -1;
+    }
+    size_t count = std::min(static_cast<size_t>(buflen - total), buffer_.size() - position_);
+    std::memcpy(buf + total, buffer_.data() + position_, count);
+    position_ += count;
+    total += count;
+  }
+  raw_bytes_ += total;
+  return total;
+}
+
+int CompressionStream::writeData(uint8_t *value, int size) {
+  if (!compress_) {
+    int ret = stream_->write(value, size);
+    if (ret > 0) {
+      raw_bytes_ += ret;
+      compressed_bytes_ += ret;
+    }
+    return ret;
+  }
+  int total = 0;
+  while (total < size) {
+    size_t count = std::min(static_cast<size_t>(size - total), SITE2SITE_COMPRESSION_BUFFER_SIZE - buffer_.size());
+    buffer_.insert(buffer_.end(), value + total, value + total + count);
+    total += count;
+    if (buffer_.size() >= SITE2SITE_COMPRESSION_BUFFER_SIZE && writeChunk() < 0) {
+      return -1;
+    }
+  }
+  raw_bytes_ += total;
+  return total;
+}
+
+int CompressionStream::finishPacket() {
+  if (!compress_) {
+    return 0;
+  }
+  if (!buffer_.empty() && writeChunk() < 0) {
+    return -1;
+  }
+  chunk_written_ = false;
+  uint8_t end = 0;
+  if (stream_->write(&end, 1) != 1) {
+    return -1;
+  }
+  compressed_bytes_++;
+  return 0;
+}
+
+int CompressionStream::writeChunk() {
+  // the chunks after the first of a packet are preceded by a 1
+  size_t offset = chunk_written_ ? 1 : 0;
+  uLongf compressed_length = compressBound(buffer_.size());
+  compressed_.resize(offset + CHUNK_HEADER_SIZE + compressed_length);
+  if (compress2(compressed_.data() + offset + CHUNK_HEADER_SIZE, &compressed_length, buffer_.data(), buffer_.size(), level_) != Z_OK) {
+    return -1;
+  }
+  if (chunk_written_) {
+    compressed_[0] = 1;
+  }
+  std::memcpy(compressed_.data() + offset, SYNC_BYTES, sizeof(SYNC_BYTES));
+  putInt(compressed_.data() + offset + 4, buffer_.size());
+  putInt(compressed_.data() + offset + 8, compressed_length);
+  int length = offset + CHUNK_HEADER_SIZE + compressed_length;
+  if (stream_->write(compressed_.data(), length) != length) {
+    return -1;
+  }
+  compressed_bytes_ += length;
+  chunk_written_ = true;
+  buffer_.clear();
+  return length;
+}
+
+int CompressionStream::readChunk() {
+  uint8_t header[CHUNK_HEADER_SIZE];
+  if (readFully(header, CHUNK_HEADER_SIZE) != static_cast<int>(CHUNK_HEADER_SIZE) || std::memcmp(header, SYNC_BYTES, sizeof(SYNC_BYTES)) != 0) {
+    return -1;
+  }
+  uint32_t raw_length = getInt(header + 4);
+  uint32_t compressed_length = getInt(header + 8);
+  if (raw_length == 0 || raw_length > SITE2SITE_COMPRESSION_MAX_CHUNK_SIZE || compressed_length > SITE2SITE_COMPRESSION_MAX_CHUNK_SIZE) {
+    return -1;
+  }
+  compressed_.resize(compressed_length);
+  if (readFully(compressed_.data(), compressed_length) != static_cast<int>(compressed_length)) {
+    return -1;
+  }
+  buffer_.resize(raw_length);
+  uLongf length = raw_length;
+  if (uncompress(buffer_.data(), &length, compressed_.data(), compressed_length) != Z_OK || length != raw_length) {
+    return -1;
+  }
+  position_ = 0;
+  // 1 if another chunk of the packet follows, 0 if the packet ends
+  uint8_t next = 0;
+  if (readFully(&next, 1) != 1 || next > 1) {
+    return -1;
+  }
+  compressed_bytes_ += CHUNK_HEADER_SIZE + compressed_length + 1;
+  return raw_length;
+}
+
+int CompressionStream::readFully(uint8_t *buf, int buflen) {
+  int total = 0;
+  while (total < buflen) {
+    int ret = stream_->read(buf + total, buflen - total);
+    if (ret <= 0) {
+      return -1;
+    }
+    total += ret;
+  }
+  return total;
+}
+
+} /* namespace sitetosite */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,99 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sitetosite/PeerSelector.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace sitetosite {
+
+uint32_t PeerSelector::calculateWeight(uint64_t flow_file_count, uint64_t total_flow_file_count, size_t peer_count, TransferDirection direction) {
+  if (peer_count == 0) {
+    return 0;
+  }
+  double percentage;
+  if (total_flow_file_count == 0) {
+    percentage = 1.0 / peer_count;
+  } else if (direction == SEND) {
+    // the peers with fewer flow files receive more of the data
+    if (peer_count == 1) {
+      percentage = 1.0;
+    } else {
+      percentage = (1.0 - static_cast<double>(flow_file_count) / total_flow_file_count) / (peer_count - 1);
+    }
+  } else {
+    // the peers with more flow files are drained first
+    percentage = static_cast<double>(flow_file_count) / total_flow_file_count;
+  }
+  return std::max(1U, static_cast<uint32_t>(SITE2SITE_PEER_SELECTOR_DESTINATIONS * percentage));
+}
+
+void PeerSelector::setPeers(std::vector<PeerStatus> &peers, TransferDirection direction) {
+  uint64_t total_flow_file_count = 0;
+  for (auto &peer : peers) {
+    total_flow_file_count += peer.getFlowFileCount();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  peers_.clear();
+  weights_.clear();
+  total_weight_ = 0;
+  for (auto &peer : peers) {
+    peers_.push_back(peer.getPeer());
+    weights_.push_back(calculateWeight(peer.getFlowFileCount(), total_flow_file_count, peers.size(), direction));
+    total_weight_ += weights_.back();
+  }
+  current_weights_.assign(peers_.size(), 0);
+}
+
+std::shared_ptr<Peer> PeerSelector::getNextPeer() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (peers_.empty()) {
+    return nullptr;
+  }
+  size_t selected = 0;
+  for (size_t i = 0; i < peers_.size(); i++) {
+    current_weights_[i] += weights_[i];
+    if (current_weights_[i] > current_weights_[selected]) {
+      selected = i;
+    }
+  }
+  current_weights_[selected] -= total_weight_;
+  return peers_[selected];
+}
+
+std::vector<std::shared_ptr<Peer>> PeerSelector::getPeers() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return peers_;
+}
+
+size_t PeerSelector::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return peers_.size();
+}
+
+} /* namespace sitetosite */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -246,7 +246,7 @@ bool RawSiteToSiteClient::handShake() {
   }
 
   std::map<std::string, std::string> properties;
-  properties[HandShakePropertyStr[GZIP]] = "false";
+  properties[HandShakePropertyStr[GZIP]] = use_compression_ ? "true" : "false";
   properties[HandShakePropertyStr[PORT_IDENTIFIER]] = port_id_str_;
   properties[HandShakePropertyStr[REQUEST_EXPIRATION_MILLIS]] = std::to_string(_timeOut);
   if (_currentVersion >= 5) {
@@ -500,7 +500,7 @@ std::shared_ptr<Transaction> RawSiteToSiteClient::createTransaction(std::string
       case MORE_DATA:
         dataAvailable = true;
         logger_->log_trace("Site2Site peer indicates that data is available");
-        transaction = std::make_shared<Transaction>(direction, crcstream);
+        transaction = std::make_shared<Transaction>(direction, crcstream, use_compression_);
         known_transactions_[transaction->getUUIDStr()] = transaction;
         transactionID = transaction->getUUIDStr();
         transaction->setDataAvailable(dataAvailable);
@@ -509,7 +509,7 @@ std::shared_ptr<Transaction> RawSiteToSiteClient::createTransaction(std::string
       case NO_MORE_DATA:
         dataAvailable = false;
         logger_->log_trace("Site2Site peer indicates that no data is available");
-        transaction = std::make_shared<Transaction>(direction, crcstream);
+        transaction = std::make_shared<Transaction>(direction, crcstream, use_compression_);
         known_transactions_[transaction->getUUIDStr()] = transaction;
         transactionID = transaction->getUUIDStr();
         transaction->setDataAvailable(dataAvailable);
@@ -526,7 +526,7 @@ std::shared_ptr<Transaction> RawSiteToSiteClient::createTransaction(std::string
       return NULL;
     } else {
       org::apache::nifi::minifi::io::CRCStream<SiteToSitePeer> crcstream(peer_.get());
-      transaction = std::make_shared<Transaction>(direction, crcstream);
+      transaction = std::make_shared<Transaction>(direction, crcstream, use_compression_);
       known_transactions_[transaction->getUUIDStr()] = transaction;
       transactionID = transaction->getUUIDStr();
       logger_->log_trace("Site2Site create transaction %s", transaction->getUUIDStr());
@@ -75,6 +75,8 @@ void SiteToSiteClient::deleteTransaction(std::string transactionID) {
   }
 
   logger_->log_debug("Site2Site delete transaction %s", transaction->getUUIDStr());
+  raw_bytes_ += transaction->getRawBytes();
+  compressed_bytes_ += transaction->getCompressedBytes();
   known_transactions_.erase(transactionID);
 }
 
@@ -513,6 +515,11 @@ int16_t SiteToSiteClient::send(std::string transactionID, DataPacket *packet, co
     }
   }
 
+  if (transaction->finishPacket() != 0) {
+    logger_->log_debug("Failed to finish the packet!");
+    return -1;
+  }
+
   transaction->current_transfers_++;
   transaction->total_transfers_++;
   transaction->_state = DATA_EXCHANGED;
@@ -26,6 +26,10 @@ namespace utils {
 
 template<typename T>
 void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
+  if (work_stealing_) {
+    run_stealing_tasks(thread);
+    return;
+  }
   thread->is_running_ = true;
   while (running_.load()) {
     if (UNLIKELY(thread_reduction_count_ > 0)) {
@@ -54,11 +58,10 @@ void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
         }
         // Task will be put to the delayed queue as next exec time is in the future
         std::unique_lock<std::mutex> lock(worker_queue_mutex_);
-        bool need_to_notify =
-            delayed_worker_queue_.empty() ||
-                task.getNextExecutionTime() < delayed_worker_queue_.top().getNextExecutionTime();
+        const auto next_execution_time = task.getNextExecutionTime();
+        bool need_to_notify = next_execution_time < delayed_worker_queue_.nextExpiration();
 
-        delayed_worker_queue_.push(std::move(task));
+        delayed_worker_queue_.schedule(std::move(task), next_execution_time);
         if (need_to_notify) {
           delayed_task_available_.notify_all();
         }
@@ -80,23 +83,122 @@ void ThreadPool<T>::manage_delayed_queue() {
     std::unique_lock<std::mutex> lock(worker_queue_mutex_);
 
     // Put the tasks ready to run in the worker queue
-    while (!delayed_worker_queue_.empty() &&
-        delayed_worker_queue_.top().getNextExecutionTime() <= std::chrono::steady_clock::now()) {
-      // I'm very sorry for this - committee must has been seriously drunk when the interface of prio queue was submitted.
-      Worker<T> task = std::move(const_cast<Worker<T>&>(delayed_worker_queue_.top()));
-      delayed_worker_queue_.pop();
+    delayed_worker_queue_.expire(std::chrono::steady_clock::now(), [this](Worker<T> &&task) {
       worker_queue_.enqueue(std::move(task));
-    }
+    });
     if (delayed_worker_queue_.empty()) {
       delayed_task_available_.wait(lock);
     } else {
-      auto wait_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-          delayed_worker_queue_.top().getNextExecutionTime() - std::chrono::steady_clock::now());
-      delayed_task_available_.wait_for(lock, (std::max)(wait_time, std::chrono::milliseconds(1)));
+      delayed_task_available_.wait_until(lock, delayed_worker_queue_.nextExpiration());
     }
   }
 }
 
+template<typename T>
+void ThreadPool<T>::run_stealing_tasks(std::shared_ptr<WorkerThread> thread) {
+  thread->is_running_ = true;
+  // workers started by the thread manager may outnumber the queues, those share the first one
+  size_t own_queue = 0;
+  bool owner = false;
+  for (size_t i = 0; i < stealing_queues_.size() && !owner; i++) {
+    owner = stealing_queues_[i]->claim();
+    own_queue = owner ? i : 0;
+  }
+  auto &queue = *stealing_queues_[own_queue];
+
+  while (running_.load()) {
+    if (UNLIKELY(thread_reduction_count_ > 0)) {
+      if (--thread_reduction_count_ >= 0) {
+        deceased_thread_queue_.enqueue(thread);
+        thread->is_running_ = false;
+        break;
+      } else {
+        thread_reduction_count_++;
+      }
+    }
+
+    Worker<T> task;
+    auto now = std::chrono::steady_clock::now();
+    if (!queue.pop(task, now) && !stealTask(own_queue, task, now)) {
+      waitForTask();
+      continue;
+    }
+    if (!isTaskActive(task.getIdentifier())) {
+      continue;
+    }
+    if (task.run()) {
+      if (task.getNextExecutionTime() <= std::chrono::steady_clock::now()) {
+        queue.push(std::move(task));
+      } else if (queue.pushDelayed(std::move(task))) {
+        // the idle workers may be waiting for a later task
+        notifyIdleWorkers();
+      }
+    }
+    if (queue.hasReadyTask() && idle_workers_ > 0) {
+      // this worker can run only one of them at a time
+      notifyIdleWorkers();
+    }
+  }
+  if (owner) {
+    // the tasks left behind are stolen by the remaining workers
+    queue.release();
+    notifyIdleWorkers(true);
+  }
+  current_workers_--;
+}
+
+template<typename T>
+void ThreadPool<T>::createStealingQueues() {
+  stealing_queues_.clear();
+  if (work_stealing_) {
+    for (int i = 0; i < (std::max)(max_worker_threads_, 1); i++) {
+      stealing_queues_.emplace_back(new WorkStealingQueue<T>(timer_lateness_));
+    }
+  }
+}
+
+template<typename T>
+bool ThreadPool<T>::stealTask(size_t own_queue, Worker<T> &task, std::chrono::time_point<std::chrono::steady_clock> now) {
+  for (size_t i = 1; i < stealing_queues_.size(); i++) {
+    if (stealing_queues_[(own_queue + i) % stealing_queues_.size()]->steal(task, now)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template<typename T>
+void ThreadPool<T>::waitForTask() {
+  // wake up regularly even if there is nothing to do, so that thread reduction requests are honored
+  auto wake_up_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  std::unique_lock<std::mutex> lock(idle_mutex_);
+  // notifiers publish the task before taking idle_mutex_, so checking the queues here can't miss one
+  for (const auto &queue : stealing_queues_) {
+    if (queue->hasReadyTask()) {
+      return;
+    }
+    wake_up_time = (std::min)(wake_up_time, queue->getNextDelayedTime());
+  }
+  if (!running_) {
+    return;
+  }
+  idle_workers_++;
+  idle_condition_.wait_until(lock, wake_up_time);
+  idle_workers_--;
+}
+
+template<typename T>
+void ThreadPool<T>::notifyIdleWorkers(bool all) {
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+  }
+  if (all) {
+    idle_condition_.notify_all();
+  } else {
+    idle_condition_.notify_one();
+  }
+}
+
 template<typename T>
 bool ThreadPool<T>::execute(Worker<T> &&task, std::future<T> &future) {
   {
@@ -104,7 +206,12 @@ bool ThreadPool<T>::execute(Worker<T> &&task, std::future<T> &future) {
     task_status_[task.getIdentifier()] = true;
   }
   future = std::move(task.getPromise()->get_future());
-  worker_queue_.enqueue(std::move(task));
+  if (work_stealing_) {
+    stealing_queues_[next_queue_++ % stealing_queues_.size()]->push(std::move(task));
+    notifyIdleWorkers();
+  } else {
+    worker_queue_.enqueue(std::move(task));
+  }
 
   task_count_++;
 
@@ -188,8 +295,10 @@ void ThreadPool<T>::start() {
     worker_queue_.start();
     manager_thread_ = std::move(std::thread(&ThreadPool::manageWorkers, this));
 
-    std::lock_guard<std::mutex> quee_lock(worker_queue_mutex_);
-    delayed_scheduler_thread_ = std::thread(&ThreadPool<T>::manage_delayed_queue, this);
+    if (!work_stealing_) {
+      std::lock_guard<std::mutex> quee_lock(worker_queue_mutex_);
+      delayed_scheduler_thread_ = std::thread(&ThreadPool<T>::manage_delayed_queue, this);
+    }
   }
 }
 
@@ -224,11 +333,12 @@ void ThreadPool<T>::shutdown() {
 
     thread_queue_.clear();
     current_workers_ = 0;
-    while (!delayed_worker_queue_.empty()) {
-      delayed_worker_queue_.pop();
-    }
+    delayed_worker_queue_.clear();
 
     worker_queue_.clear();
+    for (auto &queue : stealing_queues_) {
+      queue->clear();
+    }
   }
 }
 
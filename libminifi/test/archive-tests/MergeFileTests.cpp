@@ -172,6 +172,11 @@ TEST_CASE("MergeFileDefragment", "[mergefiletest1]") {
     context->setProperty(org::apache::nifi::minifi::processors::MergeContent::MergeFormat, MERGE_FORMAT_CONCAT_VALUE);
     context->setProperty(org::apache::nifi::minifi::processors::MergeContent::MergeStrategy, MERGE_STRATEGY_DEFRAGMENT);
     context->setProperty(org::apache::nifi::minifi::processors::MergeContent::DelimiterStratgey, DELIMITER_STRATEGY_TEXT);
+    SECTION("One flow file per trigger") {
+    }
+    SECTION("All flow files in one trigger") {
+      context->setProperty(org::apache::nifi::minifi::processors::MergeContent::BatchSize, "6");
+    }
 
     core::ProcessSession sessionGenFlowFile(context);
     std::shared_ptr<core::FlowFile> record[6];
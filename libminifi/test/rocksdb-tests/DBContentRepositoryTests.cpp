@@ -16,13 +16,16 @@
  * limitations under the License.
  */
 #include "../TestBase.h"
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 #include "../unit/ProvenanceTestHelper.h"
 #include "provenance/Provenance.h"
 #include "FlowFileRecord.h"
 #include "core/Core.h"
 #include "DatabaseContentRepository.h"
+#include "RocksDbStream.h"
 #include "properties/Configure.h"
 
 TEST_CASE("Write Claim", "[TestDBCR1]") {
@@ -292,3 +295,163 @@ TEST_CASE("Delete Remove Count Claim", "[TestDBCR6]") {
 
   REQUIRE(readstr == "well hello there");
 }
+
+namespace {
+
+std::string createContent(size_t size) {
+  std::string content;
+  for (size_t i = 0; content.size() < size; i++) {
+    content += std::to_string(i) + ",";
+  }
+  content.resize(size);
+  return content;
+}
+
+std::string readContent(const std::shared_ptr<minifi::io::BaseStream> &stream, int buffer_size) {
+  std::string content;
+  std::vector<uint8_t> buffer(buffer_size);
+  int read;
+  while ((read = stream->readData(buffer.data(), buffer_size)) > 0) {
+    content.append(reinterpret_cast<const char*>(buffer.data()), read);
+  }
+  REQUIRE(read == 0);
+  return content;
+}
+
+}  // namespace
+
+TEST_CASE("Chunked claims are streamed", "[TestDBCR7]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto content_repo = std::make_shared<core::repository::DatabaseContentRepository>();
+
+  auto configuration = std::make_shared<org::apache::nifi::minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  REQUIRE(content_repo->initialize(configuration));
+
+  const std::string content = createContent(3 * ROCKSDB_STREAM_CHUNK_SIZE + 123);
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  auto stream = content_repo->write(claim);
+  for (size_t offset = 0; offset < content.size(); offset += 4096) {
+    const int size = static_cast<int>((std::min)(content.size() - offset, static_cast<size_t>(4096)));
+    REQUIRE(size == stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())) + offset, size));
+  }
+  // nothing is visible before the stream is closed
+  REQUIRE_FALSE(content_repo->exists(claim));
+  stream->closeStream();
+  REQUIRE(content_repo->exists(claim));
+
+  auto read_stream = content_repo->read(claim);
+  REQUIRE(content.size() == read_stream->getSize());
+  REQUIRE(content == readContent(read_stream, 10000));
+
+  // ranged reads start at the chunk holding the offset
+  const uint64_t offset = 2 * ROCKSDB_STREAM_CHUNK_SIZE - 10;
+  read_stream = content_repo->read(claim);
+  read_stream->seek(offset);
+  std::vector<uint8_t> buffer;
+  REQUIRE(20 == read_stream->readData(buffer, 20));
+  REQUIRE(content.substr(offset, 20) == std::string(buffer.begin(), buffer.end()));
+
+  // appending continues the last chunk
+  auto append_stream = content_repo->write(claim, true);
+  REQUIRE(content.size() == append_stream->getSize());
+  const std::string appended = createContent(ROCKSDB_STREAM_CHUNK_SIZE);
+  REQUIRE(static_cast<int>(appended.size()) == append_stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(appended.data())), static_cast<int>(appended.size())));
+  append_stream->closeStream();
+  REQUIRE(content + appended == readContent(content_repo->read(claim), 4096));
+
+  // rewriting replaces the content
+  stream = content_repo->write(claim);
+  stream->writeUTF("well hello there");
+  stream->closeStream();
+  std::string readstr;
+  read_stream = content_repo->read(claim);
+  read_stream->readUTF(readstr);
+  REQUIRE(readstr == "well hello there");
+
+  REQUIRE(content_repo->remove(claim));
+  REQUIRE_FALSE(content_repo->exists(claim));
+  REQUIRE(content_repo->read(claim)->readUTF(readstr) == -1);
+}
+
+TEST_CASE("Claims written by earlier versions are read", "[TestDBCR8]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto content_repo = std::make_shared<core::repository::DatabaseContentRepository>();
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  const std::string content = createContent(ROCKSDB_STREAM_CHUNK_SIZE + 1000);
+  {
+    rocksdb::DB *db;
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    options.merge_operator = std::make_shared<core::repository::StringAppender>();
+    REQUIRE(rocksdb::DB::Open(options, dir, &db).ok());
+    REQUIRE(db->Put(rocksdb::WriteOptions(), claim->getContentFullPath(), content).ok());
+    delete db;
+  }
+
+  auto configuration = std::make_shared<org::apache::nifi::minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  REQUIRE(content_repo->initialize(configuration));
+  REQUIRE(content_repo->exists(claim));
+  auto read_stream = content_repo->read(claim);
+  read_stream->seek(100);
+  REQUIRE(content.substr(100) == readContent(read_stream, 4096));
+
+  auto append_stream = content_repo->write(claim, true);
+  std::vector<uint8_t> appended{'e', 'n', 'd'};
+  REQUIRE(3 == append_stream->writeData(appended.data(), 3));
+  append_stream->closeStream();
+  REQUIRE(content + "end" == readContent(content_repo->read(claim), 4096));
+
+  REQUIRE(content_repo->remove(claim));
+  REQUIRE_FALSE(content_repo->exists(claim));
+}
+
+TEST_CASE("Replacing a claim does not touch its content before the stream is closed", "[TestDBCR9]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto content_repo = std::make_shared<core::repository::DatabaseContentRepository>();
+
+  auto configuration = std::make_shared<org::apache::nifi::minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  REQUIRE(content_repo->initialize(configuration));
+
+  // large enough for both streams to write chunks ahead of the manifest
+  const std::string content = createContent(ROCKSDB_STREAM_MAX_BATCH_SIZE + 3 * ROCKSDB_STREAM_CHUNK_SIZE);
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  auto stream = content_repo->write(claim);
+  REQUIRE(static_cast<int>(content.size()) == stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())), static_cast<int>(content.size())));
+  stream->closeStream();
+
+  auto early_reader = content_repo->read(claim);
+  std::string replacement = createContent(ROCKSDB_STREAM_MAX_BATCH_SIZE + ROCKSDB_STREAM_CHUNK_SIZE);
+  std::reverse(replacement.begin(), replacement.end());
+  stream = content_repo->write(claim);
+  REQUIRE(static_cast<int>(replacement.size()) == stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(replacement.data())), static_cast<int>(replacement.size())));
+
+  // the chunks written so far belong to a generation no manifest refers to
+  REQUIRE(content == readContent(content_repo->read(claim), 65536));
+
+  auto late_reader = content_repo->read(claim);
+  stream->closeStream();
+  REQUIRE(replacement == readContent(content_repo->read(claim), 65536));
+
+  // streams opened before the switch keep reading the content they started with
+  REQUIRE(content == readContent(early_reader, 65536));
+  REQUIRE(content == readContent(late_reader, 65536));
+
+  // appending to the replacement continues its generation
+  auto append_stream = content_repo->write(claim, true);
+  std::vector<uint8_t> appended{'e', 'n', 'd'};
+  REQUIRE(3 == append_stream->writeData(appended.data(), 3));
+  append_stream->closeStream();
+  REQUIRE(replacement + "end" == readContent(content_repo->read(claim), 65536));
+
+  REQUIRE(content_repo->remove(claim));
+  REQUIRE_FALSE(content_repo->exists(claim));
+}
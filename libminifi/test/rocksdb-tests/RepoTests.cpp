@@ -16,18 +16,23 @@
  * limitations under the License.
  */
 #include "../TestBase.h"
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <chrono>
 #include <thread>
 #include <map>
+#include <vector>
 #include "../unit/ProvenanceTestHelper.h"
 #include "provenance/Provenance.h"
 #include "FlowFileRecord.h"
 #include "core/Core.h"
 #include "FlowFileRepository.h"
+#include "GroupCommitWriter.h"
 #include "core/repository/AtomicRepoEntries.h"
 #include "core/RepositoryFactory.h"
+#include "core/state/nodes/RepositoryMetrics.h"
 #include "properties/Configure.h"
 
 TEST_CASE("Test Repo Names", "[TestFFR1]") {
@@ -250,3 +255,335 @@ TEST_CASE("Test Validate Checkpoint ", "[TestFFR5]") {
   LogTestController::getInstance().reset();
 }
 
+
+namespace {
+
+rocksdb::DB *openDatabase(const std::string &dir) {
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  rocksdb::DB *db = nullptr;
+  REQUIRE(rocksdb::DB::Open(options, dir, &db).ok());
+  return db;
+}
+
+}  // namespace
+
+TEST_CASE("Test group commit of concurrent writes", "[TestFFR6]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  std::unique_ptr<rocksdb::DB> db(openDatabase(dir));
+  core::repository::GroupCommitWriter writer(db.get(), std::chrono::milliseconds(100), false);
+
+  const int writers = 8;
+  std::vector<std::thread> threads;
+  std::atomic<int> succeeded(0);
+  for (int i = 0; i < writers; i++) {
+    threads.emplace_back([&writer, &succeeded, i]() {
+      const std::string key = "key" + std::to_string(i);
+      core::repository::GroupCommitWriter::Operation operation = [&key](rocksdb::WriteBatch &batch) {
+        auto status = batch.Put(key, "value");
+        if (status.ok() && key == "key0") {
+          // a failing operation must not leave anything in the batch
+          return rocksdb::Status::Aborted();
+        }
+        return status;
+      };
+      if (writer.write(operation).ok()) {
+        succeeded++;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(writers - 1 == succeeded);
+  REQUIRE(writers - 1 == writer.getCommitCount());
+  REQUIRE(writer.getGroupCount() < writer.getCommitCount());
+  std::string value;
+  REQUIRE_FALSE(db->Get(rocksdb::ReadOptions(), "key0", &value).ok());
+  for (int i = 1; i < writers; i++) {
+    REQUIRE(db->Get(rocksdb::ReadOptions(), "key" + std::to_string(i), &value).ok());
+    REQUIRE("value" == value);
+  }
+}
+
+TEST_CASE("Test flow file repository with commit window", "[TestFFR7]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_flowfile_repository_commit_window, "5 ms");
+  configuration->set(minifi::Configure::nifi_flowfile_repository_sync_writes, "true");
+  REQUIRE(repository->initialize(configuration));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&repository, i]() {
+      for (int j = 0; j < 10; j++) {
+        const std::string value = std::to_string(i * 10 + j);
+        repository->Put(value, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < 40; i++) {
+    std::string value;
+    REQUIRE(repository->Get(std::to_string(i), value));
+    REQUIRE(std::to_string(i) == value);
+  }
+  repository->stop();
+}
+
+TEST_CASE("Flow file repository commit benchmark", "[.][benchmark]") {
+  const int threads_count = 8;
+  const int commits_per_thread = 500;
+  LogTestController::getInstance().setWarn<core::repository::FlowFileRepository>();
+  std::string record(300, 'a');
+
+  auto run = [&](const std::string &name, const std::function<rocksdb::Status(const std::string&)> &commit) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads_count; i++) {
+      threads.emplace_back([&commit, i, commits_per_thread]() {
+        for (int j = 0; j < commits_per_thread; j++) {
+          commit(std::to_string(i) + "-" + std::to_string(j));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << (threads_count * commits_per_thread * 1000 / (std::max)(elapsed, static_cast<decltype(elapsed)>(1))) << " commits/s" << std::endl;
+  };
+
+  for (bool sync : {false, true}) {
+    TestController testController;
+    char format[] = "/var/tmp/testRepo.XXXXXX";
+    auto dir = testController.createTempDirectory(format);
+    std::unique_ptr<rocksdb::DB> db(openDatabase(dir));
+    rocksdb::WriteOptions options;
+    options.sync = sync;
+    const std::string suffix = sync ? " (sync)" : "";
+
+    run("separate writes" + suffix, [&](const std::string &key) {
+      rocksdb::WriteBatch batch;
+      batch.Put(key, record);
+      return db->Write(options, &batch);
+    });
+    for (int window : {0, 1, 5}) {
+      core::repository::GroupCommitWriter writer(db.get(), std::chrono::milliseconds(window), sync);
+      run("group commit, " + std::to_string(window) + " ms window" + suffix, [&](const std::string &key) {
+        core::repository::GroupCommitWriter::Operation operation = [&](rocksdb::WriteBatch &batch) {
+          return batch.Put(key, record);
+        };
+        return writer.write(operation);
+      });
+    }
+  }
+}
+
+namespace {
+
+void requireSameRecord(minifi::FlowFileRecord &expected, minifi::FlowFileRecord &actual) {
+  REQUIRE(expected.getUUIDStr() == actual.getUUIDStr());
+  REQUIRE(expected.getConnectionUuid() == actual.getConnectionUuid());
+  REQUIRE(expected.getEventTime() == actual.getEventTime());
+  REQUIRE(expected.getEntryDate() == actual.getEntryDate());
+  REQUIRE(expected.getlineageStartDate() == actual.getlineageStartDate());
+  REQUIRE(expected.getAttributes() == actual.getAttributes());
+  REQUIRE(expected.getContentFullPath() == actual.getContentFullPath());
+  REQUIRE(expected.getSize() == actual.getSize());
+  REQUIRE(expected.getOffset() == actual.getOffset());
+}
+
+}  // namespace
+
+TEST_CASE("Test compact flow file records", "[TestFFR8]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  content_repo->initialize(configuration);
+  std::shared_ptr<minifi::ResourceClaim> claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  std::string uuid;
+  std::string connection_uuid = minifi::FlowFileRecord(nullptr, content_repo).getUUIDStr();
+  {
+    std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+    REQUIRE(repository->initialize(std::make_shared<minifi::Configure>()));
+
+    minifi::FlowFileRecord record(repository, content_repo, std::map<std::string, std::string>{{"keyA", "valueA"}, {"", ""}}, claim);
+    record.setUuidConnection(connection_uuid);
+    record.setSize(1234);
+    record.setOffset(42);
+    uuid = record.getUUIDStr();
+
+    minifi::io::DataStream compact;
+    minifi::io::DataStream legacy;
+    REQUIRE(record.Serialize(compact, minifi::FlowFileRecord::RecordFormat::COMPACT));
+    REQUIRE(record.Serialize(legacy, minifi::FlowFileRecord::RecordFormat::LEGACY));
+    REQUIRE(compact.getSize() < legacy.getSize() / 2);
+
+    minifi::FlowFileRecord from_compact(repository, content_repo);
+    REQUIRE(from_compact.DeSerialize(compact));
+    requireSameRecord(record, from_compact);
+
+    minifi::FlowFileRecord from_legacy(repository, content_repo);
+    REQUIRE(from_legacy.DeSerialize(legacy));
+    requireSameRecord(record, from_legacy);
+
+    REQUIRE(record.Serialize());
+    repository->stop();
+  }
+
+  // the content path prefix is read back from the repository after a restart
+  std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+  REQUIRE(repository->initialize(std::make_shared<minifi::Configure>()));
+  minifi::FlowFileRecord restored(repository, content_repo);
+  REQUIRE(restored.DeSerialize(uuid));
+  REQUIRE(claim->getContentFullPath() == restored.getContentFullPath());
+  REQUIRE(connection_uuid == restored.getConnectionUuid());
+  REQUIRE(1234 == restored.getSize());
+  repository->stop();
+
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+}
+
+TEST_CASE("Test compact flow file records without interned content", "[TestFFR9]") {
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  std::shared_ptr<minifi::ResourceClaim> claim = std::make_shared<minifi::ResourceClaim>("/content/not-a-counter", content_repo);
+  minifi::FlowFileRecord record(nullptr, content_repo, std::map<std::string, std::string>{{"keyA", "valueA"}}, claim);
+  record.setUuidConnection("Not A UUID");
+
+  minifi::io::DataStream stream;
+  REQUIRE(record.Serialize(stream));
+  minifi::FlowFileRecord read(nullptr, content_repo);
+  REQUIRE(read.DeSerialize(stream));
+  requireSameRecord(record, read);
+
+  SECTION("Truncated records are rejected") {
+    for (size_t size = 0; size < stream.getSize(); size++) {
+      minifi::FlowFileRecord truncated(nullptr, content_repo);
+      REQUIRE_FALSE(truncated.DeSerialize(stream.getBuffer(), size));
+    }
+  }
+}
+
+TEST_CASE("Test parallel recovery of stored flow files", "[TestFFR10]") {
+  TestController testController;
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+  LogTestController::getInstance().setWarn<minifi::FlowFileRecord>();
+  LogTestController::getInstance().setWarn<minifi::Connection>();
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_flowfile_repository_recovery_threads, "4");
+
+  const int per_connection = 1500;
+  const int orphans = 20;
+  std::string connection_uuids[2];
+  {
+    std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+    REQUIRE(repository->initialize(configuration));
+    for (auto &connection_uuid : connection_uuids) {
+      connection_uuid = minifi::FlowFileRecord(nullptr, content_repo).getUUIDStr();
+    }
+    for (int i = 0; i < 2 * per_connection + orphans; i++) {
+      minifi::FlowFileRecord record(repository, content_repo, std::map<std::string, std::string>{{"index", std::to_string(i)}});
+      record.setUuidConnection(i < 2 * per_connection ? connection_uuids[i % 2] : "no such connection");
+      REQUIRE(record.Serialize());
+    }
+    repository->stop();
+  }
+
+  std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+  REQUIRE(repository->initialize(configuration));
+  std::map<std::string, std::shared_ptr<core::Connectable>> connection_map;
+  std::vector<std::shared_ptr<minifi::Connection>> connections;
+  for (const auto &connection_uuid : connection_uuids) {
+    auto connection = std::make_shared<minifi::Connection>(repository, content_repo, "connection");
+    connection_map[connection_uuid] = connection;
+    connections.push_back(connection);
+  }
+  repository->setConnectionMap(connection_map);
+  repository->loadComponent(content_repo);
+  repository->start();
+
+  for (int i = 0; i < 500 && (repository->isRecovering() || repository->getRecoveredCount() + repository->getDiscardedCount() < 2 * per_connection + orphans); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE_FALSE(repository->isRecovering());
+  REQUIRE(2 * per_connection == repository->getRecoveredCount());
+  REQUIRE(orphans == repository->getDiscardedCount());
+  for (const auto &connection : connections) {
+    REQUIRE(per_connection == connection->getQueueSize());
+  }
+
+  minifi::state::response::RepositoryMetrics metrics;
+  metrics.addRepository(repository);
+  auto resp = metrics.serialize().at(0);
+  REQUIRE(7 == resp.children.size());
+  REQUIRE("recoveredCount" == resp.children.at(4).name);
+  REQUIRE(std::to_string(2 * per_connection) == resp.children.at(4).value.to_string());
+  REQUIRE("discardedCount" == resp.children.at(5).name);
+  REQUIRE(std::to_string(orphans) == resp.children.at(5).value.to_string());
+
+  repository->stop();
+  for (const auto &connection : connections) {
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    while (connection->poll(expired) != nullptr) {
+    }
+  }
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("Flow file record format benchmark", "[.][benchmark]") {
+  const int records = 100000;
+  LogTestController::getInstance().setWarn<minifi::FlowFileRecord>();
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+  REQUIRE(repository->initialize(std::make_shared<minifi::Configure>()));
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  content_repo->initialize(configuration);
+
+  std::map<std::string, std::string> attributes{{"mime.type", "application/json"}, {"kafka.topic", "sensors"}, {"kafka.partition", "3"}};
+  minifi::FlowFileRecord record(repository, content_repo, attributes, std::make_shared<minifi::ResourceClaim>(content_repo));
+  record.setUuidConnection(minifi::FlowFileRecord(nullptr, content_repo).getUUIDStr());
+
+  for (auto record_format : {minifi::FlowFileRecord::RecordFormat::LEGACY, minifi::FlowFileRecord::RecordFormat::COMPACT}) {
+    const std::string name = record_format == minifi::FlowFileRecord::RecordFormat::LEGACY ? "legacy" : "compact";
+    std::vector<std::unique_ptr<minifi::io::DataStream>> streams;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < records; i++) {
+      streams.emplace_back(new minifi::io::DataStream());
+      record.Serialize(*streams.back(), record_format);
+    }
+    auto serialized = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<minifi::FlowFileRecord>> read;
+    read.reserve(records);
+    for (const auto &stream : streams) {
+      read.push_back(std::make_shared<minifi::FlowFileRecord>(repository, content_repo));
+      read.back()->DeSerialize(*stream);
+    }
+    auto deserialized = std::chrono::steady_clock::now();
+    auto perSecond = [records](std::chrono::steady_clock::duration elapsed) {
+      return records * 1000 / (std::max)(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()), static_cast<int64_t>(1));
+    };
+    std::cout << name << ": " << streams.front()->getSize() << " bytes, " << perSecond(serialized - start) << " serializations/s, " << perSecond(deserialized - serialized)
+              << " deserializations/s" << std::endl;
+  }
+  repository->stop();
+}
@@ -373,3 +373,84 @@ TEST_CASE("Lua: Test Require", "[executescriptLuaRequire]") { // NOLINT
 
   logTestController.reset();
 }
+
+TEST_CASE("Lua: Test Read Buffer", "[executescriptLuaReadBuffer]") { // NOLINT
+  TestController testController;
+
+  LogTestController &logTestController = LogTestController::getInstance();
+  logTestController.setDebug<TestPlan>();
+  logTestController.setDebug<minifi::processors::LogAttribute>();
+  logTestController.setDebug<minifi::processors::ExecuteScript>();
+
+  auto plan = testController.createPlan();
+
+  auto getFile = plan->addProcessor("GetFile", "getFile");
+  auto logAttribute = plan->addProcessor("LogAttribute", "logAttribute",
+                                         core::Relationship("success", "description"),
+                                         true);
+  auto executeScript = plan->addProcessor("ExecuteScript",
+                                          "executeScript",
+                                          core::Relationship("success", "description"),
+                                          true);
+  auto putFile = plan->addProcessor("PutFile", "putFile", core::Relationship("success", "description"), true);
+
+  plan->setProperty(executeScript, processors::ExecuteScript::ScriptEngine.getName(), "lua");
+  plan->setProperty(executeScript, processors::ExecuteScript::ScriptBody.getName(), R"(
+    read_buffer_callback = {}
+
+    function read_buffer_callback.process(self, content)
+        log:info('buffer length: ' .. #content)
+        log:info('buffer slice: ' .. content:sub(content:find('F'), -1))
+        log:info('buffer content: ' .. tostring(content))
+        return content:len()
+    end
+
+    function onTrigger(context, session)
+      flow_file = session:get()
+
+      if flow_file ~= nil then
+        session:readBuffer(flow_file, read_buffer_callback)
+        session:transfer(flow_file, REL_SUCCESS)
+      end
+    end
+  )");
+
+  char getFileDirFmt[] = "/tmp/ft.XXXXXX";
+  auto getFileDir = testController.createTempDirectory(getFileDirFmt);
+  plan->setProperty(getFile, processors::GetFile::Directory.getName(), getFileDir);
+
+  char putFileDirFmt[] = "/tmp/ft.XXXXXX";
+  auto putFileDir = testController.createTempDirectory(putFileDirFmt);
+  plan->setProperty(putFile, processors::PutFile::Directory.getName(), putFileDir);
+
+  testController.runSession(plan, false);
+
+  auto records = plan->getProvenanceRecords();
+  std::shared_ptr<core::FlowFile> record = plan->getCurrentFlowFile();
+  REQUIRE(record == nullptr);
+  REQUIRE(records.empty());
+
+  std::fstream file;
+  std::stringstream ss;
+  ss << getFileDir << "/" << "tstFile.ext";
+  file.open(ss.str(), std::ios::out);
+  file << "tempFile";
+  file.close();
+  plan->reset();
+
+  testController.runSession(plan, false);
+  testController.runSession(plan, false);
+  testController.runSession(plan, false);
+
+  records = plan->getProvenanceRecords();
+  record = plan->getCurrentFlowFile();
+  testController.runSession(plan, false);
+
+  unlink(ss.str().c_str());
+
+  REQUIRE(logTestController.contains("[info] buffer length: 8"));
+  REQUIRE(logTestController.contains("[info] buffer slice: File"));
+  REQUIRE(logTestController.contains("[info] buffer content: tempFile"));
+
+  logTestController.reset();
+}
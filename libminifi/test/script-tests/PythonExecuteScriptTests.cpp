@@ -18,7 +18,10 @@
 
 #define CATCH_CONFIG_MAIN
 
+#include <fstream>
+#include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <set>
 
@@ -198,6 +201,217 @@ TEST_CASE("Python: Test Write File", "[executescriptPythonWrite]") { // NOLINT
   logTestController.reset();
 }
 
+TEST_CASE("Python: Test Read Buffer", "[executescriptPythonReadBuffer]") { // NOLINT
+  TestController testController;
+
+  LogTestController &logTestController = LogTestController::getInstance();
+  logTestController.setDebug<TestPlan>();
+  logTestController.setDebug<minifi::processors::LogAttribute>();
+  logTestController.setDebug<minifi::processors::ExecuteScript>();
+
+  auto plan = testController.createPlan();
+
+  auto getFile = plan->addProcessor("GetFile", "getFile");
+  auto logAttribute = plan->addProcessor("LogAttribute", "logAttribute",
+                                         core::Relationship("success", "description"),
+                                         true);
+  auto executeScript = plan->addProcessor("ExecuteScript",
+                                          "executeScript",
+                                          core::Relationship("success", "description"),
+                                          true);
+  auto putFile = plan->addProcessor("PutFile", "putFile", core::Relationship("success", "description"), true);
+
+  plan->setProperty(executeScript, processors::ExecuteScript::ScriptBody.getName(), R"(
+    class ReadBufferCallback(object):
+      def __init__(self):
+        self.tail = None
+
+      def process(self, content):
+        self.tail = content[4:]
+        try:
+          content[0] = 0
+        except TypeError:
+          log.info('buffer is read only')
+        return len(content)
+
+    class ReadAllCallback(object):
+      def __init__(self):
+        self.content = bytearray()
+
+      def process(self, input_stream):
+        return input_stream.readAllInto(self.content)
+
+    class WriteCallback(object):
+      def __init__(self, content):
+        self.content = content
+
+      def process(self, output_stream):
+        return output_stream.write(self.content)
+
+    def onTrigger(context, session):
+      flow_file = session.get()
+
+      if flow_file is not None:
+        read_buffer = ReadBufferCallback()
+        session.readBuffer(flow_file, read_buffer)
+        log.info('buffer content: %s' % bytes(read_buffer.tail).decode('utf-8'))
+        read_all = ReadAllCallback()
+        session.read(flow_file, read_all)
+        session.write(flow_file, WriteCallback(read_all.content.upper()))
+        session.transfer(flow_file, REL_SUCCESS)
+  )");
+
+  char getFileDirFmt[] = "/tmp/ft.XXXXXX";
+  auto getFileDir = testController.createTempDirectory(getFileDirFmt);
+  plan->setProperty(getFile, processors::GetFile::Directory.getName(), getFileDir);
+
+  char putFileDirFmt[] = "/tmp/ft.XXXXXX";
+  auto putFileDir = testController.createTempDirectory(putFileDirFmt);
+  plan->setProperty(putFile, processors::PutFile::Directory.getName(), putFileDir);
+
+  testController.runSession(plan, false);
+
+  auto records = plan->getProvenanceRecords();
+  std::shared_ptr<core::FlowFile> record = plan->getCurrentFlowFile();
+  REQUIRE(record == nullptr);
+  REQUIRE(records.empty());
+
+  std::fstream file;
+  std::stringstream ss;
+  ss << getFileDir << "/" << "tstFile.ext";
+  file.open(ss.str(), std::ios::out);
+  file << "tempFile";
+  file.close();
+  plan->reset();
+
+  testController.runSession(plan, false);
+  testController.runSession(plan, false);
+  testController.runSession(plan, false);
+
+  records = plan->getProvenanceRecords();
+  record = plan->getCurrentFlowFile();
+  testController.runSession(plan, false);
+
+  unlink(ss.str().c_str());
+
+  REQUIRE(logTestController.contains("[info] buffer is read only"));
+  REQUIRE(logTestController.contains("[info] buffer content: File"));
+
+  // Verify that the content read into the bytearray was written back
+  std::stringstream movedFile;
+  movedFile << putFileDir << "/" << "tstFile.ext";
+  REQUIRE(std::ifstream(movedFile.str()).good());
+
+  file.open(movedFile.str(), std::ios::in);
+  std::string contents((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+  REQUIRE("TEMPFILE" == contents);
+  file.close();
+  logTestController.reset();
+}
+
+TEST_CASE("Python: Read Path benchmark", "[.][benchmark]") { // NOLINT
+  TestController testController;
+
+  LogTestController &logTestController = LogTestController::getInstance();
+  logTestController.setDebug<minifi::processors::ExecuteScript>();
+
+  auto plan = testController.createPlan();
+
+  auto getFile = plan->addProcessor("GetFile", "getFile");
+  auto executeScript = plan->addProcessor("ExecuteScript",
+                                          "executeScript",
+                                          core::Relationship("success", "description"),
+                                          true);
+
+  // each callback computes the same checksum, so the rates only differ in how the content reaches the script
+  plan->setProperty(executeScript, processors::ExecuteScript::ScriptBody.getName(), R"(
+    import time
+    import zlib
+
+    ROUNDS = 10
+
+    class ReadCallback(object):
+      def __init__(self):
+        self.size = 0
+        self.checksum = 0
+
+      def process(self, input_stream):
+        content = input_stream.read()
+        self.size = len(content)
+        self.checksum = zlib.crc32(content)
+        return self.size
+
+    class ReadAllIntoCallback(object):
+      def __init__(self):
+        self.content = bytearray()
+        self.size = 0
+        self.checksum = 0
+
+      def process(self, input_stream):
+        self.size = input_stream.readAllInto(self.content)
+        self.checksum = zlib.crc32(self.content)
+        return self.size
+
+    class ReadBufferCallback(object):
+      def __init__(self):
+        self.size = 0
+        self.checksum = 0
+
+      def process(self, content):
+        self.size = len(content)
+        self.checksum = zlib.crc32(content)
+        return self.size
+
+    def measure(name, read, flow_file, callback):
+      start = time.perf_counter()
+      for _ in range(ROUNDS):
+        read(flow_file, callback)
+      elapsed = time.perf_counter() - start
+      log.info('%s: %.1f MB/s' % (name, ROUNDS * callback.size / elapsed / 1048576))
+      return callback.checksum
+
+    def onTrigger(context, session):
+      flow_file = session.get()
+
+      if flow_file is not None:
+        checksums = {
+          measure('read()', session.read, flow_file, ReadCallback()),
+          measure('readAllInto', session.read, flow_file, ReadAllIntoCallback()),
+          measure('readBuffer', session.readBuffer, flow_file, ReadBufferCallback()),
+        }
+        if len(checksums) == 1:
+          log.info('checksums agree')
+        session.transfer(flow_file, REL_SUCCESS)
+  )");
+
+  char getFileDirFmt[] = "/tmp/ft.XXXXXX";
+  auto getFileDir = testController.createTempDirectory(getFileDirFmt);
+  plan->setProperty(getFile, processors::GetFile::Directory.getName(), getFileDir);
+
+  const size_t size = 32 * 1024 * 1024;
+  std::string content(size, '\0');
+  for (size_t i = 0; i < size; i++) {
+    content[i] = static_cast<char>(i * 31 % 251);
+  }
+  std::ofstream(getFileDir + "/tstFile.ext", std::ios::binary) << content;
+  plan->reset();
+
+  testController.runSession(plan, false);
+  testController.runSession(plan, false);
+
+  REQUIRE(logTestController.contains("[info] checksums agree"));
+
+  std::istringstream output(logTestController.log_output.str());
+  for (std::string line; std::getline(output, line);) {
+    if (line.find("MB/s") != std::string::npos) {
+      std::cout << line.substr(line.find("[info] ") + 7) << std::endl;
+    }
+  }
+
+  logTestController.reset();
+}
+
 TEST_CASE("Python: Test Create", "[executescriptPythonCreate]") { // NOLINT
   TestController testController;
 
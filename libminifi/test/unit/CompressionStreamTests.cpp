@@ -0,0 +1,141 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "io/BaseStream.h"
+#include "io/CRCStream.h"
+#include "sitetosite/CompressionStream.h"
+
+namespace io = org::apache::nifi::minifi::io;
+namespace sitetosite = org::apache::nifi::minifi::sitetosite;
+
+TEST_CASE("Compressed packets can be read back", "[basic]") {
+  io::BaseStream wire;
+
+  std::string first = "first packet";
+  std::string second;
+  for (int i = 0; i < 20000; i++) {
+    second += "a line of log data that repeats\n";
+  }
+
+  sitetosite::CompressionStream writer(&wire, true);
+  REQUIRE(static_cast<int>(first.size()) == writer.write(reinterpret_cast<uint8_t*>(&first[0]), first.size()));
+  REQUIRE(0 == writer.finishPacket());
+  REQUIRE(static_cast<int>(second.size()) == writer.write(reinterpret_cast<uint8_t*>(&second[0]), second.size()));
+  REQUIRE(0 == writer.finishPacket());
+
+  REQUIRE(first.size() + second.size() == writer.getRawBytes());
+  REQUIRE(writer.getCompressedBytes() == wire.getSize());
+  REQUIRE(writer.getCompressedBytes() < writer.getRawBytes() / 10);
+
+  sitetosite::CompressionStream reader(&wire, true);
+  std::vector<uint8_t> buf;
+  REQUIRE(static_cast<int>(first.size()) == reader.readData(buf, first.size()));
+  REQUIRE(first == std::string(reinterpret_cast<char*>(buf.data()), first.size()));
+  REQUIRE(static_cast<int>(second.size()) == reader.readData(buf, second.size()));
+  REQUIRE(second == std::string(reinterpret_cast<char*>(buf.data()), second.size()));
+
+  REQUIRE(writer.getRawBytes() == reader.getRawBytes());
+  REQUIRE(writer.getCompressedBytes() == reader.getCompressedBytes());
+}
+
+TEST_CASE("Packets pass through without compression", "[basic]") {
+  io::BaseStream wire;
+
+  sitetosite::CompressionStream writer(&wire, false);
+  io::CRCStream<sitetosite::CompressionStream> crc_writer(&writer);
+  REQUIRE(4 == crc_writer.write(static_cast<uint32_t>(42)));
+  REQUIRE(0 == writer.finishPacket());
+
+  REQUIRE(4U == wire.getSize());
+  REQUIRE(4U == writer.getRawBytes());
+  REQUIRE(4U == writer.getCompressedBytes());
+
+  sitetosite::CompressionStream reader(&wire, false);
+  io::CRCStream<sitetosite::CompressionStream> crc_reader(&reader);
+  uint32_t value = 0;
+  REQUIRE(4 == crc_reader.read(value));
+  REQUIRE(42U == value);
+  REQUIRE(crc_writer.getCRC() == crc_reader.getCRC());
+}
+
+TEST_CASE("Corrupted chunks are rejected", "[basic]") {
+  io::BaseStream wire;
+  std::string garbage = "SYNX0000000000";
+  wire.write(reinterpret_cast<uint8_t*>(&garbage[0]), garbage.size());
+
+  sitetosite::CompressionStream reader(&wire, true);
+  uint8_t value;
+  REQUIRE(-1 == reader.readData(&value, 1));
+}
+
+TEST_CASE("Packets are framed as NiFi's CompressionOutputStream frames them", "[basic]") {
+  // 65536 bytes of 'a' fill the first chunk, "NiFi" the second one
+  std::string packet(SITE2SITE_COMPRESSION_BUFFER_SIZE, 'a');
+  packet += "NiFi";
+  // compressed with zlib at Z_BEST_SPEED, as NiFi's Deflater default of level 1 does
+  const std::vector<uint8_t> framed = {
+    // sync bytes, raw length 65536, compressed length 308
+    'S', 'Y', 'N', 'C', 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x34,
+    0x78, 0x01, 0xed, 0xd0, 0x81, 0x00, 0x00, 0x00, 0x00, 0x80, 0x20, 0xd6, 0xfd, 0x25, 0x16, 0x29,
+    0x84, 0x0a, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30,
+    0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c,
+    0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03,
+    0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80,
+    0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60,
+    0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18,
+    0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06,
+    0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01,
+    0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0,
+    0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30,
+    0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c,
+    0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03,
+    0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80,
+    0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60,
+    0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18,
+    0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06,
+    0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01,
+    0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x80, 0x01, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x50, 0x03,
+    0x2d, 0x87, 0x05, 0xb0,
+    // another chunk follows
+    0x01,
+    // sync bytes, raw length 4, compressed length 12
+    'S', 'Y', 'N', 'C', 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0c,
+    0x78, 0x01, 0xf3, 0xcb, 0x74, 0xcb, 0x04, 0x00, 0x03, 0x6c, 0x01, 0x67,
+    // end of the packet
+    0x00
+  };
+
+  io::BaseStream wire;
+  REQUIRE(static_cast<int>(framed.size()) == wire.write(const_cast<uint8_t*>(framed.data()), framed.size()));
+  sitetosite::CompressionStream reader(&wire, true);
+  std::vector<uint8_t> buf;
+  REQUIRE(static_cast<int>(packet.size()) == reader.readData(buf, packet.size()));
+  REQUIRE(packet == std::string(reinterpret_cast<char*>(buf.data()), packet.size()));
+  REQUIRE(framed.size() == reader.getCompressedBytes());
+
+  io::BaseStream encoded;
+  sitetosite::CompressionStream writer(&encoded, true);
+  REQUIRE(static_cast<int>(packet.size()) == writer.write(reinterpret_cast<uint8_t*>(&packet[0]), packet.size()));
+  REQUIRE(0 == writer.finishPacket());
+  REQUIRE(framed.size() == encoded.getSize());
+  std::vector<uint8_t> written(framed.size());
+  REQUIRE(static_cast<int>(framed.size()) == encoded.readData(written, framed.size()));
+  REQUIRE(framed == written);
+}
@@ -0,0 +1,264 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../TestBase.h"
+#include "ProvenanceTestHelper.h"
+#include "Connection.h"
+#include "core/FlowFilePrioritizer.h"
+#include "FlowFileRecord.h"
+#include "core/repository/VolatileContentRepository.h"
+
+namespace {
+
+std::shared_ptr<minifi::Connection> createConnection(const std::string &name) {
+  std::shared_ptr<minifi::Configure> configuration = std::make_shared<minifi::Configure>();
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  content_repo->initialize(configuration);
+  std::shared_ptr<core::Repository> flow_repo = std::make_shared<TestRepository>();
+  return std::make_shared<minifi::Connection>(flow_repo, content_repo, name);
+}
+
+std::shared_ptr<core::FlowFile> createFlowFile(uint64_t size) {
+  std::map<std::string, std::string> attributes;
+  auto flow_file = std::make_shared<minifi::FlowFileRecord>(std::make_shared<TestRepository>(), std::make_shared<core::repository::VolatileContentRepository>(), attributes);
+  flow_file->setSize(size);
+  flow_file->setStoredToRepository(true);
+  return flow_file;
+}
+
+}  // namespace
+
+TEST_CASE("Connection keeps FIFO order and lock-free counters", "[Connection]") {
+  auto connection = createConnection("fifo");
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files;
+  for (int i = 0; i < 5; i++) {
+    flow_files.push_back(createFlowFile(10));
+    connection->put(flow_files.back());
+  }
+
+  REQUIRE(5 == connection->getQueueSize());
+  REQUIRE(50 == connection->getQueueDataSize());
+  REQUIRE_FALSE(connection->isEmpty());
+
+  connection->setMaxQueueSize(5);
+  REQUIRE(connection->isFull());
+  connection->setMaxQueueSize(0);
+  connection->setMaxQueueDataSize(51);
+  REQUIRE_FALSE(connection->isFull());
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  for (int i = 0; i < 5; i++) {
+    REQUIRE(flow_files[i] == connection->poll(expired));
+  }
+  REQUIRE(nullptr == connection->poll(expired));
+  REQUIRE(expired.empty());
+  REQUIRE(connection->isEmpty());
+  REQUIRE(0 == connection->getQueueDataSize());
+}
+
+TEST_CASE("Connection does not let penalized flow files block the queue", "[Connection]") {
+  auto connection = createConnection("penalty");
+  auto penalized = createFlowFile(1);
+  penalized->setPenaltyExpiration(getTimeMillis() + 60000);
+  auto ready = createFlowFile(1);
+  connection->put(penalized);
+  connection->put(ready);
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(ready == connection->poll(expired));
+  REQUIRE(nullptr == connection->poll(expired));
+  REQUIRE(1 == connection->getQueueSize());
+  REQUIRE(1 == connection->getPenalizedQueueSize());
+  REQUIRE(1 == connection->getQueueDataSize());
+
+  connection->drain();
+  REQUIRE(connection->isEmpty());
+  REQUIRE(0 == connection->getPenalizedQueueSize());
+  REQUIRE(0 == connection->getQueueDataSize());
+}
+
+TEST_CASE("Connection releases flow files when their penalty expires", "[Connection]") {
+  auto connection = createConnection("penalty_release");
+  connection->setPrioritizer(std::make_shared<core::PriorityAttributePrioritizer>());
+  auto penalized = createFlowFile(1);
+  penalized->setAttribute(core::PriorityAttributePrioritizer::PRIORITY_ATTRIBUTE, "1");
+  penalized->setPenaltyExpiration(getTimeMillis() + 100);
+  auto ready = createFlowFile(1);
+  ready->setAttribute(core::PriorityAttributePrioritizer::PRIORITY_ATTRIBUTE, "2");
+  connection->put(penalized);
+  connection->put(ready);
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(ready == connection->poll(expired));
+  REQUIRE(nullptr == connection->poll(expired));
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  REQUIRE(penalized == connection->poll(expired));
+  REQUIRE(connection->isEmpty());
+  REQUIRE(0 == connection->getPenalizedQueueSize());
+}
+
+TEST_CASE("Connection orders flow files with the prioritizer", "[Connection]") {
+  auto connection = createConnection("prioritized");
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files;
+  for (const auto &priority : {"3", "1", "", "2", "1"}) {
+    auto flow_file = createFlowFile(1);
+    if (*priority) {
+      flow_file->setAttribute(core::PriorityAttributePrioritizer::PRIORITY_ATTRIBUTE, priority);
+    }
+    flow_files.push_back(flow_file);
+  }
+
+  SECTION("set before the flow files are queued") {
+    connection->setPrioritizer(core::createFlowFilePrioritizer("org.apache.nifi.prioritizer.PriorityAttributePrioritizer"));
+    connection->multiPut(flow_files);
+  }
+  SECTION("set after the flow files are queued") {
+    connection->multiPut(flow_files);
+    connection->setPrioritizer(core::createFlowFilePrioritizer("PriorityAttributePrioritizer"));
+  }
+
+  std::vector<std::shared_ptr<core::FlowFile>> flows;
+  std::vector<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(5 == connection->pollBatch(flows, 10, 0, expired));
+  // equal priorities keep their insertion order, flow files without priority come last
+  REQUIRE(flow_files[1] == flows[0]);
+  REQUIRE(flow_files[4] == flows[1]);
+  REQUIRE(flow_files[3] == flows[2]);
+  REQUIRE(flow_files[0] == flows[3]);
+  REQUIRE(flow_files[2] == flows[4]);
+  REQUIRE(connection->isEmpty());
+  REQUIRE(0 == connection->getQueueDataSize());
+}
+
+TEST_CASE("Connection polls flow files in batches", "[Connection]") {
+  auto connection = createConnection("batch");
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files;
+  for (int i = 0; i < 10; i++) {
+    flow_files.push_back(createFlowFile(10));
+  }
+  connection->multiPut(flow_files);
+  REQUIRE(10 == connection->getQueueSize());
+
+  std::vector<std::shared_ptr<core::FlowFile>> flows;
+  std::vector<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(4 == connection->pollBatch(flows, 4, 0, expired));
+  REQUIRE(4 == flows.size());
+  REQUIRE(std::equal(flows.begin(), flows.end(), flow_files.begin()));
+  REQUIRE(6 == connection->getQueueSize());
+  REQUIRE(60 == connection->getQueueDataSize());
+
+  // the byte limit stops the batch, but never before the first flow file
+  REQUIRE(2 == connection->pollBatch(flows, 10, 25, expired));
+  REQUIRE(1 == connection->pollBatch(flows, 10, 5, expired));
+  REQUIRE(7 == flows.size());
+  REQUIRE(std::equal(flows.begin(), flows.end(), flow_files.begin()));
+
+  REQUIRE(3 == connection->pollBatch(flows, 10, 0, expired));
+  REQUIRE(connection->isEmpty());
+  REQUIRE(0 == connection->getQueueDataSize());
+  REQUIRE(expired.empty());
+}
+
+TEST_CASE("Connection batch poll handles expired and penalized flow files", "[Connection]") {
+  auto connection = createConnection("batch_penalty");
+  connection->setFlowExpirationDuration(1000);
+
+  auto expired_flow = createFlowFile(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  auto penalized = createFlowFile(1);
+  penalized->setPenaltyExpiration(getTimeMillis() + 60000);
+  auto ready1 = createFlowFile(1);
+  auto ready2 = createFlowFile(1);
+  connection->put(expired_flow);
+  connection->put(penalized);
+  connection->put(ready1);
+  connection->put(ready2);
+
+  std::vector<std::shared_ptr<core::FlowFile>> flows;
+  std::vector<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(2 == connection->pollBatch(flows, 10, 0, expired));
+  REQUIRE(ready1 == flows[0]);
+  REQUIRE(ready2 == flows[1]);
+  REQUIRE(1 == expired.size());
+  REQUIRE(expired_flow == expired[0]);
+
+  // the penalized flow file was kept in the queue
+  REQUIRE(1 == connection->getQueueSize());
+  REQUIRE(1 == connection->getQueueDataSize());
+  REQUIRE(1 == connection->getPenalizedQueueSize());
+  REQUIRE(0 == connection->pollBatch(flows, 10, 0, expired));
+}
+
+TEST_CASE("Connection contention benchmark", "[.][benchmark]") {
+  const int items_per_producer = 100000;
+  const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+  LogTestController::getInstance().setWarn<minifi::Connection>();
+
+  for (unsigned workers = 1; workers <= threads / 2; workers *= 2) {
+    auto connection = createConnection("benchmark");
+    auto flow_file = createFlowFile(1);
+    std::atomic<uint64_t> consumed(0);
+    std::atomic<bool> done(false);
+    const uint64_t total = workers * items_per_producer;
+
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned p = 0; p < workers; p++) {
+      pool.emplace_back([&]() {
+        for (int i = 0; i < items_per_producer; i++) {
+          connection->put(flow_file);
+        }
+      });
+    }
+    for (unsigned c = 0; c < workers; c++) {
+      pool.emplace_back([&]() {
+        std::set<std::shared_ptr<core::FlowFile>> expired;
+        while (consumed < total) {
+          if (connection->poll(expired)) {
+            consumed++;
+          }
+        }
+      });
+    }
+    // the schedulers keep asking whether there is work to do
+    std::thread scheduler([&]() {
+      while (!done) {
+        connection->isWorkAvailable();
+        connection->isFull();
+      }
+    });
+    for (auto &t : pool) {
+      t.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    done = true;
+    scheduler.join();
+    std::cout << workers << " producer(s) / " << workers << " consumer(s): " << static_cast<uint64_t>(total / (elapsed / 1000000.0)) << " flow files/s" << std::endl;
+  }
+}
@@ -0,0 +1,269 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../TestBase.h"
+#include "ResourceClaim.h"
+#include "core/repository/FileSystemRepository.h"
+#include "properties/Configure.h"
+
+namespace {
+
+std::shared_ptr<core::ContentRepository> createContentRepository(TestController &testController) {
+  char format[] = "/tmp/content.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(configuration));
+  return content_repo;
+}
+
+std::shared_ptr<minifi::ResourceClaim> writeContent(const std::shared_ptr<core::ContentRepository> &content_repo, const std::string &content) {
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  auto stream = content_repo->write(claim);
+  REQUIRE(static_cast<int>(content.size()) == stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())), static_cast<int>(content.size())));
+  stream->closeStream();
+  return claim;
+}
+
+std::string readContent(const std::shared_ptr<core::ContentRepository> &content_repo, const std::shared_ptr<minifi::ResourceClaim> &claim, uint64_t offset = 0) {
+  auto stream = content_repo->read(claim);
+  REQUIRE(nullptr != stream);
+  stream->seek(offset);
+  std::string content;
+  uint8_t buffer[3];
+  int ret;
+  // small reads, which end within the ranges
+  while ((ret = stream->readData(buffer, sizeof(buffer))) > 0) {
+    content.append(reinterpret_cast<char*>(buffer), ret);
+  }
+  REQUIRE(0 == ret);
+  return content;
+}
+
+}  // namespace
+
+TEST_CASE("Composite claims refer to the content of other claims", "[ContentRepository]") {
+  TestController testController;
+  auto content_repo = createContentRepository(testController);
+  auto first = writeContent(content_repo, "first content");
+  auto second = writeContent(content_repo, "second content");
+  auto delimiters = writeContent(content_repo, "[,]");
+  first->increaseFlowFileRecordOwnedCount();
+  second->increaseFlowFileRecordOwnedCount();
+
+  auto composite = std::make_shared<minifi::ResourceClaim>(content_repo);
+  REQUIRE(content_repo->createComposite(composite, {
+    core::ContentRange{delimiters, 0, 1}, core::ContentRange{first, 6, 7}, core::ContentRange{delimiters, 1, 1},
+    core::ContentRange{second, 0, 6}, core::ContentRange{delimiters, 2, 1}}));
+  REQUIRE(core::ContentRepository::isComposite(composite));
+  REQUIRE_FALSE(core::ContentRepository::isComposite(first));
+  REQUIRE(content_repo->exists(composite));
+  REQUIRE(16 == content_repo->read(composite)->getSize());
+  REQUIRE("[content,second]" == readContent(content_repo, composite));
+  REQUIRE("second]" == readContent(content_repo, composite, 9));
+  REQUIRE(2 == first->getFlowFileRecordOwnedCount());
+  // counted once per range
+  REQUIRE(3 == delimiters->getFlowFileRecordOwnedCount());
+
+  // ranges of composite claims are resolved to the claims they refer to
+  auto nested = std::make_shared<minifi::ResourceClaim>(content_repo);
+  REQUIRE(content_repo->createComposite(nested, {core::ContentRange{composite, 4, 8}, core::ContentRange{first, 0, 5}}));
+  REQUIRE("tent,secfirst" == readContent(content_repo, nested));
+  REQUIRE(4 == first->getFlowFileRecordOwnedCount());
+
+  // the content of the claims referred to is kept until the last composite claim is removed
+  first->decreaseFlowFileRecordOwnedCount();
+  second->decreaseFlowFileRecordOwnedCount();
+  REQUIRE_FALSE(content_repo->removeIfOrphaned(first));
+  REQUIRE(content_repo->removeIfOrphaned(composite));
+  REQUIRE_FALSE(content_repo->exists(composite));
+  REQUIRE(content_repo->exists(first));
+  REQUIRE(content_repo->exists(second));
+  REQUIRE("tent,secfirst" == readContent(content_repo, nested));
+  REQUIRE(content_repo->remove(nested));
+  REQUIRE_FALSE(content_repo->exists(first));
+  REQUIRE_FALSE(content_repo->exists(second));
+  REQUIRE_FALSE(content_repo->exists(delimiters));
+}
+
+TEST_CASE("Composite claims are restored after a restart", "[ContentRepository]") {
+  TestController testController;
+  char format[] = "/tmp/content.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  std::string path;
+  std::string part_path;
+  {
+    std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+    REQUIRE(content_repo->initialize(configuration));
+    auto part = writeContent(content_repo, "part of the content");
+    auto composite = std::make_shared<minifi::ResourceClaim>(content_repo);
+    REQUIRE(content_repo->createComposite(composite, {core::ContentRange{part, 12, 7}, core::ContentRange{part, 0, 4}}));
+    path = composite->getContentFullPath();
+    part_path = part->getContentFullPath();
+  }
+
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(configuration));
+  auto composite = std::make_shared<minifi::ResourceClaim>(path, content_repo, true);
+  auto part = std::make_shared<minifi::ResourceClaim>(part_path, content_repo, true);
+  // e.g. by the Flow File restored with it
+  composite->increaseFlowFileRecordOwnedCount();
+  REQUIRE(2 == part->getFlowFileRecordOwnedCount());
+  REQUIRE("contentpart" == readContent(content_repo, composite));
+  composite->decreaseFlowFileRecordOwnedCount();
+  REQUIRE(content_repo->removeIfOrphaned(composite));
+  REQUIRE_FALSE(content_repo->exists(part));
+}
+
+TEST_CASE("Content is mapped in one piece", "[ContentRepository]") {
+  TestController testController;
+  auto content_repo = createContentRepository(testController);
+  auto claim = writeContent(content_repo, "first content");
+
+  auto buffer = content_repo->map(claim, 6, 7);
+  REQUIRE(nullptr != buffer);
+#ifndef WIN32
+  REQUIRE(buffer->isMapped());
+#endif
+  REQUIRE("content" == std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()));
+  // ranges are cut at the end of the content
+  buffer = content_repo->map(claim, 6, 100);
+  REQUIRE("content" == std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()));
+  REQUIRE(0 == content_repo->map(claim, 20, 5)->size());
+  REQUIRE(0 == content_repo->map(claim, 0, 0)->size());
+
+  // composite claims are not mapped, their content is read through their stream instead of being copied
+  auto composite = std::make_shared<minifi::ResourceClaim>(content_repo);
+  REQUIRE(content_repo->createComposite(composite, {core::ContentRange{claim, 6, 7}, core::ContentRange{claim, 0, 5}}));
+  REQUIRE(nullptr == content_repo->map(composite, 2, 100));
+
+  // mapped content stays readable after the claim is removed
+  buffer = content_repo->map(claim, 0, 5);
+  REQUIRE(content_repo->remove(composite));
+  REQUIRE_FALSE(content_repo->exists(claim));
+  REQUIRE("first" == std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()));
+}
+
+TEST_CASE("Claims of the same content share their count", "[ContentRepository]") {
+  TestController testController;
+  auto content_repo = createContentRepository(testController);
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  // e.g. created for another Flow File recovered from the repository
+  auto same_content = std::make_shared<minifi::ResourceClaim>(claim->getContentFullPath(), content_repo);
+  auto other = std::make_shared<minifi::ResourceClaim>(content_repo);
+
+  REQUIRE(0 == content_repo->getStreamCount(claim));
+  claim->increaseFlowFileRecordOwnedCount();
+  same_content->increaseFlowFileRecordOwnedCount();
+  other->increaseFlowFileRecordOwnedCount();
+  REQUIRE(0 != claim->getClaimId());
+  REQUIRE(claim->getClaimId() == same_content->getClaimId());
+  REQUIRE(claim->getClaimId() != other->getClaimId());
+  REQUIRE(2 == claim->getFlowFileRecordOwnedCount());
+  REQUIRE(1 == other->getFlowFileRecordOwnedCount());
+
+  claim->decreaseFlowFileRecordOwnedCount();
+  REQUIRE(1 == same_content->getFlowFileRecordOwnedCount());
+  REQUIRE_FALSE(content_repo->removeIfOrphaned(claim));
+  same_content->decreaseFlowFileRecordOwnedCount();
+  REQUIRE(0 == claim->getFlowFileRecordOwnedCount());
+  REQUIRE(content_repo->removeIfOrphaned(claim));
+  REQUIRE(1 == other->getFlowFileRecordOwnedCount());
+
+  // claims still holding the ID of a dropped count start over
+  same_content->increaseFlowFileRecordOwnedCount();
+  REQUIRE(1 == claim->getFlowFileRecordOwnedCount());
+  REQUIRE(claim->getClaimId() == same_content->getClaimId());
+  claim->decreaseFlowFileRecordOwnedCount();
+  claim->decreaseFlowFileRecordOwnedCount();
+  REQUIRE(0 == same_content->getFlowFileRecordOwnedCount());
+}
+
+TEST_CASE("Claim counts stay consistent under concurrent updates", "[ContentRepository]") {
+  TestController testController;
+  auto content_repo = createContentRepository(testController);
+  std::vector<std::shared_ptr<minifi::ResourceClaim>> claims;
+  for (int i = 0; i < 16; i++) {
+    claims.push_back(std::make_shared<minifi::ResourceClaim>(content_repo));
+    claims.back()->increaseFlowFileRecordOwnedCount();
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&claims, &content_repo, t]() {
+      for (int i = 0; i < 10000; i++) {
+        const auto &claim = claims[(i + t) % claims.size()];
+        // a claim object per thread, like the claims of recovered Flow Files
+        auto copy = std::make_shared<minifi::ResourceClaim>(claim->getContentFullPath(), content_repo);
+        claim->increaseFlowFileRecordOwnedCount();
+        copy->increaseFlowFileRecordOwnedCount();
+        claim->decreaseFlowFileRecordOwnedCount();
+        copy->decreaseFlowFileRecordOwnedCount();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &claim : claims) {
+    REQUIRE(1 == claim->getFlowFileRecordOwnedCount());
+  }
+}
+
+TEST_CASE("Claim count contention benchmark", "[.][benchmark]") {
+  const int clones_per_thread = 200000;
+  const unsigned max_threads = std::max(2u, std::thread::hardware_concurrency());
+  TestController testController;
+  auto content_repo = createContentRepository(testController);
+
+  for (unsigned workers = 1; workers <= max_threads; workers *= 2) {
+    std::vector<std::shared_ptr<minifi::ResourceClaim>> claims;
+    for (unsigned i = 0; i < workers * 4; i++) {
+      claims.push_back(std::make_shared<minifi::ResourceClaim>(content_repo));
+    }
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned w = 0; w < workers; w++) {
+      pool.emplace_back([&claims, w]() {
+        // the claim updates of cloning a Flow File and dropping the clone, see FlowFileRecord::releaseClaim
+        for (int i = 0; i < clones_per_thread; i++) {
+          const auto &claim = claims[(w + i) % claims.size()];
+          claim->increaseFlowFileRecordOwnedCount();
+          claim->decreaseFlowFileRecordOwnedCount();
+          claim->getFlowFileRecordOwnedCount();
+        }
+      });
+    }
+    for (auto &thread : pool) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << workers << " threads: " << (static_cast<uint64_t>(workers) * clones_per_thread * 1000000 / std::max<int64_t>(elapsed, 1)) << " clones/s" << std::endl;
+  }
+}
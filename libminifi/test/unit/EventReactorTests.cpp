@@ -0,0 +1,229 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "io/EventReactor.h"
+#include "io/ServerSocket.h"
+
+namespace {
+
+// waits until predicate holds, for at most five seconds
+template<typename Predicate>
+bool waitFor(Predicate predicate) {
+  for (int i = 0; i < 500 && !predicate(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return predicate();
+}
+
+}  // namespace
+
+TEST_CASE("EventReactor notifies the handlers of readable sockets", "[EventReactor]") {
+  minifi::io::EventReactor reactor(2);
+  REQUIRE(2 == reactor.getThreadCount());
+  int fds[2];
+  REQUIRE(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  REQUIRE(minifi::io::EventReactor::setNonBlocking(fds[0]));
+
+  std::mutex mutex;
+  std::string received;
+  std::atomic<int> notifications{0};
+  auto handler = [&](uint32_t) {
+    char buffer[4];
+    ssize_t count;
+    // the handler is not notified again until the socket is drained
+    while ((count = read(fds[0], buffer, sizeof(buffer))) > 0) {
+      std::lock_guard<std::mutex> lock(mutex);
+      received.append(buffer, count);
+    }
+    notifications++;
+  };
+  REQUIRE(reactor.add(fds[0], minifi::io::EventReactor::READ, handler));
+  REQUIRE_FALSE(reactor.add(fds[0], minifi::io::EventReactor::READ, handler));
+
+  auto hasReceived = [&](const std::string &expected) {
+    return waitFor([&] {
+      std::lock_guard<std::mutex> lock(mutex);
+      return received == expected;
+    });
+  };
+  REQUIRE(11 == write(fds[1], "hello world", 11));
+  REQUIRE(hasReceived("hello world"));
+  REQUIRE(6 == write(fds[1], " again", 6));
+  REQUIRE(hasReceived("hello world again"));
+
+  reactor.remove(fds[0]);
+  const int removed_at = notifications;
+  REQUIRE(1 == write(fds[1], "n", 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(2 * REACTOR_POLL_PERIOD));
+  REQUIRE(removed_at == notifications);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST_CASE("EventReactor changes the events of sockets", "[EventReactor]") {
+  minifi::io::EventReactor reactor(1);
+  int fds[2];
+  REQUIRE(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  REQUIRE(minifi::io::EventReactor::setNonBlocking(fds[0]));
+
+  std::atomic<uint32_t> events_seen{0};
+  auto handler = [&](uint32_t events) {
+    char buffer[16];
+    while (read(fds[0], buffer, sizeof(buffer)) > 0) {
+    }
+    events_seen |= events;
+  };
+  auto hasSeen = [&](uint32_t events) {
+    return waitFor([&] { return (events_seen & events) != 0; });
+  };
+  REQUIRE(reactor.add(fds[0], minifi::io::EventReactor::READ, handler));
+  // an idle socket is writable, but only readability was asked for
+  std::this_thread::sleep_for(std::chrono::milliseconds(2 * REACTOR_POLL_PERIOD));
+  REQUIRE(0 == events_seen);
+  REQUIRE(reactor.modify(fds[0], minifi::io::EventReactor::READ | minifi::io::EventReactor::WRITE));
+  REQUIRE(hasSeen(minifi::io::EventReactor::WRITE));
+
+  close(fds[1]);
+  REQUIRE(hasSeen(minifi::io::EventReactor::HANGUP));
+  reactor.remove(fds[0]);
+  REQUIRE_FALSE(reactor.modify(fds[0], minifi::io::EventReactor::READ));
+  close(fds[0]);
+}
+
+TEST_CASE("EventReactor waits for running handlers when removing their sockets", "[EventReactor]") {
+  minifi::io::EventReactor reactor(1);
+  int fds[2];
+  REQUIRE(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+  std::atomic<bool> running{false};
+  std::atomic<bool> finished{false};
+  auto handler = [&](uint32_t) {
+    running = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    finished = true;
+  };
+  REQUIRE(reactor.add(fds[0], minifi::io::EventReactor::READ, handler));
+  REQUIRE(1 == write(fds[1], "x", 1));
+  const bool started = waitFor([&] { return running.load(); });
+  REQUIRE(started);
+  reactor.remove(fds[0]);
+  REQUIRE(finished);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST_CASE("EventReactor runs submitted tasks on its workers", "[EventReactor]") {
+  minifi::io::EventReactor reactor(1, 2);
+  REQUIRE(2 == reactor.getWorkerCount());
+  std::atomic<int> ran{0};
+  auto task = [&ran] { ran++; };
+  for (int i = 0; i < 10; i++) {
+    REQUIRE(reactor.submit(task));
+  }
+  const bool finished = waitFor([&] { return ran == 10; });
+  REQUIRE(finished);
+}
+
+TEST_CASE("EventReactor notifies paused sockets once the delay passed", "[EventReactor]") {
+  minifi::io::EventReactor reactor(1);
+  int fds[2];
+  REQUIRE(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+  std::atomic<int> notified{0};
+  auto handler = [&notified](uint32_t) { notified++; };
+  REQUIRE(reactor.add(fds[0], minifi::io::EventReactor::READ, handler));
+  reactor.pause(fds[0], 500);
+  REQUIRE(1 == write(fds[1], "x", 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  REQUIRE(0 == notified);
+  const bool resumed = waitFor([&] { return notified > 0; });
+  REQUIRE(resumed);
+  reactor.remove(fds[0]);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST_CASE("ServerSocket serves concurrent connections from the shared reactor", "[EventReactor]") {
+  auto socket_context = std::make_shared<minifi::io::SocketContext>(std::make_shared<minifi::Configure>());
+  minifi::io::ServerSocket server(socket_context, minifi::io::Socket::getMyHostName(), 9185, 100);
+  REQUIRE(-1 != server.initialize());
+  std::atomic<int> served{0};
+  server.registerCallback([] { return true; }, [&served](minifi::io::BaseStream *stream) {
+    uint32_t value;
+    if (stream->read(value) == 4) {
+      stream->write(value + 1);
+      served++;
+    }
+  });
+
+  // all connections are open at the same time
+  const uint32_t connections = 300;
+  std::vector<std::unique_ptr<minifi::io::Socket>> clients;
+  for (uint32_t i = 0; i < connections; i++) {
+    clients.emplace_back(new minifi::io::Socket(socket_context, minifi::io::Socket::getMyHostName(), 9185));
+    REQUIRE(-1 != clients.back()->initialize());
+  }
+  for (uint32_t i = 0; i < connections; i++) {
+    REQUIRE(4 == clients[i]->write(i));
+  }
+  for (uint32_t i = 0; i < connections; i++) {
+    uint32_t value = 0;
+    REQUIRE(4 == clients[i]->read(value));
+    REQUIRE(i + 1 == value);
+  }
+  REQUIRE(connections == static_cast<uint32_t>(served));
+}
+
+TEST_CASE("ServerSocket serves other connections while a client stalls", "[EventReactor]") {
+  auto socket_context = std::make_shared<minifi::io::SocketContext>(std::make_shared<minifi::Configure>());
+  minifi::io::ServerSocket server(socket_context, minifi::io::Socket::getMyHostName(), 9186, 100);
+  REQUIRE(-1 != server.initialize());
+  server.registerCallback([] { return true; }, [](minifi::io::BaseStream *stream) {
+    uint32_t value;
+    if (stream->read(value) == 4) {
+      stream->write(value + 1);
+    }
+  });
+
+  // sends part of its request only, leaving a worker waiting for the rest
+  minifi::io::Socket stalled(socket_context, minifi::io::Socket::getMyHostName(), 9186);
+  REQUIRE(-1 != stalled.initialize());
+  uint8_t partial[2] = { 0, 0 };
+  REQUIRE(2 == stalled.writeData(partial, 2));
+
+  for (uint32_t i = 0; i < 20; i++) {
+    minifi::io::Socket client(socket_context, minifi::io::Socket::getMyHostName(), 9186);
+    REQUIRE(-1 != client.initialize());
+    REQUIRE(4 == client.write(i));
+    uint32_t value = 0;
+    REQUIRE(4 == client.read(value));
+    REQUIRE(i + 1 == value);
+  }
+}
+#endif /* !WIN32 */
@@ -241,3 +241,33 @@ TEST_CASE("TestFileExceedSize", "[TestLoader]") {
 
   unlink(ss.str().c_str());
 }
+
+TEST_CASE("TestFileVectoredReadWrite", "[TestFiles]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  std::string path = dir + "/tstFile.ext";
+
+  std::string first = "tempFile";
+  std::string second = ", appended";
+  {
+    minifi::io::FileStream stream(path);
+    minifi::io::IoVec buffers[] = { { reinterpret_cast<uint8_t*>(&first[0]), first.size() }, { reinterpret_cast<uint8_t*>(&second[0]), second.size() } };
+    REQUIRE(18 == stream.writev(buffers, 2));
+    REQUIRE(18 == stream.getSize());
+  }
+
+  minifi::io::FileStream stream(path, 4, false);
+  std::string head(6, '\0');
+  std::string tail(20, 'x');
+  minifi::io::IoVec buffers[] = { { reinterpret_cast<uint8_t*>(&head[0]), head.size() }, { reinterpret_cast<uint8_t*>(&tail[0]), tail.size() } };
+  // the read ends at the end of the file
+  REQUIRE(14 == stream.readv(buffers, 2));
+  REQUIRE("File, " == head);
+  REQUIRE("appended" == tail.substr(0, 8));
+  REQUIRE(0 == stream.readv(buffers, 2));
+
+  stream.seek(0);
+  REQUIRE(6 == stream.readv(buffers, 1));
+  REQUIRE("tempFi" == head);
+}
@@ -0,0 +1,92 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../TestBase.h"
+#include "ProvenanceTestHelper.h"
+#include "FlowFileRecord.h"
+#include "core/FlowFilePrioritizer.h"
+#include "core/repository/VolatileContentRepository.h"
+
+namespace {
+
+std::shared_ptr<core::FlowFile> createFlowFile(const std::string &priority = "") {
+  std::map<std::string, std::string> attributes;
+  if (!priority.empty()) {
+    attributes[core::PriorityAttributePrioritizer::PRIORITY_ATTRIBUTE] = priority;
+  }
+  return std::make_shared<minifi::FlowFileRecord>(std::make_shared<TestRepository>(), std::make_shared<core::repository::VolatileContentRepository>(), attributes);
+}
+
+}  // namespace
+
+TEST_CASE("PriorityAttributePrioritizer ordering", "[FlowFilePrioritizer]") {
+  core::PriorityAttributePrioritizer prioritizer;
+  auto one = createFlowFile("1");
+  auto ten = createFlowFile("10");
+  auto negative = createFlowFile("-5");
+  auto text = createFlowFile("abc");
+  auto none = createFlowFile();
+
+  REQUIRE(prioritizer.prioritize(*one, *ten));
+  REQUIRE_FALSE(prioritizer.prioritize(*ten, *one));
+  REQUIRE(prioritizer.prioritize(*negative, *one));
+  REQUIRE(prioritizer.prioritize(*ten, *text));
+  REQUIRE(prioritizer.prioritize(*text, *none));
+  REQUIRE(prioritizer.prioritize(*one, *none));
+  REQUIRE_FALSE(prioritizer.prioritize(*none, *none));
+  REQUIRE_FALSE(prioritizer.prioritize(*one, *createFlowFile("1")));
+  REQUIRE(prioritizer.prioritize(*text, *createFlowFile("abd")));
+}
+
+TEST_CASE("Lineage start date prioritizers", "[FlowFilePrioritizer]") {
+  auto older = createFlowFile();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  auto newer = createFlowFile();
+  REQUIRE(older->getlineageStartDate() < newer->getlineageStartDate());
+
+  core::OldestFlowFileFirstPrioritizer oldest;
+  REQUIRE(oldest.prioritize(*older, *newer));
+  REQUIRE_FALSE(oldest.prioritize(*newer, *older));
+
+  core::NewestFlowFileFirstPrioritizer newest;
+  REQUIRE(newest.prioritize(*newer, *older));
+  REQUIRE_FALSE(newest.prioritize(*older, *newer));
+
+  core::FirstInFirstOutPrioritizer fifo;
+  REQUIRE(fifo.isFirstInFirstOut());
+  REQUIRE_FALSE(fifo.prioritize(*older, *newer));
+  REQUIRE_FALSE(fifo.prioritize(*newer, *older));
+}
+
+TEST_CASE("Create prioritizers by class name", "[FlowFilePrioritizer]") {
+  auto prioritizer = core::createFlowFilePrioritizer("org.apache.nifi.prioritizer.OldestFlowFileFirstPrioritizer");
+  REQUIRE(nullptr != std::dynamic_pointer_cast<core::OldestFlowFileFirstPrioritizer>(prioritizer));
+  prioritizer = core::createFlowFilePrioritizer("NewestFlowFileFirstPrioritizer");
+  REQUIRE(nullptr != std::dynamic_pointer_cast<core::NewestFlowFileFirstPrioritizer>(prioritizer));
+  prioritizer = core::createFlowFilePrioritizer("priorityattributeprioritizer");
+  REQUIRE(nullptr != std::dynamic_pointer_cast<core::PriorityAttributePrioritizer>(prioritizer));
+  prioritizer = core::createFlowFilePrioritizer("FirstInFirstOutPrioritizer");
+  REQUIRE(prioritizer->isFirstInFirstOut());
+  REQUIRE(nullptr == core::createFlowFilePrioritizer("UnknownPrioritizer"));
+}
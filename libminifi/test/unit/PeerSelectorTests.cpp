@@ -0,0 +1,119 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "sitetosite/PeerSelector.h"
+
+namespace sitetosite = org::apache::nifi::minifi::sitetosite;
+
+namespace {
+
+std::map<std::string, int> selectPeers(sitetosite::PeerSelector &selector, int count) {
+  std::map<std::string, int> selections;
+  for (int i = 0; i < count; i++) {
+    auto peer = selector.getNextPeer();
+    selections[peer->getHost()]++;
+  }
+  return selections;
+}
+
+std::vector<sitetosite::PeerStatus> createPeers(const std::vector<uint32_t> &flow_file_counts) {
+  std::vector<sitetosite::PeerStatus> peers;
+  for (size_t i = 0; i < flow_file_counts.size(); i++) {
+    peers.emplace_back(std::make_shared<sitetosite::Peer>("peer" + std::to_string(i), 8080), flow_file_counts[i], true);
+  }
+  return peers;
+}
+
+}  // namespace
+
+TEST_CASE("Peers without load are selected evenly", "[peerselector]") {
+  auto peers = createPeers({ 0, 0, 0, 0 });
+  sitetosite::PeerSelector selector;
+  selector.setPeers(peers, sitetosite::SEND);
+
+  auto selections = selectPeers(selector, 400);
+  REQUIRE(4U == selections.size());
+  for (const auto &selection : selections) {
+    REQUIRE(100 == selection.second);
+  }
+}
+
+TEST_CASE("Sending favors the least loaded peers", "[peerselector]") {
+  auto peers = createPeers({ 900, 100 });
+  sitetosite::PeerSelector selector;
+  selector.setPeers(peers, sitetosite::SEND);
+
+  auto selections = selectPeers(selector, 1000);
+  REQUIRE(selections["peer1"] > 8 * selections["peer0"]);
+  // the loaded peer still gets some of the data
+  REQUIRE(selections["peer0"] > 0);
+}
+
+TEST_CASE("Receiving favors the most loaded peers", "[peerselector]") {
+  auto peers = createPeers({ 900, 100 });
+  sitetosite::PeerSelector selector;
+  selector.setPeers(peers, sitetosite::RECEIVE);
+
+  auto selections = selectPeers(selector, 1000);
+  REQUIRE(selections["peer0"] > 8 * selections["peer1"]);
+  REQUIRE(selections["peer1"] > 0);
+}
+
+TEST_CASE("Weighted peers are interleaved", "[peerselector]") {
+  auto peers = createPeers({ 0, 50, 50 });
+  sitetosite::PeerSelector selector;
+  selector.setPeers(peers, sitetosite::SEND);
+
+  // peer0 has half of the weight, so it is never selected three times in a row
+  int consecutive = 0;
+  for (int i = 0; i < 100; i++) {
+    if (selector.getNextPeer()->getHost() == "peer0") {
+      REQUIRE(++consecutive < 3);
+    } else {
+      consecutive = 0;
+    }
+  }
+}
+
+TEST_CASE("Peers can be replaced", "[peerselector]") {
+  sitetosite::PeerSelector selector;
+  REQUIRE(selector.empty());
+  REQUIRE(nullptr == selector.getNextPeer());
+
+  auto peers = createPeers({ 10, 20, 30 });
+  selector.setPeers(peers, sitetosite::SEND);
+  REQUIRE(3U == selector.size());
+
+  peers = createPeers({ 10 });
+  selector.setPeers(peers, sitetosite::SEND);
+  REQUIRE(1U == selector.size());
+  REQUIRE("peer0" == selector.getNextPeer()->getHost());
+}
+
+TEST_CASE("Weights follow NiFi's peer selector", "[peerselector]") {
+  REQUIRE(64U == sitetosite::PeerSelector::calculateWeight(0, 0, 2, sitetosite::SEND));
+  REQUIRE(128U == sitetosite::PeerSelector::calculateWeight(10, 10, 1, sitetosite::SEND));
+  REQUIRE(96U == sitetosite::PeerSelector::calculateWeight(25, 100, 2, sitetosite::SEND));
+  REQUIRE(32U == sitetosite::PeerSelector::calculateWeight(25, 100, 2, sitetosite::RECEIVE));
+  // a peer is never left out entirely
+  REQUIRE(1U == sitetosite::PeerSelector::calculateWeight(100, 100, 2, sitetosite::SEND));
+}
@@ -0,0 +1,295 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../TestBase.h"
+#include "ResourceClaim.h"
+#include "core/repository/FileSystemRepository.h"
+#include "core/repository/SlabContentRepository.h"
+#include "properties/Configure.h"
+
+namespace {
+
+std::shared_ptr<minifi::Configure> createConfiguration(const std::string &dir, const std::string &container_size = "1 MB") {
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_slab_content_repository_directory_default, dir);
+  configuration->set(minifi::Configure::nifi_slab_content_repository_container_size, container_size);
+  // compaction is triggered by the tests
+  configuration->set(minifi::Configure::nifi_slab_content_repository_compaction_period, "1 hour");
+  return configuration;
+}
+
+void writeContent(const std::shared_ptr<core::ContentRepository> &repository, const std::shared_ptr<minifi::ResourceClaim> &claim, const std::string &content, bool append = false) {
+  auto stream = repository->write(claim, append);
+  REQUIRE(nullptr != stream);
+  std::vector<uint8_t> data(content.begin(), content.end());
+  REQUIRE(static_cast<int>(data.size()) == stream->writeData(data.data(), static_cast<int>(data.size())));
+  stream->closeStream();
+}
+
+std::string readContent(const std::shared_ptr<core::ContentRepository> &repository, const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  auto stream = repository->read(claim);
+  REQUIRE(nullptr != stream);
+  std::vector<uint8_t> data;
+  REQUIRE(static_cast<int>(stream->getSize()) == stream->readData(data, static_cast<int>(stream->getSize())));
+  return std::string(data.begin(), data.end());
+}
+
+}  // namespace
+
+TEST_CASE("SlabContentRepository writes, reads and removes claims", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/tmp/slab.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(createConfiguration(dir)));
+
+  auto first = std::make_shared<minifi::ResourceClaim>(repository);
+  auto second = std::make_shared<minifi::ResourceClaim>(repository);
+  auto empty = std::make_shared<minifi::ResourceClaim>(repository);
+  writeContent(repository, first, "first content");
+  writeContent(repository, second, "second content");
+  writeContent(repository, empty, "");
+  REQUIRE(repository->exists(first));
+  REQUIRE("first content" == readContent(repository, first));
+  REQUIRE("second content" == readContent(repository, second));
+  REQUIRE(readContent(repository, empty).empty());
+  // small claims share a container
+  REQUIRE(1 == repository->getContainerCount());
+
+  auto stream = repository->read(second);
+  stream->seek(7);
+  std::vector<uint8_t> data;
+  REQUIRE(7 == stream->readData(data, 100));
+  REQUIRE("content" == std::string(data.begin(), data.end()));
+
+  writeContent(repository, first, " appended", true);
+  REQUIRE("first content appended" == readContent(repository, first));
+  writeContent(repository, first, "rewritten");
+  REQUIRE("rewritten" == readContent(repository, first));
+
+  REQUIRE(repository->remove(first));
+  REQUIRE_FALSE(repository->exists(first));
+  REQUIRE(nullptr == repository->read(first));
+  REQUIRE_FALSE(repository->remove(first));
+  // a stream opened earlier still reads the removed content
+  stream->seek(0);
+  REQUIRE(14 == stream->readData(data, 100));
+  repository->stop();
+}
+
+TEST_CASE("SlabContentRepository maps the records of claims", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/tmp/slab.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(createConfiguration(dir)));
+
+  auto first = std::make_shared<minifi::ResourceClaim>(repository);
+  auto second = std::make_shared<minifi::ResourceClaim>(repository);
+  writeContent(repository, first, "first content");
+  writeContent(repository, second, "second content");
+  REQUIRE(1 == repository->getContainerCount());
+
+  // the range stays within the record of the claim
+  auto buffer = repository->map(second, 7, 100);
+  REQUIRE(nullptr != buffer);
+  REQUIRE("content" == std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()));
+  buffer = repository->map(first, 0, 100);
+  REQUIRE("first content" == std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()));
+  REQUIRE(0 == repository->map(first, 100, 5)->size());
+  REQUIRE(repository->remove(first));
+  REQUIRE(nullptr == repository->map(first, 0, 5));
+  REQUIRE("first content" == std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()));
+  repository->stop();
+}
+
+TEST_CASE("SlabContentRepository stores large claims", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/tmp/slab.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(createConfiguration(dir)));
+
+  std::string large;
+  for (int i = 0; large.size() < 3 * SLAB_CONTENT_REPOSITORY_STREAM_BUFFER_SIZE; i++) {
+    large += std::to_string(i) + ",";
+  }
+  auto claim = std::make_shared<minifi::ResourceClaim>(repository);
+  auto stream = repository->write(claim);
+  std::vector<uint8_t> data(large.begin(), large.end());
+  for (size_t offset = 0; offset < data.size(); offset += 1000) {
+    const int amount = static_cast<int>((std::min)(data.size() - offset, static_cast<size_t>(1000)));
+    REQUIRE(amount == stream->writeData(data.data() + offset, amount));
+  }
+  // content becomes visible when the stream is closed
+  REQUIRE_FALSE(repository->exists(claim));
+  stream->closeStream();
+  REQUIRE(large == readContent(repository, claim));
+
+  auto small = std::make_shared<minifi::ResourceClaim>(repository);
+  writeContent(repository, small, "small");
+  REQUIRE("small" == readContent(repository, small));
+  REQUIRE(large == readContent(repository, claim));
+  repository->stop();
+}
+
+TEST_CASE("SlabContentRepository recovers its claims after a restart", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/tmp/slab.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  std::vector<std::string> paths;
+  {
+    auto repository = std::make_shared<core::repository::SlabContentRepository>();
+    REQUIRE(repository->initialize(createConfiguration(dir)));
+    for (int i = 0; i < 10; i++) {
+      auto claim = std::make_shared<minifi::ResourceClaim>(repository);
+      writeContent(repository, claim, "content " + std::to_string(i));
+      paths.push_back(claim->getContentFullPath());
+    }
+    auto rewritten = std::make_shared<minifi::ResourceClaim>(paths[1], repository);
+    writeContent(repository, rewritten, "rewritten");
+    for (int i = 5; i < 10; i++) {
+      REQUIRE(repository->remove(std::make_shared<minifi::ResourceClaim>(paths[i], repository)));
+    }
+    repository->stop();
+  }
+
+  auto repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(createConfiguration(dir)));
+  for (int i = 0; i < 10; i++) {
+    auto claim = std::make_shared<minifi::ResourceClaim>(paths[i], repository);
+    if (i >= 5) {
+      REQUIRE_FALSE(repository->exists(claim));
+    } else if (i == 1) {
+      REQUIRE("rewritten" == readContent(repository, claim));
+    } else {
+      REQUIRE("content " + std::to_string(i) == readContent(repository, claim));
+    }
+  }
+
+  // recovered containers are not appended to, they are merged into new ones
+  auto claim = std::make_shared<minifi::ResourceClaim>(repository);
+  writeContent(repository, claim, "after restart");
+  REQUIRE(2 == repository->getContainerCount());
+  REQUIRE(1 == repository->compact());
+  REQUIRE(1 == repository->getContainerCount());
+  REQUIRE("after restart" == readContent(repository, claim));
+  REQUIRE("content 0" == readContent(repository, std::make_shared<minifi::ResourceClaim>(paths[0], repository)));
+  repository->stop();
+
+  // the removed claims stay removed once their container is compacted away
+  repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(createConfiguration(dir)));
+  REQUIRE_FALSE(repository->exists(std::make_shared<minifi::ResourceClaim>(paths[7], repository)));
+  REQUIRE("rewritten" == readContent(repository, std::make_shared<minifi::ResourceClaim>(paths[1], repository)));
+  REQUIRE("after restart" == readContent(repository, claim));
+  repository->stop();
+}
+
+TEST_CASE("SlabContentRepository compacts sparse containers", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/tmp/slab.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(createConfiguration(dir, "64 KB")));
+
+  const std::string content(1000, 'x');
+  std::vector<std::shared_ptr<minifi::ResourceClaim>> claims;
+  for (int i = 0; i < 300; i++) {
+    claims.push_back(std::make_shared<minifi::ResourceClaim>(repository));
+    writeContent(repository, claims.back(), content + std::to_string(i));
+  }
+  const size_t containers = repository->getContainerCount();
+  REQUIRE(containers >= 4);
+  REQUIRE(0 == repository->compact());
+
+  // keep every tenth claim
+  for (size_t i = 0; i < claims.size(); i++) {
+    if (i % 10 != 0) {
+      REQUIRE(repository->remove(claims[i]));
+    }
+  }
+  REQUIRE(repository->compact() >= containers - 1);
+  REQUIRE(repository->getContainerCount() < containers);
+  for (size_t i = 0; i < claims.size(); i += 10) {
+    REQUIRE(content + std::to_string(i) == readContent(repository, claims[i]));
+  }
+  repository->stop();
+
+  repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(createConfiguration(dir, "64 KB")));
+  for (size_t i = 0; i < claims.size(); i++) {
+    if (i % 10 != 0) {
+      REQUIRE_FALSE(repository->exists(claims[i]));
+    } else {
+      REQUIRE(content + std::to_string(i) == readContent(repository, claims[i]));
+    }
+  }
+  repository->stop();
+}
+
+TEST_CASE("Content repository small claim benchmark", "[.][benchmark]") {
+  const int claims = 20000;
+  LogTestController::getInstance().setWarn<core::repository::SlabContentRepository>();
+  TestController testController;
+  const std::vector<uint8_t> content(512, 'x');
+  for (const std::string name : {"FileSystemRepository", "SlabContentRepository"}) {
+    char format[] = "/var/tmp/slab.XXXXXX";
+    auto dir = testController.createTempDirectory(format);
+    std::shared_ptr<core::ContentRepository> repository;
+    if (name == "FileSystemRepository") {
+      repository = std::make_shared<core::repository::FileSystemRepository>();
+    } else {
+      repository = std::make_shared<core::repository::SlabContentRepository>();
+    }
+    REQUIRE(repository->initialize(createConfiguration(dir)));
+
+    std::vector<std::shared_ptr<minifi::ResourceClaim>> written;
+    written.reserve(claims);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < claims; i++) {
+      written.push_back(std::make_shared<minifi::ResourceClaim>(repository));
+      auto stream = repository->write(written.back());
+      stream->writeData(const_cast<uint8_t*>(content.data()), static_cast<int>(content.size()));
+      stream->closeStream();
+    }
+    auto write_done = std::chrono::steady_clock::now();
+    std::vector<uint8_t> buffer(content.size());
+    for (const auto &claim : written) {
+      auto stream = repository->read(claim);
+      REQUIRE(static_cast<int>(content.size()) == stream->readData(buffer.data(), static_cast<int>(buffer.size())));
+    }
+    auto read_done = std::chrono::steady_clock::now();
+    for (const auto &claim : written) {
+      repository->remove(claim);
+    }
+    auto remove_done = std::chrono::steady_clock::now();
+    auto perSecond = [claims](std::chrono::steady_clock::duration elapsed) {
+      return claims * 1000 / (std::max)(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()), static_cast<int64_t>(1));
+    };
+    std::cout << name << ": " << perSecond(write_done - start) << " writes/s, " << perSecond(read_done - write_done) << " reads/s, " << perSecond(remove_done - read_done) << " removes/s"
+              << std::endl;
+    repository->stop();
+  }
+}
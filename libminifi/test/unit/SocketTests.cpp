@@ -76,6 +76,34 @@ TEST_CASE("TestSocketWriteTest2", "[TestSocket3]") {
   client.closeStream();
 }
 
+TEST_CASE("TestSocketVectoredWrite", "[TestSocket3]") {
+  std::shared_ptr<org::apache::nifi::minifi::io::SocketContext> socket_context = std::make_shared<org::apache::nifi::minifi::io::SocketContext>(std::make_shared<minifi::Configure>());
+  org::apache::nifi::minifi::io::ServerSocket server(socket_context, Sockets::getMyHostName(), 9184, 1);
+
+  REQUIRE(-1 != server.initialize());
+
+  org::apache::nifi::minifi::io::Socket client(socket_context, Sockets::getMyHostName(), 9184);
+
+  REQUIRE(-1 != client.initialize());
+
+  std::string header = "header";
+  std::string payload = "payload";
+  org::apache::nifi::minifi::io::IoVec writes[] = { { reinterpret_cast<uint8_t*>(&header[0]), header.size() }, { reinterpret_cast<uint8_t*>(&payload[0]), payload.size() } };
+  REQUIRE(13 == client.writev(writes, 2));
+
+  // scattered into buffers of other sizes
+  std::string first(3, '\0');
+  std::string second(10, '\0');
+  org::apache::nifi::minifi::io::IoVec reads[] = { { reinterpret_cast<uint8_t*>(&first[0]), first.size() }, { reinterpret_cast<uint8_t*>(&second[0]), second.size() } };
+  REQUIRE(13 == server.readv(reads, 2));
+  REQUIRE("hea" == first);
+  REQUIRE("derpayload" == second);
+
+  server.closeStream();
+
+  client.closeStream();
+}
+
 TEST_CASE("TestGetHostName", "[TestSocket4]") {
   REQUIRE(Sockets::getMyHostName().length() > 0);
 }
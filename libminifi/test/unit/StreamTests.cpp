@@ -73,3 +73,21 @@ TEST_CASE("TestRead4", "[testread]") {
   base->read(c);
   REQUIRE(c == 8);
 }
+
+TEST_CASE("TestVectoredReadWrite", "[testread]") {
+  auto base = std::make_shared<minifi::io::BaseStream>();
+  std::string first = "first";
+  std::string second = "second";
+  base->reserve(first.size() + second.size());
+  minifi::io::IoVec writes[] = { { reinterpret_cast<uint8_t*>(&first[0]), first.size() }, { nullptr, 0 }, { reinterpret_cast<uint8_t*>(&second[0]), second.size() } };
+  REQUIRE(11 == base->writev(writes, 3));
+  REQUIRE(11 == base->getSize());
+
+  // reads span the written buffers
+  std::string head(3, '\0');
+  std::string tail(8, '\0');
+  minifi::io::IoVec reads[] = { { reinterpret_cast<uint8_t*>(&head[0]), head.size() }, { reinterpret_cast<uint8_t*>(&tail[0]), tail.size() } };
+  REQUIRE(11 == base->readv(reads, 2));
+  REQUIRE("fir" == head);
+  REQUIRE("stsecond" == tail);
+}
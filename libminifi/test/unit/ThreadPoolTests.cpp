@@ -16,10 +16,16 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <iostream>
 #include <utility>
 #include <future>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 #include "../TestBase.h"
+#include "utils/GeneralUtils.h"
 #include "utils/ThreadPool.h"
 
 bool function() {
@@ -95,3 +101,131 @@ TEST_CASE("ThreadPoolTest2", "[TPT2]") {
   fut.wait();
   REQUIRE(20 == fut.get());
 }
+
+TEST_CASE("Delayed tasks are rescheduled through the timer wheel", "[TPT3]") {
+  counter = 0;
+  utils::ThreadPool<int> pool(5);
+  bool work_stealing = false;
+  SECTION("Shared worker queue") {
+  }
+  SECTION("Work stealing") {
+    work_stealing = true;
+  }
+  pool.setWorkStealing(work_stealing);
+  REQUIRE(work_stealing == pool.isWorkStealing());
+  std::function<int()> f_ex = counterFunction;
+  std::unique_ptr<utils::AfterExecute<int>> after_execute = std::unique_ptr<utils::AfterExecute<int>>(new WorkerNumberExecutions(20));
+  utils::Worker<int> functor(f_ex, "id", std::move(after_execute));
+  pool.start();
+  std::future<int> fut;
+  REQUIRE(true == pool.execute(std::move(functor), fut));
+  fut.wait();
+  REQUIRE(20 == fut.get());
+  // every run but the first one was delayed
+  REQUIRE(19 == pool.getTimerLateness()->getExpiredCount());
+  REQUIRE(pool.getTimerLateness()->getMax() >= pool.getTimerLateness()->getAverage());
+}
+
+TEST_CASE("Work stealing pool runs the tasks queued behind a busy worker", "[TPT4]") {
+  utils::ThreadPool<bool> pool(2);
+  pool.setWorkStealing(true);
+  std::atomic<bool> release(false);
+  std::function<bool()> blocking = [&release]() {
+    while (!release) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  };
+  std::function<bool()> quick = function;
+  std::future<bool> blocking_future;
+  std::future<bool> other_future;
+  std::future<bool> queued_future;
+  // the first and third task land in the same worker queue
+  pool.execute(utils::Worker<bool>(blocking, "blocking"), blocking_future);
+  pool.execute(utils::Worker<bool>(quick, "other"), other_future);
+  pool.execute(utils::Worker<bool>(quick, "queued"), queued_future);
+  pool.start();
+
+  REQUIRE(std::future_status::ready == queued_future.wait_for(std::chrono::seconds(5)));
+  REQUIRE(std::future_status::ready == other_future.wait_for(std::chrono::seconds(5)));
+  release = true;
+  REQUIRE(true == blocking_future.get());
+}
+
+namespace {
+
+class RescheduleMonitor : public utils::AfterExecute<utils::TaskRescheduleInfo> {
+ public:
+  bool isFinished(const utils::TaskRescheduleInfo &result) override {
+    wait_time_ = result.wait_time_;
+    return result.finished_;
+  }
+  bool isCancelled(const utils::TaskRescheduleInfo &result) override {
+    return false;
+  }
+  std::chrono::milliseconds wait_time() override {
+    return wait_time_;
+  }
+
+ private:
+  std::chrono::milliseconds wait_time_{0};
+};
+
+// simulates the triggers of many processors scheduled by the timer driven agent
+void benchmarkTriggers(bool work_stealing, int processors, std::chrono::milliseconds period) {
+  const std::chrono::seconds duration(3);
+  struct Trigger {
+    std::chrono::steady_clock::time_point due;
+    std::vector<int64_t> lateness_us;
+  };
+  utils::ThreadPool<utils::TaskRescheduleInfo> pool(std::max(2u, std::thread::hardware_concurrency()));
+  pool.setWorkStealing(work_stealing);
+  std::atomic<bool> stop(false);
+  std::vector<std::shared_ptr<Trigger>> triggers;
+  std::vector<std::future<utils::TaskRescheduleInfo>> futures;
+  pool.start();
+  for (int i = 0; i < processors; i++) {
+    auto trigger = std::make_shared<Trigger>();
+    trigger->due = std::chrono::steady_clock::now();
+    std::function<utils::TaskRescheduleInfo()> f_ex = [trigger, &stop, period]() {
+      auto now = std::chrono::steady_clock::now();
+      trigger->lateness_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(now - trigger->due).count());
+      if (stop) {
+        return utils::TaskRescheduleInfo::Done();
+      }
+      trigger->due += period;
+      return utils::TaskRescheduleInfo::RetryIn(period);
+    };
+    std::future<utils::TaskRescheduleInfo> future;
+    pool.execute(utils::Worker<utils::TaskRescheduleInfo>(f_ex, "trigger" + std::to_string(i), utils::make_unique<RescheduleMonitor>()), future);
+    triggers.push_back(trigger);
+    futures.push_back(std::move(future));
+  }
+  std::this_thread::sleep_for(duration);
+  stop = true;
+  for (auto &future : futures) {
+    future.wait();
+  }
+  pool.shutdown();
+
+  std::vector<int64_t> lateness;
+  for (const auto &trigger : triggers) {
+    lateness.insert(lateness.end(), trigger->lateness_us.begin(), trigger->lateness_us.end());
+  }
+  std::sort(lateness.begin(), lateness.end());
+  auto percentile = [&lateness](double p) {
+    return lateness[static_cast<size_t>(p * (lateness.size() - 1))];
+  };
+  std::cout << (work_stealing ? "work stealing" : "shared queue ") << " " << processors << " processors every " << period.count() << " ms: "
+            << lateness.size() / duration.count() << " triggers/s, lateness p50 " << percentile(0.5) << " us, p99 " << percentile(0.99)
+            << " us, p99.9 " << percentile(0.999) << " us, max " << lateness.back() << " us" << std::endl;
+}
+
+}  // namespace
+
+TEST_CASE("Thread pool trigger throughput benchmark", "[.][benchmark]") {
+  for (int processors : {100, 1000, 5000}) {
+    benchmarkTriggers(false, processors, std::chrono::milliseconds(1));
+    benchmarkTriggers(true, processors, std::chrono::milliseconds(1));
+  }
+}
@@ -0,0 +1,99 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "../TestBase.h"
+#include "utils/TimerWheel.h"
+
+using std::chrono::milliseconds;
+using std::chrono::hours;
+
+TEST_CASE("TimerWheel expires timers in due order", "[TimerWheel]") {
+  auto lateness = std::make_shared<utils::TimerLateness>();
+  utils::TimerWheel<int> wheel(lateness);
+  const auto base = std::chrono::steady_clock::now();
+  wheel.schedule(3, base + milliseconds(300));
+  wheel.schedule(1, base + milliseconds(10));
+  wheel.schedule(2, base + milliseconds(100));
+  wheel.schedule(4, base + hours(2));
+  REQUIRE(4 == wheel.size());
+  REQUIRE(wheel.nextExpiration() <= base + milliseconds(64));
+
+  std::vector<int> expired;
+  auto collect = [&expired](int &&value) {
+    expired.push_back(value);
+  };
+  REQUIRE(0 == wheel.expire(base + milliseconds(5), collect));
+  REQUIRE(2 == wheel.expire(base + milliseconds(150), collect));
+  REQUIRE(1 == wheel.expire(base + hours(1), collect));
+  REQUIRE(1 == wheel.expire(base + hours(3), collect));
+  REQUIRE((std::vector<int>{1, 2, 3, 4}) == expired);
+  REQUIRE(wheel.empty());
+  REQUIRE(std::chrono::steady_clock::time_point::max() == wheel.nextExpiration());
+
+  REQUIRE(4 == lateness->getExpiredCount());
+  REQUIRE(lateness->getMax() >= hours(1));
+}
+
+TEST_CASE("TimerWheel never expires timers early", "[TimerWheel]") {
+  utils::TimerWheel<std::chrono::steady_clock::time_point> wheel;
+  const auto base = std::chrono::steady_clock::now();
+  std::srand(42);
+  std::multimap<std::chrono::steady_clock::time_point, bool> pending;
+  for (int i = 0; i < 10000; i++) {
+    // spread the timers over every level of the wheel, including beyond its range
+    auto due = base + milliseconds(std::rand() % (1 << (i % 28)));
+    wheel.schedule(std::move(due), due);
+    pending.emplace(due, true);
+  }
+
+  auto now = base;
+  size_t total = 0;
+  while (!pending.empty()) {
+    now += milliseconds(1 + std::rand() % 50000);
+    total += wheel.expire(now, [&](std::chrono::steady_clock::time_point &&due) {
+      REQUIRE(due <= now);
+      pending.erase(pending.find(due));
+    });
+    // everything that is due has expired and the next expiration is at most a tick late
+    REQUIRE((pending.empty() || pending.begin()->first + milliseconds(1) > now));
+    REQUIRE((pending.empty() || wheel.nextExpiration() <= pending.begin()->first + milliseconds(1)));
+    REQUIRE(pending.size() == wheel.size());
+  }
+  REQUIRE(10000 == total);
+}
+
+TEST_CASE("TimerWheel clear drops every timer", "[TimerWheel]") {
+  utils::TimerWheel<std::shared_ptr<int>> wheel;
+  const auto base = std::chrono::steady_clock::now();
+  auto value = std::make_shared<int>(5);
+  for (int i = 0; i < 100; i++) {
+    wheel.schedule(std::shared_ptr<int>(value), base + milliseconds(i * 1000));
+  }
+  REQUIRE(101 == value.use_count());
+  wheel.clear();
+  REQUIRE(wheel.empty());
+  REQUIRE(1 == value.use_count());
+  size_t expired = wheel.expire(base + hours(1), [](std::shared_ptr<int> &&) {});
+  REQUIRE(0 == expired);
+}
@@ -0,0 +1,203 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../TestBase.h"
+#include "utils/MinifiConcurrentQueue.h"
+#include "utils/TwoLockQueue.h"
+#include "utils/StringUtils.h"
+
+namespace utils = org::apache::nifi::minifi::utils;
+
+TEST_CASE("TwoLockQueue preserves insertion order", "[TwoLockQueue]") {
+  utils::TwoLockQueue<std::string> queue;
+  REQUIRE(queue.empty());
+
+  queue.enqueue("ba");
+  queue.enqueue("dum");
+  queue.enqueue("tss");
+  REQUIRE(3 == queue.size());
+
+  std::vector<std::string> results;
+  std::string s;
+  while (queue.tryDequeue(s)) {
+    results.push_back(s);
+  }
+
+  REQUIRE(utils::StringUtils::join("-", results) == "ba-dum-tss");
+  REQUIRE(queue.empty());
+  REQUIRE_FALSE(queue.tryDequeue(s));
+}
+
+TEST_CASE("TwoLockQueue clear visits every element", "[TwoLockQueue]") {
+  utils::TwoLockQueue<int> queue;
+  for (int i = 0; i < 10; i++) {
+    queue.enqueue(i);
+  }
+  int sum = 0;
+  queue.clear([&sum](int &i) { sum += i; });
+  REQUIRE(45 == sum);
+  REQUIRE(queue.empty());
+  queue.enqueue(1);
+  REQUIRE(1 == queue.size());
+}
+
+TEST_CASE("TwoLockQueue batch operations", "[TwoLockQueue]") {
+  utils::TwoLockQueue<int> queue;
+  std::vector<int> input{1, 2, 3, 4, 5, 6};
+  queue.enqueueRange(input.begin(), input.end());
+  REQUIRE(6 == queue.size());
+
+  std::vector<int> taken;
+  size_t count = queue.consume([&taken](int &i) {
+    if (i > 3) {
+      return false;
+    }
+    taken.push_back(i);
+    return true;
+  });
+  REQUIRE(3 == count);
+  REQUIRE((std::vector<int>{1, 2, 3}) == taken);
+  REQUIRE(3 == queue.size());
+
+  queue.enqueueRange(input.begin(), input.begin() + 1);
+  taken.clear();
+  count = queue.consume([&taken](int &i) {
+    taken.push_back(i);
+    return true;
+  });
+  REQUIRE(4 == count);
+  REQUIRE((std::vector<int>{4, 5, 6, 1}) == taken);
+  REQUIRE(queue.empty());
+  count = queue.consume([](int&) { return true; });
+  REQUIRE(0 == count);
+}
+
+TEST_CASE("TwoLockQueue multiple producers and consumers", "[TwoLockQueue]") {
+  const int producers = 4;
+  const int consumers = 4;
+  const int items_per_producer = 10000;
+
+  utils::TwoLockQueue<std::pair<int, int>> queue;
+  std::atomic<int> consumed(0);
+  std::atomic<bool> order_violated(false);
+  std::vector<std::atomic<int>> seen(producers);
+  for (auto &s : seen) {
+    s = 0;
+  }
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([&queue, p]() {
+      for (int i = 0; i < items_per_producer; i++) {
+        queue.enqueue(p, i);
+      }
+    });
+  }
+  for (int c = 0; c < consumers; c++) {
+    threads.emplace_back([&]() {
+      std::vector<int> last(producers, -1);
+      std::pair<int, int> item;
+      while (consumed < producers * items_per_producer) {
+        if (queue.tryDequeue(item)) {
+          // every consumer has to observe the items of one producer in increasing order
+          if (item.second <= last[item.first]) {
+            order_violated = true;
+          }
+          last[item.first] = item.second;
+          seen[item.first]++;
+          consumed++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  REQUIRE_FALSE(order_violated);
+  REQUIRE(queue.empty());
+  for (auto &s : seen) {
+    REQUIRE(items_per_producer == s);
+  }
+}
+
+namespace {
+
+template<typename Queue>
+double measureContention(Queue &queue, int producers, int consumers, int items_per_producer) {
+  std::atomic<int> consumed(0);
+  std::atomic<bool> done(false);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < items_per_producer; i++) {
+        queue.enqueue(i);
+      }
+    });
+  }
+  for (int c = 0; c < consumers; c++) {
+    threads.emplace_back([&]() {
+      int item;
+      while (consumed < producers * items_per_producer) {
+        if (queue.tryDequeue(item)) {
+          consumed++;
+        }
+      }
+    });
+  }
+  // emulates the scheduler polling for work
+  std::thread poller([&]() {
+    size_t dummy = 0;
+    while (!done) {
+      dummy += queue.size();
+    }
+  });
+  for (auto &t : threads) {
+    t.join();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  done = true;
+  poller.join();
+  return (producers * items_per_producer) / (elapsed / 1000000.0);
+}
+
+}  // namespace
+
+TEST_CASE("TwoLockQueue contention benchmark", "[.][benchmark]") {
+  const int items_per_producer = 200000;
+  const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+  for (unsigned workers = 1; workers <= threads / 2; workers *= 2) {
+    utils::ConcurrentQueue<int> locked_queue;
+    utils::TwoLockQueue<int> two_lock_queue;
+    double locked = measureContention(locked_queue, workers, workers, items_per_producer);
+    double two_lock = measureContention(two_lock_queue, workers, workers, items_per_producer);
+    std::cout << workers << " producer(s) / " << workers << " consumer(s): ConcurrentQueue " << static_cast<uint64_t>(locked)
+              << " items/s, TwoLockQueue " << static_cast<uint64_t>(two_lock) << " items/s" << std::endl;
+  }
+}
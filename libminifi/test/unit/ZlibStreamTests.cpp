@@ -42,6 +42,13 @@ TEST_CASE("gzip compression and decompression", "[basic]") {
     REQUIRE(strlen("bar") == compressStream.write(reinterpret_cast<uint8_t*>(const_cast<char*>("bar")), strlen("bar")));
     original += "bar";
   }
+  SECTION("Simple content in a vectored write") {
+    std::string foo = "foo";
+    std::string bar = "bar";
+    io::IoVec buffers[] = { { reinterpret_cast<uint8_t*>(&foo[0]), foo.size() }, { nullptr, 0 }, { reinterpret_cast<uint8_t*>(&bar[0]), bar.size() } };
+    REQUIRE(6 == compressStream.writev(buffers, 3));
+    original += "foobar";
+  }
   SECTION("Large data") {
     std::mt19937 gen(std::random_device { }());
     std::uniform_int_distribution<> dist(0, 255);
@@ -87,6 +94,13 @@ TEST_CASE("gzip compression and decompression pipeline", "[basic]") {
     REQUIRE(strlen("bar") == compressStream.writeData(reinterpret_cast<uint8_t*>(const_cast<char*>("bar")), strlen("bar")));
     original += "bar";
   }
+  SECTION("Simple content in a vectored write") {
+    std::string foo = "foo";
+    std::string bar = "bar";
+    io::IoVec buffers[] = { { reinterpret_cast<uint8_t*>(&foo[0]), foo.size() }, { reinterpret_cast<uint8_t*>(&bar[0]), bar.size() } };
+    REQUIRE(6 == compressStream.writev(buffers, 2));
+    original += "foobar";
+  }
   SECTION("Large data") {
     std::mt19937 gen(std::random_device { }());
     std::uniform_int_distribution<> dist(0, 255);
@@ -55,6 +55,14 @@ class ReflexiveSession : public ProcessSession{
      return prevff;
    }
 
+   virtual std::vector<std::shared_ptr<core::FlowFile>> get(size_t max, uint64_t max_bytes = 0){
+     std::vector<std::shared_ptr<core::FlowFile>> flows;
+     if (ff && max > 0) {
+       flows.push_back(get());
+     }
+     return flows;
+   }
+
    virtual void add(const std::shared_ptr<core::FlowFile> &flow){
      ff = flow;
    }